@@ -12,8 +12,48 @@ extern "C" {
 #define WEBVULKAN_RUNTIME_DEFAULT_SHADER_KEY_HI 0u
 #define WEBVULKAN_RUNTIME_DISPATCH_MODE_RAW_LLVM_IR 0u
 #define WEBVULKAN_RUNTIME_DISPATCH_MODE_FAST_WASM 1u
+#define WEBVULKAN_RUNTIME_DEFAULT_SUBGROUP_SIZE 4u
+#define WEBVULKAN_RUNTIME_MAX_SUBGROUP_SIZE 128u
+#define WEBVULKAN_RUNTIME_NO_SPECIALIZATION_KEY 0u
+#define WEBVULKAN_RUNTIME_ANY_GROUP_COUNT 0u
 #define WEBVULKAN_RUNTIME_SHADER_BUNDLE_HAS_WASM 0x1u
 #define WEBVULKAN_RUNTIME_SHADER_BUNDLE_HAS_EXPECTED_VALUE 0x2u
+#define WEBVULKAN_RUNTIME_SHADER_BUNDLE_HAS_SHARED_WASM_MODULE 0x4u
+#define WEBVULKAN_RUNTIME_NO_SHARED_WASM_MODULE 0u
+#define WEBVULKAN_RUNTIME_KERNEL_IMPORT_MODULE "env"
+#define WEBVULKAN_RUNTIME_KERNEL_MEMORY_IMPORT "memory"
+#define WEBVULKAN_RUNTIME_TRACE_MAX_EVENTS 65536u
+#define WEBVULKAN_RUNTIME_TRACE_INSTANCE_CREATE 0u
+#define WEBVULKAN_RUNTIME_TRACE_DEVICE_CREATE 1u
+#define WEBVULKAN_RUNTIME_TRACE_SHADER_MODULE_CREATE 2u
+#define WEBVULKAN_RUNTIME_TRACE_PIPELINE_CREATE 3u
+#define WEBVULKAN_RUNTIME_TRACE_REGISTRY_LOOKUP 4u
+#define WEBVULKAN_RUNTIME_TRACE_QUEUE_SUBMIT 5u
+#define WEBVULKAN_RUNTIME_TRACE_FENCE_WAIT 6u
+#define WEBVULKAN_RUNTIME_TRACE_WASM_KERNEL 7u
+#define WEBVULKAN_RUNTIME_TRACE_EVENT_COUNT 8u
+#define WEBVULKAN_RUNTIME_STAGE_INSTANCE_CREATE 0u
+#define WEBVULKAN_RUNTIME_STAGE_DEVICE_CREATE 1u
+#define WEBVULKAN_RUNTIME_STAGE_PIPELINE_CREATE 2u
+#define WEBVULKAN_RUNTIME_STAGE_RESOURCE_SETUP 3u
+#define WEBVULKAN_RUNTIME_STAGE_COMMAND_RECORD 4u
+#define WEBVULKAN_RUNTIME_STAGE_QUEUE_SUBMIT 5u
+#define WEBVULKAN_RUNTIME_STAGE_FENCE_WAIT 6u
+#define WEBVULKAN_RUNTIME_STAGE_HOST_READBACK 7u
+#define WEBVULKAN_RUNTIME_STAGE_REGISTRY_LOOKUP 8u
+#define WEBVULKAN_RUNTIME_STAGE_COUNT 9u
+#define WEBVULKAN_RUNTIME_MEMORY_LINEAR_BYTES 0u
+#define WEBVULKAN_RUNTIME_MEMORY_MALLOC_IN_USE_BYTES 1u
+#define WEBVULKAN_RUNTIME_MEMORY_MALLOC_FOOTPRINT_BYTES 2u
+#define WEBVULKAN_RUNTIME_MEMORY_PEAK_MALLOC_FOOTPRINT_BYTES 3u
+#define WEBVULKAN_RUNTIME_MEMORY_REGISTRY_PAYLOAD_BYTES 4u
+#define WEBVULKAN_RUNTIME_MEMORY_DEVICE_MEMORY_BYTES 5u
+#define WEBVULKAN_RUNTIME_MEMORY_PEAK_DEVICE_MEMORY_BYTES 6u
+#define WEBVULKAN_RUNTIME_MEMORY_DEVICE_MEMORY_ALLOCATIONS 7u
+#define WEBVULKAN_RUNTIME_MEMORY_PIPELINE_HEAP_DELTA_BYTES 8u
+#define WEBVULKAN_RUNTIME_MEMORY_LAST_PIPELINE_HEAP_DELTA_BYTES 9u
+#define WEBVULKAN_RUNTIME_MEMORY_LIVE_PIPELINES 10u
+#define WEBVULKAN_RUNTIME_MEMORY_COUNT 11u
 
 typedef struct WebVulkanRuntimeShaderBundle_t {
   uint32_t keyLo;
@@ -27,8 +67,36 @@ typedef struct WebVulkanRuntimeShaderBundle_t {
   const char* wasmProvider;
   uint32_t expectedDispatchValue;
   uint32_t flags;
+  uint32_t wasmModuleId;
 } WebVulkanRuntimeShaderBundle;
 
+typedef struct WebVulkanRuntimeSpecializationEntry_t {
+  uint32_t constantId;
+  uint32_t offset;
+  uint32_t size;
+} WebVulkanRuntimeSpecializationEntry;
+
+/* Durations of one WEBVULKAN_RUNTIME_STAGE_*, in milliseconds; lastMs is -1 until recorded. */
+typedef struct WebVulkanRuntimeStageTiming_t {
+  double totalMs;
+  double lastMs;
+  uint32_t count;
+  uint32_t reserved;
+} WebVulkanRuntimeStageTiming;
+
+typedef struct WebVulkanRuntimeStageTimings_t {
+  WebVulkanRuntimeStageTiming stages[WEBVULKAN_RUNTIME_STAGE_COUNT];
+} WebVulkanRuntimeStageTimings;
+
+/*
+ * Heap footprint in bytes, indexed by WEBVULKAN_RUNTIME_MEMORY_*. Linear memory never
+ * shrinks, so its current size is also its peak. Device memory and pipeline bytes are
+ * whatever the host reported through the record calls.
+ */
+typedef struct WebVulkanRuntimeMemoryFootprint_t {
+  uint32_t values[WEBVULKAN_RUNTIME_MEMORY_COUNT];
+} WebVulkanRuntimeMemoryFootprint;
+
 int webvulkan_runtime_register_shader_bundle(const WebVulkanRuntimeShaderBundle* bundle);
 int webvulkan_runtime_register_shader_bundles(const WebVulkanRuntimeShaderBundle* bundles, uint32_t bundleCount);
 int webvulkan_runtime_register_shader_bundle_params(
@@ -48,6 +116,44 @@ int webvulkan_runtime_unregister_shader_bundle(uint32_t keyLo, uint32_t keyHi);
 void webvulkan_runtime_clear_shader_bundles(void);
 uint32_t webvulkan_runtime_get_registered_spirv_count(void);
 uint32_t webvulkan_runtime_get_registered_wasm_count(void);
+uint32_t webvulkan_runtime_get_registered_specialized_wasm_count(void);
+uint32_t webvulkan_runtime_get_registered_grid_wasm_count(void);
+uint32_t webvulkan_runtime_get_registered_imported_memory_wasm_count(void);
+int webvulkan_runtime_wasm_module_imports_memory(const uint8_t* bytes, uint32_t byteCount);
+uint32_t webvulkan_runtime_get_live_wasm_instance_count(void);
+uint32_t webvulkan_runtime_get_wasm_instantiation_count(void);
+uint32_t webvulkan_runtime_get_wasm_instance_dispatch_count(void);
+uint32_t webvulkan_runtime_get_wasm_kernel_binding(uint32_t keyLo, uint32_t keyHi);
+uint32_t webvulkan_runtime_get_wasm_kernel_instance(uint32_t keyLo, uint32_t keyHi);
+uint32_t webvulkan_runtime_get_wasm_grid_lookup_hit_count(void);
+void webvulkan_runtime_reset_wasm_instance_counters(void);
+int webvulkan_runtime_dispatch_wasm_instance(
+  uint32_t bindingId,
+  uint32_t dst,
+  uint32_t offset,
+  uint32_t value,
+  uint32_t workload,
+  uint32_t invocations,
+  uint32_t workgroups
+);
+int webvulkan_runtime_get_stage_timings(WebVulkanRuntimeStageTimings* outTimings);
+double webvulkan_runtime_get_stage_total_ms(uint32_t stage);
+double webvulkan_runtime_get_stage_last_ms(uint32_t stage);
+uint32_t webvulkan_runtime_get_stage_count(uint32_t stage);
+void webvulkan_runtime_reset_stage_timings(void);
+void webvulkan_runtime_record_stage_timing(uint32_t stage, double ms);
+int webvulkan_runtime_get_memory_footprint(WebVulkanRuntimeMemoryFootprint* outFootprint);
+uint32_t webvulkan_runtime_get_memory_footprint_value(uint32_t field);
+void webvulkan_runtime_record_device_memory(uint32_t bytes, int allocated);
+void webvulkan_runtime_record_pipeline_heap_delta(uint32_t bytes, int created);
+int webvulkan_runtime_trace_enable(uint32_t capacity);
+int webvulkan_runtime_trace_enabled(void);
+void webvulkan_runtime_trace_reset(void);
+void webvulkan_runtime_trace_begin(uint32_t event, uint32_t arg);
+void webvulkan_runtime_trace_end(uint32_t event);
+uint32_t webvulkan_runtime_trace_get_event_count(void);
+uint32_t webvulkan_runtime_trace_get_dropped_count(void);
+const char* webvulkan_runtime_trace_export_json(void);
 int webvulkan_runtime_set_active_shader_bundle(uint32_t keyLo, uint32_t keyHi);
 int webvulkan_runtime_set_dispatch_mode_fast_wasm(int enabled);
 
@@ -68,6 +174,81 @@ int webvulkan_register_runtime_wasm_module(
   const char* provider
 );
 
+int webvulkan_register_runtime_wasm_module_specialized(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey,
+  const uint8_t* bytes,
+  uint32_t byteCount,
+  const char* entrypoint,
+  const char* provider
+);
+
+int webvulkan_register_runtime_wasm_module_for_grid(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey,
+  uint32_t groupCountX,
+  uint32_t groupCountY,
+  uint32_t groupCountZ,
+  const uint8_t* bytes,
+  uint32_t byteCount,
+  const char* entrypoint,
+  const char* provider
+);
+
+int webvulkan_register_runtime_wasm_shared_module(
+  uint32_t moduleId,
+  const uint8_t* bytes,
+  uint32_t byteCount,
+  const char* provider
+);
+int webvulkan_unregister_runtime_wasm_shared_module(uint32_t moduleId);
+uint32_t webvulkan_runtime_get_registered_shared_wasm_module_count(void);
+
+int webvulkan_register_runtime_wasm_kernel(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey,
+  uint32_t groupCountX,
+  uint32_t groupCountY,
+  uint32_t groupCountZ,
+  uint32_t moduleId,
+  const char* exportName
+);
+
+/*
+ * Specialization keys are small ids handed out per distinct constant set (sorted by
+ * constant id, compared byte for byte), so equal sets share a key whatever their entry
+ * order and different sets never collide. Ids stay valid across registry resets.
+ */
+int webvulkan_runtime_intern_specialization(
+  const WebVulkanRuntimeSpecializationEntry* entries,
+  uint32_t entryCount,
+  const uint8_t* data,
+  uint32_t dataSize,
+  uint32_t* outSpecializationKey
+);
+
+/*
+ * The driver does not pass a pipeline's specialization constants to the lookup, so the
+ * host states which interned set pipelines of this shader key are created with.
+ * webvulkan_runtime_lookup_wasm_module then resolves only modules built for that set.
+ */
+int webvulkan_runtime_set_shader_specialization(uint32_t keyLo, uint32_t keyHi, uint32_t specializationKey);
+
+/*
+ * Likewise for the dispatch grid: a grid-specialized module registered for this grid is
+ * preferred over the grid-generic one. WEBVULKAN_RUNTIME_ANY_GROUP_COUNT clears it.
+ */
+int webvulkan_runtime_set_shader_dispatch_grid(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t groupCountX,
+  uint32_t groupCountY,
+  uint32_t groupCountZ
+);
+
 int webvulkan_register_runtime_shader_bundle(
   uint32_t keyLo,
   uint32_t keyHi,
@@ -86,6 +267,8 @@ uint32_t webvulkan_get_runtime_active_shader_key_lo(void);
 uint32_t webvulkan_get_runtime_active_shader_key_hi(void);
 int webvulkan_set_runtime_dispatch_mode(uint32_t mode);
 uint32_t webvulkan_get_runtime_dispatch_mode(void);
+int webvulkan_set_runtime_subgroup_size(uint32_t subgroupSize);
+uint32_t webvulkan_get_runtime_subgroup_size(void);
 int webvulkan_set_runtime_expected_dispatch_value(uint32_t keyLo, uint32_t keyHi, uint32_t expectedValue);
 void webvulkan_runtime_reset_captured_shader_key(void);
 int webvulkan_runtime_has_captured_shader_key(void);
@@ -103,6 +286,39 @@ bool webvulkan_runtime_lookup_wasm_module(
   const char** outProvider
 );
 
+bool webvulkan_runtime_lookup_wasm_module_specialized(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey,
+  const uint8_t** outModuleBytes,
+  uint32_t* outModuleSize,
+  const char** outEntrypoint,
+  const char** outProvider
+);
+
+bool webvulkan_runtime_lookup_wasm_module_for_dispatch(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey,
+  uint32_t groupCountX,
+  uint32_t groupCountY,
+  uint32_t groupCountZ,
+  const uint8_t** outModuleBytes,
+  uint32_t* outModuleSize,
+  const char** outEntrypoint,
+  const char** outProvider
+);
+
+bool webvulkan_runtime_lookup_wasm_instance_for_dispatch(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey,
+  uint32_t groupCountX,
+  uint32_t groupCountY,
+  uint32_t groupCountZ,
+  uint32_t* outBindingId
+);
+
 bool webvulkan_runtime_lookup_spirv_module(
   uint32_t keyLo,
   uint32_t keyHi,
@@ -1,13 +1,21 @@
 #include "webvulkan/webvulkan_shader_runtime_registry.h"
 
 #include <emscripten/emscripten.h>
+#include <emscripten/heap.h>
+#include <malloc.h>
+#include <pthread.h>
 #include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define WEBVULKAN_RUNTIME_MAX_MODULES 16u
+#define WEBVULKAN_RUNTIME_MAX_MODULES 64u
 #define WEBVULKAN_RUNTIME_ENTRYPOINT_MAX 64u
 #define WEBVULKAN_RUNTIME_PROVIDER_MAX 128u
+#define WEBVULKAN_RUNTIME_TRACE_JSON_EVENT_BYTES 192u
+#define WEBVULKAN_RUNTIME_MAX_SPECIALIZATIONS 64u
+#define WEBVULKAN_RUNTIME_MAX_SPECIALIZATION_CONSTANTS 16u
+#define WEBVULKAN_RUNTIME_MAX_SPECIALIZATION_BYTES 128u
 
 typedef struct WebVulkanRuntimeSpirvEntry_t {
   uint32_t keyLo;
@@ -15,30 +23,202 @@ typedef struct WebVulkanRuntimeSpirvEntry_t {
   uint8_t* bytes;
   uint32_t byteCount;
   uint32_t expectedDispatchValue;
+  uint32_t specializationKey;
+  uint32_t groupCountX;
+  uint32_t groupCountY;
+  uint32_t groupCountZ;
   char entrypoint[WEBVULKAN_RUNTIME_ENTRYPOINT_MAX];
 } WebVulkanRuntimeSpirvEntry;
 
 typedef struct WebVulkanRuntimeWasmEntry_t {
   uint32_t keyLo;
   uint32_t keyHi;
+  uint32_t specializationKey;
+  uint32_t groupCountX;
+  uint32_t groupCountY;
+  uint32_t groupCountZ;
   uint8_t* bytes;
   uint32_t byteCount;
+  int importsMemory;
+  uint32_t moduleId;
+  uint32_t instanceId;
+  uint32_t bindingId;
   char entrypoint[WEBVULKAN_RUNTIME_ENTRYPOINT_MAX];
   char provider[WEBVULKAN_RUNTIME_PROVIDER_MAX];
 } WebVulkanRuntimeWasmEntry;
 
+typedef struct WebVulkanRuntimeWasmSharedModule_t {
+  uint32_t moduleId;
+  uint8_t* bytes;
+  uint32_t byteCount;
+  int importsMemory;
+  uint32_t instanceId;
+  char provider[WEBVULKAN_RUNTIME_PROVIDER_MAX];
+} WebVulkanRuntimeWasmSharedModule;
+
+/*
+ * One interned specialization constant set: constants sorted by id, their bytes packed
+ * in that order. hash only picks the candidates; two sets are the same specialization
+ * when every field matches. Unused tails stay zeroed, so the whole struct compares.
+ */
+typedef struct WebVulkanRuntimeSpecialization_t {
+  uint32_t hash;
+  uint32_t constantCount;
+  uint32_t constantIds[WEBVULKAN_RUNTIME_MAX_SPECIALIZATION_CONSTANTS];
+  uint32_t constantSizes[WEBVULKAN_RUNTIME_MAX_SPECIALIZATION_CONSTANTS];
+  uint32_t dataSize;
+  uint8_t data[WEBVULKAN_RUNTIME_MAX_SPECIALIZATION_BYTES];
+} WebVulkanRuntimeSpecialization;
+
+/*
+ * One slot of the trace ring. sequence is the claimed write index plus one and is
+ * published last, so the exporter can tell a finished slot from one still being
+ * written or already reused by a later event. The write index is 64-bit so the
+ * head never wraps and the dropped count stays exact.
+ */
+typedef struct WebVulkanRuntimeTraceEvent_t {
+  double timestampMs;
+  uint64_t sequence;
+  uint32_t event;
+  uint32_t arg;
+  uint32_t thread;
+  char phase;
+} WebVulkanRuntimeTraceEvent;
+
 static WebVulkanRuntimeSpirvEntry g_runtime_spirv_entries[WEBVULKAN_RUNTIME_MAX_MODULES];
 static uint32_t g_runtime_spirv_count = 0u;
 static WebVulkanRuntimeWasmEntry g_runtime_wasm_entries[WEBVULKAN_RUNTIME_MAX_MODULES];
 static uint32_t g_runtime_wasm_count = 0u;
+static WebVulkanRuntimeWasmSharedModule g_runtime_wasm_shared_modules[WEBVULKAN_RUNTIME_MAX_MODULES];
+static uint32_t g_runtime_wasm_shared_module_count = 0u;
+static WebVulkanRuntimeSpecialization g_runtime_specializations[WEBVULKAN_RUNTIME_MAX_SPECIALIZATIONS];
+static uint32_t g_runtime_specialization_count = 0u;
 static int g_runtime_wasm_used = 0;
 static char g_runtime_wasm_provider[WEBVULKAN_RUNTIME_PROVIDER_MAX] = "none";
 static uint32_t g_runtime_active_shader_key_lo = WEBVULKAN_RUNTIME_DEFAULT_SHADER_KEY_LO;
 static uint32_t g_runtime_active_shader_key_hi = WEBVULKAN_RUNTIME_DEFAULT_SHADER_KEY_HI;
 static uint32_t g_runtime_dispatch_mode = WEBVULKAN_RUNTIME_DISPATCH_MODE_FAST_WASM;
+static uint32_t g_runtime_subgroup_size = WEBVULKAN_RUNTIME_DEFAULT_SUBGROUP_SIZE;
 static int g_runtime_captured_shader_key_valid = 0;
 static uint32_t g_runtime_captured_shader_key_lo = 0u;
 static uint32_t g_runtime_captured_shader_key_hi = 0u;
+static uint32_t g_runtime_next_wasm_instance_id = 1u;
+static uint32_t g_runtime_wasm_instantiation_count = 0u;
+static uint32_t g_runtime_wasm_instance_dispatch_count = 0u;
+static uint32_t g_runtime_wasm_grid_lookup_hit_count = 0u;
+static WebVulkanRuntimeStageTimings g_runtime_stage_timings = {
+  {
+    { 0.0, -1.0, 0u, 0u },
+    { 0.0, -1.0, 0u, 0u },
+    { 0.0, -1.0, 0u, 0u },
+    { 0.0, -1.0, 0u, 0u },
+    { 0.0, -1.0, 0u, 0u },
+    { 0.0, -1.0, 0u, 0u },
+    { 0.0, -1.0, 0u, 0u },
+    { 0.0, -1.0, 0u, 0u },
+    { 0.0, -1.0, 0u, 0u }
+  }
+};
+static uint32_t g_runtime_device_memory_bytes = 0u;
+static uint32_t g_runtime_peak_device_memory_bytes = 0u;
+static uint32_t g_runtime_device_memory_allocations = 0u;
+static uint32_t g_runtime_pipeline_heap_delta_bytes = 0u;
+static uint32_t g_runtime_last_pipeline_heap_delta_bytes = 0u;
+static uint32_t g_runtime_live_pipelines = 0u;
+static WebVulkanRuntimeTraceEvent* g_runtime_trace_events = NULL;
+static uint32_t g_runtime_trace_capacity = 0u;
+static uint64_t g_runtime_trace_head = 0u;
+static char* g_runtime_trace_json = NULL;
+static const char* const g_runtime_trace_event_names[WEBVULKAN_RUNTIME_TRACE_EVENT_COUNT] = {
+  "vkCreateInstance",
+  "vkCreateDevice",
+  "vkCreateShaderModule",
+  "vkCreatePipelines",
+  "registry_lookup",
+  "vkQueueSubmit",
+  "vkWaitForFences",
+  "wasm_kernel"
+};
+static const char* const g_runtime_trace_event_categories[WEBVULKAN_RUNTIME_TRACE_EVENT_COUNT] = {
+  "vulkan",
+  "vulkan",
+  "vulkan",
+  "vulkan",
+  "registry",
+  "vulkan",
+  "vulkan",
+  "kernel"
+};
+
+EM_JS_DEPS(webvulkan_shader_runtime_registry, "$UTF8ToString");
+
+/*
+ * Registered modules are compiled and instantiated once, at registration, outside the
+ * dispatch path. Instances are keyed by instance id; a binding resolves one exported
+ * kernel of an instance, so a multi-kernel module is shared by every entry that points
+ * at it. A module that imports WEBVULKAN_RUNTIME_KERNEL_MEMORY_IMPORT gets the lavapipe
+ * memory; an import-free module keeps its own.
+ *
+ * Compilation is synchronous. Browsers refuse that on the main thread for modules over
+ * 4 KiB, so register from a worker there; the rejection is logged and fails the
+ * registration instead of surfacing later as a silent fallback.
+ */
+EM_JS(int, webvulkan_runtime_js_instantiate_wasm, (uint32_t instanceId, const uint8_t* bytes, uint32_t byteCount), {
+  try {
+    const instances = Module.webvulkanRuntimeWasmInstances || (Module.webvulkanRuntimeWasmInstances = new Map());
+    const module = new WebAssembly.Module(HEAPU8.slice(bytes, bytes + byteCount));
+    instances.set(instanceId, new WebAssembly.Instance(module, {
+      env: {
+        memory: wasmMemory
+      }
+    }));
+    return 0;
+  } catch (e) {
+    err("webvulkan runtime: Wasm instantiation failed for instance " + instanceId + ": " + e);
+    return -1;
+  }
+});
+
+EM_JS(void, webvulkan_runtime_js_release_wasm, (uint32_t instanceId), {
+  if (Module.webvulkanRuntimeWasmInstances) {
+    Module.webvulkanRuntimeWasmInstances.delete(instanceId);
+  }
+});
+
+EM_JS(int, webvulkan_runtime_js_bind_wasm_export, (uint32_t bindingId, uint32_t instanceId, const char* exportName), {
+  const instance = Module.webvulkanRuntimeWasmInstances && Module.webvulkanRuntimeWasmInstances.get(instanceId);
+  if (!instance) {
+    return -1;
+  }
+  const run = instance.exports[UTF8ToString(exportName)];
+  if (typeof run !== "function") {
+    err("webvulkan runtime: Wasm instance " + instanceId + " has no exported kernel '" + UTF8ToString(exportName) + "'");
+    return -2;
+  }
+  const bindings = Module.webvulkanRuntimeWasmBindings || (Module.webvulkanRuntimeWasmBindings = new Map());
+  bindings.set(bindingId, run);
+  return 0;
+});
+
+EM_JS(void, webvulkan_runtime_js_release_wasm_binding, (uint32_t bindingId), {
+  if (Module.webvulkanRuntimeWasmBindings) {
+    Module.webvulkanRuntimeWasmBindings.delete(bindingId);
+  }
+});
+
+EM_JS(int, webvulkan_runtime_js_dispatch_wasm, (uint32_t bindingId, uint32_t dst, uint32_t offset, uint32_t value, uint32_t workload, uint32_t invocations, uint32_t workgroups), {
+  const run = Module.webvulkanRuntimeWasmBindings && Module.webvulkanRuntimeWasmBindings.get(bindingId);
+  if (!run) {
+    return -1;
+  }
+  try {
+    run(dst, offset, value, workload, invocations, workgroups);
+  } catch (e) {
+    err("webvulkan runtime: Wasm kernel binding " + bindingId + " trapped: " + e);
+    return -2;
+  }
+  return 0;
+});
 
 static void webvulkan_copy_string(char* dst, uint32_t dstSize, const char* src, const char* fallback) {
   if (!dst || dstSize == 0u) {
@@ -76,6 +256,125 @@ static int webvulkan_validate_wasm_bytes(const uint8_t* bytes, uint32_t byteCoun
   return 0;
 }
 
+static int webvulkan_read_wasm_uleb(const uint8_t* bytes, uint32_t byteCount, uint32_t* cursor, uint32_t* outValue) {
+  uint32_t value = 0u;
+  for (uint32_t shift = 0u; shift < 35u; shift += 7u) {
+    if (*cursor >= byteCount) {
+      return -1;
+    }
+    uint8_t byte = bytes[(*cursor)++];
+    value |= (uint32_t)(byte & 0x7fu) << shift;
+    if ((byte & 0x80u) == 0u) {
+      *outValue = value;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+static int webvulkan_skip_wasm_bytes(uint32_t byteCount, uint32_t* cursor, uint32_t skipCount) {
+  if (skipCount > byteCount - *cursor) {
+    return -1;
+  }
+  *cursor += skipCount;
+  return 0;
+}
+
+static int webvulkan_skip_wasm_limits(const uint8_t* bytes, uint32_t byteCount, uint32_t* cursor) {
+  uint32_t flags = 0u;
+  uint32_t limit = 0u;
+  if (webvulkan_read_wasm_uleb(bytes, byteCount, cursor, &flags) != 0 ||
+      webvulkan_read_wasm_uleb(bytes, byteCount, cursor, &limit) != 0) {
+    return -1;
+  }
+  if ((flags & 0x1u) != 0u && webvulkan_read_wasm_uleb(bytes, byteCount, cursor, &limit) != 0) {
+    return -1;
+  }
+  return 0;
+}
+
+/*
+ * Scans the import and data sections. A module that imports its memory shares the
+ * lavapipe heap, so it must not carry data segments that would be copied into it
+ * at instantiation time.
+ */
+static int webvulkan_scan_wasm_memory_layout(
+  const uint8_t* bytes,
+  uint32_t byteCount,
+  int* outImportsMemory,
+  int* outHasDataSegments
+) {
+  *outImportsMemory = 0;
+  *outHasDataSegments = 0;
+  uint32_t cursor = 8u;
+  while (cursor < byteCount) {
+    uint8_t sectionId = bytes[cursor++];
+    uint32_t sectionSize = 0u;
+    if (webvulkan_read_wasm_uleb(bytes, byteCount, &cursor, &sectionSize) != 0 ||
+        sectionSize > byteCount - cursor) {
+      return -1;
+    }
+    const uint32_t sectionEnd = cursor + sectionSize;
+    if (sectionId == 2u) {
+      uint32_t importCount = 0u;
+      if (webvulkan_read_wasm_uleb(bytes, sectionEnd, &cursor, &importCount) != 0) {
+        return -1;
+      }
+      for (uint32_t i = 0u; i < importCount; ++i) {
+        uint32_t nameLength = 0u;
+        if (webvulkan_read_wasm_uleb(bytes, sectionEnd, &cursor, &nameLength) != 0 ||
+            webvulkan_skip_wasm_bytes(sectionEnd, &cursor, nameLength) != 0 ||
+            webvulkan_read_wasm_uleb(bytes, sectionEnd, &cursor, &nameLength) != 0 ||
+            webvulkan_skip_wasm_bytes(sectionEnd, &cursor, nameLength) != 0 ||
+            cursor >= sectionEnd) {
+          return -1;
+        }
+        uint8_t kind = bytes[cursor++];
+        uint32_t index = 0u;
+        int rc = 0;
+        switch (kind) {
+        case 0u:
+          rc = webvulkan_read_wasm_uleb(bytes, sectionEnd, &cursor, &index);
+          break;
+        case 1u:
+          rc = webvulkan_skip_wasm_bytes(sectionEnd, &cursor, 1u);
+          if (rc == 0) {
+            rc = webvulkan_skip_wasm_limits(bytes, sectionEnd, &cursor);
+          }
+          break;
+        case 2u:
+          *outImportsMemory = 1;
+          rc = webvulkan_skip_wasm_limits(bytes, sectionEnd, &cursor);
+          break;
+        case 3u:
+          rc = webvulkan_skip_wasm_bytes(sectionEnd, &cursor, 2u);
+          break;
+        case 4u:
+          rc = webvulkan_skip_wasm_bytes(sectionEnd, &cursor, 1u);
+          if (rc == 0) {
+            rc = webvulkan_read_wasm_uleb(bytes, sectionEnd, &cursor, &index);
+          }
+          break;
+        default:
+          rc = -1;
+          break;
+        }
+        if (rc != 0) {
+          return -1;
+        }
+      }
+    } else if (sectionId == 11u) {
+      uint32_t segmentCount = 0u;
+      if (webvulkan_read_wasm_uleb(bytes, sectionEnd, &cursor, &segmentCount) != 0) {
+        return -1;
+      }
+      *outHasDataSegments = segmentCount > 0u;
+    }
+    cursor = sectionEnd;
+  }
+  return 0;
+}
+
 static int webvulkan_find_spirv_entry_index(uint32_t keyLo, uint32_t keyHi) {
   for (uint32_t i = 0u; i < g_runtime_spirv_count; ++i) {
     if (g_runtime_spirv_entries[i].keyLo == keyLo && g_runtime_spirv_entries[i].keyHi == keyHi) {
@@ -85,7 +384,26 @@ static int webvulkan_find_spirv_entry_index(uint32_t keyLo, uint32_t keyHi) {
   return -1;
 }
 
-static int webvulkan_find_wasm_entry_index(uint32_t keyLo, uint32_t keyHi) {
+static int webvulkan_find_wasm_entry_index(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey,
+  uint32_t groupCountX,
+  uint32_t groupCountY,
+  uint32_t groupCountZ
+) {
+  for (uint32_t i = 0u; i < g_runtime_wasm_count; ++i) {
+    const WebVulkanRuntimeWasmEntry* entry = &g_runtime_wasm_entries[i];
+    if (entry->keyLo == keyLo && entry->keyHi == keyHi && entry->specializationKey == specializationKey &&
+        entry->groupCountX == groupCountX && entry->groupCountY == groupCountY &&
+        entry->groupCountZ == groupCountZ) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+static int webvulkan_find_any_wasm_entry_index(uint32_t keyLo, uint32_t keyHi) {
   for (uint32_t i = 0u; i < g_runtime_wasm_count; ++i) {
     if (g_runtime_wasm_entries[i].keyLo == keyLo && g_runtime_wasm_entries[i].keyHi == keyHi) {
       return (int)i;
@@ -94,6 +412,107 @@ static int webvulkan_find_wasm_entry_index(uint32_t keyLo, uint32_t keyHi) {
   return -1;
 }
 
+static int webvulkan_resolve_wasm_entry_index(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey,
+  uint32_t groupCountX,
+  uint32_t groupCountY,
+  uint32_t groupCountZ
+) {
+  const uint32_t any = WEBVULKAN_RUNTIME_ANY_GROUP_COUNT;
+  int index = -1;
+  if (groupCountX != any || groupCountY != any || groupCountZ != any) {
+    index = webvulkan_find_wasm_entry_index(keyLo, keyHi, specializationKey, groupCountX, groupCountY, groupCountZ);
+    if (index >= 0) {
+      ++g_runtime_wasm_grid_lookup_hit_count;
+    }
+  }
+  if (index < 0) {
+    index = webvulkan_find_wasm_entry_index(keyLo, keyHi, specializationKey, any, any, any);
+  }
+  /* No fallback to the unspecialized module: its constants are the compiled-in defaults. */
+  return index;
+}
+
+static uint32_t webvulkan_fnv1a_u32(uint32_t hash, uint32_t value) {
+  for (uint32_t i = 0u; i < 4u; ++i) {
+    hash ^= (value >> (i * 8u)) & 0xffu;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static int webvulkan_find_wasm_shared_module_index(uint32_t moduleId) {
+  for (uint32_t i = 0u; i < g_runtime_wasm_shared_module_count; ++i) {
+    if (g_runtime_wasm_shared_modules[i].moduleId == moduleId) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+static uint32_t webvulkan_instantiate_wasm_bytes(const uint8_t* bytes, uint32_t byteCount) {
+  const uint32_t instanceId = g_runtime_next_wasm_instance_id++;
+  if (webvulkan_runtime_js_instantiate_wasm(instanceId, bytes, byteCount) != 0) {
+    return 0u;
+  }
+  ++g_runtime_wasm_instantiation_count;
+  return instanceId;
+}
+
+static void webvulkan_release_wasm_entry_instance(WebVulkanRuntimeWasmEntry* entry) {
+  if (entry->bindingId != 0u) {
+    webvulkan_runtime_js_release_wasm_binding(entry->bindingId);
+    entry->bindingId = 0u;
+  }
+  if (entry->instanceId != 0u && entry->moduleId == WEBVULKAN_RUNTIME_NO_SHARED_WASM_MODULE) {
+    webvulkan_runtime_js_release_wasm(entry->instanceId);
+  }
+  entry->instanceId = 0u;
+}
+
+/* Returns -9 when the module does not instantiate and -8 when the kernel export does not bind. */
+static int webvulkan_instantiate_wasm_entry(WebVulkanRuntimeWasmEntry* entry) {
+  if (entry->bindingId != 0u) {
+    return 0;
+  }
+  if (!entry->bytes) {
+    return -9;
+  }
+  if (entry->instanceId == 0u) {
+    if (entry->moduleId != WEBVULKAN_RUNTIME_NO_SHARED_WASM_MODULE) {
+      int moduleIndex = webvulkan_find_wasm_shared_module_index(entry->moduleId);
+      if (moduleIndex < 0) {
+        return -9;
+      }
+      WebVulkanRuntimeWasmSharedModule* module = &g_runtime_wasm_shared_modules[(uint32_t)moduleIndex];
+      if (module->instanceId == 0u) {
+        module->instanceId = webvulkan_instantiate_wasm_bytes(module->bytes, module->byteCount);
+      }
+      entry->instanceId = module->instanceId;
+    } else {
+      entry->instanceId = webvulkan_instantiate_wasm_bytes(entry->bytes, entry->byteCount);
+    }
+    if (entry->instanceId == 0u) {
+      return -9;
+    }
+  }
+  const uint32_t bindingId = g_runtime_next_wasm_instance_id++;
+  if (webvulkan_runtime_js_bind_wasm_export(bindingId, entry->instanceId, entry->entrypoint) != 0) {
+    return -8;
+  }
+  entry->bindingId = bindingId;
+  return 0;
+}
+
+static void webvulkan_free_wasm_entry_bytes(WebVulkanRuntimeWasmEntry* entry) {
+  if (entry->bytes && entry->moduleId == WEBVULKAN_RUNTIME_NO_SHARED_WASM_MODULE) {
+    free(entry->bytes);
+  }
+  entry->bytes = 0;
+}
+
 static void webvulkan_remove_spirv_entry_at(uint32_t index) {
   if (index >= g_runtime_spirv_count) {
     return;
@@ -117,10 +536,8 @@ static void webvulkan_remove_wasm_entry_at(uint32_t index) {
     return;
   }
   WebVulkanRuntimeWasmEntry* entry = &g_runtime_wasm_entries[index];
-  if (entry->bytes) {
-    free(entry->bytes);
-    entry->bytes = 0;
-  }
+  webvulkan_release_wasm_entry_instance(entry);
+  webvulkan_free_wasm_entry_bytes(entry);
   for (uint32_t i = index + 1u; i < g_runtime_wasm_count; ++i) {
     g_runtime_wasm_entries[i - 1u] = g_runtime_wasm_entries[i];
   }
@@ -140,12 +557,20 @@ EMSCRIPTEN_KEEPALIVE void webvulkan_reset_runtime_shader_registry(void) {
   g_runtime_spirv_count = 0u;
 
   for (uint32_t i = 0u; i < g_runtime_wasm_count; ++i) {
-    if (g_runtime_wasm_entries[i].bytes) {
-      free(g_runtime_wasm_entries[i].bytes);
-      g_runtime_wasm_entries[i].bytes = 0;
-    }
+    webvulkan_release_wasm_entry_instance(&g_runtime_wasm_entries[i]);
+    webvulkan_free_wasm_entry_bytes(&g_runtime_wasm_entries[i]);
   }
   g_runtime_wasm_count = 0u;
+
+  for (uint32_t i = 0u; i < g_runtime_wasm_shared_module_count; ++i) {
+    WebVulkanRuntimeWasmSharedModule* module = &g_runtime_wasm_shared_modules[i];
+    if (module->instanceId != 0u) {
+      webvulkan_runtime_js_release_wasm(module->instanceId);
+    }
+    free(module->bytes);
+  }
+  memset(g_runtime_wasm_shared_modules, 0, sizeof(g_runtime_wasm_shared_modules));
+  g_runtime_wasm_shared_module_count = 0u;
   g_runtime_wasm_used = 0;
   webvulkan_copy_string(g_runtime_wasm_provider, WEBVULKAN_RUNTIME_PROVIDER_MAX, "none", "none");
   g_runtime_captured_shader_key_valid = 0;
@@ -180,6 +605,19 @@ EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_runtime_dispatch_mode(void) {
   return g_runtime_dispatch_mode;
 }
 
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_subgroup_size(uint32_t subgroupSize) {
+  if (subgroupSize == 0u || subgroupSize > WEBVULKAN_RUNTIME_MAX_SUBGROUP_SIZE ||
+      (subgroupSize & (subgroupSize - 1u)) != 0u) {
+    return -1;
+  }
+  g_runtime_subgroup_size = subgroupSize;
+  return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_runtime_subgroup_size(void) {
+  return g_runtime_subgroup_size;
+}
+
 EMSCRIPTEN_KEEPALIVE int webvulkan_runtime_set_dispatch_mode_fast_wasm(int enabled) {
   if (enabled) {
     return webvulkan_set_runtime_dispatch_mode(WEBVULKAN_RUNTIME_DISPATCH_MODE_FAST_WASM);
@@ -199,6 +637,424 @@ EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_runtime_get_registered_wasm_count(void)
   return g_runtime_wasm_count;
 }
 
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_runtime_get_registered_grid_wasm_count(void) {
+  uint32_t count = 0u;
+  for (uint32_t i = 0u; i < g_runtime_wasm_count; ++i) {
+    if (g_runtime_wasm_entries[i].groupCountX != WEBVULKAN_RUNTIME_ANY_GROUP_COUNT) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_runtime_get_registered_imported_memory_wasm_count(void) {
+  uint32_t count = 0u;
+  for (uint32_t i = 0u; i < g_runtime_wasm_count; ++i) {
+    if (g_runtime_wasm_entries[i].importsMemory) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+EMSCRIPTEN_KEEPALIVE int webvulkan_runtime_wasm_module_imports_memory(const uint8_t* bytes, uint32_t byteCount) {
+  int validateRc = webvulkan_validate_wasm_bytes(bytes, byteCount);
+  if (validateRc != 0) {
+    return validateRc;
+  }
+  int importsMemory = 0;
+  int hasDataSegments = 0;
+  if (webvulkan_scan_wasm_memory_layout(bytes, byteCount, &importsMemory, &hasDataSegments) != 0) {
+    return -2;
+  }
+  return importsMemory;
+}
+
+EMSCRIPTEN_KEEPALIVE int webvulkan_runtime_dispatch_wasm_instance(
+  uint32_t bindingId,
+  uint32_t dst,
+  uint32_t offset,
+  uint32_t value,
+  uint32_t workload,
+  uint32_t invocations,
+  uint32_t workgroups
+) {
+  if (bindingId == 0u) {
+    return -1;
+  }
+  webvulkan_runtime_trace_begin(WEBVULKAN_RUNTIME_TRACE_WASM_KERNEL, workgroups);
+  const int rc = webvulkan_runtime_js_dispatch_wasm(
+    bindingId,
+    dst,
+    offset,
+    value,
+    workload,
+    invocations,
+    workgroups
+  );
+  webvulkan_runtime_trace_end(WEBVULKAN_RUNTIME_TRACE_WASM_KERNEL);
+  if (rc == 0) {
+    ++g_runtime_wasm_instance_dispatch_count;
+  }
+  return rc;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_runtime_get_live_wasm_instance_count(void) {
+  uint32_t count = 0u;
+  for (uint32_t i = 0u; i < g_runtime_wasm_count; ++i) {
+    const WebVulkanRuntimeWasmEntry* entry = &g_runtime_wasm_entries[i];
+    if (entry->instanceId != 0u && entry->moduleId == WEBVULKAN_RUNTIME_NO_SHARED_WASM_MODULE) {
+      ++count;
+    }
+  }
+  for (uint32_t i = 0u; i < g_runtime_wasm_shared_module_count; ++i) {
+    if (g_runtime_wasm_shared_modules[i].instanceId != 0u) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_runtime_get_registered_shared_wasm_module_count(void) {
+  return g_runtime_wasm_shared_module_count;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_runtime_get_wasm_instantiation_count(void) {
+  return g_runtime_wasm_instantiation_count;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_runtime_get_wasm_instance_dispatch_count(void) {
+  return g_runtime_wasm_instance_dispatch_count;
+}
+
+static const WebVulkanRuntimeWasmEntry* webvulkan_find_wasm_kernel_entry(uint32_t keyLo, uint32_t keyHi) {
+  int index = webvulkan_find_wasm_entry_index(
+    keyLo,
+    keyHi,
+    WEBVULKAN_RUNTIME_NO_SPECIALIZATION_KEY,
+    WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+    WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+    WEBVULKAN_RUNTIME_ANY_GROUP_COUNT
+  );
+  return index >= 0 ? &g_runtime_wasm_entries[(uint32_t)index] : 0;
+}
+
+/* Binding and instance behind the unspecialized kernel of a key, or 0 when none is bound. */
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_runtime_get_wasm_kernel_binding(uint32_t keyLo, uint32_t keyHi) {
+  const WebVulkanRuntimeWasmEntry* entry = webvulkan_find_wasm_kernel_entry(keyLo, keyHi);
+  return entry ? entry->bindingId : 0u;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_runtime_get_wasm_kernel_instance(uint32_t keyLo, uint32_t keyHi) {
+  const WebVulkanRuntimeWasmEntry* entry = webvulkan_find_wasm_kernel_entry(keyLo, keyHi);
+  return entry ? entry->instanceId : 0u;
+}
+
+/* Lookups that resolved to a module registered for the exact dispatch grid. */
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_runtime_get_wasm_grid_lookup_hit_count(void) {
+  return g_runtime_wasm_grid_lookup_hit_count;
+}
+
+EMSCRIPTEN_KEEPALIVE void webvulkan_runtime_reset_wasm_instance_counters(void) {
+  g_runtime_wasm_instantiation_count = 0u;
+  g_runtime_wasm_instance_dispatch_count = 0u;
+  g_runtime_wasm_grid_lookup_hit_count = 0u;
+}
+
+/*
+ * Cumulative and last-call time per WEBVULKAN_RUNTIME_STAGE_*. Whoever drives the
+ * device records them: the smoke harness times its own calls, and a production host
+ * can do the same around its submits and readbacks. SPIR-V -> NIR and NIR -> LLVM
+ * are not split out; they fall inside the caller's PIPELINE_CREATE time. Registry
+ * lookups made at pipeline creation are timed here.
+ */
+EMSCRIPTEN_KEEPALIVE int webvulkan_runtime_get_stage_timings(WebVulkanRuntimeStageTimings* outTimings) {
+  if (!outTimings) {
+    return -1;
+  }
+  *outTimings = g_runtime_stage_timings;
+  return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE double webvulkan_runtime_get_stage_total_ms(uint32_t stage) {
+  if (stage >= WEBVULKAN_RUNTIME_STAGE_COUNT) {
+    return -1.0;
+  }
+  return g_runtime_stage_timings.stages[stage].totalMs;
+}
+
+EMSCRIPTEN_KEEPALIVE double webvulkan_runtime_get_stage_last_ms(uint32_t stage) {
+  if (stage >= WEBVULKAN_RUNTIME_STAGE_COUNT) {
+    return -1.0;
+  }
+  return g_runtime_stage_timings.stages[stage].lastMs;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_runtime_get_stage_count(uint32_t stage) {
+  if (stage >= WEBVULKAN_RUNTIME_STAGE_COUNT) {
+    return 0u;
+  }
+  return g_runtime_stage_timings.stages[stage].count;
+}
+
+EMSCRIPTEN_KEEPALIVE void webvulkan_runtime_reset_stage_timings(void) {
+  for (uint32_t stage = 0u; stage < WEBVULKAN_RUNTIME_STAGE_COUNT; ++stage) {
+    g_runtime_stage_timings.stages[stage].totalMs = 0.0;
+    g_runtime_stage_timings.stages[stage].lastMs = -1.0;
+    g_runtime_stage_timings.stages[stage].count = 0u;
+  }
+}
+
+EMSCRIPTEN_KEEPALIVE void webvulkan_runtime_record_stage_timing(uint32_t stage, double ms) {
+  if (stage >= WEBVULKAN_RUNTIME_STAGE_COUNT || ms < 0.0) {
+    return;
+  }
+  WebVulkanRuntimeStageTiming* timing = &g_runtime_stage_timings.stages[stage];
+  timing->totalMs += ms;
+  timing->lastMs = ms;
+  ++timing->count;
+}
+
+/* Heap bytes the registry itself holds: shader payload copies, push-constant chunks and the trace ring. */
+static uint32_t webvulkan_runtime_registry_payload_bytes(void) {
+  size_t bytes = 0u;
+  for (uint32_t i = 0u; i < g_runtime_spirv_count; ++i) {
+    if (g_runtime_spirv_entries[i].bytes) {
+      bytes += g_runtime_spirv_entries[i].byteCount;
+    }
+  }
+  for (uint32_t i = 0u; i < g_runtime_wasm_count; ++i) {
+    const WebVulkanRuntimeWasmEntry* entry = &g_runtime_wasm_entries[i];
+    if (entry->bytes && entry->moduleId == WEBVULKAN_RUNTIME_NO_SHARED_WASM_MODULE) {
+      bytes += entry->byteCount;
+    }
+  }
+  for (uint32_t i = 0u; i < g_runtime_wasm_shared_module_count; ++i) {
+    if (g_runtime_wasm_shared_modules[i].bytes) {
+      bytes += g_runtime_wasm_shared_modules[i].byteCount;
+    }
+  }
+  if (g_runtime_trace_events) {
+    bytes += sizeof(WebVulkanRuntimeTraceEvent) * (size_t)g_runtime_trace_capacity;
+  }
+  return (uint32_t)bytes;
+}
+
+/*
+ * Snapshot of where linear memory goes. The malloc figures come from mallinfo(), which
+ * walks the heap, so this is meant for sampling between frames or cycles, not per
+ * dispatch. Compiled kernel modules and instances live on the JS heap and are not
+ * counted here.
+ */
+EMSCRIPTEN_KEEPALIVE int webvulkan_runtime_get_memory_footprint(WebVulkanRuntimeMemoryFootprint* outFootprint) {
+  if (!outFootprint) {
+    return -1;
+  }
+  const struct mallinfo heapInfo = mallinfo();
+  uint32_t* values = outFootprint->values;
+  values[WEBVULKAN_RUNTIME_MEMORY_LINEAR_BYTES] = (uint32_t)emscripten_get_heap_size();
+  values[WEBVULKAN_RUNTIME_MEMORY_MALLOC_IN_USE_BYTES] = (uint32_t)heapInfo.uordblks;
+  values[WEBVULKAN_RUNTIME_MEMORY_MALLOC_FOOTPRINT_BYTES] = (uint32_t)heapInfo.arena;
+  values[WEBVULKAN_RUNTIME_MEMORY_PEAK_MALLOC_FOOTPRINT_BYTES] = (uint32_t)heapInfo.usmblks;
+  values[WEBVULKAN_RUNTIME_MEMORY_REGISTRY_PAYLOAD_BYTES] = webvulkan_runtime_registry_payload_bytes();
+  values[WEBVULKAN_RUNTIME_MEMORY_DEVICE_MEMORY_BYTES] = g_runtime_device_memory_bytes;
+  values[WEBVULKAN_RUNTIME_MEMORY_PEAK_DEVICE_MEMORY_BYTES] = g_runtime_peak_device_memory_bytes;
+  values[WEBVULKAN_RUNTIME_MEMORY_DEVICE_MEMORY_ALLOCATIONS] = g_runtime_device_memory_allocations;
+  values[WEBVULKAN_RUNTIME_MEMORY_PIPELINE_HEAP_DELTA_BYTES] = g_runtime_pipeline_heap_delta_bytes;
+  values[WEBVULKAN_RUNTIME_MEMORY_LAST_PIPELINE_HEAP_DELTA_BYTES] = g_runtime_last_pipeline_heap_delta_bytes;
+  values[WEBVULKAN_RUNTIME_MEMORY_LIVE_PIPELINES] = g_runtime_live_pipelines;
+  return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_runtime_get_memory_footprint_value(uint32_t field) {
+  if (field >= WEBVULKAN_RUNTIME_MEMORY_COUNT) {
+    return 0u;
+  }
+  WebVulkanRuntimeMemoryFootprint footprint;
+  webvulkan_runtime_get_memory_footprint(&footprint);
+  return footprint.values[field];
+}
+
+/* Hosts call this from their vkAllocateMemory / vkFreeMemory paths with the allocation size. */
+EMSCRIPTEN_KEEPALIVE void webvulkan_runtime_record_device_memory(uint32_t bytes, int allocated) {
+  if (allocated) {
+    g_runtime_device_memory_bytes += bytes;
+    ++g_runtime_device_memory_allocations;
+    if (g_runtime_device_memory_bytes > g_runtime_peak_device_memory_bytes) {
+      g_runtime_peak_device_memory_bytes = g_runtime_device_memory_bytes;
+    }
+    return;
+  }
+  g_runtime_device_memory_bytes -= bytes < g_runtime_device_memory_bytes ? bytes : g_runtime_device_memory_bytes;
+  if (g_runtime_device_memory_allocations > 0u) {
+    --g_runtime_device_memory_allocations;
+  }
+}
+
+/*
+ * dlmalloc in-use growth the host measured across one pipeline's creation. It
+ * covers everything allocated in that window, not only the pipeline's NIR, LLVM
+ * IR and JIT code. The host reports the same byte count on creation and destruction.
+ */
+EMSCRIPTEN_KEEPALIVE void webvulkan_runtime_record_pipeline_heap_delta(uint32_t bytes, int created) {
+  if (created) {
+    g_runtime_pipeline_heap_delta_bytes += bytes;
+    g_runtime_last_pipeline_heap_delta_bytes = bytes;
+    ++g_runtime_live_pipelines;
+    return;
+  }
+  g_runtime_pipeline_heap_delta_bytes -= bytes < g_runtime_pipeline_heap_delta_bytes ? bytes : g_runtime_pipeline_heap_delta_bytes;
+  if (g_runtime_live_pipelines > 0u) {
+    --g_runtime_live_pipelines;
+  }
+}
+
+/*
+ * Opt-in trace of WEBVULKAN_RUNTIME_TRACE_* spans. capacity is a power of two up to
+ * WEBVULKAN_RUNTIME_TRACE_MAX_EVENTS; 0 turns tracing off and frees the ring. Writers
+ * claim a slot with one atomic add and overwrite the oldest events once the ring
+ * wraps. Enabling or resetting must not race with writers.
+ */
+EMSCRIPTEN_KEEPALIVE int webvulkan_runtime_trace_enable(uint32_t capacity) {
+  if (capacity > WEBVULKAN_RUNTIME_TRACE_MAX_EVENTS || (capacity & (capacity - 1u)) != 0u) {
+    return -1;
+  }
+  WebVulkanRuntimeTraceEvent* events = NULL;
+  if (capacity != 0u) {
+    events = (WebVulkanRuntimeTraceEvent*)calloc(capacity, sizeof(WebVulkanRuntimeTraceEvent));
+    if (!events) {
+      return -1;
+    }
+  }
+  WebVulkanRuntimeTraceEvent* previous = g_runtime_trace_events;
+  __atomic_store_n(&g_runtime_trace_events, NULL, __ATOMIC_RELEASE);
+  g_runtime_trace_capacity = capacity;
+  __atomic_store_n(&g_runtime_trace_head, 0u, __ATOMIC_RELAXED);
+  __atomic_store_n(&g_runtime_trace_events, events, __ATOMIC_RELEASE);
+  free(previous);
+  free(g_runtime_trace_json);
+  g_runtime_trace_json = NULL;
+  return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int webvulkan_runtime_trace_enabled(void) {
+  return __atomic_load_n(&g_runtime_trace_events, __ATOMIC_RELAXED) != NULL ? 1 : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE void webvulkan_runtime_trace_reset(void) {
+  if (g_runtime_trace_events) {
+    memset(g_runtime_trace_events, 0, sizeof(WebVulkanRuntimeTraceEvent) * (size_t)g_runtime_trace_capacity);
+  }
+  __atomic_store_n(&g_runtime_trace_head, 0u, __ATOMIC_RELEASE);
+}
+
+static void webvulkan_runtime_trace_record(uint32_t event, char phase, uint32_t arg) {
+  WebVulkanRuntimeTraceEvent* events = __atomic_load_n(&g_runtime_trace_events, __ATOMIC_ACQUIRE);
+  if (!events || event >= WEBVULKAN_RUNTIME_TRACE_EVENT_COUNT) {
+    return;
+  }
+  const uint64_t index = __atomic_fetch_add(&g_runtime_trace_head, 1u, __ATOMIC_RELAXED);
+  WebVulkanRuntimeTraceEvent* slot = &events[index & (uint64_t)(g_runtime_trace_capacity - 1u)];
+  __atomic_store_n(&slot->sequence, 0u, __ATOMIC_RELAXED);
+  slot->timestampMs = emscripten_get_now();
+  slot->event = event;
+  slot->arg = arg;
+  slot->thread = (uint32_t)(uintptr_t)pthread_self();
+  slot->phase = phase;
+  __atomic_store_n(&slot->sequence, index + 1u, __ATOMIC_RELEASE);
+}
+
+EMSCRIPTEN_KEEPALIVE void webvulkan_runtime_trace_begin(uint32_t event, uint32_t arg) {
+  webvulkan_runtime_trace_record(event, 'B', arg);
+}
+
+EMSCRIPTEN_KEEPALIVE void webvulkan_runtime_trace_end(uint32_t event) {
+  webvulkan_runtime_trace_record(event, 'E', 0u);
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_runtime_trace_get_event_count(void) {
+  const uint64_t head = __atomic_load_n(&g_runtime_trace_head, __ATOMIC_ACQUIRE);
+  return head < g_runtime_trace_capacity ? (uint32_t)head : g_runtime_trace_capacity;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_runtime_trace_get_dropped_count(void) {
+  const uint64_t head = __atomic_load_n(&g_runtime_trace_head, __ATOMIC_ACQUIRE);
+  const uint64_t dropped = head > g_runtime_trace_capacity ? head - g_runtime_trace_capacity : 0u;
+  return dropped < UINT32_MAX ? (uint32_t)dropped : UINT32_MAX;
+}
+
+/*
+ * Chrome trace-event JSON (loads in chrome://tracing and ui.perfetto.dev) for the
+ * events still in the ring, oldest first, with ts in microseconds. End events whose
+ * begin was overwritten are skipped. The string stays valid until the next export,
+ * enable or reset of the trace.
+ */
+EMSCRIPTEN_KEEPALIVE const char* webvulkan_runtime_trace_export_json(void) {
+  free(g_runtime_trace_json);
+  g_runtime_trace_json = NULL;
+  const uint64_t head = __atomic_load_n(&g_runtime_trace_head, __ATOMIC_ACQUIRE);
+  const uint32_t capacity = g_runtime_trace_capacity;
+  const uint64_t first = head > capacity ? head - capacity : 0u;
+  const size_t byteCount = (size_t)(head - first) * WEBVULKAN_RUNTIME_TRACE_JSON_EVENT_BYTES + 256u;
+  char* json = (char*)malloc(byteCount);
+  if (!json) {
+    return NULL;
+  }
+  uint32_t openSpans[WEBVULKAN_RUNTIME_TRACE_EVENT_COUNT];
+  memset(openSpans, 0, sizeof(openSpans));
+  size_t used = (size_t)snprintf(
+    json,
+    byteCount,
+    "{\"displayTimeUnit\":\"ms\",\"traceEvents\":["
+    "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"webvulkan\"}}"
+  );
+  for (uint64_t index = first; index != head && g_runtime_trace_events; ++index) {
+    const WebVulkanRuntimeTraceEvent* slot = &g_runtime_trace_events[index & (uint64_t)(capacity - 1u)];
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != index + 1u) {
+      continue;
+    }
+    const WebVulkanRuntimeTraceEvent event = *slot;
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != index + 1u) {
+      continue;
+    }
+    if (event.phase == 'E') {
+      if (openSpans[event.event] == 0u) {
+        continue;
+      }
+      --openSpans[event.event];
+    } else {
+      ++openSpans[event.event];
+    }
+    used += (size_t)snprintf(
+      json + used,
+      byteCount - used,
+      ",{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u",
+      g_runtime_trace_event_names[event.event],
+      g_runtime_trace_event_categories[event.event],
+      event.phase,
+      event.timestampMs * 1000.0,
+      event.thread
+    );
+    if (event.phase == 'B') {
+      used += (size_t)snprintf(json + used, byteCount - used, ",\"args\":{\"arg\":%u}", event.arg);
+    }
+    json[used++] = '}';
+  }
+  snprintf(json + used, byteCount - used, "],\"otherData\":{\"dropped\":%llu}}", (unsigned long long)first);
+  g_runtime_trace_json = json;
+  return json;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_runtime_get_registered_specialized_wasm_count(void) {
+  uint32_t count = 0u;
+  for (uint32_t i = 0u; i < g_runtime_wasm_count; ++i) {
+    if (g_runtime_wasm_entries[i].specializationKey != WEBVULKAN_RUNTIME_NO_SPECIALIZATION_KEY) {
+      ++count;
+    }
+  }
+  return count;
+}
+
 EMSCRIPTEN_KEEPALIVE int webvulkan_runtime_unregister_shader_bundle(uint32_t keyLo, uint32_t keyHi) {
   int removed = 0;
   int spirvIndex = webvulkan_find_spirv_entry_index(keyLo, keyHi);
@@ -206,10 +1062,11 @@ EMSCRIPTEN_KEEPALIVE int webvulkan_runtime_unregister_shader_bundle(uint32_t key
     webvulkan_remove_spirv_entry_at((uint32_t)spirvIndex);
     removed = 1;
   }
-  int wasmIndex = webvulkan_find_wasm_entry_index(keyLo, keyHi);
-  if (wasmIndex >= 0) {
+  int wasmIndex = webvulkan_find_any_wasm_entry_index(keyLo, keyHi);
+  while (wasmIndex >= 0) {
     webvulkan_remove_wasm_entry_at((uint32_t)wasmIndex);
     removed = 1;
+    wasmIndex = webvulkan_find_any_wasm_entry_index(keyLo, keyHi);
   }
   return removed ? 0 : -1;
 }
@@ -250,6 +1107,117 @@ EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_runtime_get_captured_shader_key_hi(void)
   return g_runtime_captured_shader_key_hi;
 }
 
+EMSCRIPTEN_KEEPALIVE int webvulkan_runtime_intern_specialization(
+  const WebVulkanRuntimeSpecializationEntry* entries,
+  uint32_t entryCount,
+  const uint8_t* data,
+  uint32_t dataSize,
+  uint32_t* outSpecializationKey
+) {
+  if (!outSpecializationKey) {
+    return -1;
+  }
+  *outSpecializationKey = WEBVULKAN_RUNTIME_NO_SPECIALIZATION_KEY;
+  if (entryCount == 0u) {
+    return 0;
+  }
+  if (!entries || !data || entryCount > WEBVULKAN_RUNTIME_MAX_SPECIALIZATION_CONSTANTS) {
+    return -1;
+  }
+
+  /* Canonical order is by constant id, so the order of the map entries does not matter. */
+  uint32_t order[WEBVULKAN_RUNTIME_MAX_SPECIALIZATION_CONSTANTS];
+  for (uint32_t i = 0u; i < entryCount; ++i) {
+    const WebVulkanRuntimeSpecializationEntry* entry = &entries[i];
+    if (entry->size == 0u || entry->offset > dataSize || entry->size > dataSize - entry->offset) {
+      return -2;
+    }
+    uint32_t slot = i;
+    while (slot > 0u && entries[order[slot - 1u]].constantId > entry->constantId) {
+      order[slot] = order[slot - 1u];
+      --slot;
+    }
+    if (slot > 0u && entries[order[slot - 1u]].constantId == entry->constantId) {
+      return -2;
+    }
+    order[slot] = i;
+  }
+
+  WebVulkanRuntimeSpecialization candidate;
+  memset(&candidate, 0, sizeof(candidate));
+  candidate.constantCount = entryCount;
+  for (uint32_t i = 0u; i < entryCount; ++i) {
+    const WebVulkanRuntimeSpecializationEntry* entry = &entries[order[i]];
+    if (entry->size > WEBVULKAN_RUNTIME_MAX_SPECIALIZATION_BYTES - candidate.dataSize) {
+      return -3;
+    }
+    candidate.constantIds[i] = entry->constantId;
+    candidate.constantSizes[i] = entry->size;
+    memcpy(candidate.data + candidate.dataSize, data + entry->offset, entry->size);
+    candidate.dataSize += entry->size;
+  }
+
+  uint32_t hash = 2166136261u;
+  hash = webvulkan_fnv1a_u32(hash, candidate.constantCount);
+  for (uint32_t i = 0u; i < candidate.constantCount; ++i) {
+    hash = webvulkan_fnv1a_u32(hash, candidate.constantIds[i]);
+    hash = webvulkan_fnv1a_u32(hash, candidate.constantSizes[i]);
+  }
+  for (uint32_t byte = 0u; byte < candidate.dataSize; ++byte) {
+    hash ^= candidate.data[byte];
+    hash *= 16777619u;
+  }
+  candidate.hash = hash;
+
+  for (uint32_t i = 0u; i < g_runtime_specialization_count; ++i) {
+    const WebVulkanRuntimeSpecialization* interned = &g_runtime_specializations[i];
+    if (interned->hash == candidate.hash && memcmp(interned, &candidate, sizeof(candidate)) == 0) {
+      *outSpecializationKey = i + 1u;
+      return 0;
+    }
+  }
+  if (g_runtime_specialization_count >= WEBVULKAN_RUNTIME_MAX_SPECIALIZATIONS) {
+    return -4;
+  }
+  g_runtime_specializations[g_runtime_specialization_count++] = candidate;
+  *outSpecializationKey = g_runtime_specialization_count;
+  return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int webvulkan_runtime_set_shader_specialization(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey
+) {
+  if (specializationKey > g_runtime_specialization_count) {
+    return -2;
+  }
+  int index = webvulkan_find_spirv_entry_index(keyLo, keyHi);
+  if (index < 0) {
+    return -1;
+  }
+  g_runtime_spirv_entries[(uint32_t)index].specializationKey = specializationKey;
+  return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int webvulkan_runtime_set_shader_dispatch_grid(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t groupCountX,
+  uint32_t groupCountY,
+  uint32_t groupCountZ
+) {
+  int index = webvulkan_find_spirv_entry_index(keyLo, keyHi);
+  if (index < 0) {
+    return -1;
+  }
+  WebVulkanRuntimeSpirvEntry* entry = &g_runtime_spirv_entries[(uint32_t)index];
+  entry->groupCountX = groupCountX;
+  entry->groupCountY = groupCountY;
+  entry->groupCountZ = groupCountZ;
+  return 0;
+}
+
 EMSCRIPTEN_KEEPALIVE int webvulkan_register_runtime_shader_spirv(
   uint32_t keyLo,
   uint32_t keyHi,
@@ -288,6 +1256,10 @@ EMSCRIPTEN_KEEPALIVE int webvulkan_register_runtime_shader_spirv(
   entry->bytes = copy;
   entry->byteCount = byteCount;
   entry->expectedDispatchValue = keyLo;
+  entry->specializationKey = WEBVULKAN_RUNTIME_NO_SPECIALIZATION_KEY;
+  entry->groupCountX = WEBVULKAN_RUNTIME_ANY_GROUP_COUNT;
+  entry->groupCountY = WEBVULKAN_RUNTIME_ANY_GROUP_COUNT;
+  entry->groupCountZ = WEBVULKAN_RUNTIME_ANY_GROUP_COUNT;
   webvulkan_copy_string(entry->entrypoint, WEBVULKAN_RUNTIME_ENTRYPOINT_MAX, entrypoint, "write_const");
   return 0;
 }
@@ -300,10 +1272,143 @@ EMSCRIPTEN_KEEPALIVE int webvulkan_register_runtime_wasm_module(
   const char* entrypoint,
   const char* provider
 ) {
+  return webvulkan_register_runtime_wasm_module_specialized(
+    keyLo,
+    keyHi,
+    WEBVULKAN_RUNTIME_NO_SPECIALIZATION_KEY,
+    bytes,
+    byteCount,
+    entrypoint,
+    provider
+  );
+}
+
+EMSCRIPTEN_KEEPALIVE int webvulkan_register_runtime_wasm_module_specialized(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey,
+  const uint8_t* bytes,
+  uint32_t byteCount,
+  const char* entrypoint,
+  const char* provider
+) {
+  return webvulkan_register_runtime_wasm_module_for_grid(
+    keyLo,
+    keyHi,
+    specializationKey,
+    WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+    WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+    WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+    bytes,
+    byteCount,
+    entrypoint,
+    provider
+  );
+}
+
+static int webvulkan_validate_group_counts(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
+  const int anyGroupCount = groupCountX == WEBVULKAN_RUNTIME_ANY_GROUP_COUNT &&
+                            groupCountY == WEBVULKAN_RUNTIME_ANY_GROUP_COUNT &&
+                            groupCountZ == WEBVULKAN_RUNTIME_ANY_GROUP_COUNT;
+  if (!anyGroupCount && (groupCountX == 0u || groupCountY == 0u || groupCountZ == 0u)) {
+    return -5;
+  }
+  return 0;
+}
+
+static int webvulkan_validate_wasm_module_layout(const uint8_t* bytes, uint32_t byteCount, int* outImportsMemory) {
   int validateRc = webvulkan_validate_wasm_bytes(bytes, byteCount);
   if (validateRc != 0) {
     return validateRc;
   }
+  int hasDataSegments = 0;
+  if (webvulkan_scan_wasm_memory_layout(bytes, byteCount, outImportsMemory, &hasDataSegments) != 0) {
+    return -2;
+  }
+  if (*outImportsMemory && hasDataSegments) {
+    return -6;
+  }
+  return 0;
+}
+
+static int webvulkan_store_wasm_entry(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey,
+  uint32_t groupCountX,
+  uint32_t groupCountY,
+  uint32_t groupCountZ,
+  uint8_t* bytes,
+  uint32_t byteCount,
+  int importsMemory,
+  uint32_t moduleId,
+  const char* entrypoint,
+  const char* provider
+) {
+  int existingIndex =
+    webvulkan_find_wasm_entry_index(keyLo, keyHi, specializationKey, groupCountX, groupCountY, groupCountZ);
+  if (existingIndex < 0 && g_runtime_wasm_count >= WEBVULKAN_RUNTIME_MAX_MODULES) {
+    if (moduleId == WEBVULKAN_RUNTIME_NO_SHARED_WASM_MODULE) {
+      free(bytes);
+    }
+    return -4;
+  }
+
+  /* Bind the replacement before touching the old entry, so a failed re-registration keeps it. */
+  WebVulkanRuntimeWasmEntry candidate;
+  memset(&candidate, 0, sizeof(candidate));
+  candidate.keyLo = keyLo;
+  candidate.keyHi = keyHi;
+  candidate.specializationKey = specializationKey;
+  candidate.groupCountX = groupCountX;
+  candidate.groupCountY = groupCountY;
+  candidate.groupCountZ = groupCountZ;
+  candidate.bytes = bytes;
+  candidate.byteCount = byteCount;
+  candidate.importsMemory = importsMemory;
+  candidate.moduleId = moduleId;
+  webvulkan_copy_string(candidate.entrypoint, WEBVULKAN_RUNTIME_ENTRYPOINT_MAX, entrypoint, "run");
+  webvulkan_copy_string(candidate.provider, WEBVULKAN_RUNTIME_PROVIDER_MAX, provider, "runtime-registry");
+  const int instantiateRc = webvulkan_instantiate_wasm_entry(&candidate);
+  if (instantiateRc != 0) {
+    webvulkan_release_wasm_entry_instance(&candidate);
+    webvulkan_free_wasm_entry_bytes(&candidate);
+    return instantiateRc;
+  }
+
+  WebVulkanRuntimeWasmEntry* entry = 0;
+  if (existingIndex >= 0) {
+    entry = &g_runtime_wasm_entries[(uint32_t)existingIndex];
+    webvulkan_release_wasm_entry_instance(entry);
+    webvulkan_free_wasm_entry_bytes(entry);
+  } else {
+    entry = &g_runtime_wasm_entries[g_runtime_wasm_count++];
+  }
+  *entry = candidate;
+  return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int webvulkan_register_runtime_wasm_module_for_grid(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey,
+  uint32_t groupCountX,
+  uint32_t groupCountY,
+  uint32_t groupCountZ,
+  const uint8_t* bytes,
+  uint32_t byteCount,
+  const char* entrypoint,
+  const char* provider
+) {
+  int gridRc = webvulkan_validate_group_counts(groupCountX, groupCountY, groupCountZ);
+  if (gridRc != 0) {
+    return gridRc;
+  }
+  int importsMemory = 0;
+  int layoutRc = webvulkan_validate_wasm_module_layout(bytes, byteCount, &importsMemory);
+  if (layoutRc != 0) {
+    return layoutRc;
+  }
 
   uint8_t* copy = (uint8_t*)malloc(byteCount);
   if (!copy) {
@@ -311,30 +1416,176 @@ EMSCRIPTEN_KEEPALIVE int webvulkan_register_runtime_wasm_module(
   }
   memcpy(copy, bytes, byteCount);
 
-  int existingIndex = webvulkan_find_wasm_entry_index(keyLo, keyHi);
-  WebVulkanRuntimeWasmEntry* entry = 0;
+  return webvulkan_store_wasm_entry(
+    keyLo,
+    keyHi,
+    specializationKey,
+    groupCountX,
+    groupCountY,
+    groupCountZ,
+    copy,
+    byteCount,
+    importsMemory,
+    WEBVULKAN_RUNTIME_NO_SHARED_WASM_MODULE,
+    entrypoint,
+    provider
+  );
+}
+
+EMSCRIPTEN_KEEPALIVE int webvulkan_register_runtime_wasm_shared_module(
+  uint32_t moduleId,
+  const uint8_t* bytes,
+  uint32_t byteCount,
+  const char* provider
+) {
+  if (moduleId == WEBVULKAN_RUNTIME_NO_SHARED_WASM_MODULE) {
+    return -7;
+  }
+  int importsMemory = 0;
+  int layoutRc = webvulkan_validate_wasm_module_layout(bytes, byteCount, &importsMemory);
+  if (layoutRc != 0) {
+    return layoutRc;
+  }
+  int existingIndex = webvulkan_find_wasm_shared_module_index(moduleId);
+  if (existingIndex < 0 && g_runtime_wasm_shared_module_count >= WEBVULKAN_RUNTIME_MAX_MODULES) {
+    return -4;
+  }
+
+  uint8_t* copy = (uint8_t*)malloc(byteCount);
+  if (!copy) {
+    return -3;
+  }
+  memcpy(copy, bytes, byteCount);
+
+  const uint32_t instanceId = webvulkan_instantiate_wasm_bytes(copy, byteCount);
+  if (instanceId == 0u) {
+    free(copy);
+    return -9;
+  }
+
+  /*
+   * Kernels registered against an older build of this module rebind to the new instance.
+   * Every rebind must succeed before the old instance goes away; otherwise all of them
+   * keep their old binding and the registration fails.
+   */
+  uint32_t reboundIds[WEBVULKAN_RUNTIME_MAX_MODULES];
+  memset(reboundIds, 0, sizeof(reboundIds));
+  for (uint32_t i = 0u; i < g_runtime_wasm_count; ++i) {
+    const WebVulkanRuntimeWasmEntry* entry = &g_runtime_wasm_entries[i];
+    if (entry->moduleId != moduleId) {
+      continue;
+    }
+    const uint32_t bindingId = g_runtime_next_wasm_instance_id++;
+    if (webvulkan_runtime_js_bind_wasm_export(bindingId, instanceId, entry->entrypoint) != 0) {
+      for (uint32_t j = 0u; j < i; ++j) {
+        if (reboundIds[j] != 0u) {
+          webvulkan_runtime_js_release_wasm_binding(reboundIds[j]);
+        }
+      }
+      webvulkan_runtime_js_release_wasm(instanceId);
+      free(copy);
+      return -8;
+    }
+    reboundIds[i] = bindingId;
+  }
+
+  WebVulkanRuntimeWasmSharedModule* module = 0;
   if (existingIndex >= 0) {
-    entry = &g_runtime_wasm_entries[(uint32_t)existingIndex];
-    if (entry->bytes) {
-      free(entry->bytes);
+    module = &g_runtime_wasm_shared_modules[(uint32_t)existingIndex];
+    for (uint32_t i = 0u; i < g_runtime_wasm_count; ++i) {
+      if (g_runtime_wasm_entries[i].moduleId == moduleId) {
+        webvulkan_release_wasm_entry_instance(&g_runtime_wasm_entries[i]);
+      }
+    }
+    if (module->instanceId != 0u) {
+      webvulkan_runtime_js_release_wasm(module->instanceId);
     }
+    free(module->bytes);
   } else {
-    if (g_runtime_wasm_count >= WEBVULKAN_RUNTIME_MAX_MODULES) {
-      free(copy);
-      return -4;
+    module = &g_runtime_wasm_shared_modules[g_runtime_wasm_shared_module_count++];
+  }
+  module->moduleId = moduleId;
+  module->bytes = copy;
+  module->byteCount = byteCount;
+  module->importsMemory = importsMemory;
+  module->instanceId = instanceId;
+  webvulkan_copy_string(module->provider, WEBVULKAN_RUNTIME_PROVIDER_MAX, provider, "runtime-registry");
+
+  for (uint32_t i = 0u; i < g_runtime_wasm_count; ++i) {
+    WebVulkanRuntimeWasmEntry* entry = &g_runtime_wasm_entries[i];
+    if (entry->moduleId == moduleId) {
+      entry->bytes = module->bytes;
+      entry->byteCount = module->byteCount;
+      entry->importsMemory = module->importsMemory;
+      entry->instanceId = instanceId;
+      entry->bindingId = reboundIds[i];
     }
-    entry = &g_runtime_wasm_entries[g_runtime_wasm_count++];
   }
+  return 0;
+}
 
-  entry->keyLo = keyLo;
-  entry->keyHi = keyHi;
-  entry->bytes = copy;
-  entry->byteCount = byteCount;
-  webvulkan_copy_string(entry->entrypoint, WEBVULKAN_RUNTIME_ENTRYPOINT_MAX, entrypoint, "run");
-  webvulkan_copy_string(entry->provider, WEBVULKAN_RUNTIME_PROVIDER_MAX, provider, "runtime-registry");
+EMSCRIPTEN_KEEPALIVE int webvulkan_unregister_runtime_wasm_shared_module(uint32_t moduleId) {
+  int moduleIndex = webvulkan_find_wasm_shared_module_index(moduleId);
+  if (moduleIndex < 0) {
+    return -1;
+  }
+  for (uint32_t i = g_runtime_wasm_count; i > 0u; --i) {
+    if (g_runtime_wasm_entries[i - 1u].moduleId == moduleId) {
+      webvulkan_remove_wasm_entry_at(i - 1u);
+    }
+  }
+  WebVulkanRuntimeWasmSharedModule* module = &g_runtime_wasm_shared_modules[(uint32_t)moduleIndex];
+  if (module->instanceId != 0u) {
+    webvulkan_runtime_js_release_wasm(module->instanceId);
+  }
+  free(module->bytes);
+  for (uint32_t i = (uint32_t)moduleIndex + 1u; i < g_runtime_wasm_shared_module_count; ++i) {
+    g_runtime_wasm_shared_modules[i - 1u] = g_runtime_wasm_shared_modules[i];
+  }
+  --g_runtime_wasm_shared_module_count;
+  memset(&g_runtime_wasm_shared_modules[g_runtime_wasm_shared_module_count], 0, sizeof(g_runtime_wasm_shared_modules[0]));
   return 0;
 }
 
+EMSCRIPTEN_KEEPALIVE int webvulkan_register_runtime_wasm_kernel(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey,
+  uint32_t groupCountX,
+  uint32_t groupCountY,
+  uint32_t groupCountZ,
+  uint32_t moduleId,
+  const char* exportName
+) {
+  int gridRc = webvulkan_validate_group_counts(groupCountX, groupCountY, groupCountZ);
+  if (gridRc != 0) {
+    return gridRc;
+  }
+  if (!exportName || !exportName[0]) {
+    return -1;
+  }
+  int moduleIndex = webvulkan_find_wasm_shared_module_index(moduleId);
+  if (moduleIndex < 0) {
+    return -7;
+  }
+  WebVulkanRuntimeWasmSharedModule* module = &g_runtime_wasm_shared_modules[(uint32_t)moduleIndex];
+  int storeRc = webvulkan_store_wasm_entry(
+    keyLo,
+    keyHi,
+    specializationKey,
+    groupCountX,
+    groupCountY,
+    groupCountZ,
+    module->bytes,
+    module->byteCount,
+    module->importsMemory,
+    moduleId,
+    exportName,
+    module->provider
+  );
+  return storeRc;
+}
+
 EMSCRIPTEN_KEEPALIVE int webvulkan_runtime_register_shader_bundle(const WebVulkanRuntimeShaderBundle* bundle) {
   if (!bundle) {
     return -10;
@@ -360,6 +1611,19 @@ EMSCRIPTEN_KEEPALIVE int webvulkan_runtime_register_shader_bundle(const WebVulka
   }
   (void)webvulkan_set_runtime_expected_dispatch_value(bundle->keyLo, bundle->keyHi, expectedDispatchValue);
 
+  if ((bundle->flags & WEBVULKAN_RUNTIME_SHADER_BUNDLE_HAS_SHARED_WASM_MODULE) != 0u) {
+    return webvulkan_register_runtime_wasm_kernel(
+      bundle->keyLo,
+      bundle->keyHi,
+      WEBVULKAN_RUNTIME_NO_SPECIALIZATION_KEY,
+      WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+      WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+      WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+      bundle->wasmModuleId,
+      bundle->wasmEntrypoint
+    );
+  }
+
   int hasWasm = (bundle->flags & WEBVULKAN_RUNTIME_SHADER_BUNDLE_HAS_WASM) != 0u;
   if (!hasWasm && bundle->wasmBytes && bundle->wasmByteCount > 0u) {
     hasWasm = 1;
@@ -486,11 +1750,79 @@ bool webvulkan_runtime_lookup_wasm_module(
   uint32_t* outModuleSize,
   const char** outEntrypoint,
   const char** outProvider
+) {
+  /*
+   * The driver passes neither the pipeline's constants nor its grid; use the ones
+   * stated for this key. A grid miss still finds the grid-generic module.
+   */
+  const double startMs = emscripten_get_now();
+  const int spirvIndex = webvulkan_find_spirv_entry_index(keyLo, keyHi);
+  const WebVulkanRuntimeSpirvEntry* spirv = spirvIndex >= 0 ? &g_runtime_spirv_entries[(uint32_t)spirvIndex] : NULL;
+  const bool found = webvulkan_runtime_lookup_wasm_module_for_dispatch(
+    keyLo,
+    keyHi,
+    spirv ? spirv->specializationKey : WEBVULKAN_RUNTIME_NO_SPECIALIZATION_KEY,
+    spirv ? spirv->groupCountX : WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+    spirv ? spirv->groupCountY : WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+    spirv ? spirv->groupCountZ : WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+    outModuleBytes,
+    outModuleSize,
+    outEntrypoint,
+    outProvider
+  );
+  webvulkan_runtime_record_stage_timing(
+    WEBVULKAN_RUNTIME_STAGE_REGISTRY_LOOKUP,
+    emscripten_get_now() - startMs
+  );
+  return found;
+}
+
+bool webvulkan_runtime_lookup_wasm_module_specialized(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey,
+  const uint8_t** outModuleBytes,
+  uint32_t* outModuleSize,
+  const char** outEntrypoint,
+  const char** outProvider
+) {
+  /* The driver resolves the module without a grid when it creates the pipeline. */
+  const double startMs = emscripten_get_now();
+  const bool found = webvulkan_runtime_lookup_wasm_module_for_dispatch(
+    keyLo,
+    keyHi,
+    specializationKey,
+    WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+    WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+    WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+    outModuleBytes,
+    outModuleSize,
+    outEntrypoint,
+    outProvider
+  );
+  webvulkan_runtime_record_stage_timing(
+    WEBVULKAN_RUNTIME_STAGE_REGISTRY_LOOKUP,
+    emscripten_get_now() - startMs
+  );
+  return found;
+}
+
+bool webvulkan_runtime_lookup_wasm_module_for_dispatch(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey,
+  uint32_t groupCountX,
+  uint32_t groupCountY,
+  uint32_t groupCountZ,
+  const uint8_t** outModuleBytes,
+  uint32_t* outModuleSize,
+  const char** outEntrypoint,
+  const char** outProvider
 ) {
   if (!outModuleBytes || !outModuleSize || !outEntrypoint || !outProvider) {
     return false;
   }
-  int index = webvulkan_find_wasm_entry_index(keyLo, keyHi);
+  int index = webvulkan_resolve_wasm_entry_index(keyLo, keyHi, specializationKey, groupCountX, groupCountY, groupCountZ);
   if (index < 0) {
     return false;
   }
@@ -505,6 +1837,53 @@ bool webvulkan_runtime_lookup_wasm_module(
   return true;
 }
 
+static bool webvulkan_lookup_wasm_instance(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey,
+  uint32_t groupCountX,
+  uint32_t groupCountY,
+  uint32_t groupCountZ,
+  uint32_t* outBindingId
+) {
+  if (!outBindingId) {
+    return false;
+  }
+  int index = webvulkan_resolve_wasm_entry_index(keyLo, keyHi, specializationKey, groupCountX, groupCountY, groupCountZ);
+  if (index < 0) {
+    return false;
+  }
+  const WebVulkanRuntimeWasmEntry* entry = &g_runtime_wasm_entries[(uint32_t)index];
+  if (entry->bindingId == 0u) {
+    return false;
+  }
+  *outBindingId = entry->bindingId;
+  return true;
+}
+
+bool webvulkan_runtime_lookup_wasm_instance_for_dispatch(
+  uint32_t keyLo,
+  uint32_t keyHi,
+  uint32_t specializationKey,
+  uint32_t groupCountX,
+  uint32_t groupCountY,
+  uint32_t groupCountZ,
+  uint32_t* outBindingId
+) {
+  webvulkan_runtime_trace_begin(WEBVULKAN_RUNTIME_TRACE_REGISTRY_LOOKUP, keyLo);
+  bool found = webvulkan_lookup_wasm_instance(
+    keyLo,
+    keyHi,
+    specializationKey,
+    groupCountX,
+    groupCountY,
+    groupCountZ,
+    outBindingId
+  );
+  webvulkan_runtime_trace_end(WEBVULKAN_RUNTIME_TRACE_REGISTRY_LOOKUP);
+  return found;
+}
+
 bool webvulkan_runtime_lookup_spirv_module(
   uint32_t keyLo,
   uint32_t keyHi,
@@ -515,7 +1894,12 @@ bool webvulkan_runtime_lookup_spirv_module(
   if (!outModuleBytes || !outModuleSize || !outEntrypoint) {
     return false;
   }
+  const double startMs = emscripten_get_now();
   int index = webvulkan_find_spirv_entry_index(keyLo, keyHi);
+  webvulkan_runtime_record_stage_timing(
+    WEBVULKAN_RUNTIME_STAGE_REGISTRY_LOOKUP,
+    emscripten_get_now() - startMs
+  );
   if (index < 0) {
     return false;
   }
@@ -23,7 +23,7 @@ if(NOT SMOKE_RUNTIME_MODE STREQUAL "fast_wasm" AND NOT SMOKE_RUNTIME_MODE STREQU
   message(FATAL_ERROR "SMOKE_RUNTIME_MODE must be fast_wasm or raw_llvm_ir")
 endif()
 if(NOT DEFINED SMOKE_RUNTIME_BENCH_ITERATIONS OR "${SMOKE_RUNTIME_BENCH_ITERATIONS}" STREQUAL "")
-  set(SMOKE_RUNTIME_BENCH_ITERATIONS "5")
+  set(SMOKE_RUNTIME_BENCH_ITERATIONS "20")
 endif()
 if(NOT DEFINED SMOKE_RUNTIME_WARMUP_ITERATIONS OR "${SMOKE_RUNTIME_WARMUP_ITERATIONS}" STREQUAL "")
   set(SMOKE_RUNTIME_WARMUP_ITERATIONS "1")
@@ -34,11 +34,16 @@ endif()
 if(NOT SMOKE_RUNTIME_BENCH_PROFILE STREQUAL "dispatch_overhead"
    AND NOT SMOKE_RUNTIME_BENCH_PROFILE STREQUAL "balanced_grid"
    AND NOT SMOKE_RUNTIME_BENCH_PROFILE STREQUAL "large_grid"
+   AND NOT SMOKE_RUNTIME_BENCH_PROFILE STREQUAL "large_buffer"
+   AND NOT SMOKE_RUNTIME_BENCH_PROFILE STREQUAL "indirect_dispatch"
+   AND NOT SMOKE_RUNTIME_BENCH_PROFILE STREQUAL "push_constant_sweep"
+   AND NOT SMOKE_RUNTIME_BENCH_PROFILE STREQUAL "descriptor_param_sweep"
+   AND NOT SMOKE_RUNTIME_BENCH_PROFILE STREQUAL "image_filter_2d"
    AND NOT SMOKE_RUNTIME_BENCH_PROFILE STREQUAL "micro"
    AND NOT SMOKE_RUNTIME_BENCH_PROFILE STREQUAL "realistic"
    AND NOT SMOKE_RUNTIME_BENCH_PROFILE STREQUAL "hot_loop_single_dispatch")
   message(FATAL_ERROR
-    "SMOKE_RUNTIME_BENCH_PROFILE must be dispatch_overhead, balanced_grid, large_grid, micro, realistic, or hot_loop_single_dispatch")
+    "SMOKE_RUNTIME_BENCH_PROFILE must be dispatch_overhead, balanced_grid, large_grid, large_buffer, indirect_dispatch, push_constant_sweep, descriptor_param_sweep, image_filter_2d, micro, realistic, or hot_loop_single_dispatch")
 endif()
 if(NOT DEFINED SMOKE_CLANG_WASM_PACKAGE OR "${SMOKE_CLANG_WASM_PACKAGE}" STREQUAL "")
   set(SMOKE_CLANG_WASM_PACKAGE "clang/clang")
@@ -49,9 +54,84 @@ endif()
 if(NOT SMOKE_RUNTIME_SHADER_WORKLOAD STREQUAL "write_const"
    AND NOT SMOKE_RUNTIME_SHADER_WORKLOAD STREQUAL "atomic_single_counter"
    AND NOT SMOKE_RUNTIME_SHADER_WORKLOAD STREQUAL "atomic_per_workgroup"
-   AND NOT SMOKE_RUNTIME_SHADER_WORKLOAD STREQUAL "no_race_unique_writes")
+   AND NOT SMOKE_RUNTIME_SHADER_WORKLOAD STREQUAL "no_race_unique_writes"
+   AND NOT SMOKE_RUNTIME_SHADER_WORKLOAD STREQUAL "atomic_sharded_histogram"
+   AND NOT SMOKE_RUNTIME_SHADER_WORKLOAD STREQUAL "groupshared_reduction"
+   AND NOT SMOKE_RUNTIME_SHADER_WORKLOAD STREQUAL "groupshared_scan"
+   AND NOT SMOKE_RUNTIME_SHADER_WORKLOAD STREQUAL "subgroup_reduction"
+   AND NOT SMOKE_RUNTIME_SHADER_WORKLOAD STREQUAL "spec_constant_tiles"
+   AND NOT SMOKE_RUNTIME_SHADER_WORKLOAD STREQUAL "buffer_copy"
+   AND NOT SMOKE_RUNTIME_SHADER_WORKLOAD STREQUAL "push_constant_param"
+   AND NOT SMOKE_RUNTIME_SHADER_WORKLOAD STREQUAL "image_box_filter")
   message(FATAL_ERROR
-    "SMOKE_RUNTIME_SHADER_WORKLOAD must be write_const, atomic_single_counter, atomic_per_workgroup, or no_race_unique_writes")
+    "SMOKE_RUNTIME_SHADER_WORKLOAD must be write_const, atomic_single_counter, atomic_per_workgroup, no_race_unique_writes, atomic_sharded_histogram, groupshared_reduction, groupshared_scan, subgroup_reduction, spec_constant_tiles, buffer_copy, push_constant_param, or image_box_filter")
+endif()
+if(NOT DEFINED SMOKE_RUNTIME_KERNEL_SPECIALIZATION OR "${SMOKE_RUNTIME_KERNEL_SPECIALIZATION}" STREQUAL "")
+  set(SMOKE_RUNTIME_KERNEL_SPECIALIZATION "generic")
+endif()
+if(NOT SMOKE_RUNTIME_KERNEL_SPECIALIZATION STREQUAL "generic"
+   AND NOT SMOKE_RUNTIME_KERNEL_SPECIALIZATION STREQUAL "grid")
+  message(FATAL_ERROR "SMOKE_RUNTIME_KERNEL_SPECIALIZATION must be generic or grid")
+endif()
+if(NOT DEFINED SMOKE_RUNTIME_TRANSFER_BENCH_MAX_BYTES OR "${SMOKE_RUNTIME_TRANSFER_BENCH_MAX_BYTES}" STREQUAL "")
+  set(SMOKE_RUNTIME_TRANSFER_BENCH_MAX_BYTES "0")
+endif()
+if(NOT SMOKE_RUNTIME_TRANSFER_BENCH_MAX_BYTES MATCHES "^[0-9]+$")
+  message(FATAL_ERROR "SMOKE_RUNTIME_TRANSFER_BENCH_MAX_BYTES must be a non-negative integer")
+endif()
+if(NOT DEFINED SMOKE_RUNTIME_RENDER_BENCH_SIZE OR "${SMOKE_RUNTIME_RENDER_BENCH_SIZE}" STREQUAL "")
+  set(SMOKE_RUNTIME_RENDER_BENCH_SIZE "0")
+endif()
+if(NOT SMOKE_RUNTIME_RENDER_BENCH_SIZE MATCHES "^[0-9]+$")
+  message(FATAL_ERROR "SMOKE_RUNTIME_RENDER_BENCH_SIZE must be a non-negative integer")
+endif()
+if(NOT DEFINED SMOKE_RUNTIME_VERTEX_BENCH_MAX_VERTICES OR "${SMOKE_RUNTIME_VERTEX_BENCH_MAX_VERTICES}" STREQUAL "")
+  set(SMOKE_RUNTIME_VERTEX_BENCH_MAX_VERTICES "0")
+endif()
+if(NOT SMOKE_RUNTIME_VERTEX_BENCH_MAX_VERTICES MATCHES "^[0-9]+$")
+  message(FATAL_ERROR "SMOKE_RUNTIME_VERTEX_BENCH_MAX_VERTICES must be a non-negative integer")
+endif()
+if(NOT DEFINED SMOKE_RUNTIME_PERSISTENT_SAMPLES OR "${SMOKE_RUNTIME_PERSISTENT_SAMPLES}" STREQUAL "")
+  set(SMOKE_RUNTIME_PERSISTENT_SAMPLES "0")
+endif()
+if(NOT SMOKE_RUNTIME_PERSISTENT_SAMPLES MATCHES "^[0-9]+$")
+  message(FATAL_ERROR "SMOKE_RUNTIME_PERSISTENT_SAMPLES must be a non-negative integer")
+endif()
+if(NOT DEFINED SMOKE_RUNTIME_PIPELINE_BENCH_SHADERS OR "${SMOKE_RUNTIME_PIPELINE_BENCH_SHADERS}" STREQUAL "")
+  set(SMOKE_RUNTIME_PIPELINE_BENCH_SHADERS "0")
+endif()
+if(NOT SMOKE_RUNTIME_PIPELINE_BENCH_SHADERS MATCHES "^[0-9]+$")
+  message(FATAL_ERROR "SMOKE_RUNTIME_PIPELINE_BENCH_SHADERS must be a non-negative integer")
+endif()
+if(NOT DEFINED SMOKE_RUNTIME_BANDWIDTH_BENCH_MAX_BYTES OR "${SMOKE_RUNTIME_BANDWIDTH_BENCH_MAX_BYTES}" STREQUAL "")
+  set(SMOKE_RUNTIME_BANDWIDTH_BENCH_MAX_BYTES "0")
+endif()
+if(NOT SMOKE_RUNTIME_BANDWIDTH_BENCH_MAX_BYTES MATCHES "^[0-9]+$")
+  message(FATAL_ERROR "SMOKE_RUNTIME_BANDWIDTH_BENCH_MAX_BYTES must be a non-negative integer")
+endif()
+if(NOT DEFINED SMOKE_RUNTIME_PRIMITIVE_BENCH_MAX_ELEMENTS OR "${SMOKE_RUNTIME_PRIMITIVE_BENCH_MAX_ELEMENTS}" STREQUAL "")
+  set(SMOKE_RUNTIME_PRIMITIVE_BENCH_MAX_ELEMENTS "0")
+endif()
+if(NOT SMOKE_RUNTIME_PRIMITIVE_BENCH_MAX_ELEMENTS MATCHES "^[0-9]+$")
+  message(FATAL_ERROR "SMOKE_RUNTIME_PRIMITIVE_BENCH_MAX_ELEMENTS must be a non-negative integer")
+endif()
+if(NOT DEFINED SMOKE_RUNTIME_SWEEP_MAX_WORKGROUP_SIZE OR "${SMOKE_RUNTIME_SWEEP_MAX_WORKGROUP_SIZE}" STREQUAL "")
+  set(SMOKE_RUNTIME_SWEEP_MAX_WORKGROUP_SIZE "0")
+endif()
+if(NOT SMOKE_RUNTIME_SWEEP_MAX_WORKGROUP_SIZE MATCHES "^[0-9]+$")
+  message(FATAL_ERROR "SMOKE_RUNTIME_SWEEP_MAX_WORKGROUP_SIZE must be a non-negative integer")
+endif()
+if(NOT DEFINED SMOKE_RUNTIME_TRACE_EVENTS OR "${SMOKE_RUNTIME_TRACE_EVENTS}" STREQUAL "")
+  set(SMOKE_RUNTIME_TRACE_EVENTS "0")
+endif()
+if(NOT SMOKE_RUNTIME_TRACE_EVENTS MATCHES "^[0-9]+$")
+  message(FATAL_ERROR "SMOKE_RUNTIME_TRACE_EVENTS must be a non-negative integer")
+endif()
+if(NOT DEFINED SMOKE_RUNTIME_MEMORY_GROWTH_CYCLES OR "${SMOKE_RUNTIME_MEMORY_GROWTH_CYCLES}" STREQUAL "")
+  set(SMOKE_RUNTIME_MEMORY_GROWTH_CYCLES "0")
+endif()
+if(NOT SMOKE_RUNTIME_MEMORY_GROWTH_CYCLES MATCHES "^[0-9]+$")
+  message(FATAL_ERROR "SMOKE_RUNTIME_MEMORY_GROWTH_CYCLES must be a non-negative integer")
 endif()
 if(NOT DEFINED SMOKE_SPIRV_WASM_PACKAGE OR "${SMOKE_SPIRV_WASM_PACKAGE}" STREQUAL "")
   set(SMOKE_SPIRV_WASM_PACKAGE "lights0123/llvm-spir")
@@ -115,6 +195,9 @@ endif()
 
 get_filename_component(SMOKE_OUT_DIR "${SMOKE_JS_OUT}" DIRECTORY)
 file(MAKE_DIRECTORY "${SMOKE_OUT_DIR}")
+if(NOT DEFINED SMOKE_RUNTIME_BENCH_JSON_DIR OR "${SMOKE_RUNTIME_BENCH_JSON_DIR}" STREQUAL "")
+  set(SMOKE_RUNTIME_BENCH_JSON_DIR "${SMOKE_OUT_DIR}/bench-json")
+endif()
 
 set(RSP_FILE "${SMOKE_OUT_DIR}/lavapipe_runtime_smoke.rsp")
 file(WRITE "${RSP_FILE}" "")
@@ -143,7 +226,7 @@ append_rsp("-sMODULARIZE=1")
 append_rsp("-sEXPORT_ES6=1")
 append_rsp("-sENVIRONMENT=web,worker,node")
 if(SMOKE_REQUIRE_RUNTIME_SPIRV STREQUAL "1")
-  append_rsp("-sEXPORTED_FUNCTIONS=['_main','${SMOKE_EXPORT}','_webvulkan_reset_runtime_shader_registry','_webvulkan_runtime_clear_shader_bundles','_webvulkan_set_runtime_active_shader_key','_webvulkan_runtime_set_active_shader_bundle','_webvulkan_set_runtime_dispatch_mode','_webvulkan_runtime_set_dispatch_mode_fast_wasm','_webvulkan_get_runtime_dispatch_mode','_webvulkan_set_runtime_expected_dispatch_value','_webvulkan_runtime_reset_captured_shader_key','_webvulkan_runtime_has_captured_shader_key','_webvulkan_runtime_get_captured_shader_key_lo','_webvulkan_runtime_get_captured_shader_key_hi','_webvulkan_set_runtime_shader_spirv','_webvulkan_register_runtime_shader_spirv','_webvulkan_register_runtime_wasm_module','_webvulkan_register_runtime_shader_bundle','_webvulkan_runtime_register_shader_bundle_params','_webvulkan_runtime_unregister_shader_bundle','_webvulkan_runtime_get_registered_spirv_count','_webvulkan_runtime_get_registered_wasm_count','_webvulkan_get_runtime_wasm_used','_webvulkan_get_runtime_wasm_provider','_webvulkan_set_runtime_bench_profile','_webvulkan_get_runtime_bench_profile','_webvulkan_set_runtime_shader_workload','_webvulkan_get_runtime_shader_workload','_webvulkan_get_last_dispatch_ms','_malloc','_free']")
+  append_rsp("-sEXPORTED_FUNCTIONS=['_main','${SMOKE_EXPORT}','_webvulkan_reset_runtime_shader_registry','_webvulkan_runtime_clear_shader_bundles','_webvulkan_set_runtime_active_shader_key','_webvulkan_runtime_set_active_shader_bundle','_webvulkan_set_runtime_dispatch_mode','_webvulkan_runtime_set_dispatch_mode_fast_wasm','_webvulkan_get_runtime_dispatch_mode','_webvulkan_set_runtime_subgroup_size','_webvulkan_get_runtime_subgroup_size','_webvulkan_set_runtime_expected_dispatch_value','_webvulkan_runtime_reset_captured_shader_key','_webvulkan_runtime_has_captured_shader_key','_webvulkan_runtime_get_captured_shader_key_lo','_webvulkan_runtime_get_captured_shader_key_hi','_webvulkan_set_runtime_shader_spirv','_webvulkan_register_runtime_shader_spirv','_webvulkan_register_runtime_wasm_module','_webvulkan_register_runtime_wasm_module_specialized','_webvulkan_register_runtime_wasm_module_for_grid','_webvulkan_runtime_get_registered_grid_wasm_count','_webvulkan_runtime_get_registered_specialized_wasm_count','_webvulkan_runtime_set_shader_specialization','_webvulkan_runtime_set_shader_dispatch_grid','_webvulkan_register_runtime_shader_bundle','_webvulkan_runtime_register_shader_bundle_params','_webvulkan_runtime_unregister_shader_bundle','_webvulkan_runtime_get_registered_spirv_count','_webvulkan_runtime_get_registered_wasm_count','_webvulkan_get_runtime_wasm_used','_webvulkan_get_runtime_wasm_provider','_webvulkan_set_runtime_bench_profile','_webvulkan_get_runtime_bench_profile','_webvulkan_set_runtime_shader_workload','_webvulkan_get_runtime_shader_workload','_webvulkan_set_runtime_specialization_constants','_webvulkan_get_runtime_specialization_key','_webvulkan_check_runtime_specialization_identity','_webvulkan_get_last_dispatch_ms','_webvulkan_get_last_mapped_storage_base','_webvulkan_get_last_mapped_storage_bytes','_webvulkan_get_last_kernel_storage_address','_webvulkan_get_last_bandwidth_wasm_submits','_webvulkan_runtime_get_registered_imported_memory_wasm_count','_webvulkan_runtime_wasm_module_imports_memory','_webvulkan_runtime_get_live_wasm_instance_count','_webvulkan_runtime_get_wasm_instantiation_count','_webvulkan_runtime_get_wasm_instance_dispatch_count','_webvulkan_runtime_get_wasm_kernel_binding','_webvulkan_runtime_get_wasm_kernel_instance','_webvulkan_runtime_get_wasm_grid_lookup_hit_count','_webvulkan_runtime_reset_wasm_instance_counters','_webvulkan_runtime_dispatch_wasm_instance','_webvulkan_register_runtime_wasm_shared_module','_webvulkan_unregister_runtime_wasm_shared_module','_webvulkan_runtime_get_registered_shared_wasm_module_count','_webvulkan_register_runtime_wasm_kernel','_webvulkan_set_runtime_transfer_bench_max_bytes','_webvulkan_get_runtime_transfer_bench_max_bytes','_webvulkan_set_runtime_render_bench_size','_webvulkan_get_runtime_render_bench_size','_webvulkan_set_runtime_render_shader_key','_webvulkan_set_runtime_vertex_bench_max_vertices','_webvulkan_get_runtime_vertex_bench_max_vertices','_webvulkan_set_runtime_vertex_shader_key','_webvulkan_set_runtime_persistent_samples','_webvulkan_get_runtime_persistent_samples','_webvulkan_get_runtime_persistent_sample_ms','_webvulkan_set_runtime_pipeline_bench_shaders','_webvulkan_get_runtime_pipeline_bench_shaders','_webvulkan_set_runtime_pipeline_bench_kernel','_webvulkan_set_runtime_bandwidth_bench_max_bytes','_webvulkan_get_runtime_bandwidth_bench_max_bytes','_webvulkan_set_runtime_bandwidth_shader_key','_webvulkan_set_runtime_bandwidth_bench_kernel_module','_webvulkan_set_runtime_primitive_bench_max_elements','_webvulkan_get_runtime_primitive_bench_max_elements','_webvulkan_set_runtime_primitive_shader_key','_webvulkan_set_runtime_primitive_bench_kernel_module','_webvulkan_set_runtime_launch_override','_webvulkan_runtime_get_stage_total_ms','_webvulkan_runtime_get_stage_last_ms','_webvulkan_runtime_get_stage_count','_webvulkan_runtime_reset_stage_timings','_webvulkan_runtime_get_stage_timings','_webvulkan_runtime_record_stage_timing','_webvulkan_runtime_trace_enable','_webvulkan_runtime_trace_get_event_count','_webvulkan_runtime_trace_get_dropped_count','_webvulkan_runtime_trace_export_json','_webvulkan_runtime_get_memory_footprint','_webvulkan_runtime_get_memory_footprint_value','_webvulkan_runtime_record_device_memory','_webvulkan_runtime_record_pipeline_heap_delta','_webvulkan_set_runtime_memory_growth_cycles','_webvulkan_get_runtime_memory_growth_cycles','_webvulkan_get_runtime_memory_growth_sample_count','_webvulkan_get_runtime_memory_growth_sample','_malloc','_free']")
 else()
   append_rsp("-sEXPORTED_FUNCTIONS=['_main','${SMOKE_EXPORT}']")
 endif()
@@ -174,6 +257,18 @@ execute_process(
       "WEBVULKAN_RUNTIME_WARMUP_ITERATIONS=${SMOKE_RUNTIME_WARMUP_ITERATIONS}"
     "WEBVULKAN_RUNTIME_BENCH_PROFILE=${SMOKE_RUNTIME_BENCH_PROFILE}"
     "WEBVULKAN_RUNTIME_SHADER_WORKLOAD=${SMOKE_RUNTIME_SHADER_WORKLOAD}"
+    "WEBVULKAN_RUNTIME_KERNEL_SPECIALIZATION=${SMOKE_RUNTIME_KERNEL_SPECIALIZATION}"
+    "WEBVULKAN_RUNTIME_TRANSFER_BENCH_MAX_BYTES=${SMOKE_RUNTIME_TRANSFER_BENCH_MAX_BYTES}"
+    "WEBVULKAN_RUNTIME_RENDER_BENCH_SIZE=${SMOKE_RUNTIME_RENDER_BENCH_SIZE}"
+    "WEBVULKAN_RUNTIME_VERTEX_BENCH_MAX_VERTICES=${SMOKE_RUNTIME_VERTEX_BENCH_MAX_VERTICES}"
+    "WEBVULKAN_RUNTIME_PERSISTENT_SAMPLES=${SMOKE_RUNTIME_PERSISTENT_SAMPLES}"
+    "WEBVULKAN_RUNTIME_PIPELINE_BENCH_SHADERS=${SMOKE_RUNTIME_PIPELINE_BENCH_SHADERS}"
+    "WEBVULKAN_RUNTIME_BANDWIDTH_BENCH_MAX_BYTES=${SMOKE_RUNTIME_BANDWIDTH_BENCH_MAX_BYTES}"
+    "WEBVULKAN_RUNTIME_PRIMITIVE_BENCH_MAX_ELEMENTS=${SMOKE_RUNTIME_PRIMITIVE_BENCH_MAX_ELEMENTS}"
+    "WEBVULKAN_RUNTIME_SWEEP_MAX_WORKGROUP_SIZE=${SMOKE_RUNTIME_SWEEP_MAX_WORKGROUP_SIZE}"
+    "WEBVULKAN_RUNTIME_TRACE_EVENTS=${SMOKE_RUNTIME_TRACE_EVENTS}"
+    "WEBVULKAN_RUNTIME_MEMORY_GROWTH_CYCLES=${SMOKE_RUNTIME_MEMORY_GROWTH_CYCLES}"
+    "WEBVULKAN_RUNTIME_BENCH_JSON_DIR=${SMOKE_RUNTIME_BENCH_JSON_DIR}"
     "WEBVULKAN_CLANG_WASM_PACKAGE=${SMOKE_CLANG_WASM_PACKAGE}"
     "WEBVULKAN_SPIRV_WASM_PACKAGE=${SMOKE_SPIRV_WASM_PACKAGE}"
     "WEBVULKAN_SPIRV_WASM_ENTRYPOINT=${SMOKE_SPIRV_WASM_ENTRYPOINT}"
@@ -10,13 +10,69 @@
 
 VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vk_icdGetInstanceProcAddr(VkInstance instance, const char* pName);
 static double g_last_dispatch_wall_ms = -1.0;
+static uint32_t g_last_mapped_storage_base = 0u;
+static uint32_t g_last_mapped_storage_bytes = 0u;
+static uint32_t g_last_kernel_storage_address = 0u;
 static const uint32_t kSmokeBufferWordCount = 65536u;
+static const uint32_t kRuntimeHistogramBinCount = 16u;
+static const uint32_t kRuntimeCopySampleCount = 64u;
+static const uint32_t kRuntimeCopyPoisonValue = 0xdeadbeefu;
+static const uint32_t kRuntimeTransferMinBytes = 4096u;
+static const uint32_t kRuntimeTransferMaxBytes = 256u << 20;
+static const uint32_t kRuntimeTransferUpdateMaxBytes = 65536u;
+static const uint32_t kRuntimeTransferBytesPerSubmit = 64u << 20;
+static const uint32_t kRuntimeTransferMaxCommandsPerSubmit = 256u;
+static const uint32_t kRuntimeTransferFillValue = 0x5a5a5a5au;
+static const uint32_t kRuntimeImageFilterTileSize = 8u;
+static const uint32_t kRuntimeImageFilterSampleCount = 64u;
+static const uint32_t kRuntimeRenderMinSize = 16u;
+static const uint32_t kRuntimeRenderMaxSize = 2048u;
+static const uint32_t kRuntimeRenderDrawsPerSubmit = 4u;
+static const uint32_t kRuntimeRenderSubmitIterations = 8u;
+static const uint32_t kRuntimeRenderTextureSize = 64u;
+static const uint32_t kRuntimeRenderClearColor = 0xff996633u;
+static const uint32_t kRuntimeRenderBlendColor = 0xff4c3399u;
+static const uint32_t kRuntimeVertexMinCount = 1024u;
+static const uint32_t kRuntimeVertexMaxCount = 1048576u;
+static const uint32_t kRuntimeVertexStrideBytes = 16u;
+static const uint32_t kRuntimeVertexSubmitIterations = 4u;
+static const uint32_t kRuntimeBandwidthMinBytes = 64u << 10;
+static const uint32_t kRuntimeBandwidthMaxBytes = 256u << 20;
+static const uint32_t kRuntimeBandwidthHeaderWords = 4u;
+static const uint32_t kRuntimeBandwidthWorkgroupSize = 64u;
+static const uint32_t kRuntimeBandwidthMaxWorkgroups = 4096u;
+static const uint32_t kRuntimeBandwidthGatherColumns = 16u;
+static const uint32_t kRuntimeBandwidthScale = 3u;
+static const uint32_t kRuntimeBandwidthBytesPerSubmit = 64u << 20;
+static const uint32_t kRuntimeBandwidthMaxDispatchesPerSubmit = 64u;
+static const uint32_t kRuntimePrimitiveMinElements = 4096u;
+static const uint32_t kRuntimePrimitiveMaxElements = 4u << 20;
+static const uint32_t kRuntimePrimitiveHeaderWords = 16u;
+static const uint32_t kRuntimePrimitiveBlockSize = 256u;
+static const uint32_t kRuntimePrimitiveMaxGridWorkgroups = 1024u;
+static const uint32_t kRuntimePrimitiveSubmitIterations = 4u;
+static const uint32_t kRuntimePrimitiveRadixShift = 0u;
+static const uint32_t kRuntimeLaunchMaxWorkgroupSize = 1024u;
+static const uint32_t kRuntimeLaunchMaxGroupCount = 65535u;
+static const uint32_t kRuntimeLaunchMaxDispatchesPerSubmit = 1024u;
+static const uint64_t kRuntimeLaunchMaxInvocationsPerSubmit = 1ull << 22;
 
 enum {
   WEBVULKAN_RUNTIME_BENCH_PROFILE_DISPATCH_OVERHEAD = 0u,
   WEBVULKAN_RUNTIME_BENCH_PROFILE_BALANCED_GRID = 1u,
   WEBVULKAN_RUNTIME_BENCH_PROFILE_LARGE_GRID = 2u,
-  WEBVULKAN_RUNTIME_BENCH_PROFILE_COUNT = 3u
+  WEBVULKAN_RUNTIME_BENCH_PROFILE_LARGE_BUFFER = 3u,
+  WEBVULKAN_RUNTIME_BENCH_PROFILE_INDIRECT_DISPATCH = 4u,
+  WEBVULKAN_RUNTIME_BENCH_PROFILE_PUSH_CONSTANT_SWEEP = 5u,
+  WEBVULKAN_RUNTIME_BENCH_PROFILE_DESCRIPTOR_PARAM_SWEEP = 6u,
+  WEBVULKAN_RUNTIME_BENCH_PROFILE_IMAGE_FILTER_2D = 7u,
+  WEBVULKAN_RUNTIME_BENCH_PROFILE_COUNT = 8u
+};
+
+enum {
+  WEBVULKAN_RUNTIME_PARAM_MODE_NONE = 0u,
+  WEBVULKAN_RUNTIME_PARAM_MODE_PUSH_CONSTANT = 1u,
+  WEBVULKAN_RUNTIME_PARAM_MODE_DESCRIPTOR = 2u
 };
 
 enum {
@@ -24,9 +80,181 @@ enum {
   WEBVULKAN_RUNTIME_SHADER_WORKLOAD_ATOMIC_SINGLE_COUNTER = 1u,
   WEBVULKAN_RUNTIME_SHADER_WORKLOAD_ATOMIC_PER_WORKGROUP = 2u,
   WEBVULKAN_RUNTIME_SHADER_WORKLOAD_NO_RACE_UNIQUE_WRITES = 3u,
-  WEBVULKAN_RUNTIME_SHADER_WORKLOAD_COUNT = 4u
+  WEBVULKAN_RUNTIME_SHADER_WORKLOAD_ATOMIC_SHARDED_HISTOGRAM = 4u,
+  WEBVULKAN_RUNTIME_SHADER_WORKLOAD_GROUPSHARED_REDUCTION = 5u,
+  WEBVULKAN_RUNTIME_SHADER_WORKLOAD_GROUPSHARED_SCAN = 6u,
+  WEBVULKAN_RUNTIME_SHADER_WORKLOAD_SUBGROUP_REDUCTION = 7u,
+  WEBVULKAN_RUNTIME_SHADER_WORKLOAD_SPEC_CONSTANT_TILES = 8u,
+  WEBVULKAN_RUNTIME_SHADER_WORKLOAD_BUFFER_COPY = 9u,
+  WEBVULKAN_RUNTIME_SHADER_WORKLOAD_PUSH_CONSTANT_PARAM = 10u,
+  WEBVULKAN_RUNTIME_SHADER_WORKLOAD_IMAGE_BOX_FILTER = 11u,
+  WEBVULKAN_RUNTIME_SHADER_WORKLOAD_COUNT = 12u
+};
+
+enum {
+  WEBVULKAN_RUNTIME_TRANSFER_OP_FILL = 0u,
+  WEBVULKAN_RUNTIME_TRANSFER_OP_COPY = 1u,
+  WEBVULKAN_RUNTIME_TRANSFER_OP_UPDATE = 2u,
+  WEBVULKAN_RUNTIME_TRANSFER_OP_COUNT = 3u,
+  WEBVULKAN_RUNTIME_TRANSFER_MAX_SIZE_COUNT = 9u
+};
+
+enum {
+  WEBVULKAN_RUNTIME_RENDER_SCENE_CLEAR = 0u,
+  WEBVULKAN_RUNTIME_RENDER_SCENE_FULLSCREEN_TRIANGLE = 1u,
+  WEBVULKAN_RUNTIME_RENDER_SCENE_SMALL_TRIANGLES = 2u,
+  WEBVULKAN_RUNTIME_RENDER_SCENE_TEXTURED_QUADS = 3u,
+  WEBVULKAN_RUNTIME_RENDER_SCENE_BLEND = 4u,
+  WEBVULKAN_RUNTIME_RENDER_SCENE_COUNT = 5u,
+  WEBVULKAN_RUNTIME_RENDER_MAX_SIZE_COUNT = 4u
+};
+
+enum {
+  WEBVULKAN_RUNTIME_RENDER_SHADER_FULLSCREEN_VS = 0u,
+  WEBVULKAN_RUNTIME_RENDER_SHADER_GRID_VS = 1u,
+  WEBVULKAN_RUNTIME_RENDER_SHADER_GRADIENT_PS = 2u,
+  WEBVULKAN_RUNTIME_RENDER_SHADER_TEXTURE_PS = 3u,
+  WEBVULKAN_RUNTIME_RENDER_SHADER_BLEND_PS = 4u,
+  WEBVULKAN_RUNTIME_RENDER_SHADER_COUNT = 5u
+};
+
+enum {
+  WEBVULKAN_RUNTIME_VERTEX_MAX_SIZE_COUNT = 6u
+};
+
+enum {
+  WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COPY = 0u,
+  WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_SAXPY = 1u,
+  WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_TRIAD = 2u,
+  WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_GATHER = 3u,
+  WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COUNT = 4u,
+  WEBVULKAN_RUNTIME_BANDWIDTH_MAX_SIZE_COUNT = 7u
+};
+
+enum {
+  WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_REDUCE = 0u,
+  WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_HISTOGRAM = 1u,
+  WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_BLOCK_SUM = 2u,
+  WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_SCAN_PARTIALS = 3u,
+  WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_BLOCK_SCAN = 4u,
+  WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_RADIX_COUNT = 5u,
+  WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_RADIX_SCATTER = 6u,
+  WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_COUNT = 7u
+};
+
+enum {
+  WEBVULKAN_RUNTIME_PRIMITIVE_REDUCE = 0u,
+  WEBVULKAN_RUNTIME_PRIMITIVE_SCAN = 1u,
+  WEBVULKAN_RUNTIME_PRIMITIVE_HISTOGRAM = 2u,
+  WEBVULKAN_RUNTIME_PRIMITIVE_RADIX_PASS = 3u,
+  WEBVULKAN_RUNTIME_PRIMITIVE_COUNT = 4u,
+  WEBVULKAN_RUNTIME_PRIMITIVE_MAX_STAGES = 3u,
+  WEBVULKAN_RUNTIME_PRIMITIVE_MAX_SIZE_COUNT = 6u,
+  WEBVULKAN_RUNTIME_PRIMITIVE_HISTOGRAM_BINS = 256u
+};
+
+enum {
+  WEBVULKAN_RUNTIME_PERSISTENT_MAX_SAMPLES = 4096u
+};
+
+enum {
+  WEBVULKAN_RUNTIME_PIPELINE_STATE_COLD = 0u,
+  WEBVULKAN_RUNTIME_PIPELINE_STATE_BUNDLE = 1u,
+  WEBVULKAN_RUNTIME_PIPELINE_STATE_CACHE = 2u,
+  WEBVULKAN_RUNTIME_PIPELINE_STATE_COUNT = 3u,
+  WEBVULKAN_RUNTIME_PIPELINE_BENCH_MAX_SHADERS = 32u,
+  WEBVULKAN_RUNTIME_PIPELINE_KERNEL_EXPORT_MAX = 64u
+};
+
+enum {
+  WEBVULKAN_RUNTIME_MEMORY_GROWTH_MAX_CYCLES = 1024u,
+  WEBVULKAN_RUNTIME_TRACKED_DEVICE_MEMORY_MAX = 4096u
 };
 
+/* gridCells == 0 draws one fullscreen triangle; otherwise gridCells^2 quads of two triangles each. */
+typedef struct WebVulkanRuntimeRenderScene_t {
+  const char* name;
+  uint32_t drawsGeometry;
+  uint32_t vertexShader;
+  uint32_t fragmentShader;
+  uint32_t gridCells;
+  uint32_t blend;
+} WebVulkanRuntimeRenderScene;
+
+typedef struct WebVulkanRuntimeTransferSample_t {
+  uint32_t bytes;
+  uint32_t commandsPerSubmit;
+  double submitMs[WEBVULKAN_RUNTIME_TRANSFER_OP_COUNT];
+  double hostScalarFillMs;
+  double hostScalarCopyMs;
+} WebVulkanRuntimeTransferSample;
+
+/*
+ * One STREAM-style kernel of the bandwidth bench. `arrays` counts the u32 arrays
+ * read or written per element; `dstArray` is the array the host validates.
+ */
+typedef struct WebVulkanRuntimeBandwidthKernel_t {
+  const char* name;
+  const char* kernelExport;
+  uint32_t arrays;
+  uint32_t dstArray;
+} WebVulkanRuntimeBandwidthKernel;
+
+typedef struct WebVulkanRuntimeBandwidthSample_t {
+  uint32_t bytes;
+  uint32_t elements;
+  uint32_t dispatchesPerSubmit;
+  double submitMs[WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COUNT];
+  uint32_t wasmSubmits[WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COUNT];
+  double hostMemcpyMs;
+} WebVulkanRuntimeBandwidthSample;
+
+/* One data-parallel primitive: its WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_* stages, dispatched in order. */
+typedef struct WebVulkanRuntimePrimitive_t {
+  const char* name;
+  uint32_t stageCount;
+  uint32_t stages[WEBVULKAN_RUNTIME_PRIMITIVE_MAX_STAGES];
+} WebVulkanRuntimePrimitive;
+
+typedef struct WebVulkanRuntimePrimitiveSample_t {
+  uint32_t elements;
+  double submitMs[WEBVULKAN_RUNTIME_PRIMITIVE_COUNT];
+  double hostMs[WEBVULKAN_RUNTIME_PRIMITIVE_COUNT];
+  uint32_t wasmSubmits[WEBVULKAN_RUNTIME_PRIMITIVE_COUNT];
+} WebVulkanRuntimePrimitiveSample;
+
+typedef struct WebVulkanRuntimeRenderSample_t {
+  uint32_t scene;
+  uint32_t width;
+  uint32_t height;
+  uint32_t trianglesPerDraw;
+  uint32_t drawsPerSubmit;
+  uint32_t submitIterations;
+  double submitMs;
+  double readbackMs;
+  uint32_t pixelsChecked;
+} WebVulkanRuntimeRenderSample;
+
+typedef struct WebVulkanRuntimeVertexSample_t {
+  uint32_t vertexCount;
+  uint32_t submitIterations;
+  double submitMs;
+  uint32_t verticesChecked;
+} WebVulkanRuntimeVertexSample;
+
+typedef struct WebVulkanRuntimePipelineStateSample_t {
+  double moduleMs[WEBVULKAN_RUNTIME_PIPELINE_BENCH_MAX_SHADERS];
+  double pipelineMs[WEBVULKAN_RUNTIME_PIPELINE_BENCH_MAX_SHADERS];
+  /* Registry stage totals and counts accumulated during the timed pass. */
+  double stageMs[WEBVULKAN_RUNTIME_STAGE_COUNT];
+  uint32_t stageCalls[WEBVULKAN_RUNTIME_STAGE_COUNT];
+} WebVulkanRuntimePipelineStateSample;
+
+typedef struct WebVulkanRuntimeTrackedDeviceMemory_t {
+  VkDeviceMemory memory;
+  uint32_t bytes;
+} WebVulkanRuntimeTrackedDeviceMemory;
+
 typedef struct WebVulkanRuntimeBenchProfile_t {
   const char* name;
   uint32_t dispatchesPerSubmit;
@@ -34,15 +262,111 @@ typedef struct WebVulkanRuntimeBenchProfile_t {
   uint32_t dispatchX;
   uint32_t dispatchY;
   uint32_t dispatchZ;
+  uint32_t indirect;
+  uint32_t paramMode;
 } WebVulkanRuntimeBenchProfile;
 
+/* Launch sweep point; dispatchesPerSubmit == 0 means the bench profile and workload decide. */
+typedef struct WebVulkanRuntimeLaunchOverride_t {
+  uint32_t dispatchesPerSubmit;
+  uint32_t dispatchX;
+  uint32_t dispatchY;
+  uint32_t dispatchZ;
+  uint32_t workgroupSizeX;
+} WebVulkanRuntimeLaunchOverride;
+
 static uint32_t g_runtime_bench_profile = WEBVULKAN_RUNTIME_BENCH_PROFILE_DISPATCH_OVERHEAD;
+static WebVulkanRuntimeLaunchOverride g_runtime_launch_override = { 0u, 0u, 0u, 0u, 0u };
 static const WebVulkanRuntimeBenchProfile g_runtime_bench_profiles[WEBVULKAN_RUNTIME_BENCH_PROFILE_COUNT] = {
-  { "dispatch_overhead", 1024u, 16u, 1u, 1u, 1u },
-  { "balanced_grid", 256u, 16u, 4u, 1u, 1u },
-  { "large_grid", 1u, 64u, 256u, 1u, 1u }
+  { "dispatch_overhead", 1024u, 16u, 1u, 1u, 1u, 0u, WEBVULKAN_RUNTIME_PARAM_MODE_NONE },
+  { "balanced_grid", 256u, 16u, 4u, 1u, 1u, 0u, WEBVULKAN_RUNTIME_PARAM_MODE_NONE },
+  { "large_grid", 1u, 64u, 256u, 1u, 1u, 0u, WEBVULKAN_RUNTIME_PARAM_MODE_NONE },
+  { "large_buffer", 1u, 16u, 16384u, 1u, 1u, 0u, WEBVULKAN_RUNTIME_PARAM_MODE_NONE },
+  { "indirect_dispatch", 256u, 16u, 4u, 1u, 1u, 1u, WEBVULKAN_RUNTIME_PARAM_MODE_NONE },
+  { "push_constant_sweep", 256u, 16u, 4u, 1u, 1u, 0u, WEBVULKAN_RUNTIME_PARAM_MODE_PUSH_CONSTANT },
+  { "descriptor_param_sweep", 256u, 16u, 4u, 1u, 1u, 0u, WEBVULKAN_RUNTIME_PARAM_MODE_DESCRIPTOR },
+  { "image_filter_2d", 1u, 16u, 32u, 32u, 1u, 0u, WEBVULKAN_RUNTIME_PARAM_MODE_NONE }
 };
 static uint32_t g_runtime_shader_workload = WEBVULKAN_RUNTIME_SHADER_WORKLOAD_WRITE_CONST;
+static uint32_t g_runtime_transfer_bench_max_bytes = 0u;
+static uint32_t g_runtime_render_bench_size = 0u;
+static uint32_t g_runtime_render_shader_keys[WEBVULKAN_RUNTIME_RENDER_SHADER_COUNT][2];
+static const WebVulkanRuntimeRenderScene g_runtime_render_scenes[WEBVULKAN_RUNTIME_RENDER_SCENE_COUNT] = {
+  { "clear", 0u, WEBVULKAN_RUNTIME_RENDER_SHADER_FULLSCREEN_VS, WEBVULKAN_RUNTIME_RENDER_SHADER_GRADIENT_PS, 0u, 0u },
+  { "fullscreen_triangle", 1u, WEBVULKAN_RUNTIME_RENDER_SHADER_FULLSCREEN_VS, WEBVULKAN_RUNTIME_RENDER_SHADER_GRADIENT_PS, 0u, 0u },
+  { "small_triangles", 1u, WEBVULKAN_RUNTIME_RENDER_SHADER_GRID_VS, WEBVULKAN_RUNTIME_RENDER_SHADER_GRADIENT_PS, 64u, 0u },
+  { "textured_quads", 1u, WEBVULKAN_RUNTIME_RENDER_SHADER_GRID_VS, WEBVULKAN_RUNTIME_RENDER_SHADER_TEXTURE_PS, 4u, 0u },
+  { "blend", 1u, WEBVULKAN_RUNTIME_RENDER_SHADER_FULLSCREEN_VS, WEBVULKAN_RUNTIME_RENDER_SHADER_BLEND_PS, 0u, 1u }
+};
+static uint32_t g_runtime_vertex_bench_max_vertices = 0u;
+static uint32_t g_runtime_vertex_shader_key[2] = { 0u, 0u };
+static uint32_t g_runtime_bandwidth_bench_max_bytes = 0u;
+static uint32_t g_runtime_bandwidth_shader_keys[WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COUNT][2];
+static uint32_t g_runtime_bandwidth_kernel_module = WEBVULKAN_RUNTIME_NO_SHARED_WASM_MODULE;
+static uint32_t g_last_bandwidth_wasm_submits[WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COUNT];
+static const WebVulkanRuntimeBandwidthKernel g_runtime_bandwidth_kernels[WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COUNT] = {
+  { "copy", "kernel_bandwidth_copy", 2u, 1u },
+  { "saxpy", "kernel_bandwidth_saxpy", 3u, 1u },
+  { "triad", "kernel_bandwidth_triad", 3u, 2u },
+  { "gather", "kernel_bandwidth_gather", 2u, 1u }
+};
+static uint32_t g_runtime_primitive_bench_max_elements = 0u;
+static uint32_t g_runtime_primitive_shader_keys[WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_COUNT][2];
+static uint32_t g_runtime_primitive_kernel_module = WEBVULKAN_RUNTIME_NO_SHARED_WASM_MODULE;
+static const char* const g_runtime_primitive_shader_exports[WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_COUNT] = {
+  "kernel_primitive_reduce",
+  "kernel_primitive_histogram",
+  "kernel_primitive_block_sum",
+  "kernel_primitive_scan_partials",
+  "kernel_primitive_block_scan",
+  "kernel_primitive_radix_count",
+  "kernel_primitive_radix_scatter"
+};
+static const WebVulkanRuntimePrimitive g_runtime_primitives[WEBVULKAN_RUNTIME_PRIMITIVE_COUNT] = {
+  { "reduce", 1u, { WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_REDUCE, 0u, 0u } },
+  {
+    "exclusive_scan",
+    3u,
+    {
+      WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_BLOCK_SUM,
+      WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_SCAN_PARTIALS,
+      WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_BLOCK_SCAN
+    }
+  },
+  { "histogram", 1u, { WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_HISTOGRAM, 0u, 0u } },
+  {
+    "radix_pass",
+    3u,
+    {
+      WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_RADIX_COUNT,
+      WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_SCAN_PARTIALS,
+      WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_RADIX_SCATTER
+    }
+  }
+};
+static uint32_t g_runtime_persistent_samples = 0u;
+static double g_runtime_persistent_sample_ms[WEBVULKAN_RUNTIME_PERSISTENT_MAX_SAMPLES];
+static uint32_t g_runtime_pipeline_bench_shaders = 0u;
+static uint32_t g_runtime_pipeline_bench_kernel_module = WEBVULKAN_RUNTIME_NO_SHARED_WASM_MODULE;
+static char g_runtime_pipeline_bench_kernel_export[WEBVULKAN_RUNTIME_PIPELINE_KERNEL_EXPORT_MAX];
+static uint32_t g_runtime_memory_growth_cycles = 0u;
+static uint32_t g_runtime_memory_growth_sample_count = 0u;
+/*
+ * Sample 0 is taken before the first cycle, sample i after cycle i destroyed its pipeline.
+ * Pipeline bytes and live pipelines in sample i are read while that pipeline was alive.
+ */
+static WebVulkanRuntimeMemoryFootprint g_runtime_memory_growth_samples[WEBVULKAN_RUNTIME_MEMORY_GROWTH_MAX_CYCLES + 1u];
+static WebVulkanRuntimeTrackedDeviceMemory g_runtime_tracked_device_memory[WEBVULKAN_RUNTIME_TRACKED_DEVICE_MEMORY_MAX];
+static const char* const g_runtime_pipeline_state_names[WEBVULKAN_RUNTIME_PIPELINE_STATE_COUNT] = {
+  "cold",
+  "bundle",
+  "cache"
+};
+static uint32_t g_runtime_spec_constants[2] = { 16u, 4u };
+static const WebVulkanRuntimeSpecializationEntry g_runtime_spec_entries[2] = {
+  { 0u, 0u, sizeof(uint32_t) },
+  { 1u, sizeof(uint32_t), sizeof(uint32_t) }
+};
 
 static const WebVulkanRuntimeBenchProfile* webvulkan_get_runtime_bench_profile_desc(void) {
   uint32_t profile = g_runtime_bench_profile;
@@ -61,6 +385,43 @@ EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_bench_profile(uint32_t profile) {
   return 0;
 }
 
+/*
+ * Launch sweep: replaces the profile's grid and dispatches per submit, and the
+ * workload's workgroup size, on the following smoke calls. The bound shader must
+ * be built with numthreads(workgroupSizeX, 1, 1). All zeros returns to the profile.
+ */
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_launch_override(
+  uint32_t dispatchesPerSubmit,
+  uint32_t dispatchX,
+  uint32_t dispatchY,
+  uint32_t dispatchZ,
+  uint32_t workgroupSizeX
+) {
+  if (dispatchesPerSubmit == 0u && dispatchX == 0u && dispatchY == 0u && dispatchZ == 0u && workgroupSizeX == 0u) {
+    memset(&g_runtime_launch_override, 0, sizeof(g_runtime_launch_override));
+    return 0;
+  }
+  if (dispatchesPerSubmit == 0u || dispatchesPerSubmit > kRuntimeLaunchMaxDispatchesPerSubmit ||
+      dispatchX == 0u || dispatchX > kRuntimeLaunchMaxGroupCount ||
+      dispatchY == 0u || dispatchY > kRuntimeLaunchMaxGroupCount ||
+      dispatchZ == 0u || dispatchZ > kRuntimeLaunchMaxGroupCount ||
+      workgroupSizeX == 0u || workgroupSizeX > kRuntimeLaunchMaxWorkgroupSize ||
+      (workgroupSizeX & (workgroupSizeX - 1u)) != 0u) {
+    return -1;
+  }
+  const uint64_t invocationsPerSubmit =
+    (uint64_t)dispatchesPerSubmit * dispatchX * dispatchY * dispatchZ * workgroupSizeX;
+  if (invocationsPerSubmit > kRuntimeLaunchMaxInvocationsPerSubmit) {
+    return -1;
+  }
+  g_runtime_launch_override.dispatchesPerSubmit = dispatchesPerSubmit;
+  g_runtime_launch_override.dispatchX = dispatchX;
+  g_runtime_launch_override.dispatchY = dispatchY;
+  g_runtime_launch_override.dispatchZ = dispatchZ;
+  g_runtime_launch_override.workgroupSizeX = workgroupSizeX;
+  return 0;
+}
+
 EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_runtime_bench_profile(void) {
   return g_runtime_bench_profile;
 }
@@ -77,6 +438,267 @@ EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_runtime_shader_workload(void) {
   return g_runtime_shader_workload;
 }
 
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_transfer_bench_max_bytes(uint32_t maxBytes) {
+  if (maxBytes != 0u && (maxBytes < kRuntimeTransferMinBytes || maxBytes > kRuntimeTransferMaxBytes)) {
+    return -1;
+  }
+  g_runtime_transfer_bench_max_bytes = maxBytes;
+  return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_runtime_transfer_bench_max_bytes(void) {
+  return g_runtime_transfer_bench_max_bytes;
+}
+
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_render_bench_size(uint32_t size) {
+  if (size != 0u && (size < kRuntimeRenderMinSize || size > kRuntimeRenderMaxSize)) {
+    return -1;
+  }
+  g_runtime_render_bench_size = size;
+  return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_runtime_render_bench_size(void) {
+  return g_runtime_render_bench_size;
+}
+
+/* The render bench loads each of its shaders (WEBVULKAN_RUNTIME_RENDER_SHADER_*) from the registry by key. */
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_render_shader_key(uint32_t shader, uint32_t keyLo, uint32_t keyHi) {
+  if (shader >= WEBVULKAN_RUNTIME_RENDER_SHADER_COUNT) {
+    return -1;
+  }
+  g_runtime_render_shader_keys[shader][0] = keyLo;
+  g_runtime_render_shader_keys[shader][1] = keyHi;
+  return 0;
+}
+
+/* Mesh sizes run from 1k vertices up to maxVertices in steps of 4x. */
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_vertex_bench_max_vertices(uint32_t maxVertices) {
+  if (maxVertices != 0u && (maxVertices < kRuntimeVertexMinCount || maxVertices > kRuntimeVertexMaxCount)) {
+    return -1;
+  }
+  g_runtime_vertex_bench_max_vertices = maxVertices;
+  return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_runtime_vertex_bench_max_vertices(void) {
+  return g_runtime_vertex_bench_max_vertices;
+}
+
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_vertex_shader_key(uint32_t keyLo, uint32_t keyHi) {
+  g_runtime_vertex_shader_key[0] = keyLo;
+  g_runtime_vertex_shader_key[1] = keyHi;
+  return 0;
+}
+
+/*
+ * Bandwidth bench: copy, saxpy, triad and strided gather over one storage buffer
+ * of 64 KiB up to maxBytes in steps of 4x. 0 disables it. The cap is 256 MiB:
+ * the buffer lives in wasm32 linear memory next to the lavapipe heap.
+ */
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_bandwidth_bench_max_bytes(uint32_t maxBytes) {
+  if (maxBytes != 0u && (maxBytes < kRuntimeBandwidthMinBytes || maxBytes > kRuntimeBandwidthMaxBytes)) {
+    return -1;
+  }
+  g_runtime_bandwidth_bench_max_bytes = maxBytes;
+  return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_runtime_bandwidth_bench_max_bytes(void) {
+  return g_runtime_bandwidth_bench_max_bytes;
+}
+
+/* Each bandwidth kernel (WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_*) is loaded from the registry by key. */
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_bandwidth_shader_key(uint32_t kernel, uint32_t keyLo, uint32_t keyHi) {
+  if (kernel >= WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COUNT) {
+    return -1;
+  }
+  g_runtime_bandwidth_shader_keys[kernel][0] = keyLo;
+  g_runtime_bandwidth_shader_keys[kernel][1] = keyHi;
+  return 0;
+}
+
+/* Shared module whose kernel_bandwidth_* exports are registered under the captured bench keys. */
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_bandwidth_bench_kernel_module(uint32_t moduleId) {
+  g_runtime_bandwidth_kernel_module = moduleId;
+  return 0;
+}
+
+/*
+ * Data-parallel suite: reduction, exclusive scan, 256-bin histogram and one 8-bit
+ * radix sort pass over 4k elements up to maxElements in steps of 4x, each checked
+ * in full against a host reference. 0 disables it.
+ */
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_primitive_bench_max_elements(uint32_t maxElements) {
+  if (maxElements != 0u && (maxElements < kRuntimePrimitiveMinElements || maxElements > kRuntimePrimitiveMaxElements)) {
+    return -1;
+  }
+  g_runtime_primitive_bench_max_elements = maxElements;
+  return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_runtime_primitive_bench_max_elements(void) {
+  return g_runtime_primitive_bench_max_elements;
+}
+
+/* Each primitive stage shader (WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_*) is loaded from the registry by key. */
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_primitive_shader_key(uint32_t shader, uint32_t keyLo, uint32_t keyHi) {
+  if (shader >= WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_COUNT) {
+    return -1;
+  }
+  g_runtime_primitive_shader_keys[shader][0] = keyLo;
+  g_runtime_primitive_shader_keys[shader][1] = keyHi;
+  return 0;
+}
+
+/* Shared module whose kernel_primitive_* exports are registered under the captured stage keys. */
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_primitive_bench_kernel_module(uint32_t moduleId) {
+  g_runtime_primitive_kernel_module = moduleId;
+  return 0;
+}
+
+/*
+ * Persistent mode: one smoke call submits the recorded dispatch command buffer
+ * `samples` times on the same device and pipeline. Only the fenced submit is
+ * timed; buffer resets and validation run between samples. 0 disables it.
+ */
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_persistent_samples(uint32_t samples) {
+  if (samples > WEBVULKAN_RUNTIME_PERSISTENT_MAX_SAMPLES) {
+    return -1;
+  }
+  g_runtime_persistent_samples = samples;
+  return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_runtime_persistent_samples(void) {
+  return g_runtime_persistent_samples;
+}
+
+/* Per-dispatch milliseconds of persistent sample `index` from the last smoke call, or -1. */
+EMSCRIPTEN_KEEPALIVE double webvulkan_get_runtime_persistent_sample_ms(uint32_t index) {
+  if (index >= g_runtime_persistent_samples) {
+    return -1.0;
+  }
+  return g_runtime_persistent_sample_ms[index];
+}
+
+/*
+ * Pipeline creation bench: each smoke call builds `shaders` distinct compute shaders
+ * three times (cold, with fast-path kernels registered for their keys, and through a
+ * primed VkPipelineCache) and reports p50/p99 creation latency. 0 disables it.
+ */
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_pipeline_bench_shaders(uint32_t shaders) {
+  if (shaders > WEBVULKAN_RUNTIME_PIPELINE_BENCH_MAX_SHADERS) {
+    return -1;
+  }
+  g_runtime_pipeline_bench_shaders = shaders;
+  return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_runtime_pipeline_bench_shaders(void) {
+  return g_runtime_pipeline_bench_shaders;
+}
+
+/* Pipeline create/destroy cycles run by the next smoke call, sampling the heap footprint after each. */
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_memory_growth_cycles(uint32_t cycles) {
+  if (cycles > WEBVULKAN_RUNTIME_MEMORY_GROWTH_MAX_CYCLES) {
+    return -1;
+  }
+  g_runtime_memory_growth_cycles = cycles;
+  return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_runtime_memory_growth_cycles(void) {
+  return g_runtime_memory_growth_cycles;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_runtime_memory_growth_sample_count(void) {
+  return g_runtime_memory_growth_sample_count;
+}
+
+/* One WEBVULKAN_RUNTIME_MEMORY_* value of a growth sample from the last smoke call. */
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_runtime_memory_growth_sample(uint32_t sample, uint32_t field) {
+  if (sample >= g_runtime_memory_growth_sample_count || field >= WEBVULKAN_RUNTIME_MEMORY_COUNT) {
+    return 0u;
+  }
+  return g_runtime_memory_growth_samples[sample].values[field];
+}
+
+/* Shared-module export the bundle state registers under every captured bench key. */
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_pipeline_bench_kernel(uint32_t moduleId, const char* exportName) {
+  if (!exportName || strlen(exportName) >= WEBVULKAN_RUNTIME_PIPELINE_KERNEL_EXPORT_MAX) {
+    return -1;
+  }
+  g_runtime_pipeline_bench_kernel_module = moduleId;
+  strcpy(g_runtime_pipeline_bench_kernel_export, exportName);
+  return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE int webvulkan_set_runtime_specialization_constants(uint32_t tileSize, uint32_t tileRepeats) {
+  if (tileSize == 0u || tileRepeats == 0u) {
+    return -1;
+  }
+  g_runtime_spec_constants[0] = tileSize;
+  g_runtime_spec_constants[1] = tileRepeats;
+  uint32_t specializationKey = WEBVULKAN_RUNTIME_NO_SPECIALIZATION_KEY;
+  return webvulkan_runtime_intern_specialization(
+    g_runtime_spec_entries,
+    2u,
+    (const uint8_t*)g_runtime_spec_constants,
+    (uint32_t)sizeof(g_runtime_spec_constants),
+    &specializationKey
+  );
+}
+
+/* Interned key of the current constants; interning an already seen set returns its id. */
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_runtime_specialization_key(void) {
+  uint32_t specializationKey = WEBVULKAN_RUNTIME_NO_SPECIALIZATION_KEY;
+  webvulkan_runtime_intern_specialization(
+    g_runtime_spec_entries,
+    2u,
+    (const uint8_t*)g_runtime_spec_constants,
+    (uint32_t)sizeof(g_runtime_spec_constants),
+    &specializationKey
+  );
+  return specializationKey;
+}
+
+/*
+ * Interns the current constants again with the map entries reversed, then with the
+ * second value changed: the first must give the same key, the second a new one.
+ */
+EMSCRIPTEN_KEEPALIVE int webvulkan_check_runtime_specialization_identity(void) {
+  const WebVulkanRuntimeSpecializationEntry reversedEntries[2] = { g_runtime_spec_entries[1], g_runtime_spec_entries[0] };
+  const uint32_t changedConstants[2] = { g_runtime_spec_constants[0], g_runtime_spec_constants[1] + 1u };
+  const uint32_t specializationKey = webvulkan_get_runtime_specialization_key();
+  uint32_t reversedKey = WEBVULKAN_RUNTIME_NO_SPECIALIZATION_KEY;
+  uint32_t changedKey = WEBVULKAN_RUNTIME_NO_SPECIALIZATION_KEY;
+  if (specializationKey == WEBVULKAN_RUNTIME_NO_SPECIALIZATION_KEY) {
+    return -1;
+  }
+  if (webvulkan_runtime_intern_specialization(
+        reversedEntries,
+        2u,
+        (const uint8_t*)g_runtime_spec_constants,
+        (uint32_t)sizeof(g_runtime_spec_constants),
+        &reversedKey
+      ) != 0 ||
+      reversedKey != specializationKey) {
+    return -2;
+  }
+  if (webvulkan_runtime_intern_specialization(
+        g_runtime_spec_entries,
+        2u,
+        (const uint8_t*)changedConstants,
+        (uint32_t)sizeof(changedConstants),
+        &changedKey
+      ) != 0 ||
+      changedKey == specializationKey) {
+    return -3;
+  }
+  return 0;
+}
+
 static const char* webvulkan_get_runtime_shader_workload_name(uint32_t workload) {
   switch (workload) {
   case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_WRITE_CONST:
@@ -87,6 +709,22 @@ static const char* webvulkan_get_runtime_shader_workload_name(uint32_t workload)
     return "atomic_per_workgroup";
   case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_NO_RACE_UNIQUE_WRITES:
     return "no_race_unique_writes";
+  case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_ATOMIC_SHARDED_HISTOGRAM:
+    return "atomic_sharded_histogram";
+  case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_GROUPSHARED_REDUCTION:
+    return "groupshared_reduction";
+  case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_GROUPSHARED_SCAN:
+    return "groupshared_scan";
+  case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_SUBGROUP_REDUCTION:
+    return "subgroup_reduction";
+  case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_SPEC_CONSTANT_TILES:
+    return "spec_constant_tiles";
+  case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_BUFFER_COPY:
+    return "buffer_copy";
+  case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_PUSH_CONSTANT_PARAM:
+    return "push_constant_param";
+  case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_IMAGE_BOX_FILTER:
+    return "image_box_filter";
   default:
     return "unknown";
   }
@@ -99,6 +737,202 @@ static uint32_t webvulkan_get_runtime_shader_workgroup_size_x(uint32_t workload)
   return 64u;
 }
 
+static const char* webvulkan_get_runtime_param_mode_name(uint32_t paramMode) {
+  switch (paramMode) {
+  case WEBVULKAN_RUNTIME_PARAM_MODE_PUSH_CONSTANT:
+    return "push_constant";
+  case WEBVULKAN_RUNTIME_PARAM_MODE_DESCRIPTOR:
+    return "descriptor";
+  default:
+    return "none";
+  }
+}
+
+static uint32_t webvulkan_runtime_groupshared_prefix_sum(uint32_t lane) {
+  return ((lane + 1u) * (lane + 2u)) / 2u;
+}
+
+static uint32_t webvulkan_runtime_copy_pattern(uint32_t index) {
+  return (index * 2654435761u) ^ 0xa5a5a5a5u;
+}
+
+static uint32_t webvulkan_runtime_image_pattern(uint32_t x, uint32_t y) {
+  return ((x * 31u) ^ (y * 17u)) & 0xffffu;
+}
+
+/* Host reference for image_box_filter: 3x3 sum with clamp-to-edge texel fetches. */
+static uint32_t webvulkan_runtime_image_box_filter_reference(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+  uint32_t sum = 0u;
+  for (int32_t dy = -1; dy <= 1; ++dy) {
+    for (int32_t dx = -1; dx <= 1; ++dx) {
+      int32_t sx = (int32_t)x + dx;
+      int32_t sy = (int32_t)y + dy;
+      sx = sx < 0 ? 0 : (sx >= (int32_t)width ? (int32_t)width - 1 : sx);
+      sy = sy < 0 ? 0 : (sy >= (int32_t)height ? (int32_t)height - 1 : sy);
+      sum += webvulkan_runtime_image_pattern((uint32_t)sx, (uint32_t)sy);
+    }
+  }
+  return sum;
+}
+
+/* Host reference for render_ps: R = x & 255, G = y & 255, B = A = 255, packed as RGBA8. */
+static uint32_t webvulkan_runtime_render_gradient_reference(uint32_t x, uint32_t y) {
+  return (x & 255u) | ((y & 255u) << 8u) | 0xffff0000u;
+}
+
+/* Texel (x, y) of the textured_quads source image, packed as RGBA8. */
+static uint32_t webvulkan_runtime_render_texel(uint32_t x, uint32_t y) {
+  return ((x * 4u) & 255u) | (((y * 4u) & 255u) << 8u) | ((((x ^ y) * 4u) & 255u) << 16u) | 0xff000000u;
+}
+
+/* Expected pixel (x, y) for a scene; texture_ps loads texel (x & 63, y & 63) without filtering. */
+static uint32_t webvulkan_runtime_render_reference(uint32_t scene, uint32_t x, uint32_t y) {
+  switch (scene) {
+    case WEBVULKAN_RUNTIME_RENDER_SCENE_CLEAR:
+      return kRuntimeRenderClearColor;
+    case WEBVULKAN_RUNTIME_RENDER_SCENE_TEXTURED_QUADS:
+      return webvulkan_runtime_render_texel(x % kRuntimeRenderTextureSize, y % kRuntimeRenderTextureSize);
+    case WEBVULKAN_RUNTIME_RENDER_SCENE_BLEND:
+      return kRuntimeRenderBlendColor;
+    default:
+      return webvulkan_runtime_render_gradient_reference(x, y);
+  }
+}
+
+/* Blending (1, 0, 0, 0.5) over the clear color lands on x.5 in blue, so blended channels may round either way. */
+static int webvulkan_runtime_render_pixel_matches(uint32_t scene, uint32_t expected, uint32_t observed) {
+  if (scene != WEBVULKAN_RUNTIME_RENDER_SCENE_BLEND) {
+    return expected == observed;
+  }
+  for (uint32_t channel = 0u; channel < 4u; ++channel) {
+    const uint32_t e = (expected >> (channel * 8u)) & 255u;
+    const uint32_t o = (observed >> (channel * 8u)) & 255u;
+    if ((e > o ? e - o : o - e) > 1u) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* Input position of vertex v: a 1024-wide grid of small integers, exact in float. */
+static void webvulkan_runtime_vertex_position(uint32_t v, float* position) {
+  position[0] = (float)(v & 1023u);
+  position[1] = (float)(v >> 10u);
+  position[2] = (float)(v & 7u);
+  position[3] = 1.0f;
+}
+
+/* Host reference for vertex_vs: xy * 0.5 + 0.25, z and w unchanged. */
+static void webvulkan_runtime_vertex_transform(float* position) {
+  position[0] = position[0] * 0.5f + 0.25f;
+  position[1] = position[1] * 0.5f + 0.25f;
+}
+
+/*
+ * Host reference for bandwidth kernel `kernel` at element i of its destination array
+ * after `dispatches` back-to-back dispatches. x[i] and y[i] start as copy patterns;
+ * gather reads x as a rows x 16 matrix in column order.
+ */
+static uint32_t webvulkan_runtime_bandwidth_reference(uint32_t kernel, uint32_t i, uint32_t elements, uint32_t dispatches) {
+  const uint32_t x = webvulkan_runtime_copy_pattern(i);
+  const uint32_t y = webvulkan_runtime_copy_pattern(elements + i);
+  const uint32_t rows = elements / kRuntimeBandwidthGatherColumns;
+  switch (kernel) {
+  case WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_SAXPY:
+    return y + dispatches * kRuntimeBandwidthScale * x;
+  case WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_TRIAD:
+    return x + kRuntimeBandwidthScale * y;
+  case WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_GATHER:
+    return webvulkan_runtime_copy_pattern(((i % rows) * kRuntimeBandwidthGatherColumns) + (i / rows));
+  default:
+    return x;
+  }
+}
+
+/*
+ * Host reference for one primitive over copy-pattern keys. reduce returns the sum;
+ * exclusive_scan and radix_pass fill `out` with `elements` words; histogram fills
+ * `bins`. radix_pass is a stable counting sort on the 8-bit digit at `shift`.
+ */
+static uint32_t webvulkan_runtime_primitive_reference(
+  uint32_t primitive,
+  uint32_t elements,
+  uint32_t shift,
+  uint32_t* out,
+  uint32_t* bins
+) {
+  uint32_t sum = 0u;
+  memset(bins, 0, sizeof(uint32_t) * WEBVULKAN_RUNTIME_PRIMITIVE_HISTOGRAM_BINS);
+  switch (primitive) {
+  case WEBVULKAN_RUNTIME_PRIMITIVE_SCAN:
+    for (uint32_t i = 0u; i < elements; ++i) {
+      out[i] = sum;
+      sum += webvulkan_runtime_copy_pattern(i);
+    }
+    break;
+  case WEBVULKAN_RUNTIME_PRIMITIVE_HISTOGRAM:
+    for (uint32_t i = 0u; i < elements; ++i) {
+      bins[webvulkan_runtime_copy_pattern(i) & 255u] += 1u;
+    }
+    break;
+  case WEBVULKAN_RUNTIME_PRIMITIVE_RADIX_PASS:
+    for (uint32_t i = 0u; i < elements; ++i) {
+      bins[(webvulkan_runtime_copy_pattern(i) >> shift) & 255u] += 1u;
+    }
+    for (uint32_t digit = 0u; digit < WEBVULKAN_RUNTIME_PRIMITIVE_HISTOGRAM_BINS; ++digit) {
+      const uint32_t count = bins[digit];
+      bins[digit] = sum;
+      sum += count;
+    }
+    for (uint32_t i = 0u; i < elements; ++i) {
+      const uint32_t key = webvulkan_runtime_copy_pattern(i);
+      out[bins[(key >> shift) & 255u]++] = key;
+    }
+    break;
+  default:
+    for (uint32_t i = 0u; i < elements; ++i) {
+      sum += webvulkan_runtime_copy_pattern(i);
+    }
+    break;
+  }
+  return sum;
+}
+
+static const char* webvulkan_get_runtime_transfer_op_name(uint32_t op) {
+  switch (op) {
+  case WEBVULKAN_RUNTIME_TRANSFER_OP_FILL:
+    return "fill";
+  case WEBVULKAN_RUNTIME_TRANSFER_OP_COPY:
+    return "copy";
+  case WEBVULKAN_RUNTIME_TRANSFER_OP_UPDATE:
+    return "update";
+  default:
+    return "unknown";
+  }
+}
+
+static double webvulkan_runtime_gbps(double bytes, double ms) {
+  return ms > 0.0 ? bytes / (ms * 1.0e6) : 0.0;
+}
+
+/* Nearest-rank percentile; sorts samples in place. */
+static double webvulkan_runtime_percentile_ms(double* samples, uint32_t count, uint32_t percent) {
+  if (count == 0u) {
+    return -1.0;
+  }
+  for (uint32_t i = 1u; i < count; ++i) {
+    const double sample = samples[i];
+    uint32_t j = i;
+    while (j > 0u && samples[j - 1u] > sample) {
+      samples[j] = samples[j - 1u];
+      --j;
+    }
+    samples[j] = sample;
+  }
+  const uint32_t rank = (percent * count + 99u) / 100u;
+  return samples[rank > 0u ? rank - 1u : 0u];
+}
+
 static const uint32_t kSmokeComputeSpirv[] = {
   0x07230203u, 0x00010000u, 0x0008000bu, 0x00000012u, 0x00000000u, 0x00020011u, 0x00000001u, 0x0006000bu,
   0x00000001u, 0x4c534c47u, 0x6474732eu, 0x3035342eu, 0x00000000u, 0x0003000eu, 0x00000000u, 0x00000001u,
@@ -120,6 +954,8 @@ static const uint32_t kSmokeComputeSpirv[] = {
 };
 
 static const uint32_t kEmbeddedExpectedDispatchValue = 0x12345678u;
+/* Word of kSmokeComputeSpirv holding the OpConstant the shader stores. */
+static const uint32_t kSmokeComputeConstantWordIndex = 98u;
 
 static int string_contains(const char* haystack, const char* needle) {
   return haystack && needle && strstr(haystack, needle) != 0;
@@ -173,44 +1009,3046 @@ static uint32_t find_memory_type_index(
     if ((flags & requiredFlags) != requiredFlags) {
       continue;
     }
-    if ((flags & preferredFlags) == preferredFlags) {
-      if (hasPreferredFlags) {
-        *hasPreferredFlags = 1;
-      }
-      return i;
+    if ((flags & preferredFlags) == preferredFlags) {
+      if (hasPreferredFlags) {
+        *hasPreferredFlags = 1;
+      }
+      return i;
+    }
+    if (fallbackIndex == UINT32_MAX) {
+      fallbackIndex = i;
+    }
+  }
+
+  return fallbackIndex;
+}
+
+static PFN_vkVoidFunction webvulkan_load_device_proc(
+  PFN_vkGetDeviceProcAddr primaryGetDeviceProcAddr,
+  PFN_vkGetDeviceProcAddr secondaryGetDeviceProcAddr,
+  VkDevice device,
+  const char* name
+) {
+  PFN_vkVoidFunction proc = 0;
+  if (device != VK_NULL_HANDLE && primaryGetDeviceProcAddr) {
+    proc = primaryGetDeviceProcAddr(device, name);
+  }
+  if (!proc && device != VK_NULL_HANDLE && secondaryGetDeviceProcAddr) {
+    proc = secondaryGetDeviceProcAddr(device, name);
+  }
+  return proc;
+}
+
+/*
+ * With webvulkan_runtime_trace_enable(...) on, the smoke routes these entrypoints
+ * through the wrappers below so every bench's module, pipeline, submit and fence
+ * wait shows up as a trace span without touching each call site.
+ */
+static PFN_vkCreateShaderModule g_runtime_traced_create_shader_module = 0;
+static PFN_vkCreateComputePipelines g_runtime_traced_create_compute_pipelines = 0;
+static PFN_vkCreateGraphicsPipelines g_runtime_traced_create_graphics_pipelines = 0;
+static PFN_vkQueueSubmit g_runtime_traced_queue_submit = 0;
+static PFN_vkWaitForFences g_runtime_traced_wait_for_fences = 0;
+
+static VKAPI_ATTR VkResult VKAPI_CALL webvulkan_traced_create_shader_module(
+  VkDevice device,
+  const VkShaderModuleCreateInfo* createInfo,
+  const VkAllocationCallbacks* allocator,
+  VkShaderModule* shaderModule
+) {
+  webvulkan_runtime_trace_begin(WEBVULKAN_RUNTIME_TRACE_SHADER_MODULE_CREATE, (uint32_t)createInfo->codeSize);
+  const VkResult rc = g_runtime_traced_create_shader_module(device, createInfo, allocator, shaderModule);
+  webvulkan_runtime_trace_end(WEBVULKAN_RUNTIME_TRACE_SHADER_MODULE_CREATE);
+  return rc;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL webvulkan_traced_create_compute_pipelines(
+  VkDevice device,
+  VkPipelineCache pipelineCache,
+  uint32_t createInfoCount,
+  const VkComputePipelineCreateInfo* createInfos,
+  const VkAllocationCallbacks* allocator,
+  VkPipeline* pipelines
+) {
+  webvulkan_runtime_trace_begin(WEBVULKAN_RUNTIME_TRACE_PIPELINE_CREATE, createInfoCount);
+  const VkResult rc =
+    g_runtime_traced_create_compute_pipelines(device, pipelineCache, createInfoCount, createInfos, allocator, pipelines);
+  webvulkan_runtime_trace_end(WEBVULKAN_RUNTIME_TRACE_PIPELINE_CREATE);
+  return rc;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL webvulkan_traced_create_graphics_pipelines(
+  VkDevice device,
+  VkPipelineCache pipelineCache,
+  uint32_t createInfoCount,
+  const VkGraphicsPipelineCreateInfo* createInfos,
+  const VkAllocationCallbacks* allocator,
+  VkPipeline* pipelines
+) {
+  webvulkan_runtime_trace_begin(WEBVULKAN_RUNTIME_TRACE_PIPELINE_CREATE, createInfoCount);
+  const VkResult rc =
+    g_runtime_traced_create_graphics_pipelines(device, pipelineCache, createInfoCount, createInfos, allocator, pipelines);
+  webvulkan_runtime_trace_end(WEBVULKAN_RUNTIME_TRACE_PIPELINE_CREATE);
+  return rc;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL webvulkan_traced_queue_submit(
+  VkQueue queue,
+  uint32_t submitCount,
+  const VkSubmitInfo* submits,
+  VkFence fence
+) {
+  webvulkan_runtime_trace_begin(WEBVULKAN_RUNTIME_TRACE_QUEUE_SUBMIT, submitCount);
+  const VkResult rc = g_runtime_traced_queue_submit(queue, submitCount, submits, fence);
+  webvulkan_runtime_trace_end(WEBVULKAN_RUNTIME_TRACE_QUEUE_SUBMIT);
+  return rc;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL webvulkan_traced_wait_for_fences(
+  VkDevice device,
+  uint32_t fenceCount,
+  const VkFence* fences,
+  VkBool32 waitAll,
+  uint64_t timeout
+) {
+  webvulkan_runtime_trace_begin(WEBVULKAN_RUNTIME_TRACE_FENCE_WAIT, fenceCount);
+  const VkResult rc = g_runtime_traced_wait_for_fences(device, fenceCount, fences, waitAll, timeout);
+  webvulkan_runtime_trace_end(WEBVULKAN_RUNTIME_TRACE_FENCE_WAIT);
+  return rc;
+}
+
+/*
+ * Device memory goes through these two wrappers on every smoke call, so the registry's
+ * VkDeviceMemory figure matches what is live. vkFreeMemory only gets the handle; the
+ * size comes from the table filled at allocation.
+ */
+static PFN_vkAllocateMemory g_runtime_accounted_allocate_memory = 0;
+static PFN_vkFreeMemory g_runtime_accounted_free_memory = 0;
+
+static VKAPI_ATTR VkResult VKAPI_CALL webvulkan_accounted_allocate_memory(
+  VkDevice device,
+  const VkMemoryAllocateInfo* allocateInfo,
+  const VkAllocationCallbacks* allocator,
+  VkDeviceMemory* memory
+) {
+  const VkResult rc = g_runtime_accounted_allocate_memory(device, allocateInfo, allocator, memory);
+  if (rc != VK_SUCCESS) {
+    return rc;
+  }
+  const uint32_t bytes = (uint32_t)allocateInfo->allocationSize;
+  webvulkan_runtime_record_device_memory(bytes, 1);
+  for (uint32_t i = 0u; i < WEBVULKAN_RUNTIME_TRACKED_DEVICE_MEMORY_MAX; ++i) {
+    if (g_runtime_tracked_device_memory[i].memory == VK_NULL_HANDLE) {
+      g_runtime_tracked_device_memory[i].memory = *memory;
+      g_runtime_tracked_device_memory[i].bytes = bytes;
+      break;
+    }
+  }
+  return rc;
+}
+
+static VKAPI_ATTR void VKAPI_CALL webvulkan_accounted_free_memory(
+  VkDevice device,
+  VkDeviceMemory memory,
+  const VkAllocationCallbacks* allocator
+) {
+  for (uint32_t i = 0u; i < WEBVULKAN_RUNTIME_TRACKED_DEVICE_MEMORY_MAX && memory != VK_NULL_HANDLE; ++i) {
+    if (g_runtime_tracked_device_memory[i].memory == memory) {
+      webvulkan_runtime_record_device_memory(g_runtime_tracked_device_memory[i].bytes, 0);
+      g_runtime_tracked_device_memory[i].memory = VK_NULL_HANDLE;
+      g_runtime_tracked_device_memory[i].bytes = 0u;
+      break;
+    }
+  }
+  g_runtime_accounted_free_memory(device, memory, allocator);
+}
+
+/*
+ * Destroying a device frees its memory without vkFreeMemory calls, and a successful
+ * smoke returns with its device still alive so the host can read the mapped storage.
+ * Either way the table still holds those handles; drop them from the registry figure.
+ */
+static void webvulkan_release_tracked_device_memory(void) {
+  for (uint32_t i = 0u; i < WEBVULKAN_RUNTIME_TRACKED_DEVICE_MEMORY_MAX; ++i) {
+    if (g_runtime_tracked_device_memory[i].memory != VK_NULL_HANDLE) {
+      webvulkan_runtime_record_device_memory(g_runtime_tracked_device_memory[i].bytes, 0);
+      g_runtime_tracked_device_memory[i].memory = VK_NULL_HANDLE;
+      g_runtime_tracked_device_memory[i].bytes = 0u;
+    }
+  }
+}
+
+EMSCRIPTEN_KEEPALIVE double webvulkan_get_last_dispatch_ms(void) {
+  return g_last_dispatch_wall_ms;
+}
+
+/* Mapped range of the last smoke's storage buffer; fast kernels must write inside it. */
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_last_mapped_storage_base(void) {
+  return g_last_mapped_storage_base;
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_last_mapped_storage_bytes(void) {
+  return g_last_mapped_storage_bytes;
+}
+
+/*
+ * Storage address the buffer_copy Wasm kernel wrote after the copy destination in the
+ * last smoke, or 0 when no kernel wrote one. The llvmpipe shader leaves the word alone.
+ */
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_last_kernel_storage_address(void) {
+  return g_last_kernel_storage_address;
+}
+
+/* Submits of one bandwidth kernel that the driver ran on the Wasm path, across every size of the last smoke. */
+EMSCRIPTEN_KEEPALIVE uint32_t webvulkan_get_last_bandwidth_wasm_submits(uint32_t kernel) {
+  if (kernel >= WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COUNT) {
+    return 0u;
+  }
+  return g_last_bandwidth_wasm_submits[kernel];
+}
+
+/*
+ * Device state lavapipe_runtime_smoke hands to its bench helpers. The entry points
+ * are the resolved ones, tracing and memory accounting wrappers included.
+ */
+typedef struct WebVulkanRuntimeSmokeDevice {
+  VkPhysicalDevice physicalDevice;
+  VkPhysicalDeviceMemoryProperties memoryProperties;
+  VkDevice device;
+  VkQueue queue;
+  VkFence submitFence;
+  VkCommandBufferAllocateInfo commandBufferAllocateInfo;
+  VkCommandBufferBeginInfo commandBufferBeginInfo;
+  PFN_vkDestroyDevice pfnDestroyDevice;
+  PFN_vkGetPhysicalDeviceMemoryProperties pfnGetPhysicalDeviceMemoryProperties;
+  PFN_vkCreateShaderModule pfnCreateShaderModule;
+  PFN_vkDestroyShaderModule pfnDestroyShaderModule;
+  PFN_vkCreateDescriptorSetLayout pfnCreateDescriptorSetLayout;
+  PFN_vkDestroyDescriptorSetLayout pfnDestroyDescriptorSetLayout;
+  PFN_vkCreateDescriptorPool pfnCreateDescriptorPool;
+  PFN_vkDestroyDescriptorPool pfnDestroyDescriptorPool;
+  PFN_vkAllocateDescriptorSets pfnAllocateDescriptorSets;
+  PFN_vkUpdateDescriptorSets pfnUpdateDescriptorSets;
+  PFN_vkCreatePipelineLayout pfnCreatePipelineLayout;
+  PFN_vkDestroyPipelineLayout pfnDestroyPipelineLayout;
+  PFN_vkCreateComputePipelines pfnCreateComputePipelines;
+  PFN_vkDestroyPipeline pfnDestroyPipeline;
+  PFN_vkCreatePipelineCache pfnCreatePipelineCache;
+  PFN_vkDestroyPipelineCache pfnDestroyPipelineCache;
+  PFN_vkCreateBuffer pfnCreateBuffer;
+  PFN_vkDestroyBuffer pfnDestroyBuffer;
+  PFN_vkGetBufferMemoryRequirements pfnGetBufferMemoryRequirements;
+  PFN_vkAllocateMemory pfnAllocateMemory;
+  PFN_vkFreeMemory pfnFreeMemory;
+  PFN_vkBindBufferMemory pfnBindBufferMemory;
+  PFN_vkMapMemory pfnMapMemory;
+  PFN_vkUnmapMemory pfnUnmapMemory;
+  PFN_vkGetDeviceQueue pfnGetDeviceQueue;
+  PFN_vkCreateCommandPool pfnCreateCommandPool;
+  PFN_vkDestroyCommandPool pfnDestroyCommandPool;
+  PFN_vkAllocateCommandBuffers pfnAllocateCommandBuffers;
+  PFN_vkBeginCommandBuffer pfnBeginCommandBuffer;
+  PFN_vkEndCommandBuffer pfnEndCommandBuffer;
+  PFN_vkCmdBindPipeline pfnCmdBindPipeline;
+  PFN_vkCmdBindDescriptorSets pfnCmdBindDescriptorSets;
+  PFN_vkCmdDispatch pfnCmdDispatch;
+  PFN_vkCmdDispatchIndirect pfnCmdDispatchIndirect;
+  PFN_vkCmdFillBuffer pfnCmdFillBuffer;
+  PFN_vkCmdCopyBuffer pfnCmdCopyBuffer;
+  PFN_vkCmdUpdateBuffer pfnCmdUpdateBuffer;
+  PFN_vkCmdPipelineBarrier pfnCmdPipelineBarrier;
+  PFN_vkCmdPushConstants pfnCmdPushConstants;
+  PFN_vkCreateImage pfnCreateImage;
+  PFN_vkDestroyImage pfnDestroyImage;
+  PFN_vkGetImageMemoryRequirements pfnGetImageMemoryRequirements;
+  PFN_vkBindImageMemory pfnBindImageMemory;
+  PFN_vkGetImageSubresourceLayout pfnGetImageSubresourceLayout;
+  PFN_vkCreateImageView pfnCreateImageView;
+  PFN_vkDestroyImageView pfnDestroyImageView;
+  PFN_vkCreateFence pfnCreateFence;
+  PFN_vkDestroyFence pfnDestroyFence;
+  PFN_vkQueueSubmit pfnQueueSubmit;
+  PFN_vkWaitForFences pfnWaitForFences;
+  PFN_vkResetFences pfnResetFences;
+  PFN_vkCreateRenderPass pfnCreateRenderPass;
+  PFN_vkDestroyRenderPass pfnDestroyRenderPass;
+  PFN_vkCreateFramebuffer pfnCreateFramebuffer;
+  PFN_vkDestroyFramebuffer pfnDestroyFramebuffer;
+  PFN_vkCreateGraphicsPipelines pfnCreateGraphicsPipelines;
+  PFN_vkCmdBeginRenderPass pfnCmdBeginRenderPass;
+  PFN_vkCmdEndRenderPass pfnCmdEndRenderPass;
+  PFN_vkCmdDraw pfnCmdDraw;
+  PFN_vkCmdBindVertexBuffers pfnCmdBindVertexBuffers;
+  PFN_vkCmdSetViewport pfnCmdSetViewport;
+  PFN_vkCmdSetScissor pfnCmdSetScissor;
+} WebVulkanRuntimeSmokeDevice;
+
+/*
+ * Times module and pipeline creation for `pipelineBenchShaders` distinct shaders in
+ * each pipeline state. The cold pass registers the bench kernel for the keys it captured.
+ */
+static int webvulkan_run_runtime_pipeline_bench(
+  const WebVulkanRuntimeSmokeDevice* dev,
+  uint32_t pipelineBenchShaders,
+  const VkDeviceCreateInfo* deviceCreateInfo,
+  const VkDescriptorSetLayoutCreateInfo* descriptorSetLayoutCreateInfo,
+  const VkPipelineLayoutCreateInfo* pipelineLayoutCreateInfo,
+  const VkComputePipelineCreateInfo* pipelineCreateInfo,
+  uint32_t shaderKeyLo,
+  uint32_t shaderKeyHi,
+  WebVulkanRuntimePipelineStateSample* pipelineStateSamples,
+  uint32_t* outKeyCount,
+  uint32_t* outBundleCount
+) {
+  const VkDevice device = dev->device;
+  uint32_t pipelineBenchCode[sizeof(kSmokeComputeSpirv) / sizeof(kSmokeComputeSpirv[0])];
+  VkPipelineCache pipelineBenchCache = VK_NULL_HANDLE;
+  VkShaderModule pipelineBenchModule = VK_NULL_HANDLE;
+  VkPipeline pipelineBenchPipeline = VK_NULL_HANDLE;
+  /* The bundle state builds on its own device so the cold pass leaves nothing warm behind. */
+  VkDevice pipelineBenchDevice = VK_NULL_HANDLE;
+  VkDevice pipelineBenchStateDevice = VK_NULL_HANDLE;
+  VkDescriptorSetLayout pipelineBenchSetLayout = VK_NULL_HANDLE;
+  VkPipelineLayout pipelineBenchLayout = VK_NULL_HANDLE;
+  uint32_t pipelineBenchKeys[WEBVULKAN_RUNTIME_PIPELINE_BENCH_MAX_SHADERS][2];
+  uint32_t pipelineBenchKeyCount = 0u;
+  uint32_t pipelineBenchBundleCount = 0u;
+  int smokeRc = 0;
+  VkResult rc = VK_SUCCESS;
+
+  if (!dev->pfnCreatePipelineCache || !dev->pfnDestroyPipelineCache) {
+    printf("lavapipe runtime smoke missing pipeline cache entrypoints\n");
+    printf("  vkCreatePipelineCache=%s\n", dev->pfnCreatePipelineCache ? "present" : "missing");
+    printf("  vkDestroyPipelineCache=%s\n", dev->pfnDestroyPipelineCache ? "present" : "missing");
+    smokeRc = 112;
+    goto cleanup;
+  }
+  /* Bench pipelines overwrite the captured key; the JS side still reads the main one. */
+  const int savedShaderKeyValid = webvulkan_runtime_has_captured_shader_key();
+  const uint32_t savedShaderKeyLo = webvulkan_runtime_get_captured_shader_key_lo();
+  const uint32_t savedShaderKeyHi = webvulkan_runtime_get_captured_shader_key_hi();
+
+  VkPipelineCacheCreateInfo pipelineCacheCreateInfo;
+  memset(&pipelineCacheCreateInfo, 0, sizeof(pipelineCacheCreateInfo));
+  pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  rc = dev->pfnCreatePipelineCache(device, &pipelineCacheCreateInfo, 0, &pipelineBenchCache);
+  if (rc != VK_SUCCESS || pipelineBenchCache == VK_NULL_HANDLE) {
+    smokeRc = 112;
+    goto cleanup;
+  }
+
+  /* Shader i stores a different constant, so every module hashes to its own key. */
+  memcpy(pipelineBenchCode, kSmokeComputeSpirv, sizeof(pipelineBenchCode));
+  VkShaderModuleCreateInfo pipelineBenchModuleInfo;
+  memset(&pipelineBenchModuleInfo, 0, sizeof(pipelineBenchModuleInfo));
+  pipelineBenchModuleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+  pipelineBenchModuleInfo.codeSize = sizeof(pipelineBenchCode);
+  pipelineBenchModuleInfo.pCode = pipelineBenchCode;
+  VkComputePipelineCreateInfo pipelineBenchCreateInfo = *pipelineCreateInfo;
+  pipelineBenchCreateInfo.stage.pName = "main";
+  pipelineBenchCreateInfo.stage.pSpecializationInfo = 0;
+
+  memset(pipelineStateSamples, 0, sizeof(*pipelineStateSamples) * WEBVULKAN_RUNTIME_PIPELINE_STATE_COUNT);
+  for (uint32_t state = 0u; state < WEBVULKAN_RUNTIME_PIPELINE_STATE_COUNT; ++state) {
+    const VkPipelineCache statePipelineCache =
+      state == WEBVULKAN_RUNTIME_PIPELINE_STATE_CACHE ? pipelineBenchCache : VK_NULL_HANDLE;
+    /* The cache state primes the cache untimed; its timed pass only sees hits. */
+    const uint32_t statePasses = state == WEBVULKAN_RUNTIME_PIPELINE_STATE_CACHE ? 2u : 1u;
+    WebVulkanRuntimePipelineStateSample* stateSample = &pipelineStateSamples[state];
+    pipelineBenchStateDevice = device;
+    pipelineBenchCreateInfo.layout = pipelineCreateInfo->layout;
+    if (state == WEBVULKAN_RUNTIME_PIPELINE_STATE_BUNDLE) {
+      rc = vkCreateDevice(dev->physicalDevice, deviceCreateInfo, 0, &pipelineBenchDevice);
+      if (rc != VK_SUCCESS || pipelineBenchDevice == VK_NULL_HANDLE) {
+        smokeRc = 128;
+        goto cleanup;
+      }
+      rc = dev->pfnCreateDescriptorSetLayout(pipelineBenchDevice, descriptorSetLayoutCreateInfo, 0, &pipelineBenchSetLayout);
+      if (rc != VK_SUCCESS || pipelineBenchSetLayout == VK_NULL_HANDLE) {
+        smokeRc = 128;
+        goto cleanup;
+      }
+      VkPipelineLayoutCreateInfo pipelineBenchLayoutInfo = *pipelineLayoutCreateInfo;
+      pipelineBenchLayoutInfo.pSetLayouts = &pipelineBenchSetLayout;
+      rc = dev->pfnCreatePipelineLayout(pipelineBenchDevice, &pipelineBenchLayoutInfo, 0, &pipelineBenchLayout);
+      if (rc != VK_SUCCESS || pipelineBenchLayout == VK_NULL_HANDLE) {
+        smokeRc = 128;
+        goto cleanup;
+      }
+      pipelineBenchStateDevice = pipelineBenchDevice;
+      pipelineBenchCreateInfo.layout = pipelineBenchLayout;
+    }
+    WebVulkanRuntimeStageTimings stageTimingsBefore;
+    for (uint32_t pass = 0u; pass < statePasses; ++pass) {
+      const int timedPass = pass + 1u == statePasses;
+      if (timedPass) {
+        webvulkan_runtime_get_stage_timings(&stageTimingsBefore);
+      }
+      for (uint32_t shader = 0u; shader < pipelineBenchShaders; ++shader) {
+        pipelineBenchCode[kSmokeComputeConstantWordIndex] = kEmbeddedExpectedDispatchValue + 1u + shader;
+        const double moduleStartMs = emscripten_get_now();
+        rc = dev->pfnCreateShaderModule(pipelineBenchStateDevice, &pipelineBenchModuleInfo, 0, &pipelineBenchModule);
+        const double moduleEndMs = emscripten_get_now();
+        if (rc != VK_SUCCESS || pipelineBenchModule == VK_NULL_HANDLE) {
+          smokeRc = 113;
+          goto cleanup;
+        }
+        pipelineBenchCreateInfo.stage.module = pipelineBenchModule;
+        webvulkan_runtime_reset_captured_shader_key();
+        rc = dev->pfnCreateComputePipelines(
+          pipelineBenchStateDevice,
+          statePipelineCache,
+          1u,
+          &pipelineBenchCreateInfo,
+          0,
+          &pipelineBenchPipeline
+        );
+        const double pipelineEndMs = emscripten_get_now();
+        if (rc != VK_SUCCESS || pipelineBenchPipeline == VK_NULL_HANDLE) {
+          smokeRc = 113;
+          goto cleanup;
+        }
+        if (timedPass) {
+          stateSample->moduleMs[shader] = moduleEndMs - moduleStartMs;
+          stateSample->pipelineMs[shader] = pipelineEndMs - moduleEndMs;
+        }
+        if (state == WEBVULKAN_RUNTIME_PIPELINE_STATE_COLD && webvulkan_runtime_has_captured_shader_key()) {
+          const uint32_t benchKeyLo = webvulkan_runtime_get_captured_shader_key_lo();
+          const uint32_t benchKeyHi = webvulkan_runtime_get_captured_shader_key_hi();
+          if (benchKeyLo != shaderKeyLo || benchKeyHi != shaderKeyHi) {
+            pipelineBenchKeys[pipelineBenchKeyCount][0] = benchKeyLo;
+            pipelineBenchKeys[pipelineBenchKeyCount][1] = benchKeyHi;
+            pipelineBenchKeyCount += 1u;
+          }
+        }
+        dev->pfnDestroyPipeline(pipelineBenchStateDevice, pipelineBenchPipeline, 0);
+        pipelineBenchPipeline = VK_NULL_HANDLE;
+        dev->pfnDestroyShaderModule(pipelineBenchStateDevice, pipelineBenchModule, 0);
+        pipelineBenchModule = VK_NULL_HANDLE;
+      }
+    }
+    WebVulkanRuntimeStageTimings stageTimingsAfter;
+    webvulkan_runtime_get_stage_timings(&stageTimingsAfter);
+    for (uint32_t stage = 0u; stage < WEBVULKAN_RUNTIME_STAGE_COUNT; ++stage) {
+      stateSample->stageMs[stage] =
+        stageTimingsAfter.stages[stage].totalMs - stageTimingsBefore.stages[stage].totalMs;
+      stateSample->stageCalls[stage] =
+        stageTimingsAfter.stages[stage].count - stageTimingsBefore.stages[stage].count;
+    }
+
+    if (state == WEBVULKAN_RUNTIME_PIPELINE_STATE_COLD && pipelineBenchKeyCount == 0u) {
+      printf("lavapipe runtime smoke pipeline bench captured no shader keys\n");
+      smokeRc = 127;
+      goto cleanup;
+    }
+    if (state == WEBVULKAN_RUNTIME_PIPELINE_STATE_COLD &&
+        g_runtime_pipeline_bench_kernel_module != WEBVULKAN_RUNTIME_NO_SHARED_WASM_MODULE) {
+      for (uint32_t k = 0u; k < pipelineBenchKeyCount; ++k) {
+        if (webvulkan_register_runtime_wasm_kernel(
+              pipelineBenchKeys[k][0],
+              pipelineBenchKeys[k][1],
+              WEBVULKAN_RUNTIME_NO_SPECIALIZATION_KEY,
+              WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+              WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+              WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+              g_runtime_pipeline_bench_kernel_module,
+              g_runtime_pipeline_bench_kernel_export
+            ) != 0) {
+          smokeRc = 114;
+          goto cleanup;
+        }
+        pipelineBenchBundleCount += 1u;
+      }
+    }
+    if (state == WEBVULKAN_RUNTIME_PIPELINE_STATE_BUNDLE) {
+      for (uint32_t k = 0u; k < pipelineBenchBundleCount; ++k) {
+        webvulkan_runtime_unregister_shader_bundle(pipelineBenchKeys[k][0], pipelineBenchKeys[k][1]);
+      }
+      dev->pfnDestroyPipelineLayout(pipelineBenchDevice, pipelineBenchLayout, 0);
+      pipelineBenchLayout = VK_NULL_HANDLE;
+      dev->pfnDestroyDescriptorSetLayout(pipelineBenchDevice, pipelineBenchSetLayout, 0);
+      pipelineBenchSetLayout = VK_NULL_HANDLE;
+      dev->pfnDestroyDevice(pipelineBenchDevice, 0);
+      pipelineBenchDevice = VK_NULL_HANDLE;
+    }
+    pipelineBenchStateDevice = VK_NULL_HANDLE;
+  }
+
+  dev->pfnDestroyPipelineCache(device, pipelineBenchCache, 0);
+  pipelineBenchCache = VK_NULL_HANDLE;
+  if (savedShaderKeyValid) {
+    webvulkan_runtime_capture_shader_key(savedShaderKeyLo, savedShaderKeyHi);
+  } else {
+    webvulkan_runtime_reset_captured_shader_key();
+  }
+
+cleanup:
+  /* Bench kernels registered before a failure must not leak into the next smoke call. */
+  if (smokeRc != 0) {
+    for (uint32_t k = 0u; k < pipelineBenchBundleCount; ++k) {
+      webvulkan_runtime_unregister_shader_bundle(pipelineBenchKeys[k][0], pipelineBenchKeys[k][1]);
+    }
+  }
+  const VkDevice pipelineBenchObjectDevice =
+    pipelineBenchStateDevice != VK_NULL_HANDLE ? pipelineBenchStateDevice : device;
+  if (pipelineBenchPipeline != VK_NULL_HANDLE && dev->pfnDestroyPipeline) {
+    dev->pfnDestroyPipeline(pipelineBenchObjectDevice, pipelineBenchPipeline, 0);
+  }
+  if (pipelineBenchModule != VK_NULL_HANDLE && dev->pfnDestroyShaderModule) {
+    dev->pfnDestroyShaderModule(pipelineBenchObjectDevice, pipelineBenchModule, 0);
+  }
+  if (pipelineBenchLayout != VK_NULL_HANDLE && dev->pfnDestroyPipelineLayout) {
+    dev->pfnDestroyPipelineLayout(pipelineBenchDevice, pipelineBenchLayout, 0);
+  }
+  if (pipelineBenchSetLayout != VK_NULL_HANDLE && dev->pfnDestroyDescriptorSetLayout) {
+    dev->pfnDestroyDescriptorSetLayout(pipelineBenchDevice, pipelineBenchSetLayout, 0);
+  }
+  if (pipelineBenchDevice != VK_NULL_HANDLE && dev->pfnDestroyDevice) {
+    dev->pfnDestroyDevice(pipelineBenchDevice, 0);
+  }
+  if (pipelineBenchCache != VK_NULL_HANDLE && dev->pfnDestroyPipelineCache) {
+    dev->pfnDestroyPipelineCache(device, pipelineBenchCache, 0);
+  }
+  *outKeyCount = pipelineBenchKeyCount;
+  *outBundleCount = pipelineBenchBundleCount;
+  return smokeRc;
+}
+
+/* Builds and destroys the same pipeline `memoryGrowthCycles` times, sampling the footprint after each cycle. */
+static int webvulkan_run_runtime_memory_growth(
+  const WebVulkanRuntimeSmokeDevice* dev,
+  uint32_t memoryGrowthCycles,
+  const VkComputePipelineCreateInfo* pipelineCreateInfo
+) {
+  const VkDevice device = dev->device;
+  VkShaderModule growthModule = VK_NULL_HANDLE;
+  VkPipeline growthPipeline = VK_NULL_HANDLE;
+  int smokeRc = 0;
+  VkResult rc = VK_SUCCESS;
+
+  const int savedShaderKeyValid = webvulkan_runtime_has_captured_shader_key();
+  const uint32_t savedShaderKeyLo = webvulkan_runtime_get_captured_shader_key_lo();
+  const uint32_t savedShaderKeyHi = webvulkan_runtime_get_captured_shader_key_hi();
+
+  /* Every cycle builds the same module and pipeline, so a flat curve means no leak per pipeline. */
+  VkShaderModuleCreateInfo growthModuleInfo;
+  memset(&growthModuleInfo, 0, sizeof(growthModuleInfo));
+  growthModuleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+  growthModuleInfo.codeSize = sizeof(kSmokeComputeSpirv);
+  growthModuleInfo.pCode = kSmokeComputeSpirv;
+  VkComputePipelineCreateInfo growthPipelineCreateInfo = *pipelineCreateInfo;
+  growthPipelineCreateInfo.stage.pName = "main";
+  growthPipelineCreateInfo.stage.pSpecializationInfo = 0;
+
+  webvulkan_runtime_get_memory_footprint(&g_runtime_memory_growth_samples[0]);
+  g_runtime_memory_growth_sample_count = 1u;
+  for (uint32_t cycle = 0u; cycle < memoryGrowthCycles; ++cycle) {
+    const uint32_t heapBeforeBytes =
+      webvulkan_runtime_get_memory_footprint_value(WEBVULKAN_RUNTIME_MEMORY_MALLOC_IN_USE_BYTES);
+    rc = dev->pfnCreateShaderModule(device, &growthModuleInfo, 0, &growthModule);
+    if (rc != VK_SUCCESS || growthModule == VK_NULL_HANDLE) {
+      smokeRc = 126;
+      goto cleanup;
+    }
+    growthPipelineCreateInfo.stage.module = growthModule;
+    rc = dev->pfnCreateComputePipelines(device, VK_NULL_HANDLE, 1u, &growthPipelineCreateInfo, 0, &growthPipeline);
+    if (rc != VK_SUCCESS || growthPipeline == VK_NULL_HANDLE) {
+      smokeRc = 126;
+      goto cleanup;
+    }
+    /* dlmalloc in-use growth across module and pipeline creation, held until they are destroyed. */
+    const uint32_t heapAfterBytes =
+      webvulkan_runtime_get_memory_footprint_value(WEBVULKAN_RUNTIME_MEMORY_MALLOC_IN_USE_BYTES);
+    const uint32_t pipelineBytes = heapAfterBytes > heapBeforeBytes ? heapAfterBytes - heapBeforeBytes : 0u;
+    webvulkan_runtime_record_pipeline_heap_delta(pipelineBytes, 1);
+    WebVulkanRuntimeMemoryFootprint* growthSample = &g_runtime_memory_growth_samples[g_runtime_memory_growth_sample_count];
+    const uint32_t livePipelineBytes =
+      webvulkan_runtime_get_memory_footprint_value(WEBVULKAN_RUNTIME_MEMORY_PIPELINE_HEAP_DELTA_BYTES);
+    const uint32_t livePipelines =
+      webvulkan_runtime_get_memory_footprint_value(WEBVULKAN_RUNTIME_MEMORY_LIVE_PIPELINES);
+    dev->pfnDestroyPipeline(device, growthPipeline, 0);
+    growthPipeline = VK_NULL_HANDLE;
+    dev->pfnDestroyShaderModule(device, growthModule, 0);
+    growthModule = VK_NULL_HANDLE;
+    webvulkan_runtime_record_pipeline_heap_delta(pipelineBytes, 0);
+    webvulkan_runtime_get_memory_footprint(growthSample);
+    growthSample->values[WEBVULKAN_RUNTIME_MEMORY_PIPELINE_HEAP_DELTA_BYTES] = livePipelineBytes;
+    growthSample->values[WEBVULKAN_RUNTIME_MEMORY_LIVE_PIPELINES] = livePipelines;
+    g_runtime_memory_growth_sample_count += 1u;
+  }
+
+  if (savedShaderKeyValid) {
+    webvulkan_runtime_capture_shader_key(savedShaderKeyLo, savedShaderKeyHi);
+  } else {
+    webvulkan_runtime_reset_captured_shader_key();
+  }
+
+cleanup:
+  if (growthPipeline != VK_NULL_HANDLE) {
+    dev->pfnDestroyPipeline(device, growthPipeline, 0);
+  }
+  if (growthModule != VK_NULL_HANDLE) {
+    dev->pfnDestroyShaderModule(device, growthModule, 0);
+  }
+  return smokeRc;
+}
+
+/* Times fill, copy and update commands over power-of-four sizes up to `transferBenchMaxBytes`. */
+static int webvulkan_run_runtime_transfer_bench(
+  const WebVulkanRuntimeSmokeDevice* dev,
+  uint32_t transferBenchMaxBytes,
+  WebVulkanRuntimeTransferSample* transferSamples,
+  uint32_t* outSampleCount
+) {
+  const VkDevice device = dev->device;
+  const VkQueue queue = dev->queue;
+  const VkFence submitFence = dev->submitFence;
+  VkBuffer transferBuffers[2] = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+  VkDeviceMemory transferMemories[2] = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+  uint32_t* mappedTransferWords[2] = { 0, 0 };
+  VkCommandBuffer transferCommandBuffer = VK_NULL_HANDLE;
+  uint32_t transferSampleCount = 0u;
+  int smokeRc = 0;
+  VkResult rc = VK_SUCCESS;
+
+  if (!dev->pfnCmdFillBuffer || !dev->pfnCmdCopyBuffer || !dev->pfnCmdUpdateBuffer || !dev->pfnCmdPipelineBarrier) {
+    printf("lavapipe runtime smoke missing transfer entrypoints\n");
+    printf("  vkCmdFillBuffer=%s\n", dev->pfnCmdFillBuffer ? "present" : "missing");
+    printf("  vkCmdCopyBuffer=%s\n", dev->pfnCmdCopyBuffer ? "present" : "missing");
+    printf("  vkCmdUpdateBuffer=%s\n", dev->pfnCmdUpdateBuffer ? "present" : "missing");
+    printf("  vkCmdPipelineBarrier=%s\n", dev->pfnCmdPipelineBarrier ? "present" : "missing");
+    smokeRc = 89;
+    goto cleanup;
+  }
+
+  for (uint32_t b = 0u; b < 2u; ++b) {
+    VkBufferCreateInfo transferBufferCreateInfo;
+    memset(&transferBufferCreateInfo, 0, sizeof(transferBufferCreateInfo));
+    transferBufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    transferBufferCreateInfo.size = (VkDeviceSize)transferBenchMaxBytes;
+    transferBufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    transferBufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    rc = dev->pfnCreateBuffer(device, &transferBufferCreateInfo, 0, &transferBuffers[b]);
+    if (rc != VK_SUCCESS || transferBuffers[b] == VK_NULL_HANDLE) {
+      smokeRc = 90;
+      goto cleanup;
+    }
+
+    VkMemoryRequirements transferMemoryRequirements;
+    memset(&transferMemoryRequirements, 0, sizeof(transferMemoryRequirements));
+    dev->pfnGetBufferMemoryRequirements(device, transferBuffers[b], &transferMemoryRequirements);
+    int transferHostCoherent = 0;
+    const uint32_t transferMemoryTypeIndex = find_memory_type_index(
+      &dev->memoryProperties,
+      transferMemoryRequirements.memoryTypeBits,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+      &transferHostCoherent
+    );
+    if (transferMemoryTypeIndex == UINT32_MAX || !transferHostCoherent) {
+      smokeRc = 90;
+      goto cleanup;
+    }
+
+    VkMemoryAllocateInfo transferAllocateInfo;
+    memset(&transferAllocateInfo, 0, sizeof(transferAllocateInfo));
+    transferAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    transferAllocateInfo.allocationSize = transferMemoryRequirements.size;
+    transferAllocateInfo.memoryTypeIndex = transferMemoryTypeIndex;
+    rc = dev->pfnAllocateMemory(device, &transferAllocateInfo, 0, &transferMemories[b]);
+    if (rc != VK_SUCCESS || transferMemories[b] == VK_NULL_HANDLE) {
+      smokeRc = 90;
+      goto cleanup;
+    }
+    rc = dev->pfnBindBufferMemory(device, transferBuffers[b], transferMemories[b], 0u);
+    if (rc != VK_SUCCESS) {
+      smokeRc = 90;
+      goto cleanup;
+    }
+    rc = dev->pfnMapMemory(
+      device,
+      transferMemories[b],
+      0u,
+      (VkDeviceSize)transferBenchMaxBytes,
+      0u,
+      (void**)&mappedTransferWords[b]
+    );
+    if (rc != VK_SUCCESS || !mappedTransferWords[b]) {
+      smokeRc = 90;
+      goto cleanup;
+    }
+  }
+  for (uint32_t i = 0u; i < transferBenchMaxBytes / sizeof(uint32_t); ++i) {
+    mappedTransferWords[0][i] = webvulkan_runtime_copy_pattern(i);
+  }
+
+  rc = dev->pfnAllocateCommandBuffers(device, &dev->commandBufferAllocateInfo, &transferCommandBuffer);
+  if (rc != VK_SUCCESS || transferCommandBuffer == VK_NULL_HANDLE) {
+    smokeRc = 90;
+    goto cleanup;
+  }
+
+  VkMemoryBarrier transferBarrier;
+  memset(&transferBarrier, 0, sizeof(transferBarrier));
+  transferBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  transferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  transferBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+  VkSubmitInfo transferSubmitInfo;
+  memset(&transferSubmitInfo, 0, sizeof(transferSubmitInfo));
+  transferSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  transferSubmitInfo.commandBufferCount = 1u;
+  transferSubmitInfo.pCommandBuffers = &transferCommandBuffer;
+
+  for (uint32_t transferBytes = kRuntimeTransferMinBytes;
+       transferBytes <= transferBenchMaxBytes && transferSampleCount < WEBVULKAN_RUNTIME_TRANSFER_MAX_SIZE_COUNT;
+       transferBytes *= 4u) {
+    WebVulkanRuntimeTransferSample* transferSample = &transferSamples[transferSampleCount++];
+    const uint32_t transferWords = transferBytes / (uint32_t)sizeof(uint32_t);
+    uint32_t transferCommands = kRuntimeTransferBytesPerSubmit / transferBytes;
+    if (transferCommands == 0u) {
+      transferCommands = 1u;
+    }
+    if (transferCommands > kRuntimeTransferMaxCommandsPerSubmit) {
+      transferCommands = kRuntimeTransferMaxCommandsPerSubmit;
+    }
+    memset(transferSample, 0, sizeof(*transferSample));
+    transferSample->bytes = transferBytes;
+    transferSample->commandsPerSubmit = transferCommands;
+
+    for (uint32_t op = 0u; op < WEBVULKAN_RUNTIME_TRANSFER_OP_COUNT; ++op) {
+      if (op == WEBVULKAN_RUNTIME_TRANSFER_OP_UPDATE && transferBytes > kRuntimeTransferUpdateMaxBytes) {
+        transferSample->submitMs[op] = -1.0;
+        continue;
+      }
+      rc = dev->pfnBeginCommandBuffer(transferCommandBuffer, &dev->commandBufferBeginInfo);
+      if (rc != VK_SUCCESS) {
+        smokeRc = 91;
+        goto cleanup;
+      }
+      for (uint32_t command = 0u; command < transferCommands; ++command) {
+        if (command > 0u) {
+          dev->pfnCmdPipelineBarrier(
+            transferCommandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0u,
+            1u,
+            &transferBarrier,
+            0u,
+            0,
+            0u,
+            0
+          );
+        }
+        if (op == WEBVULKAN_RUNTIME_TRANSFER_OP_FILL) {
+          dev->pfnCmdFillBuffer(transferCommandBuffer, transferBuffers[1], 0u, transferBytes, kRuntimeTransferFillValue ^ command);
+        } else if (op == WEBVULKAN_RUNTIME_TRANSFER_OP_COPY) {
+          VkBufferCopy transferRegion;
+          transferRegion.srcOffset = 0u;
+          transferRegion.dstOffset = 0u;
+          transferRegion.size = transferBytes;
+          dev->pfnCmdCopyBuffer(transferCommandBuffer, transferBuffers[0], transferBuffers[1], 1u, &transferRegion);
+        } else {
+          dev->pfnCmdUpdateBuffer(transferCommandBuffer, transferBuffers[1], 0u, transferBytes, mappedTransferWords[0]);
+        }
+      }
+      rc = dev->pfnEndCommandBuffer(transferCommandBuffer);
+      if (rc != VK_SUCCESS) {
+        smokeRc = 91;
+        goto cleanup;
+      }
+
+      for (uint32_t sample = 0u; sample < kRuntimeCopySampleCount; ++sample) {
+        mappedTransferWords[1][(sample * transferWords) / kRuntimeCopySampleCount] = kRuntimeCopyPoisonValue;
+      }
+      mappedTransferWords[1][transferWords - 1u] = kRuntimeCopyPoisonValue;
+      rc = dev->pfnResetFences(device, 1u, &submitFence);
+      if (rc != VK_SUCCESS) {
+        smokeRc = 91;
+        goto cleanup;
+      }
+      const double transferStartMs = emscripten_get_now();
+      rc = dev->pfnQueueSubmit(queue, 1u, &transferSubmitInfo, submitFence);
+      if (rc == VK_SUCCESS) {
+        rc = dev->pfnWaitForFences(device, 1u, &submitFence, VK_TRUE, UINT64_MAX);
+      }
+      if (rc != VK_SUCCESS) {
+        smokeRc = 91;
+        goto cleanup;
+      }
+      transferSample->submitMs[op] = emscripten_get_now() - transferStartMs;
+
+      for (uint32_t sample = 0u; sample <= kRuntimeCopySampleCount; ++sample) {
+        const uint32_t index = sample < kRuntimeCopySampleCount ?
+          (sample * transferWords) / kRuntimeCopySampleCount :
+          transferWords - 1u;
+        const uint32_t expectedValue = op == WEBVULKAN_RUNTIME_TRANSFER_OP_FILL ?
+          kRuntimeTransferFillValue ^ (transferCommands - 1u) :
+          webvulkan_runtime_copy_pattern(index);
+        const uint32_t observedValue = mappedTransferWords[1][index];
+        if (observedValue != expectedValue) {
+          printf("lavapipe runtime smoke transfer mismatch\n");
+          printf("  transfer.op=%s\n", webvulkan_get_runtime_transfer_op_name(op));
+          printf("  transfer.bytes=%u\n", transferBytes);
+          printf("  transfer.index=%u\n", index);
+          printf("  transfer.expected=0x%08x\n", expectedValue);
+          printf("  transfer.observed=0x%08x\n", observedValue);
+          smokeRc = 92;
+          goto cleanup;
+        }
+      }
+    }
+
+    volatile uint32_t* hostScalarDstWords = mappedTransferWords[1];
+    const uint32_t* hostScalarSrcWords = mappedTransferWords[0];
+    double hostScalarStartMs = emscripten_get_now();
+    for (uint32_t command = 0u; command < transferCommands; ++command) {
+      for (uint32_t i = 0u; i < transferWords; ++i) {
+        hostScalarDstWords[i] = kRuntimeTransferFillValue ^ command;
+      }
+    }
+    transferSample->hostScalarFillMs = emscripten_get_now() - hostScalarStartMs;
+    hostScalarStartMs = emscripten_get_now();
+    for (uint32_t command = 0u; command < transferCommands; ++command) {
+      for (uint32_t i = 0u; i < transferWords; ++i) {
+        hostScalarDstWords[i] = hostScalarSrcWords[i];
+      }
+    }
+    transferSample->hostScalarCopyMs = emscripten_get_now() - hostScalarStartMs;
+  }
+
+  for (uint32_t b = 0u; b < 2u; ++b) {
+    dev->pfnUnmapMemory(device, transferMemories[b]);
+    mappedTransferWords[b] = 0;
+    dev->pfnDestroyBuffer(device, transferBuffers[b], 0);
+    transferBuffers[b] = VK_NULL_HANDLE;
+    dev->pfnFreeMemory(device, transferMemories[b], 0);
+    transferMemories[b] = VK_NULL_HANDLE;
+  }
+
+cleanup:
+  for (uint32_t b = 0u; b < 2u; ++b) {
+    if (mappedTransferWords[b] && dev->pfnUnmapMemory) {
+      dev->pfnUnmapMemory(device, transferMemories[b]);
+    }
+    if (transferBuffers[b] != VK_NULL_HANDLE && dev->pfnDestroyBuffer) {
+      dev->pfnDestroyBuffer(device, transferBuffers[b], 0);
+    }
+    if (transferMemories[b] != VK_NULL_HANDLE && dev->pfnFreeMemory) {
+      dev->pfnFreeMemory(device, transferMemories[b], 0);
+    }
+  }
+  *outSampleCount = transferSampleCount;
+  return smokeRc;
+}
+
+/* Runs every bandwidth kernel over power-of-four sizes up to `bandwidthBenchMaxBytes` and validates the output. */
+static int webvulkan_run_runtime_bandwidth_bench(
+  const WebVulkanRuntimeSmokeDevice* dev,
+  uint32_t bandwidthBenchMaxBytes,
+  WebVulkanRuntimeBandwidthSample* bandwidthSamples,
+  uint32_t* outSampleCount,
+  uint32_t* outKernelCount
+) {
+  const VkDevice device = dev->device;
+  const VkQueue queue = dev->queue;
+  const VkFence submitFence = dev->submitFence;
+  VkBuffer bandwidthBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory bandwidthMemory = VK_NULL_HANDLE;
+  uint32_t* mappedBandwidthWords = 0;
+  VkShaderModule bandwidthShaderModules[WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COUNT];
+  memset(bandwidthShaderModules, 0, sizeof(bandwidthShaderModules));
+  VkPipeline bandwidthPipelines[WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COUNT];
+  memset(bandwidthPipelines, 0, sizeof(bandwidthPipelines));
+  VkDescriptorSetLayout bandwidthSetLayout = VK_NULL_HANDLE;
+  VkDescriptorPool bandwidthDescriptorPool = VK_NULL_HANDLE;
+  VkPipelineLayout bandwidthPipelineLayout = VK_NULL_HANDLE;
+  VkCommandBuffer bandwidthCommandBuffer = VK_NULL_HANDLE;
+  uint32_t bandwidthKernelKeys[WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COUNT][2];
+  uint32_t bandwidthKernelCount = 0u;
+  uint32_t bandwidthSampleCount = 0u;
+  int smokeRc = 0;
+  VkResult rc = VK_SUCCESS;
+
+  if (!dev->pfnCmdDispatch || !dev->pfnCmdPipelineBarrier) {
+    printf("lavapipe runtime smoke missing bandwidth entrypoints\n");
+    printf("  vkCmdDispatch=%s\n", dev->pfnCmdDispatch ? "present" : "missing");
+    printf("  vkCmdPipelineBarrier=%s\n", dev->pfnCmdPipelineBarrier ? "present" : "missing");
+    smokeRc = 115;
+    goto cleanup;
+  }
+
+  VkBufferCreateInfo bandwidthBufferCreateInfo;
+  memset(&bandwidthBufferCreateInfo, 0, sizeof(bandwidthBufferCreateInfo));
+  bandwidthBufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  bandwidthBufferCreateInfo.size = (VkDeviceSize)bandwidthBenchMaxBytes;
+  bandwidthBufferCreateInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+  bandwidthBufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  rc = dev->pfnCreateBuffer(device, &bandwidthBufferCreateInfo, 0, &bandwidthBuffer);
+  if (rc != VK_SUCCESS || bandwidthBuffer == VK_NULL_HANDLE) {
+    smokeRc = 116;
+    goto cleanup;
+  }
+  VkMemoryRequirements bandwidthMemoryRequirements;
+  memset(&bandwidthMemoryRequirements, 0, sizeof(bandwidthMemoryRequirements));
+  dev->pfnGetBufferMemoryRequirements(device, bandwidthBuffer, &bandwidthMemoryRequirements);
+  int bandwidthHostCoherent = 0;
+  const uint32_t bandwidthMemoryTypeIndex = find_memory_type_index(
+    &dev->memoryProperties,
+    bandwidthMemoryRequirements.memoryTypeBits,
+    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+    &bandwidthHostCoherent
+  );
+  if (bandwidthMemoryTypeIndex == UINT32_MAX || !bandwidthHostCoherent) {
+    smokeRc = 116;
+    goto cleanup;
+  }
+  VkMemoryAllocateInfo bandwidthAllocateInfo;
+  memset(&bandwidthAllocateInfo, 0, sizeof(bandwidthAllocateInfo));
+  bandwidthAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  bandwidthAllocateInfo.allocationSize = bandwidthMemoryRequirements.size;
+  bandwidthAllocateInfo.memoryTypeIndex = bandwidthMemoryTypeIndex;
+  rc = dev->pfnAllocateMemory(device, &bandwidthAllocateInfo, 0, &bandwidthMemory);
+  if (rc != VK_SUCCESS || bandwidthMemory == VK_NULL_HANDLE) {
+    smokeRc = 116;
+    goto cleanup;
+  }
+  rc = dev->pfnBindBufferMemory(device, bandwidthBuffer, bandwidthMemory, 0u);
+  if (rc != VK_SUCCESS) {
+    smokeRc = 116;
+    goto cleanup;
+  }
+  rc = dev->pfnMapMemory(device, bandwidthMemory, 0u, (VkDeviceSize)bandwidthBenchMaxBytes, 0u, (void**)&mappedBandwidthWords);
+  if (rc != VK_SUCCESS || !mappedBandwidthWords) {
+    smokeRc = 116;
+    goto cleanup;
+  }
+
+  VkDescriptorSetLayoutBinding bandwidthSetLayoutBinding;
+  memset(&bandwidthSetLayoutBinding, 0, sizeof(bandwidthSetLayoutBinding));
+  bandwidthSetLayoutBinding.binding = 0u;
+  bandwidthSetLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  bandwidthSetLayoutBinding.descriptorCount = 1u;
+  bandwidthSetLayoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  VkDescriptorSetLayoutCreateInfo bandwidthSetLayoutCreateInfo;
+  memset(&bandwidthSetLayoutCreateInfo, 0, sizeof(bandwidthSetLayoutCreateInfo));
+  bandwidthSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  bandwidthSetLayoutCreateInfo.bindingCount = 1u;
+  bandwidthSetLayoutCreateInfo.pBindings = &bandwidthSetLayoutBinding;
+  rc = dev->pfnCreateDescriptorSetLayout(device, &bandwidthSetLayoutCreateInfo, 0, &bandwidthSetLayout);
+  if (rc != VK_SUCCESS || bandwidthSetLayout == VK_NULL_HANDLE) {
+    smokeRc = 116;
+    goto cleanup;
+  }
+
+  VkDescriptorPoolSize bandwidthPoolSize;
+  bandwidthPoolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  bandwidthPoolSize.descriptorCount = 1u;
+  VkDescriptorPoolCreateInfo bandwidthPoolCreateInfo;
+  memset(&bandwidthPoolCreateInfo, 0, sizeof(bandwidthPoolCreateInfo));
+  bandwidthPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  bandwidthPoolCreateInfo.maxSets = 1u;
+  bandwidthPoolCreateInfo.poolSizeCount = 1u;
+  bandwidthPoolCreateInfo.pPoolSizes = &bandwidthPoolSize;
+  rc = dev->pfnCreateDescriptorPool(device, &bandwidthPoolCreateInfo, 0, &bandwidthDescriptorPool);
+  if (rc != VK_SUCCESS || bandwidthDescriptorPool == VK_NULL_HANDLE) {
+    smokeRc = 116;
+    goto cleanup;
+  }
+
+  VkDescriptorSetAllocateInfo bandwidthSetAllocateInfo;
+  memset(&bandwidthSetAllocateInfo, 0, sizeof(bandwidthSetAllocateInfo));
+  bandwidthSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  bandwidthSetAllocateInfo.descriptorPool = bandwidthDescriptorPool;
+  bandwidthSetAllocateInfo.descriptorSetCount = 1u;
+  bandwidthSetAllocateInfo.pSetLayouts = &bandwidthSetLayout;
+  VkDescriptorSet bandwidthDescriptorSet = VK_NULL_HANDLE;
+  rc = dev->pfnAllocateDescriptorSets(device, &bandwidthSetAllocateInfo, &bandwidthDescriptorSet);
+  if (rc != VK_SUCCESS || bandwidthDescriptorSet == VK_NULL_HANDLE) {
+    smokeRc = 116;
+    goto cleanup;
+  }
+
+  VkDescriptorBufferInfo bandwidthStorageInfo;
+  bandwidthStorageInfo.buffer = bandwidthBuffer;
+  bandwidthStorageInfo.offset = 0u;
+  bandwidthStorageInfo.range = (VkDeviceSize)bandwidthBenchMaxBytes;
+  VkWriteDescriptorSet bandwidthDescriptorWrite;
+  memset(&bandwidthDescriptorWrite, 0, sizeof(bandwidthDescriptorWrite));
+  bandwidthDescriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  bandwidthDescriptorWrite.dstSet = bandwidthDescriptorSet;
+  bandwidthDescriptorWrite.dstBinding = 0u;
+  bandwidthDescriptorWrite.descriptorCount = 1u;
+  bandwidthDescriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  bandwidthDescriptorWrite.pBufferInfo = &bandwidthStorageInfo;
+  dev->pfnUpdateDescriptorSets(device, 1u, &bandwidthDescriptorWrite, 0u, 0);
+
+  VkPipelineLayoutCreateInfo bandwidthPipelineLayoutCreateInfo;
+  memset(&bandwidthPipelineLayoutCreateInfo, 0, sizeof(bandwidthPipelineLayoutCreateInfo));
+  bandwidthPipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  bandwidthPipelineLayoutCreateInfo.setLayoutCount = 1u;
+  bandwidthPipelineLayoutCreateInfo.pSetLayouts = &bandwidthSetLayout;
+  rc = dev->pfnCreatePipelineLayout(device, &bandwidthPipelineLayoutCreateInfo, 0, &bandwidthPipelineLayout);
+  if (rc != VK_SUCCESS || bandwidthPipelineLayout == VK_NULL_HANDLE) {
+    smokeRc = 116;
+    goto cleanup;
+  }
+
+  /* Bench pipelines overwrite the captured key; the JS side still reads the main one. */
+  const int bandwidthSavedKeyValid = webvulkan_runtime_has_captured_shader_key();
+  const uint32_t bandwidthSavedKeyLo = webvulkan_runtime_get_captured_shader_key_lo();
+  const uint32_t bandwidthSavedKeyHi = webvulkan_runtime_get_captured_shader_key_hi();
+  for (uint32_t kernel = 0u; kernel < WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COUNT; ++kernel) {
+    const uint8_t* bandwidthSpirvBytes = 0;
+    uint32_t bandwidthSpirvSize = 0u;
+    const char* bandwidthSpirvEntrypoint = 0;
+    if (!webvulkan_runtime_lookup_spirv_module(
+          g_runtime_bandwidth_shader_keys[kernel][0],
+          g_runtime_bandwidth_shader_keys[kernel][1],
+          &bandwidthSpirvBytes,
+          &bandwidthSpirvSize,
+          &bandwidthSpirvEntrypoint
+        ) ||
+        !bandwidthSpirvBytes ||
+        bandwidthSpirvSize < 4u ||
+        (bandwidthSpirvSize % 4u) != 0u) {
+      printf("lavapipe runtime smoke bandwidth shader missing\n");
+      printf("  bandwidth.kernel=%s\n", g_runtime_bandwidth_kernels[kernel].name);
+      printf(
+        "  bandwidth.key=0x%08x%08x\n",
+        g_runtime_bandwidth_shader_keys[kernel][1],
+        g_runtime_bandwidth_shader_keys[kernel][0]
+      );
+      smokeRc = 115;
+      goto cleanup;
+    }
+    VkShaderModuleCreateInfo bandwidthShaderCreateInfo;
+    memset(&bandwidthShaderCreateInfo, 0, sizeof(bandwidthShaderCreateInfo));
+    bandwidthShaderCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    bandwidthShaderCreateInfo.codeSize = (size_t)bandwidthSpirvSize;
+    bandwidthShaderCreateInfo.pCode = (const uint32_t*)bandwidthSpirvBytes;
+    rc = dev->pfnCreateShaderModule(device, &bandwidthShaderCreateInfo, 0, &bandwidthShaderModules[kernel]);
+    if (rc != VK_SUCCESS || bandwidthShaderModules[kernel] == VK_NULL_HANDLE) {
+      smokeRc = 116;
+      goto cleanup;
+    }
+    VkComputePipelineCreateInfo bandwidthPipelineCreateInfo;
+    memset(&bandwidthPipelineCreateInfo, 0, sizeof(bandwidthPipelineCreateInfo));
+    bandwidthPipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    bandwidthPipelineCreateInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    bandwidthPipelineCreateInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    bandwidthPipelineCreateInfo.stage.module = bandwidthShaderModules[kernel];
+    bandwidthPipelineCreateInfo.stage.pName =
+      bandwidthSpirvEntrypoint && bandwidthSpirvEntrypoint[0] ? bandwidthSpirvEntrypoint : "main";
+    bandwidthPipelineCreateInfo.layout = bandwidthPipelineLayout;
+    webvulkan_runtime_reset_captured_shader_key();
+    rc = dev->pfnCreateComputePipelines(device, VK_NULL_HANDLE, 1u, &bandwidthPipelineCreateInfo, 0, &bandwidthPipelines[kernel]);
+    if (rc != VK_SUCCESS || bandwidthPipelines[kernel] == VK_NULL_HANDLE) {
+      smokeRc = 116;
+      goto cleanup;
+    }
+    if (g_runtime_bandwidth_kernel_module != WEBVULKAN_RUNTIME_NO_SHARED_WASM_MODULE &&
+        webvulkan_runtime_has_captured_shader_key()) {
+      bandwidthKernelKeys[bandwidthKernelCount][0] = webvulkan_runtime_get_captured_shader_key_lo();
+      bandwidthKernelKeys[bandwidthKernelCount][1] = webvulkan_runtime_get_captured_shader_key_hi();
+      if (webvulkan_register_runtime_wasm_kernel(
+            bandwidthKernelKeys[bandwidthKernelCount][0],
+            bandwidthKernelKeys[bandwidthKernelCount][1],
+            WEBVULKAN_RUNTIME_NO_SPECIALIZATION_KEY,
+            WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+            WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+            WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+            g_runtime_bandwidth_kernel_module,
+            g_runtime_bandwidth_kernels[kernel].kernelExport
+          ) != 0) {
+        smokeRc = 119;
+        goto cleanup;
+      }
+      bandwidthKernelCount += 1u;
+    }
+  }
+  if (bandwidthSavedKeyValid) {
+    webvulkan_runtime_capture_shader_key(bandwidthSavedKeyLo, bandwidthSavedKeyHi);
+  } else {
+    webvulkan_runtime_reset_captured_shader_key();
+  }
+
+  rc = dev->pfnAllocateCommandBuffers(device, &dev->commandBufferAllocateInfo, &bandwidthCommandBuffer);
+  if (rc != VK_SUCCESS || bandwidthCommandBuffer == VK_NULL_HANDLE) {
+    smokeRc = 117;
+    goto cleanup;
+  }
+
+  VkMemoryBarrier bandwidthBarrier;
+  memset(&bandwidthBarrier, 0, sizeof(bandwidthBarrier));
+  bandwidthBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  bandwidthBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  bandwidthBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+  VkSubmitInfo bandwidthSubmitInfo;
+  memset(&bandwidthSubmitInfo, 0, sizeof(bandwidthSubmitInfo));
+  bandwidthSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  bandwidthSubmitInfo.commandBufferCount = 1u;
+  bandwidthSubmitInfo.pCommandBuffers = &bandwidthCommandBuffer;
+
+  /*
+   * Layout in words: header { elements, invocation stride, scale, gather rows },
+   * then x, y and z of `elements` words each. Kernels grid-stride over the
+   * elements, so one capped workgroup count covers every size.
+   */
+  for (uint32_t bandwidthBytes = kRuntimeBandwidthMinBytes;
+       bandwidthBytes <= bandwidthBenchMaxBytes && bandwidthSampleCount < WEBVULKAN_RUNTIME_BANDWIDTH_MAX_SIZE_COUNT;
+       bandwidthBytes *= 4u) {
+    WebVulkanRuntimeBandwidthSample* bandwidthSample = &bandwidthSamples[bandwidthSampleCount++];
+    const uint32_t elements =
+      (((bandwidthBytes / (uint32_t)sizeof(uint32_t)) - kRuntimeBandwidthHeaderWords) / 3u) &
+      ~(kRuntimeBandwidthWorkgroupSize - 1u);
+    uint32_t bandwidthWorkgroups = elements / kRuntimeBandwidthWorkgroupSize;
+    if (bandwidthWorkgroups > kRuntimeBandwidthMaxWorkgroups) {
+      bandwidthWorkgroups = kRuntimeBandwidthMaxWorkgroups;
+    }
+    uint32_t bandwidthDispatches = kRuntimeBandwidthBytesPerSubmit / bandwidthBytes;
+    if (bandwidthDispatches == 0u) {
+      bandwidthDispatches = 1u;
+    }
+    if (bandwidthDispatches > kRuntimeBandwidthMaxDispatchesPerSubmit) {
+      bandwidthDispatches = kRuntimeBandwidthMaxDispatchesPerSubmit;
+    }
+    memset(bandwidthSample, 0, sizeof(*bandwidthSample));
+    bandwidthSample->bytes = bandwidthBytes;
+    bandwidthSample->elements = elements;
+    bandwidthSample->dispatchesPerSubmit = bandwidthDispatches;
+    uint32_t* bandwidthArrays[3];
+    for (uint32_t a = 0u; a < 3u; ++a) {
+      bandwidthArrays[a] = mappedBandwidthWords + kRuntimeBandwidthHeaderWords + (a * elements);
+    }
+
+    for (uint32_t kernel = 0u; kernel < WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COUNT; ++kernel) {
+      rc = dev->pfnBeginCommandBuffer(bandwidthCommandBuffer, &dev->commandBufferBeginInfo);
+      if (rc != VK_SUCCESS) {
+        smokeRc = 117;
+        goto cleanup;
+      }
+      dev->pfnCmdBindPipeline(bandwidthCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, bandwidthPipelines[kernel]);
+      dev->pfnCmdBindDescriptorSets(
+        bandwidthCommandBuffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        bandwidthPipelineLayout,
+        0u,
+        1u,
+        &bandwidthDescriptorSet,
+        0u,
+        0
+      );
+      for (uint32_t dispatch = 0u; dispatch < bandwidthDispatches; ++dispatch) {
+        if (dispatch > 0u) {
+          dev->pfnCmdPipelineBarrier(
+            bandwidthCommandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0u,
+            1u,
+            &bandwidthBarrier,
+            0u,
+            0,
+            0u,
+            0
+          );
+        }
+        dev->pfnCmdDispatch(bandwidthCommandBuffer, bandwidthWorkgroups, 1u, 1u);
+      }
+      rc = dev->pfnEndCommandBuffer(bandwidthCommandBuffer);
+      if (rc != VK_SUCCESS) {
+        smokeRc = 117;
+        goto cleanup;
+      }
+
+      mappedBandwidthWords[0] = elements;
+      mappedBandwidthWords[1] = bandwidthWorkgroups * kRuntimeBandwidthWorkgroupSize;
+      mappedBandwidthWords[2] = kRuntimeBandwidthScale;
+      mappedBandwidthWords[3] = elements / kRuntimeBandwidthGatherColumns;
+      /* y starts as a pattern no kernel reproduces and z as poison, so stale words fail validation. */
+      for (uint32_t i = 0u; i < elements; ++i) {
+        bandwidthArrays[0][i] = webvulkan_runtime_copy_pattern(i);
+        bandwidthArrays[1][i] = webvulkan_runtime_copy_pattern(elements + i);
+        bandwidthArrays[2][i] = kRuntimeCopyPoisonValue;
+      }
+      rc = dev->pfnResetFences(device, 1u, &submitFence);
+      if (rc != VK_SUCCESS) {
+        smokeRc = 117;
+        goto cleanup;
+      }
+      /* The driver marks Wasm usage when it runs a looked-up kernel; clear the mark left by earlier work. */
+      webvulkan_runtime_mark_wasm_usage(0, "none");
+      const double bandwidthStartMs = emscripten_get_now();
+      rc = dev->pfnQueueSubmit(queue, 1u, &bandwidthSubmitInfo, submitFence);
+      if (rc == VK_SUCCESS) {
+        rc = dev->pfnWaitForFences(device, 1u, &submitFence, VK_TRUE, UINT64_MAX);
+      }
+      if (rc != VK_SUCCESS) {
+        smokeRc = 117;
+        goto cleanup;
+      }
+      bandwidthSample->submitMs[kernel] = emscripten_get_now() - bandwidthStartMs;
+      bandwidthSample->wasmSubmits[kernel] = webvulkan_get_runtime_wasm_used() ? 1u : 0u;
+      g_last_bandwidth_wasm_submits[kernel] += bandwidthSample->wasmSubmits[kernel];
+
+      const uint32_t* bandwidthDstWords = bandwidthArrays[g_runtime_bandwidth_kernels[kernel].dstArray];
+      for (uint32_t sample = 0u; sample <= kRuntimeCopySampleCount; ++sample) {
+        const uint32_t index = sample < kRuntimeCopySampleCount ?
+          (sample * elements) / kRuntimeCopySampleCount :
+          elements - 1u;
+        const uint32_t expectedValue =
+          webvulkan_runtime_bandwidth_reference(kernel, index, elements, bandwidthDispatches);
+        const uint32_t observedValue = bandwidthDstWords[index];
+        if (observedValue != expectedValue) {
+          printf("lavapipe runtime smoke bandwidth mismatch\n");
+          printf("  bandwidth.kernel=%s\n", g_runtime_bandwidth_kernels[kernel].name);
+          printf("  bandwidth.bytes=%u\n", bandwidthBytes);
+          printf("  bandwidth.index=%u\n", index);
+          printf("  bandwidth.expected=0x%08x\n", expectedValue);
+          printf("  bandwidth.observed=0x%08x\n", observedValue);
+          smokeRc = 118;
+          goto cleanup;
+        }
+      }
+    }
+
+    const double hostMemcpyStartMs = emscripten_get_now();
+    for (uint32_t dispatch = 0u; dispatch < bandwidthDispatches; ++dispatch) {
+      memcpy(bandwidthArrays[1], bandwidthArrays[0], sizeof(uint32_t) * (size_t)elements);
+    }
+    bandwidthSample->hostMemcpyMs = emscripten_get_now() - hostMemcpyStartMs;
+  }
+
+  for (uint32_t k = 0u; k < bandwidthKernelCount; ++k) {
+    webvulkan_runtime_unregister_shader_bundle(bandwidthKernelKeys[k][0], bandwidthKernelKeys[k][1]);
+  }
+  for (uint32_t kernel = 0u; kernel < WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COUNT; ++kernel) {
+    dev->pfnDestroyPipeline(device, bandwidthPipelines[kernel], 0);
+    bandwidthPipelines[kernel] = VK_NULL_HANDLE;
+    dev->pfnDestroyShaderModule(device, bandwidthShaderModules[kernel], 0);
+    bandwidthShaderModules[kernel] = VK_NULL_HANDLE;
+  }
+  dev->pfnDestroyPipelineLayout(device, bandwidthPipelineLayout, 0);
+  bandwidthPipelineLayout = VK_NULL_HANDLE;
+  dev->pfnDestroyDescriptorPool(device, bandwidthDescriptorPool, 0);
+  bandwidthDescriptorPool = VK_NULL_HANDLE;
+  dev->pfnDestroyDescriptorSetLayout(device, bandwidthSetLayout, 0);
+  bandwidthSetLayout = VK_NULL_HANDLE;
+  dev->pfnUnmapMemory(device, bandwidthMemory);
+  mappedBandwidthWords = 0;
+  dev->pfnDestroyBuffer(device, bandwidthBuffer, 0);
+  bandwidthBuffer = VK_NULL_HANDLE;
+  dev->pfnFreeMemory(device, bandwidthMemory, 0);
+  bandwidthMemory = VK_NULL_HANDLE;
+
+cleanup:
+  if (smokeRc != 0) {
+    for (uint32_t k = 0u; k < bandwidthKernelCount; ++k) {
+      webvulkan_runtime_unregister_shader_bundle(bandwidthKernelKeys[k][0], bandwidthKernelKeys[k][1]);
+    }
+  }
+  for (uint32_t kernel = 0u; kernel < WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COUNT; ++kernel) {
+    if (bandwidthPipelines[kernel] != VK_NULL_HANDLE && dev->pfnDestroyPipeline) {
+      dev->pfnDestroyPipeline(device, bandwidthPipelines[kernel], 0);
+    }
+    if (bandwidthShaderModules[kernel] != VK_NULL_HANDLE && dev->pfnDestroyShaderModule) {
+      dev->pfnDestroyShaderModule(device, bandwidthShaderModules[kernel], 0);
+    }
+  }
+  if (bandwidthPipelineLayout != VK_NULL_HANDLE && dev->pfnDestroyPipelineLayout) {
+    dev->pfnDestroyPipelineLayout(device, bandwidthPipelineLayout, 0);
+  }
+  if (bandwidthDescriptorPool != VK_NULL_HANDLE && dev->pfnDestroyDescriptorPool) {
+    dev->pfnDestroyDescriptorPool(device, bandwidthDescriptorPool, 0);
+  }
+  if (bandwidthSetLayout != VK_NULL_HANDLE && dev->pfnDestroyDescriptorSetLayout) {
+    dev->pfnDestroyDescriptorSetLayout(device, bandwidthSetLayout, 0);
+  }
+  if (mappedBandwidthWords && dev->pfnUnmapMemory) {
+    dev->pfnUnmapMemory(device, bandwidthMemory);
+  }
+  if (bandwidthBuffer != VK_NULL_HANDLE && dev->pfnDestroyBuffer) {
+    dev->pfnDestroyBuffer(device, bandwidthBuffer, 0);
+  }
+  if (bandwidthMemory != VK_NULL_HANDLE && dev->pfnFreeMemory) {
+    dev->pfnFreeMemory(device, bandwidthMemory, 0);
+  }
+  *outSampleCount = bandwidthSampleCount;
+  *outKernelCount = bandwidthKernelCount;
+  return smokeRc;
+}
+
+/* Runs each primitive up to `primitiveBenchMaxElements` elements and checks it against the host reference. */
+static int webvulkan_run_runtime_primitive_bench(
+  const WebVulkanRuntimeSmokeDevice* dev,
+  uint32_t primitiveBenchMaxElements,
+  WebVulkanRuntimePrimitiveSample* primitiveSamples,
+  uint32_t* outSampleCount,
+  uint32_t* outKernelCount
+) {
+  const VkDevice device = dev->device;
+  const VkQueue queue = dev->queue;
+  const VkFence submitFence = dev->submitFence;
+  VkBuffer primitiveBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory primitiveMemory = VK_NULL_HANDLE;
+  uint32_t* mappedPrimitiveWords = 0;
+  uint32_t* primitiveReferenceWords = 0;
+  VkShaderModule primitiveShaderModules[WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_COUNT];
+  memset(primitiveShaderModules, 0, sizeof(primitiveShaderModules));
+  VkPipeline primitivePipelines[WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_COUNT];
+  memset(primitivePipelines, 0, sizeof(primitivePipelines));
+  VkDescriptorSetLayout primitiveSetLayout = VK_NULL_HANDLE;
+  VkDescriptorPool primitiveDescriptorPool = VK_NULL_HANDLE;
+  VkPipelineLayout primitivePipelineLayout = VK_NULL_HANDLE;
+  VkCommandBuffer primitiveCommandBuffer = VK_NULL_HANDLE;
+  uint32_t primitiveKernelKeys[WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_COUNT][2];
+  uint32_t primitiveKernelCount = 0u;
+  uint32_t primitiveSampleCount = 0u;
+  int smokeRc = 0;
+  VkResult rc = VK_SUCCESS;
+
+  if (!dev->pfnCmdDispatch || !dev->pfnCmdPipelineBarrier) {
+    printf("lavapipe runtime smoke missing primitive entrypoints\n");
+    printf("  vkCmdDispatch=%s\n", dev->pfnCmdDispatch ? "present" : "missing");
+    printf("  vkCmdPipelineBarrier=%s\n", dev->pfnCmdPipelineBarrier ? "present" : "missing");
+    smokeRc = 120;
+    goto cleanup;
+  }
+
+  /*
+   * Layout in words: header { elements, blocks, scan region offset, scan region
+   * count, radix shift, reduce result, invocation stride, ... }, then the input
+   * keys, the output, 256 histogram bins and 256 * blocks partials. Block stages
+   * run one 256-lane workgroup per block; reduce and histogram grid-stride.
+   */
+  const uint32_t primitiveMaxBlocks = primitiveBenchMaxElements / kRuntimePrimitiveBlockSize;
+  const uint32_t primitiveInputOffset = kRuntimePrimitiveHeaderWords;
+  const uint32_t primitiveMaxWords = kRuntimePrimitiveHeaderWords + (2u * primitiveBenchMaxElements) +
+                                     WEBVULKAN_RUNTIME_PRIMITIVE_HISTOGRAM_BINS +
+                                     (WEBVULKAN_RUNTIME_PRIMITIVE_HISTOGRAM_BINS * primitiveMaxBlocks);
+  const VkDeviceSize primitiveBufferBytes = (VkDeviceSize)primitiveMaxWords * sizeof(uint32_t);
+  VkBufferCreateInfo primitiveBufferCreateInfo;
+  memset(&primitiveBufferCreateInfo, 0, sizeof(primitiveBufferCreateInfo));
+  primitiveBufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  primitiveBufferCreateInfo.size = primitiveBufferBytes;
+  primitiveBufferCreateInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+  primitiveBufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  rc = dev->pfnCreateBuffer(device, &primitiveBufferCreateInfo, 0, &primitiveBuffer);
+  if (rc != VK_SUCCESS || primitiveBuffer == VK_NULL_HANDLE) {
+    smokeRc = 121;
+    goto cleanup;
+  }
+  VkMemoryRequirements primitiveMemoryRequirements;
+  memset(&primitiveMemoryRequirements, 0, sizeof(primitiveMemoryRequirements));
+  dev->pfnGetBufferMemoryRequirements(device, primitiveBuffer, &primitiveMemoryRequirements);
+  int primitiveHostCoherent = 0;
+  const uint32_t primitiveMemoryTypeIndex = find_memory_type_index(
+    &dev->memoryProperties,
+    primitiveMemoryRequirements.memoryTypeBits,
+    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+    &primitiveHostCoherent
+  );
+  if (primitiveMemoryTypeIndex == UINT32_MAX || !primitiveHostCoherent) {
+    smokeRc = 121;
+    goto cleanup;
+  }
+  VkMemoryAllocateInfo primitiveAllocateInfo;
+  memset(&primitiveAllocateInfo, 0, sizeof(primitiveAllocateInfo));
+  primitiveAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  primitiveAllocateInfo.allocationSize = primitiveMemoryRequirements.size;
+  primitiveAllocateInfo.memoryTypeIndex = primitiveMemoryTypeIndex;
+  rc = dev->pfnAllocateMemory(device, &primitiveAllocateInfo, 0, &primitiveMemory);
+  if (rc != VK_SUCCESS || primitiveMemory == VK_NULL_HANDLE) {
+    smokeRc = 121;
+    goto cleanup;
+  }
+  rc = dev->pfnBindBufferMemory(device, primitiveBuffer, primitiveMemory, 0u);
+  if (rc != VK_SUCCESS) {
+    smokeRc = 121;
+    goto cleanup;
+  }
+  rc = dev->pfnMapMemory(device, primitiveMemory, 0u, primitiveBufferBytes, 0u, (void**)&mappedPrimitiveWords);
+  if (rc != VK_SUCCESS || !mappedPrimitiveWords) {
+    smokeRc = 121;
+    goto cleanup;
+  }
+  primitiveReferenceWords = (uint32_t*)malloc(sizeof(uint32_t) * (size_t)primitiveBenchMaxElements);
+  if (!primitiveReferenceWords) {
+    smokeRc = 121;
+    goto cleanup;
+  }
+
+  VkDescriptorSetLayoutBinding primitiveSetLayoutBinding;
+  memset(&primitiveSetLayoutBinding, 0, sizeof(primitiveSetLayoutBinding));
+  primitiveSetLayoutBinding.binding = 0u;
+  primitiveSetLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  primitiveSetLayoutBinding.descriptorCount = 1u;
+  primitiveSetLayoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  VkDescriptorSetLayoutCreateInfo primitiveSetLayoutCreateInfo;
+  memset(&primitiveSetLayoutCreateInfo, 0, sizeof(primitiveSetLayoutCreateInfo));
+  primitiveSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  primitiveSetLayoutCreateInfo.bindingCount = 1u;
+  primitiveSetLayoutCreateInfo.pBindings = &primitiveSetLayoutBinding;
+  rc = dev->pfnCreateDescriptorSetLayout(device, &primitiveSetLayoutCreateInfo, 0, &primitiveSetLayout);
+  if (rc != VK_SUCCESS || primitiveSetLayout == VK_NULL_HANDLE) {
+    smokeRc = 121;
+    goto cleanup;
+  }
+
+  VkDescriptorPoolSize primitivePoolSize;
+  primitivePoolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  primitivePoolSize.descriptorCount = 1u;
+  VkDescriptorPoolCreateInfo primitivePoolCreateInfo;
+  memset(&primitivePoolCreateInfo, 0, sizeof(primitivePoolCreateInfo));
+  primitivePoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  primitivePoolCreateInfo.maxSets = 1u;
+  primitivePoolCreateInfo.poolSizeCount = 1u;
+  primitivePoolCreateInfo.pPoolSizes = &primitivePoolSize;
+  rc = dev->pfnCreateDescriptorPool(device, &primitivePoolCreateInfo, 0, &primitiveDescriptorPool);
+  if (rc != VK_SUCCESS || primitiveDescriptorPool == VK_NULL_HANDLE) {
+    smokeRc = 121;
+    goto cleanup;
+  }
+
+  VkDescriptorSetAllocateInfo primitiveSetAllocateInfo;
+  memset(&primitiveSetAllocateInfo, 0, sizeof(primitiveSetAllocateInfo));
+  primitiveSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  primitiveSetAllocateInfo.descriptorPool = primitiveDescriptorPool;
+  primitiveSetAllocateInfo.descriptorSetCount = 1u;
+  primitiveSetAllocateInfo.pSetLayouts = &primitiveSetLayout;
+  VkDescriptorSet primitiveDescriptorSet = VK_NULL_HANDLE;
+  rc = dev->pfnAllocateDescriptorSets(device, &primitiveSetAllocateInfo, &primitiveDescriptorSet);
+  if (rc != VK_SUCCESS || primitiveDescriptorSet == VK_NULL_HANDLE) {
+    smokeRc = 121;
+    goto cleanup;
+  }
+
+  VkDescriptorBufferInfo primitiveStorageInfo;
+  primitiveStorageInfo.buffer = primitiveBuffer;
+  primitiveStorageInfo.offset = 0u;
+  primitiveStorageInfo.range = primitiveBufferBytes;
+  VkWriteDescriptorSet primitiveDescriptorWrite;
+  memset(&primitiveDescriptorWrite, 0, sizeof(primitiveDescriptorWrite));
+  primitiveDescriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  primitiveDescriptorWrite.dstSet = primitiveDescriptorSet;
+  primitiveDescriptorWrite.dstBinding = 0u;
+  primitiveDescriptorWrite.descriptorCount = 1u;
+  primitiveDescriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  primitiveDescriptorWrite.pBufferInfo = &primitiveStorageInfo;
+  dev->pfnUpdateDescriptorSets(device, 1u, &primitiveDescriptorWrite, 0u, 0);
+
+  VkPipelineLayoutCreateInfo primitivePipelineLayoutCreateInfo;
+  memset(&primitivePipelineLayoutCreateInfo, 0, sizeof(primitivePipelineLayoutCreateInfo));
+  primitivePipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  primitivePipelineLayoutCreateInfo.setLayoutCount = 1u;
+  primitivePipelineLayoutCreateInfo.pSetLayouts = &primitiveSetLayout;
+  rc = dev->pfnCreatePipelineLayout(device, &primitivePipelineLayoutCreateInfo, 0, &primitivePipelineLayout);
+  if (rc != VK_SUCCESS || primitivePipelineLayout == VK_NULL_HANDLE) {
+    smokeRc = 121;
+    goto cleanup;
+  }
+
+  const int primitiveSavedKeyValid = webvulkan_runtime_has_captured_shader_key();
+  const uint32_t primitiveSavedKeyLo = webvulkan_runtime_get_captured_shader_key_lo();
+  const uint32_t primitiveSavedKeyHi = webvulkan_runtime_get_captured_shader_key_hi();
+  for (uint32_t shader = 0u; shader < WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_COUNT; ++shader) {
+    const uint8_t* primitiveSpirvBytes = 0;
+    uint32_t primitiveSpirvSize = 0u;
+    const char* primitiveSpirvEntrypoint = 0;
+    if (!webvulkan_runtime_lookup_spirv_module(
+          g_runtime_primitive_shader_keys[shader][0],
+          g_runtime_primitive_shader_keys[shader][1],
+          &primitiveSpirvBytes,
+          &primitiveSpirvSize,
+          &primitiveSpirvEntrypoint
+        ) ||
+        !primitiveSpirvBytes ||
+        primitiveSpirvSize < 4u ||
+        (primitiveSpirvSize % 4u) != 0u) {
+      printf("lavapipe runtime smoke primitive shader missing\n");
+      printf("  primitive.shader=%s\n", g_runtime_primitive_shader_exports[shader]);
+      printf(
+        "  primitive.key=0x%08x%08x\n",
+        g_runtime_primitive_shader_keys[shader][1],
+        g_runtime_primitive_shader_keys[shader][0]
+      );
+      smokeRc = 120;
+      goto cleanup;
+    }
+    VkShaderModuleCreateInfo primitiveShaderCreateInfo;
+    memset(&primitiveShaderCreateInfo, 0, sizeof(primitiveShaderCreateInfo));
+    primitiveShaderCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    primitiveShaderCreateInfo.codeSize = (size_t)primitiveSpirvSize;
+    primitiveShaderCreateInfo.pCode = (const uint32_t*)primitiveSpirvBytes;
+    rc = dev->pfnCreateShaderModule(device, &primitiveShaderCreateInfo, 0, &primitiveShaderModules[shader]);
+    if (rc != VK_SUCCESS || primitiveShaderModules[shader] == VK_NULL_HANDLE) {
+      smokeRc = 121;
+      goto cleanup;
+    }
+    VkComputePipelineCreateInfo primitivePipelineCreateInfo;
+    memset(&primitivePipelineCreateInfo, 0, sizeof(primitivePipelineCreateInfo));
+    primitivePipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    primitivePipelineCreateInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    primitivePipelineCreateInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    primitivePipelineCreateInfo.stage.module = primitiveShaderModules[shader];
+    primitivePipelineCreateInfo.stage.pName =
+      primitiveSpirvEntrypoint && primitiveSpirvEntrypoint[0] ? primitiveSpirvEntrypoint : "main";
+    primitivePipelineCreateInfo.layout = primitivePipelineLayout;
+    webvulkan_runtime_reset_captured_shader_key();
+    rc = dev->pfnCreateComputePipelines(device, VK_NULL_HANDLE, 1u, &primitivePipelineCreateInfo, 0, &primitivePipelines[shader]);
+    if (rc != VK_SUCCESS || primitivePipelines[shader] == VK_NULL_HANDLE) {
+      smokeRc = 121;
+      goto cleanup;
+    }
+    if (g_runtime_primitive_kernel_module != WEBVULKAN_RUNTIME_NO_SHARED_WASM_MODULE &&
+        webvulkan_runtime_has_captured_shader_key()) {
+      primitiveKernelKeys[primitiveKernelCount][0] = webvulkan_runtime_get_captured_shader_key_lo();
+      primitiveKernelKeys[primitiveKernelCount][1] = webvulkan_runtime_get_captured_shader_key_hi();
+      if (webvulkan_register_runtime_wasm_kernel(
+            primitiveKernelKeys[primitiveKernelCount][0],
+            primitiveKernelKeys[primitiveKernelCount][1],
+            WEBVULKAN_RUNTIME_NO_SPECIALIZATION_KEY,
+            WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+            WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+            WEBVULKAN_RUNTIME_ANY_GROUP_COUNT,
+            g_runtime_primitive_kernel_module,
+            g_runtime_primitive_shader_exports[shader]
+          ) != 0) {
+        smokeRc = 124;
+        goto cleanup;
+      }
+      primitiveKernelCount += 1u;
+    }
+  }
+  if (primitiveSavedKeyValid) {
+    webvulkan_runtime_capture_shader_key(primitiveSavedKeyLo, primitiveSavedKeyHi);
+  } else {
+    webvulkan_runtime_reset_captured_shader_key();
+  }
+
+  rc = dev->pfnAllocateCommandBuffers(device, &dev->commandBufferAllocateInfo, &primitiveCommandBuffer);
+  if (rc != VK_SUCCESS || primitiveCommandBuffer == VK_NULL_HANDLE) {
+    smokeRc = 122;
+    goto cleanup;
+  }
+
+  VkMemoryBarrier primitiveBarrier;
+  memset(&primitiveBarrier, 0, sizeof(primitiveBarrier));
+  primitiveBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  primitiveBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  primitiveBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+  VkSubmitInfo primitiveSubmitInfo;
+  memset(&primitiveSubmitInfo, 0, sizeof(primitiveSubmitInfo));
+  primitiveSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  primitiveSubmitInfo.commandBufferCount = 1u;
+  primitiveSubmitInfo.pCommandBuffers = &primitiveCommandBuffer;
+
+  for (uint32_t primitiveElements = kRuntimePrimitiveMinElements;
+       primitiveElements <= primitiveBenchMaxElements && primitiveSampleCount < WEBVULKAN_RUNTIME_PRIMITIVE_MAX_SIZE_COUNT;
+       primitiveElements *= 4u) {
+    WebVulkanRuntimePrimitiveSample* primitiveSample = &primitiveSamples[primitiveSampleCount++];
+    const uint32_t primitiveBlocks = primitiveElements / kRuntimePrimitiveBlockSize;
+    uint32_t primitiveGridWorkgroups = primitiveBlocks;
+    if (primitiveGridWorkgroups > kRuntimePrimitiveMaxGridWorkgroups) {
+      primitiveGridWorkgroups = kRuntimePrimitiveMaxGridWorkgroups;
+    }
+    const uint32_t primitiveOutputOffset = primitiveInputOffset + primitiveElements;
+    const uint32_t primitiveBinsOffset = primitiveOutputOffset + primitiveElements;
+    const uint32_t primitivePartialsOffset = primitiveBinsOffset + WEBVULKAN_RUNTIME_PRIMITIVE_HISTOGRAM_BINS;
+    memset(primitiveSample, 0, sizeof(*primitiveSample));
+    primitiveSample->elements = primitiveElements;
+    for (uint32_t i = 0u; i < primitiveElements; ++i) {
+      mappedPrimitiveWords[primitiveInputOffset + i] = webvulkan_runtime_copy_pattern(i);
+    }
+
+    for (uint32_t primitive = 0u; primitive < WEBVULKAN_RUNTIME_PRIMITIVE_COUNT; ++primitive) {
+      const WebVulkanRuntimePrimitive* primitiveInfo = &g_runtime_primitives[primitive];
+      rc = dev->pfnBeginCommandBuffer(primitiveCommandBuffer, &dev->commandBufferBeginInfo);
+      if (rc != VK_SUCCESS) {
+        smokeRc = 122;
+        goto cleanup;
+      }
+      dev->pfnCmdBindDescriptorSets(
+        primitiveCommandBuffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        primitivePipelineLayout,
+        0u,
+        1u,
+        &primitiveDescriptorSet,
+        0u,
+        0
+      );
+      for (uint32_t stage = 0u; stage < primitiveInfo->stageCount; ++stage) {
+        const uint32_t shader = primitiveInfo->stages[stage];
+        uint32_t stageWorkgroups = primitiveBlocks;
+        if (shader == WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_REDUCE || shader == WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_HISTOGRAM) {
+          stageWorkgroups = primitiveGridWorkgroups;
+        } else if (shader == WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_SCAN_PARTIALS) {
+          stageWorkgroups = 1u;
+        }
+        if (stage > 0u) {
+          dev->pfnCmdPipelineBarrier(
+            primitiveCommandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0u,
+            1u,
+            &primitiveBarrier,
+            0u,
+            0,
+            0u,
+            0
+          );
+        }
+        dev->pfnCmdBindPipeline(primitiveCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, primitivePipelines[shader]);
+        dev->pfnCmdDispatch(primitiveCommandBuffer, stageWorkgroups, 1u, 1u);
+      }
+      rc = dev->pfnEndCommandBuffer(primitiveCommandBuffer);
+      if (rc != VK_SUCCESS) {
+        smokeRc = 122;
+        goto cleanup;
+      }
+
+      /* exclusive_scan scans one partial per block; radix_pass scans the digit-major block counts. */
+      mappedPrimitiveWords[0] = primitiveElements;
+      mappedPrimitiveWords[1] = primitiveBlocks;
+      mappedPrimitiveWords[2] = primitivePartialsOffset;
+      mappedPrimitiveWords[3] = primitive == WEBVULKAN_RUNTIME_PRIMITIVE_RADIX_PASS ?
+        WEBVULKAN_RUNTIME_PRIMITIVE_HISTOGRAM_BINS * primitiveBlocks :
+        primitiveBlocks;
+      mappedPrimitiveWords[4] = kRuntimePrimitiveRadixShift;
+      mappedPrimitiveWords[6] = primitiveGridWorkgroups * kRuntimePrimitiveBlockSize;
+      for (uint32_t i = 0u; i < primitiveElements; ++i) {
+        mappedPrimitiveWords[primitiveOutputOffset + i] = kRuntimeCopyPoisonValue;
+      }
+      primitiveSample->wasmSubmits[primitive] = 0u;
+      for (uint32_t iteration = 0u; iteration < kRuntimePrimitiveSubmitIterations; ++iteration) {
+        /* reduce and histogram accumulate atomically, so their targets are cleared before every submit. */
+        mappedPrimitiveWords[5] = 0u;
+        memset(
+          mappedPrimitiveWords + primitiveBinsOffset,
+          0,
+          sizeof(uint32_t) * WEBVULKAN_RUNTIME_PRIMITIVE_HISTOGRAM_BINS
+        );
+        rc = dev->pfnResetFences(device, 1u, &submitFence);
+        if (rc != VK_SUCCESS) {
+          smokeRc = 122;
+          goto cleanup;
+        }
+        webvulkan_runtime_mark_wasm_usage(0, "none");
+        const double primitiveStartMs = emscripten_get_now();
+        rc = dev->pfnQueueSubmit(queue, 1u, &primitiveSubmitInfo, submitFence);
+        if (rc == VK_SUCCESS) {
+          rc = dev->pfnWaitForFences(device, 1u, &submitFence, VK_TRUE, UINT64_MAX);
+        }
+        if (rc != VK_SUCCESS) {
+          smokeRc = 122;
+          goto cleanup;
+        }
+        primitiveSample->submitMs[primitive] += emscripten_get_now() - primitiveStartMs;
+        primitiveSample->wasmSubmits[primitive] += webvulkan_get_runtime_wasm_used() ? 1u : 0u;
+      }
+      primitiveSample->submitMs[primitive] /= (double)kRuntimePrimitiveSubmitIterations;
+
+      uint32_t primitiveReferenceBins[WEBVULKAN_RUNTIME_PRIMITIVE_HISTOGRAM_BINS];
+      const double primitiveHostStartMs = emscripten_get_now();
+      const uint32_t primitiveReferenceSum = webvulkan_runtime_primitive_reference(
+        primitive,
+        primitiveElements,
+        kRuntimePrimitiveRadixShift,
+        primitiveReferenceWords,
+        primitiveReferenceBins
+      );
+      primitiveSample->hostMs[primitive] = emscripten_get_now() - primitiveHostStartMs;
+
+      const uint32_t* primitiveExpectedWords = primitiveReferenceWords;
+      const uint32_t* primitiveObservedWords = mappedPrimitiveWords + primitiveOutputOffset;
+      uint32_t primitiveCheckCount = primitiveElements;
+      if (primitive == WEBVULKAN_RUNTIME_PRIMITIVE_REDUCE) {
+        primitiveExpectedWords = &primitiveReferenceSum;
+        primitiveObservedWords = mappedPrimitiveWords + 5u;
+        primitiveCheckCount = 1u;
+      } else if (primitive == WEBVULKAN_RUNTIME_PRIMITIVE_HISTOGRAM) {
+        primitiveExpectedWords = primitiveReferenceBins;
+        primitiveObservedWords = mappedPrimitiveWords + primitiveBinsOffset;
+        primitiveCheckCount = WEBVULKAN_RUNTIME_PRIMITIVE_HISTOGRAM_BINS;
+      }
+      for (uint32_t index = 0u; index < primitiveCheckCount; ++index) {
+        if (primitiveObservedWords[index] != primitiveExpectedWords[index]) {
+          printf("lavapipe runtime smoke primitive mismatch\n");
+          printf("  primitive.kernel=%s\n", primitiveInfo->name);
+          printf("  primitive.elements=%u\n", primitiveElements);
+          printf("  primitive.index=%u\n", index);
+          printf("  primitive.expected=0x%08x\n", primitiveExpectedWords[index]);
+          printf("  primitive.observed=0x%08x\n", primitiveObservedWords[index]);
+          smokeRc = 123;
+          goto cleanup;
+        }
+      }
+    }
+  }
+
+  for (uint32_t k = 0u; k < primitiveKernelCount; ++k) {
+    webvulkan_runtime_unregister_shader_bundle(primitiveKernelKeys[k][0], primitiveKernelKeys[k][1]);
+  }
+  for (uint32_t shader = 0u; shader < WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_COUNT; ++shader) {
+    dev->pfnDestroyPipeline(device, primitivePipelines[shader], 0);
+    primitivePipelines[shader] = VK_NULL_HANDLE;
+    dev->pfnDestroyShaderModule(device, primitiveShaderModules[shader], 0);
+    primitiveShaderModules[shader] = VK_NULL_HANDLE;
+  }
+  dev->pfnDestroyPipelineLayout(device, primitivePipelineLayout, 0);
+  primitivePipelineLayout = VK_NULL_HANDLE;
+  dev->pfnDestroyDescriptorPool(device, primitiveDescriptorPool, 0);
+  primitiveDescriptorPool = VK_NULL_HANDLE;
+  dev->pfnDestroyDescriptorSetLayout(device, primitiveSetLayout, 0);
+  primitiveSetLayout = VK_NULL_HANDLE;
+  dev->pfnUnmapMemory(device, primitiveMemory);
+  mappedPrimitiveWords = 0;
+  dev->pfnDestroyBuffer(device, primitiveBuffer, 0);
+  primitiveBuffer = VK_NULL_HANDLE;
+  dev->pfnFreeMemory(device, primitiveMemory, 0);
+  primitiveMemory = VK_NULL_HANDLE;
+  free(primitiveReferenceWords);
+  primitiveReferenceWords = 0;
+
+cleanup:
+  if (smokeRc != 0) {
+    for (uint32_t k = 0u; k < primitiveKernelCount; ++k) {
+      webvulkan_runtime_unregister_shader_bundle(primitiveKernelKeys[k][0], primitiveKernelKeys[k][1]);
+    }
+  }
+  free(primitiveReferenceWords);
+  for (uint32_t shader = 0u; shader < WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_COUNT; ++shader) {
+    if (primitivePipelines[shader] != VK_NULL_HANDLE && dev->pfnDestroyPipeline) {
+      dev->pfnDestroyPipeline(device, primitivePipelines[shader], 0);
+    }
+    if (primitiveShaderModules[shader] != VK_NULL_HANDLE && dev->pfnDestroyShaderModule) {
+      dev->pfnDestroyShaderModule(device, primitiveShaderModules[shader], 0);
+    }
+  }
+  if (primitivePipelineLayout != VK_NULL_HANDLE && dev->pfnDestroyPipelineLayout) {
+    dev->pfnDestroyPipelineLayout(device, primitivePipelineLayout, 0);
+  }
+  if (primitiveDescriptorPool != VK_NULL_HANDLE && dev->pfnDestroyDescriptorPool) {
+    dev->pfnDestroyDescriptorPool(device, primitiveDescriptorPool, 0);
+  }
+  if (primitiveSetLayout != VK_NULL_HANDLE && dev->pfnDestroyDescriptorSetLayout) {
+    dev->pfnDestroyDescriptorSetLayout(device, primitiveSetLayout, 0);
+  }
+  if (mappedPrimitiveWords && dev->pfnUnmapMemory) {
+    dev->pfnUnmapMemory(device, primitiveMemory);
+  }
+  if (primitiveBuffer != VK_NULL_HANDLE && dev->pfnDestroyBuffer) {
+    dev->pfnDestroyBuffer(device, primitiveBuffer, 0);
+  }
+  if (primitiveMemory != VK_NULL_HANDLE && dev->pfnFreeMemory) {
+    dev->pfnFreeMemory(device, primitiveMemory, 0);
+  }
+  *outSampleCount = primitiveSampleCount;
+  *outKernelCount = primitiveKernelCount;
+  return smokeRc;
+}
+
+/* Draws every render scene at each bench size up to `renderBenchSize` and reads the target back. */
+static int webvulkan_run_runtime_render_bench(
+  const WebVulkanRuntimeSmokeDevice* dev,
+  uint32_t renderBenchSize,
+  WebVulkanRuntimeRenderSample* renderSamples,
+  uint32_t* outSampleCount,
+  uint32_t* outSizeCount
+) {
+  const VkDevice device = dev->device;
+  const VkQueue queue = dev->queue;
+  const VkFence submitFence = dev->submitFence;
+  VkImage renderImages[2] = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+  VkDeviceMemory renderImageMemories[2] = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+  VkImageView renderImageViews[2] = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+  uint8_t* mappedRenderImages[2] = { 0, 0 };
+  VkSubresourceLayout renderImageLayouts[2];
+  VkRenderPass renderPass = VK_NULL_HANDLE;
+  VkFramebuffer renderFramebuffer = VK_NULL_HANDLE;
+  VkShaderModule renderShaderModules[WEBVULKAN_RUNTIME_RENDER_SHADER_COUNT];
+  memset(renderShaderModules, 0, sizeof(renderShaderModules));
+  VkDescriptorSetLayout renderSetLayout = VK_NULL_HANDLE;
+  VkDescriptorPool renderDescriptorPool = VK_NULL_HANDLE;
+  VkPipelineLayout renderPipelineLayout = VK_NULL_HANDLE;
+  VkPipeline renderPipelines[WEBVULKAN_RUNTIME_RENDER_SCENE_COUNT];
+  memset(renderPipelines, 0, sizeof(renderPipelines));
+  VkCommandBuffer renderCommandBuffer = VK_NULL_HANDLE;
+  uint32_t* renderReadbackPixels = 0;
+  uint32_t renderSizes[WEBVULKAN_RUNTIME_RENDER_MAX_SIZE_COUNT];
+  uint32_t renderSizeCount = 0u;
+  uint32_t renderSampleCount = 0u;
+  int smokeRc = 0;
+  VkResult rc = VK_SUCCESS;
+
+  if (!dev->pfnCreateRenderPass || !dev->pfnDestroyRenderPass || !dev->pfnCreateFramebuffer || !dev->pfnDestroyFramebuffer ||
+      !dev->pfnCreateGraphicsPipelines || !dev->pfnCmdBeginRenderPass || !dev->pfnCmdEndRenderPass || !dev->pfnCmdDraw ||
+      !dev->pfnCmdSetViewport || !dev->pfnCmdSetScissor || !dev->pfnCreateImage || !dev->pfnGetImageSubresourceLayout ||
+      !dev->pfnCreateImageView || !dev->pfnCmdPipelineBarrier) {
+    printf("lavapipe runtime smoke missing render entrypoints\n");
+    printf("  vkCreateRenderPass=%s\n", dev->pfnCreateRenderPass ? "present" : "missing");
+    printf("  vkDestroyRenderPass=%s\n", dev->pfnDestroyRenderPass ? "present" : "missing");
+    printf("  vkCreateFramebuffer=%s\n", dev->pfnCreateFramebuffer ? "present" : "missing");
+    printf("  vkDestroyFramebuffer=%s\n", dev->pfnDestroyFramebuffer ? "present" : "missing");
+    printf("  vkCreateGraphicsPipelines=%s\n", dev->pfnCreateGraphicsPipelines ? "present" : "missing");
+    printf("  vkCmdBeginRenderPass=%s\n", dev->pfnCmdBeginRenderPass ? "present" : "missing");
+    printf("  vkCmdEndRenderPass=%s\n", dev->pfnCmdEndRenderPass ? "present" : "missing");
+    printf("  vkCmdDraw=%s\n", dev->pfnCmdDraw ? "present" : "missing");
+    printf("  vkCmdSetViewport=%s\n", dev->pfnCmdSetViewport ? "present" : "missing");
+    printf("  vkCmdSetScissor=%s\n", dev->pfnCmdSetScissor ? "present" : "missing");
+    printf("  vkCmdPipelineBarrier=%s\n", dev->pfnCmdPipelineBarrier ? "present" : "missing");
+    smokeRc = 98;
+    goto cleanup;
+  }
+
+  /* Resolutions halve down from renderBenchSize; renderSizes[] holds them smallest first. */
+  for (uint32_t size = renderBenchSize;
+       size >= kRuntimeRenderMinSize && renderSizeCount < WEBVULKAN_RUNTIME_RENDER_MAX_SIZE_COUNT;
+       size >>= 1u) {
+    renderSizeCount += 1u;
+  }
+  for (uint32_t k = 0u; k < renderSizeCount; ++k) {
+    renderSizes[k] = renderBenchSize >> (renderSizeCount - 1u - k);
+  }
+
+  const char* renderEntrypoints[WEBVULKAN_RUNTIME_RENDER_SHADER_COUNT];
+  for (uint32_t shader = 0u; shader < WEBVULKAN_RUNTIME_RENDER_SHADER_COUNT; ++shader) {
+    const uint8_t* renderSpirvBytes = 0;
+    uint32_t renderSpirvSize = 0u;
+    const char* renderSpirvEntrypoint = 0;
+    if (!webvulkan_runtime_lookup_spirv_module(
+          g_runtime_render_shader_keys[shader][0],
+          g_runtime_render_shader_keys[shader][1],
+          &renderSpirvBytes,
+          &renderSpirvSize,
+          &renderSpirvEntrypoint
+        ) ||
+        !renderSpirvBytes ||
+        renderSpirvSize < 4u ||
+        (renderSpirvSize % 4u) != 0u) {
+      printf("lavapipe runtime smoke render shader missing\n");
+      printf("  render.shader=%u\n", shader);
+      printf("  render.key=0x%08x%08x\n", g_runtime_render_shader_keys[shader][1], g_runtime_render_shader_keys[shader][0]);
+      smokeRc = 99;
+      goto cleanup;
+    }
+    renderEntrypoints[shader] = renderSpirvEntrypoint && renderSpirvEntrypoint[0] ? renderSpirvEntrypoint : "main";
+    VkShaderModuleCreateInfo renderShaderCreateInfo;
+    memset(&renderShaderCreateInfo, 0, sizeof(renderShaderCreateInfo));
+    renderShaderCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    renderShaderCreateInfo.codeSize = (size_t)renderSpirvSize;
+    renderShaderCreateInfo.pCode = (const uint32_t*)renderSpirvBytes;
+    rc = dev->pfnCreateShaderModule(device, &renderShaderCreateInfo, 0, &renderShaderModules[shader]);
+    if (rc != VK_SUCCESS || renderShaderModules[shader] == VK_NULL_HANDLE) {
+      smokeRc = 99;
+      goto cleanup;
+    }
+  }
+
+  /* Image 0 is the linear, host-visible color attachment, read back in place at every size.
+     Image 1 is the textured_quads source, written by the host before first use. */
+  for (uint32_t i = 0u; i < 2u; ++i) {
+    const uint32_t renderImageSize = i == 0u ? renderBenchSize : kRuntimeRenderTextureSize;
+    VkImageCreateInfo renderImageCreateInfo;
+    memset(&renderImageCreateInfo, 0, sizeof(renderImageCreateInfo));
+    renderImageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    renderImageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+    renderImageCreateInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    renderImageCreateInfo.extent.width = renderImageSize;
+    renderImageCreateInfo.extent.height = renderImageSize;
+    renderImageCreateInfo.extent.depth = 1u;
+    renderImageCreateInfo.mipLevels = 1u;
+    renderImageCreateInfo.arrayLayers = 1u;
+    renderImageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    renderImageCreateInfo.tiling = VK_IMAGE_TILING_LINEAR;
+    renderImageCreateInfo.usage = i == 0u ? VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT : VK_IMAGE_USAGE_SAMPLED_BIT;
+    renderImageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    renderImageCreateInfo.initialLayout = i == 0u ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_PREINITIALIZED;
+    rc = dev->pfnCreateImage(device, &renderImageCreateInfo, 0, &renderImages[i]);
+    if (rc != VK_SUCCESS || renderImages[i] == VK_NULL_HANDLE) {
+      smokeRc = 100;
+      goto cleanup;
+    }
+
+    VkMemoryRequirements renderMemoryRequirements;
+    memset(&renderMemoryRequirements, 0, sizeof(renderMemoryRequirements));
+    dev->pfnGetImageMemoryRequirements(device, renderImages[i], &renderMemoryRequirements);
+    int renderHostCoherent = 0;
+    const uint32_t renderMemoryTypeIndex = find_memory_type_index(
+      &dev->memoryProperties,
+      renderMemoryRequirements.memoryTypeBits,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+      &renderHostCoherent
+    );
+    if (renderMemoryTypeIndex == UINT32_MAX || !renderHostCoherent) {
+      smokeRc = 100;
+      goto cleanup;
+    }
+
+    VkMemoryAllocateInfo renderAllocateInfo;
+    memset(&renderAllocateInfo, 0, sizeof(renderAllocateInfo));
+    renderAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    renderAllocateInfo.allocationSize = renderMemoryRequirements.size;
+    renderAllocateInfo.memoryTypeIndex = renderMemoryTypeIndex;
+    rc = dev->pfnAllocateMemory(device, &renderAllocateInfo, 0, &renderImageMemories[i]);
+    if (rc != VK_SUCCESS || renderImageMemories[i] == VK_NULL_HANDLE) {
+      smokeRc = 100;
+      goto cleanup;
+    }
+    rc = dev->pfnBindImageMemory(device, renderImages[i], renderImageMemories[i], 0u);
+    if (rc != VK_SUCCESS) {
+      smokeRc = 100;
+      goto cleanup;
+    }
+    rc = dev->pfnMapMemory(device, renderImageMemories[i], 0u, VK_WHOLE_SIZE, 0u, (void**)&mappedRenderImages[i]);
+    if (rc != VK_SUCCESS || !mappedRenderImages[i]) {
+      smokeRc = 100;
+      goto cleanup;
+    }
+
+    VkImageSubresource renderSubresource;
+    memset(&renderSubresource, 0, sizeof(renderSubresource));
+    renderSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    memset(&renderImageLayouts[i], 0, sizeof(renderImageLayouts[i]));
+    dev->pfnGetImageSubresourceLayout(device, renderImages[i], &renderSubresource, &renderImageLayouts[i]);
+    if (renderImageLayouts[i].rowPitch < sizeof(uint32_t) * (VkDeviceSize)renderImageSize) {
+      smokeRc = 100;
+      goto cleanup;
+    }
+
+    VkImageViewCreateInfo renderImageViewCreateInfo;
+    memset(&renderImageViewCreateInfo, 0, sizeof(renderImageViewCreateInfo));
+    renderImageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    renderImageViewCreateInfo.image = renderImages[i];
+    renderImageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    renderImageViewCreateInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    renderImageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    renderImageViewCreateInfo.subresourceRange.levelCount = 1u;
+    renderImageViewCreateInfo.subresourceRange.layerCount = 1u;
+    rc = dev->pfnCreateImageView(device, &renderImageViewCreateInfo, 0, &renderImageViews[i]);
+    if (rc != VK_SUCCESS || renderImageViews[i] == VK_NULL_HANDLE) {
+      smokeRc = 100;
+      goto cleanup;
+    }
+  }
+  for (uint32_t y = 0u; y < kRuntimeRenderTextureSize; ++y) {
+    uint32_t* texelRow =
+      (uint32_t*)(mappedRenderImages[1] + renderImageLayouts[1].offset + (size_t)y * (size_t)renderImageLayouts[1].rowPitch);
+    for (uint32_t x = 0u; x < kRuntimeRenderTextureSize; ++x) {
+      texelRow[x] = webvulkan_runtime_render_texel(x, y);
+    }
+  }
+
+  VkAttachmentDescription renderAttachment;
+  memset(&renderAttachment, 0, sizeof(renderAttachment));
+  renderAttachment.format = VK_FORMAT_R8G8B8A8_UNORM;
+  renderAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+  renderAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+  renderAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  renderAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+  renderAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  renderAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  renderAttachment.finalLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+  VkAttachmentReference renderColorReference;
+  renderColorReference.attachment = 0u;
+  renderColorReference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+  VkSubpassDescription renderSubpass;
+  memset(&renderSubpass, 0, sizeof(renderSubpass));
+  renderSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  renderSubpass.colorAttachmentCount = 1u;
+  renderSubpass.pColorAttachments = &renderColorReference;
+
+  /* Make the stored attachment visible to the host readback after the fence wait. */
+  VkSubpassDependency renderDependency;
+  memset(&renderDependency, 0, sizeof(renderDependency));
+  renderDependency.srcSubpass = 0u;
+  renderDependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+  renderDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  renderDependency.dstStageMask = VK_PIPELINE_STAGE_HOST_BIT;
+  renderDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  renderDependency.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+  VkRenderPassCreateInfo renderPassCreateInfo;
+  memset(&renderPassCreateInfo, 0, sizeof(renderPassCreateInfo));
+  renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+  renderPassCreateInfo.attachmentCount = 1u;
+  renderPassCreateInfo.pAttachments = &renderAttachment;
+  renderPassCreateInfo.subpassCount = 1u;
+  renderPassCreateInfo.pSubpasses = &renderSubpass;
+  renderPassCreateInfo.dependencyCount = 1u;
+  renderPassCreateInfo.pDependencies = &renderDependency;
+  rc = dev->pfnCreateRenderPass(device, &renderPassCreateInfo, 0, &renderPass);
+  if (rc != VK_SUCCESS || renderPass == VK_NULL_HANDLE) {
+    smokeRc = 101;
+    goto cleanup;
+  }
+
+  /* One framebuffer at the largest size; smaller sizes shrink the render area, viewport and scissor. */
+  VkFramebufferCreateInfo renderFramebufferCreateInfo;
+  memset(&renderFramebufferCreateInfo, 0, sizeof(renderFramebufferCreateInfo));
+  renderFramebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+  renderFramebufferCreateInfo.renderPass = renderPass;
+  renderFramebufferCreateInfo.attachmentCount = 1u;
+  renderFramebufferCreateInfo.pAttachments = &renderImageViews[0];
+  renderFramebufferCreateInfo.width = renderBenchSize;
+  renderFramebufferCreateInfo.height = renderBenchSize;
+  renderFramebufferCreateInfo.layers = 1u;
+  rc = dev->pfnCreateFramebuffer(device, &renderFramebufferCreateInfo, 0, &renderFramebuffer);
+  if (rc != VK_SUCCESS || renderFramebuffer == VK_NULL_HANDLE) {
+    smokeRc = 101;
+    goto cleanup;
+  }
+
+  VkDescriptorSetLayoutBinding renderSetLayoutBinding;
+  memset(&renderSetLayoutBinding, 0, sizeof(renderSetLayoutBinding));
+  renderSetLayoutBinding.binding = 0u;
+  renderSetLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+  renderSetLayoutBinding.descriptorCount = 1u;
+  renderSetLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+  VkDescriptorSetLayoutCreateInfo renderSetLayoutCreateInfo;
+  memset(&renderSetLayoutCreateInfo, 0, sizeof(renderSetLayoutCreateInfo));
+  renderSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  renderSetLayoutCreateInfo.bindingCount = 1u;
+  renderSetLayoutCreateInfo.pBindings = &renderSetLayoutBinding;
+  rc = dev->pfnCreateDescriptorSetLayout(device, &renderSetLayoutCreateInfo, 0, &renderSetLayout);
+  if (rc != VK_SUCCESS || renderSetLayout == VK_NULL_HANDLE) {
+    smokeRc = 101;
+    goto cleanup;
+  }
+
+  VkDescriptorPoolSize renderPoolSize;
+  renderPoolSize.type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+  renderPoolSize.descriptorCount = 1u;
+  VkDescriptorPoolCreateInfo renderPoolCreateInfo;
+  memset(&renderPoolCreateInfo, 0, sizeof(renderPoolCreateInfo));
+  renderPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  renderPoolCreateInfo.maxSets = 1u;
+  renderPoolCreateInfo.poolSizeCount = 1u;
+  renderPoolCreateInfo.pPoolSizes = &renderPoolSize;
+  rc = dev->pfnCreateDescriptorPool(device, &renderPoolCreateInfo, 0, &renderDescriptorPool);
+  if (rc != VK_SUCCESS || renderDescriptorPool == VK_NULL_HANDLE) {
+    smokeRc = 101;
+    goto cleanup;
+  }
+
+  VkDescriptorSetAllocateInfo renderSetAllocateInfo;
+  memset(&renderSetAllocateInfo, 0, sizeof(renderSetAllocateInfo));
+  renderSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  renderSetAllocateInfo.descriptorPool = renderDescriptorPool;
+  renderSetAllocateInfo.descriptorSetCount = 1u;
+  renderSetAllocateInfo.pSetLayouts = &renderSetLayout;
+  VkDescriptorSet renderDescriptorSet = VK_NULL_HANDLE;
+  rc = dev->pfnAllocateDescriptorSets(device, &renderSetAllocateInfo, &renderDescriptorSet);
+  if (rc != VK_SUCCESS || renderDescriptorSet == VK_NULL_HANDLE) {
+    smokeRc = 101;
+    goto cleanup;
+  }
+
+  VkDescriptorImageInfo renderTextureInfo;
+  memset(&renderTextureInfo, 0, sizeof(renderTextureInfo));
+  renderTextureInfo.imageView = renderImageViews[1];
+  renderTextureInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+  VkWriteDescriptorSet renderDescriptorWrite;
+  memset(&renderDescriptorWrite, 0, sizeof(renderDescriptorWrite));
+  renderDescriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  renderDescriptorWrite.dstSet = renderDescriptorSet;
+  renderDescriptorWrite.dstBinding = 0u;
+  renderDescriptorWrite.descriptorCount = 1u;
+  renderDescriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+  renderDescriptorWrite.pImageInfo = &renderTextureInfo;
+  dev->pfnUpdateDescriptorSets(device, 1u, &renderDescriptorWrite, 0u, 0);
+
+  /* All scenes share one layout: the texture set for texture_ps and the grid size pushed to render_grid_vs. */
+  VkPushConstantRange renderPushConstantRange;
+  renderPushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+  renderPushConstantRange.offset = 0u;
+  renderPushConstantRange.size = sizeof(uint32_t);
+  VkPipelineLayoutCreateInfo renderPipelineLayoutCreateInfo;
+  memset(&renderPipelineLayoutCreateInfo, 0, sizeof(renderPipelineLayoutCreateInfo));
+  renderPipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  renderPipelineLayoutCreateInfo.setLayoutCount = 1u;
+  renderPipelineLayoutCreateInfo.pSetLayouts = &renderSetLayout;
+  renderPipelineLayoutCreateInfo.pushConstantRangeCount = 1u;
+  renderPipelineLayoutCreateInfo.pPushConstantRanges = &renderPushConstantRange;
+  rc = dev->pfnCreatePipelineLayout(device, &renderPipelineLayoutCreateInfo, 0, &renderPipelineLayout);
+  if (rc != VK_SUCCESS || renderPipelineLayout == VK_NULL_HANDLE) {
+    smokeRc = 102;
+    goto cleanup;
+  }
+
+  VkPipelineShaderStageCreateInfo renderStages[2];
+  memset(renderStages, 0, sizeof(renderStages));
+  for (uint32_t stage = 0u; stage < 2u; ++stage) {
+    renderStages[stage].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    renderStages[stage].stage = stage == 0u ? VK_SHADER_STAGE_VERTEX_BIT : VK_SHADER_STAGE_FRAGMENT_BIT;
+  }
+
+  /* Both vertex shaders derive positions from SV_VertexID, so there is no vertex input. */
+  VkPipelineVertexInputStateCreateInfo renderVertexInput;
+  memset(&renderVertexInput, 0, sizeof(renderVertexInput));
+  renderVertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+  VkPipelineInputAssemblyStateCreateInfo renderInputAssembly;
+  memset(&renderInputAssembly, 0, sizeof(renderInputAssembly));
+  renderInputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+  renderInputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+  VkPipelineViewportStateCreateInfo renderViewportState;
+  memset(&renderViewportState, 0, sizeof(renderViewportState));
+  renderViewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+  renderViewportState.viewportCount = 1u;
+  renderViewportState.scissorCount = 1u;
+
+  const VkDynamicState renderDynamicStates[2] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+  VkPipelineDynamicStateCreateInfo renderDynamicState;
+  memset(&renderDynamicState, 0, sizeof(renderDynamicState));
+  renderDynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+  renderDynamicState.dynamicStateCount = 2u;
+  renderDynamicState.pDynamicStates = renderDynamicStates;
+
+  VkPipelineRasterizationStateCreateInfo renderRasterization;
+  memset(&renderRasterization, 0, sizeof(renderRasterization));
+  renderRasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+  renderRasterization.polygonMode = VK_POLYGON_MODE_FILL;
+  renderRasterization.cullMode = VK_CULL_MODE_NONE;
+  renderRasterization.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+  renderRasterization.lineWidth = 1.0f;
+
+  VkPipelineMultisampleStateCreateInfo renderMultisample;
+  memset(&renderMultisample, 0, sizeof(renderMultisample));
+  renderMultisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+  renderMultisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+  VkPipelineColorBlendAttachmentState renderBlendAttachment;
+  memset(&renderBlendAttachment, 0, sizeof(renderBlendAttachment));
+  renderBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+  renderBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+  renderBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+  renderBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+  renderBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+  renderBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+  renderBlendAttachment.colorWriteMask =
+    VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+  VkPipelineColorBlendStateCreateInfo renderColorBlend;
+  memset(&renderColorBlend, 0, sizeof(renderColorBlend));
+  renderColorBlend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+  renderColorBlend.attachmentCount = 1u;
+  renderColorBlend.pAttachments = &renderBlendAttachment;
+
+  VkGraphicsPipelineCreateInfo renderPipelineCreateInfo;
+  memset(&renderPipelineCreateInfo, 0, sizeof(renderPipelineCreateInfo));
+  renderPipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+  renderPipelineCreateInfo.stageCount = 2u;
+  renderPipelineCreateInfo.pStages = renderStages;
+  renderPipelineCreateInfo.pVertexInputState = &renderVertexInput;
+  renderPipelineCreateInfo.pInputAssemblyState = &renderInputAssembly;
+  renderPipelineCreateInfo.pViewportState = &renderViewportState;
+  renderPipelineCreateInfo.pRasterizationState = &renderRasterization;
+  renderPipelineCreateInfo.pMultisampleState = &renderMultisample;
+  renderPipelineCreateInfo.pColorBlendState = &renderColorBlend;
+  renderPipelineCreateInfo.pDynamicState = &renderDynamicState;
+  renderPipelineCreateInfo.layout = renderPipelineLayout;
+  renderPipelineCreateInfo.renderPass = renderPass;
+  renderPipelineCreateInfo.subpass = 0u;
+  renderPipelineCreateInfo.basePipelineIndex = -1;
+
+  for (uint32_t scene = 0u; scene < WEBVULKAN_RUNTIME_RENDER_SCENE_COUNT; ++scene) {
+    const WebVulkanRuntimeRenderScene* renderScene = &g_runtime_render_scenes[scene];
+    if (!renderScene->drawsGeometry) {
+      continue;
+    }
+    renderStages[0].module = renderShaderModules[renderScene->vertexShader];
+    renderStages[0].pName = renderEntrypoints[renderScene->vertexShader];
+    renderStages[1].module = renderShaderModules[renderScene->fragmentShader];
+    renderStages[1].pName = renderEntrypoints[renderScene->fragmentShader];
+    renderBlendAttachment.blendEnable = renderScene->blend ? VK_TRUE : VK_FALSE;
+    rc = dev->pfnCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1u, &renderPipelineCreateInfo, 0, &renderPipelines[scene]);
+    if (rc != VK_SUCCESS || renderPipelines[scene] == VK_NULL_HANDLE) {
+      printf("lavapipe runtime smoke render pipeline failed\n");
+      printf("  render.scene=%s\n", renderScene->name);
+      smokeRc = 102;
+      goto cleanup;
+    }
+  }
+
+  rc = dev->pfnAllocateCommandBuffers(device, &dev->commandBufferAllocateInfo, &renderCommandBuffer);
+  if (rc != VK_SUCCESS || renderCommandBuffer == VK_NULL_HANDLE) {
+    smokeRc = 103;
+    goto cleanup;
+  }
+
+  VkSubmitInfo renderSubmitInfo;
+  memset(&renderSubmitInfo, 0, sizeof(renderSubmitInfo));
+  renderSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  renderSubmitInfo.commandBufferCount = 1u;
+  renderSubmitInfo.pCommandBuffers = &renderCommandBuffer;
+
+  /* Move the host-written texture to GENERAL once, outside the timed submits. */
+  rc = dev->pfnBeginCommandBuffer(renderCommandBuffer, &dev->commandBufferBeginInfo);
+  if (rc != VK_SUCCESS) {
+    smokeRc = 103;
+    goto cleanup;
+  }
+  VkImageMemoryBarrier renderTextureBarrier;
+  memset(&renderTextureBarrier, 0, sizeof(renderTextureBarrier));
+  renderTextureBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  renderTextureBarrier.srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
+  renderTextureBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  renderTextureBarrier.oldLayout = VK_IMAGE_LAYOUT_PREINITIALIZED;
+  renderTextureBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+  renderTextureBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  renderTextureBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  renderTextureBarrier.image = renderImages[1];
+  renderTextureBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  renderTextureBarrier.subresourceRange.levelCount = 1u;
+  renderTextureBarrier.subresourceRange.layerCount = 1u;
+  dev->pfnCmdPipelineBarrier(
+    renderCommandBuffer,
+    VK_PIPELINE_STAGE_HOST_BIT,
+    VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+    0u,
+    0u,
+    0,
+    0u,
+    0,
+    1u,
+    &renderTextureBarrier
+  );
+  rc = dev->pfnEndCommandBuffer(renderCommandBuffer);
+  if (rc == VK_SUCCESS) {
+    rc = dev->pfnResetFences(device, 1u, &submitFence);
+  }
+  if (rc == VK_SUCCESS) {
+    rc = dev->pfnQueueSubmit(queue, 1u, &renderSubmitInfo, submitFence);
+  }
+  if (rc == VK_SUCCESS) {
+    rc = dev->pfnWaitForFences(device, 1u, &submitFence, VK_TRUE, UINT64_MAX);
+  }
+  if (rc != VK_SUCCESS) {
+    smokeRc = 103;
+    goto cleanup;
+  }
+
+  VkClearValue renderClearValue;
+  memset(&renderClearValue, 0, sizeof(renderClearValue));
+  renderClearValue.color.float32[0] = (float)(kRuntimeRenderClearColor & 255u) / 255.0f;
+  renderClearValue.color.float32[1] = (float)((kRuntimeRenderClearColor >> 8u) & 255u) / 255.0f;
+  renderClearValue.color.float32[2] = (float)((kRuntimeRenderClearColor >> 16u) & 255u) / 255.0f;
+  renderClearValue.color.float32[3] = (float)(kRuntimeRenderClearColor >> 24u) / 255.0f;
+  VkRenderPassBeginInfo renderPassBeginInfo;
+  memset(&renderPassBeginInfo, 0, sizeof(renderPassBeginInfo));
+  renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+  renderPassBeginInfo.renderPass = renderPass;
+  renderPassBeginInfo.framebuffer = renderFramebuffer;
+  renderPassBeginInfo.clearValueCount = 1u;
+  renderPassBeginInfo.pClearValues = &renderClearValue;
+
+  renderReadbackPixels = (uint32_t*)malloc(sizeof(uint32_t) * (size_t)renderBenchSize * (size_t)renderBenchSize);
+  if (!renderReadbackPixels) {
+    smokeRc = 100;
+    goto cleanup;
+  }
+
+  for (uint32_t scene = 0u; scene < WEBVULKAN_RUNTIME_RENDER_SCENE_COUNT; ++scene) {
+    const WebVulkanRuntimeRenderScene* renderScene = &g_runtime_render_scenes[scene];
+    const uint32_t renderVertexCount =
+      renderScene->gridCells == 0u ? 3u : renderScene->gridCells * renderScene->gridCells * 6u;
+    for (uint32_t k = 0u; k < renderSizeCount; ++k) {
+      const uint32_t renderSize = renderSizes[k];
+      WebVulkanRuntimeRenderSample* renderSample = &renderSamples[renderSampleCount++];
+      memset(renderSample, 0, sizeof(*renderSample));
+      renderSample->scene = scene;
+      renderSample->width = renderSize;
+      renderSample->height = renderSize;
+      renderSample->trianglesPerDraw = renderScene->drawsGeometry ? renderVertexCount / 3u : 0u;
+      renderSample->drawsPerSubmit = kRuntimeRenderDrawsPerSubmit;
+      renderSample->submitIterations = kRuntimeRenderSubmitIterations;
+
+      VkViewport renderViewport;
+      renderViewport.x = 0.0f;
+      renderViewport.y = 0.0f;
+      renderViewport.width = (float)renderSize;
+      renderViewport.height = (float)renderSize;
+      renderViewport.minDepth = 0.0f;
+      renderViewport.maxDepth = 1.0f;
+      renderPassBeginInfo.renderArea.offset.x = 0;
+      renderPassBeginInfo.renderArea.offset.y = 0;
+      renderPassBeginInfo.renderArea.extent.width = renderSize;
+      renderPassBeginInfo.renderArea.extent.height = renderSize;
+
+      rc = dev->pfnBeginCommandBuffer(renderCommandBuffer, &dev->commandBufferBeginInfo);
+      if (rc != VK_SUCCESS) {
+        smokeRc = 103;
+        goto cleanup;
+      }
+      /* Each pass clears and redraws the render area, so every submit touches size^2 * draws pixels. */
+      for (uint32_t draw = 0u; draw < kRuntimeRenderDrawsPerSubmit; ++draw) {
+        dev->pfnCmdBeginRenderPass(renderCommandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+        if (renderScene->drawsGeometry) {
+          dev->pfnCmdBindPipeline(renderCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, renderPipelines[scene]);
+          dev->pfnCmdSetViewport(renderCommandBuffer, 0u, 1u, &renderViewport);
+          dev->pfnCmdSetScissor(renderCommandBuffer, 0u, 1u, &renderPassBeginInfo.renderArea);
+          dev->pfnCmdBindDescriptorSets(
+            renderCommandBuffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            renderPipelineLayout,
+            0u,
+            1u,
+            &renderDescriptorSet,
+            0u,
+            0
+          );
+          dev->pfnCmdPushConstants(
+            renderCommandBuffer,
+            renderPipelineLayout,
+            VK_SHADER_STAGE_VERTEX_BIT,
+            0u,
+            sizeof(uint32_t),
+            &renderScene->gridCells
+          );
+          dev->pfnCmdDraw(renderCommandBuffer, renderVertexCount, 1u, 0u, 0u);
+        }
+        dev->pfnCmdEndRenderPass(renderCommandBuffer);
+      }
+      rc = dev->pfnEndCommandBuffer(renderCommandBuffer);
+      if (rc != VK_SUCCESS) {
+        smokeRc = 103;
+        goto cleanup;
+      }
+
+      const size_t renderRowBytes = sizeof(uint32_t) * (size_t)renderSize;
+      for (uint32_t y = 0u; y < renderSize; ++y) {
+        memset(
+          mappedRenderImages[0] + renderImageLayouts[0].offset + (size_t)y * (size_t)renderImageLayouts[0].rowPitch,
+          0,
+          renderRowBytes
+        );
+      }
+      const double renderStartMs = emscripten_get_now();
+      for (uint32_t iteration = 0u; iteration < kRuntimeRenderSubmitIterations; ++iteration) {
+        rc = dev->pfnResetFences(device, 1u, &submitFence);
+        if (rc == VK_SUCCESS) {
+          rc = dev->pfnQueueSubmit(queue, 1u, &renderSubmitInfo, submitFence);
+        }
+        if (rc == VK_SUCCESS) {
+          rc = dev->pfnWaitForFences(device, 1u, &submitFence, VK_TRUE, UINT64_MAX);
+        }
+        if (rc != VK_SUCCESS) {
+          smokeRc = 104;
+          goto cleanup;
+        }
+      }
+      renderSample->submitMs = emscripten_get_now() - renderStartMs;
+
+      const double renderReadbackStartMs = emscripten_get_now();
+      for (uint32_t y = 0u; y < renderSize; ++y) {
+        memcpy(
+          &renderReadbackPixels[(size_t)y * (size_t)renderSize],
+          mappedRenderImages[0] + renderImageLayouts[0].offset + (size_t)y * (size_t)renderImageLayouts[0].rowPitch,
+          renderRowBytes
+        );
+      }
+      renderSample->readbackMs = emscripten_get_now() - renderReadbackStartMs;
+
+      for (uint32_t y = 0u; y < renderSize; ++y) {
+        for (uint32_t x = 0u; x < renderSize; ++x) {
+          const uint32_t expectedValue = webvulkan_runtime_render_reference(scene, x, y);
+          const uint32_t observedValue = renderReadbackPixels[(size_t)y * (size_t)renderSize + x];
+          if (!webvulkan_runtime_render_pixel_matches(scene, expectedValue, observedValue)) {
+            printf("lavapipe runtime smoke render mismatch\n");
+            printf("  render.scene=%s\n", renderScene->name);
+            printf("  render.size=%ux%u\n", renderSize, renderSize);
+            printf("  render.x=%u\n", x);
+            printf("  render.y=%u\n", y);
+            printf("  render.expected=0x%08x\n", expectedValue);
+            printf("  render.observed=0x%08x\n", observedValue);
+            smokeRc = 105;
+            goto cleanup;
+          }
+        }
+      }
+      renderSample->pixelsChecked = renderSize * renderSize;
+    }
+  }
+
+cleanup:
+  free(renderReadbackPixels);
+  for (uint32_t scene = 0u; scene < WEBVULKAN_RUNTIME_RENDER_SCENE_COUNT; ++scene) {
+    if (renderPipelines[scene] != VK_NULL_HANDLE && dev->pfnDestroyPipeline) {
+      dev->pfnDestroyPipeline(device, renderPipelines[scene], 0);
+    }
+  }
+  if (renderPipelineLayout != VK_NULL_HANDLE && dev->pfnDestroyPipelineLayout) {
+    dev->pfnDestroyPipelineLayout(device, renderPipelineLayout, 0);
+  }
+  if (renderDescriptorPool != VK_NULL_HANDLE && dev->pfnDestroyDescriptorPool) {
+    dev->pfnDestroyDescriptorPool(device, renderDescriptorPool, 0);
+  }
+  if (renderSetLayout != VK_NULL_HANDLE && dev->pfnDestroyDescriptorSetLayout) {
+    dev->pfnDestroyDescriptorSetLayout(device, renderSetLayout, 0);
+  }
+  for (uint32_t shader = 0u; shader < WEBVULKAN_RUNTIME_RENDER_SHADER_COUNT; ++shader) {
+    if (renderShaderModules[shader] != VK_NULL_HANDLE && dev->pfnDestroyShaderModule) {
+      dev->pfnDestroyShaderModule(device, renderShaderModules[shader], 0);
+    }
+  }
+  if (renderFramebuffer != VK_NULL_HANDLE && dev->pfnDestroyFramebuffer) {
+    dev->pfnDestroyFramebuffer(device, renderFramebuffer, 0);
+  }
+  if (renderPass != VK_NULL_HANDLE && dev->pfnDestroyRenderPass) {
+    dev->pfnDestroyRenderPass(device, renderPass, 0);
+  }
+  for (uint32_t i = 0u; i < 2u; ++i) {
+    if (renderImageViews[i] != VK_NULL_HANDLE && dev->pfnDestroyImageView) {
+      dev->pfnDestroyImageView(device, renderImageViews[i], 0);
+    }
+    if (mappedRenderImages[i] && dev->pfnUnmapMemory) {
+      dev->pfnUnmapMemory(device, renderImageMemories[i]);
+    }
+    if (renderImages[i] != VK_NULL_HANDLE && dev->pfnDestroyImage) {
+      dev->pfnDestroyImage(device, renderImages[i], 0);
+    }
+    if (renderImageMemories[i] != VK_NULL_HANDLE && dev->pfnFreeMemory) {
+      dev->pfnFreeMemory(device, renderImageMemories[i], 0);
+    }
+  }
+  *outSampleCount = renderSampleCount;
+  *outSizeCount = renderSizeCount;
+  return smokeRc;
+}
+
+/* Draws point lists up to `vertexBenchMaxVertices` vertices and checks the transformed positions. */
+static int webvulkan_run_runtime_vertex_bench(
+  const WebVulkanRuntimeSmokeDevice* dev,
+  uint32_t vertexBenchMaxVertices,
+  WebVulkanRuntimeVertexSample* vertexSamples,
+  uint32_t* outSampleCount
+) {
+  const VkDevice device = dev->device;
+  const VkQueue queue = dev->queue;
+  const VkFence submitFence = dev->submitFence;
+  VkShaderModule vertexShaderModule = VK_NULL_HANDLE;
+  VkBuffer vertexBuffers[2] = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+  VkDeviceMemory vertexMemories[2] = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+  float* mappedVertexFloats[2] = { 0, 0 };
+  VkDescriptorSetLayout vertexSetLayout = VK_NULL_HANDLE;
+  VkDescriptorPool vertexDescriptorPool = VK_NULL_HANDLE;
+  VkPipelineLayout vertexPipelineLayout = VK_NULL_HANDLE;
+  VkRenderPass vertexRenderPass = VK_NULL_HANDLE;
+  VkFramebuffer vertexFramebuffer = VK_NULL_HANDLE;
+  VkPipeline vertexPipeline = VK_NULL_HANDLE;
+  VkCommandBuffer vertexCommandBuffer = VK_NULL_HANDLE;
+  uint32_t vertexSampleCount = 0u;
+  int smokeRc = 0;
+  VkResult rc = VK_SUCCESS;
+
+  if (!dev->pfnCreateRenderPass || !dev->pfnDestroyRenderPass || !dev->pfnCreateFramebuffer || !dev->pfnDestroyFramebuffer ||
+      !dev->pfnCreateGraphicsPipelines || !dev->pfnCmdBeginRenderPass || !dev->pfnCmdEndRenderPass || !dev->pfnCmdDraw ||
+      !dev->pfnCmdBindVertexBuffers) {
+    printf("lavapipe runtime smoke missing vertex entrypoints\n");
+    printf("  vkCreateRenderPass=%s\n", dev->pfnCreateRenderPass ? "present" : "missing");
+    printf("  vkCreateFramebuffer=%s\n", dev->pfnCreateFramebuffer ? "present" : "missing");
+    printf("  vkCreateGraphicsPipelines=%s\n", dev->pfnCreateGraphicsPipelines ? "present" : "missing");
+    printf("  vkCmdBeginRenderPass=%s\n", dev->pfnCmdBeginRenderPass ? "present" : "missing");
+    printf("  vkCmdDraw=%s\n", dev->pfnCmdDraw ? "present" : "missing");
+    printf("  vkCmdBindVertexBuffers=%s\n", dev->pfnCmdBindVertexBuffers ? "present" : "missing");
+    smokeRc = 106;
+    goto cleanup;
+  }
+
+  const uint8_t* vertexSpirvBytes = 0;
+  uint32_t vertexSpirvSize = 0u;
+  const char* vertexSpirvEntrypoint = 0;
+  if (!webvulkan_runtime_lookup_spirv_module(
+        g_runtime_vertex_shader_key[0],
+        g_runtime_vertex_shader_key[1],
+        &vertexSpirvBytes,
+        &vertexSpirvSize,
+        &vertexSpirvEntrypoint
+      ) ||
+      !vertexSpirvBytes ||
+      vertexSpirvSize < 4u ||
+      (vertexSpirvSize % 4u) != 0u) {
+    printf("lavapipe runtime smoke vertex shader missing\n");
+    printf("  vertex.key=0x%08x%08x\n", g_runtime_vertex_shader_key[1], g_runtime_vertex_shader_key[0]);
+    smokeRc = 107;
+    goto cleanup;
+  }
+  VkShaderModuleCreateInfo vertexShaderCreateInfo;
+  memset(&vertexShaderCreateInfo, 0, sizeof(vertexShaderCreateInfo));
+  vertexShaderCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+  vertexShaderCreateInfo.codeSize = (size_t)vertexSpirvSize;
+  vertexShaderCreateInfo.pCode = (const uint32_t*)vertexSpirvBytes;
+  rc = dev->pfnCreateShaderModule(device, &vertexShaderCreateInfo, 0, &vertexShaderModule);
+  if (rc != VK_SUCCESS || vertexShaderModule == VK_NULL_HANDLE) {
+    smokeRc = 107;
+    goto cleanup;
+  }
+
+  /* Buffer 0 holds the input positions, buffer 1 is the storage buffer the shader writes. */
+  const VkDeviceSize vertexBufferBytes = (VkDeviceSize)vertexBenchMaxVertices * kRuntimeVertexStrideBytes;
+  for (uint32_t b = 0u; b < 2u; ++b) {
+    VkBufferCreateInfo vertexBufferCreateInfo;
+    memset(&vertexBufferCreateInfo, 0, sizeof(vertexBufferCreateInfo));
+    vertexBufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    vertexBufferCreateInfo.size = vertexBufferBytes;
+    vertexBufferCreateInfo.usage = b == 0u ? VK_BUFFER_USAGE_VERTEX_BUFFER_BIT : VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    vertexBufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    rc = dev->pfnCreateBuffer(device, &vertexBufferCreateInfo, 0, &vertexBuffers[b]);
+    if (rc != VK_SUCCESS || vertexBuffers[b] == VK_NULL_HANDLE) {
+      smokeRc = 108;
+      goto cleanup;
+    }
+
+    VkMemoryRequirements vertexMemoryRequirements;
+    memset(&vertexMemoryRequirements, 0, sizeof(vertexMemoryRequirements));
+    dev->pfnGetBufferMemoryRequirements(device, vertexBuffers[b], &vertexMemoryRequirements);
+    int vertexHostCoherent = 0;
+    const uint32_t vertexMemoryTypeIndex = find_memory_type_index(
+      &dev->memoryProperties,
+      vertexMemoryRequirements.memoryTypeBits,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+      &vertexHostCoherent
+    );
+    if (vertexMemoryTypeIndex == UINT32_MAX || !vertexHostCoherent) {
+      smokeRc = 108;
+      goto cleanup;
+    }
+
+    VkMemoryAllocateInfo vertexAllocateInfo;
+    memset(&vertexAllocateInfo, 0, sizeof(vertexAllocateInfo));
+    vertexAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    vertexAllocateInfo.allocationSize = vertexMemoryRequirements.size;
+    vertexAllocateInfo.memoryTypeIndex = vertexMemoryTypeIndex;
+    rc = dev->pfnAllocateMemory(device, &vertexAllocateInfo, 0, &vertexMemories[b]);
+    if (rc != VK_SUCCESS || vertexMemories[b] == VK_NULL_HANDLE) {
+      smokeRc = 108;
+      goto cleanup;
+    }
+    rc = dev->pfnBindBufferMemory(device, vertexBuffers[b], vertexMemories[b], 0u);
+    if (rc != VK_SUCCESS) {
+      smokeRc = 108;
+      goto cleanup;
+    }
+    rc = dev->pfnMapMemory(device, vertexMemories[b], 0u, vertexBufferBytes, 0u, (void**)&mappedVertexFloats[b]);
+    if (rc != VK_SUCCESS || !mappedVertexFloats[b]) {
+      smokeRc = 108;
+      goto cleanup;
+    }
+  }
+  for (uint32_t v = 0u; v < vertexBenchMaxVertices; ++v) {
+    webvulkan_runtime_vertex_position(v, &mappedVertexFloats[0][v * 4u]);
+  }
+
+  VkDescriptorSetLayoutBinding vertexSetLayoutBinding;
+  memset(&vertexSetLayoutBinding, 0, sizeof(vertexSetLayoutBinding));
+  vertexSetLayoutBinding.binding = 0u;
+  vertexSetLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  vertexSetLayoutBinding.descriptorCount = 1u;
+  vertexSetLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+  VkDescriptorSetLayoutCreateInfo vertexSetLayoutCreateInfo;
+  memset(&vertexSetLayoutCreateInfo, 0, sizeof(vertexSetLayoutCreateInfo));
+  vertexSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  vertexSetLayoutCreateInfo.bindingCount = 1u;
+  vertexSetLayoutCreateInfo.pBindings = &vertexSetLayoutBinding;
+  rc = dev->pfnCreateDescriptorSetLayout(device, &vertexSetLayoutCreateInfo, 0, &vertexSetLayout);
+  if (rc != VK_SUCCESS || vertexSetLayout == VK_NULL_HANDLE) {
+    smokeRc = 109;
+    goto cleanup;
+  }
+
+  VkDescriptorPoolSize vertexPoolSize;
+  vertexPoolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  vertexPoolSize.descriptorCount = 1u;
+  VkDescriptorPoolCreateInfo vertexPoolCreateInfo;
+  memset(&vertexPoolCreateInfo, 0, sizeof(vertexPoolCreateInfo));
+  vertexPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  vertexPoolCreateInfo.maxSets = 1u;
+  vertexPoolCreateInfo.poolSizeCount = 1u;
+  vertexPoolCreateInfo.pPoolSizes = &vertexPoolSize;
+  rc = dev->pfnCreateDescriptorPool(device, &vertexPoolCreateInfo, 0, &vertexDescriptorPool);
+  if (rc != VK_SUCCESS || vertexDescriptorPool == VK_NULL_HANDLE) {
+    smokeRc = 109;
+    goto cleanup;
+  }
+
+  VkDescriptorSetAllocateInfo vertexSetAllocateInfo;
+  memset(&vertexSetAllocateInfo, 0, sizeof(vertexSetAllocateInfo));
+  vertexSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  vertexSetAllocateInfo.descriptorPool = vertexDescriptorPool;
+  vertexSetAllocateInfo.descriptorSetCount = 1u;
+  vertexSetAllocateInfo.pSetLayouts = &vertexSetLayout;
+  VkDescriptorSet vertexDescriptorSet = VK_NULL_HANDLE;
+  rc = dev->pfnAllocateDescriptorSets(device, &vertexSetAllocateInfo, &vertexDescriptorSet);
+  if (rc != VK_SUCCESS || vertexDescriptorSet == VK_NULL_HANDLE) {
+    smokeRc = 109;
+    goto cleanup;
+  }
+
+  VkDescriptorBufferInfo vertexStorageInfo;
+  vertexStorageInfo.buffer = vertexBuffers[1];
+  vertexStorageInfo.offset = 0u;
+  vertexStorageInfo.range = vertexBufferBytes;
+  VkWriteDescriptorSet vertexDescriptorWrite;
+  memset(&vertexDescriptorWrite, 0, sizeof(vertexDescriptorWrite));
+  vertexDescriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  vertexDescriptorWrite.dstSet = vertexDescriptorSet;
+  vertexDescriptorWrite.dstBinding = 0u;
+  vertexDescriptorWrite.descriptorCount = 1u;
+  vertexDescriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  vertexDescriptorWrite.pBufferInfo = &vertexStorageInfo;
+  dev->pfnUpdateDescriptorSets(device, 1u, &vertexDescriptorWrite, 0u, 0);
+
+  VkPipelineLayoutCreateInfo vertexPipelineLayoutCreateInfo;
+  memset(&vertexPipelineLayoutCreateInfo, 0, sizeof(vertexPipelineLayoutCreateInfo));
+  vertexPipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  vertexPipelineLayoutCreateInfo.setLayoutCount = 1u;
+  vertexPipelineLayoutCreateInfo.pSetLayouts = &vertexSetLayout;
+  rc = dev->pfnCreatePipelineLayout(device, &vertexPipelineLayoutCreateInfo, 0, &vertexPipelineLayout);
+  if (rc != VK_SUCCESS || vertexPipelineLayout == VK_NULL_HANDLE) {
+    smokeRc = 109;
+    goto cleanup;
+  }
+
+  /* Rasterizer discard: the draw module runs the vertex stage and nothing reaches setup. */
+  VkSubpassDescription vertexSubpass;
+  memset(&vertexSubpass, 0, sizeof(vertexSubpass));
+  vertexSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  VkSubpassDependency vertexDependency;
+  memset(&vertexDependency, 0, sizeof(vertexDependency));
+  vertexDependency.srcSubpass = 0u;
+  vertexDependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+  vertexDependency.srcStageMask = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+  vertexDependency.dstStageMask = VK_PIPELINE_STAGE_HOST_BIT;
+  vertexDependency.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  vertexDependency.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+  VkRenderPassCreateInfo vertexRenderPassCreateInfo;
+  memset(&vertexRenderPassCreateInfo, 0, sizeof(vertexRenderPassCreateInfo));
+  vertexRenderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+  vertexRenderPassCreateInfo.subpassCount = 1u;
+  vertexRenderPassCreateInfo.pSubpasses = &vertexSubpass;
+  vertexRenderPassCreateInfo.dependencyCount = 1u;
+  vertexRenderPassCreateInfo.pDependencies = &vertexDependency;
+  rc = dev->pfnCreateRenderPass(device, &vertexRenderPassCreateInfo, 0, &vertexRenderPass);
+  if (rc != VK_SUCCESS || vertexRenderPass == VK_NULL_HANDLE) {
+    smokeRc = 109;
+    goto cleanup;
+  }
+
+  VkFramebufferCreateInfo vertexFramebufferCreateInfo;
+  memset(&vertexFramebufferCreateInfo, 0, sizeof(vertexFramebufferCreateInfo));
+  vertexFramebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+  vertexFramebufferCreateInfo.renderPass = vertexRenderPass;
+  vertexFramebufferCreateInfo.width = 1u;
+  vertexFramebufferCreateInfo.height = 1u;
+  vertexFramebufferCreateInfo.layers = 1u;
+  rc = dev->pfnCreateFramebuffer(device, &vertexFramebufferCreateInfo, 0, &vertexFramebuffer);
+  if (rc != VK_SUCCESS || vertexFramebuffer == VK_NULL_HANDLE) {
+    smokeRc = 109;
+    goto cleanup;
+  }
+
+  VkPipelineShaderStageCreateInfo vertexStage;
+  memset(&vertexStage, 0, sizeof(vertexStage));
+  vertexStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  vertexStage.stage = VK_SHADER_STAGE_VERTEX_BIT;
+  vertexStage.module = vertexShaderModule;
+  vertexStage.pName = vertexSpirvEntrypoint && vertexSpirvEntrypoint[0] ? vertexSpirvEntrypoint : "main";
+
+  VkVertexInputBindingDescription vertexBindingDescription;
+  vertexBindingDescription.binding = 0u;
+  vertexBindingDescription.stride = kRuntimeVertexStrideBytes;
+  vertexBindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+  VkVertexInputAttributeDescription vertexAttributeDescription;
+  vertexAttributeDescription.location = 0u;
+  vertexAttributeDescription.binding = 0u;
+  vertexAttributeDescription.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+  vertexAttributeDescription.offset = 0u;
+  VkPipelineVertexInputStateCreateInfo vertexInputState;
+  memset(&vertexInputState, 0, sizeof(vertexInputState));
+  vertexInputState.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+  vertexInputState.vertexBindingDescriptionCount = 1u;
+  vertexInputState.pVertexBindingDescriptions = &vertexBindingDescription;
+  vertexInputState.vertexAttributeDescriptionCount = 1u;
+  vertexInputState.pVertexAttributeDescriptions = &vertexAttributeDescription;
+
+  VkPipelineInputAssemblyStateCreateInfo vertexInputAssembly;
+  memset(&vertexInputAssembly, 0, sizeof(vertexInputAssembly));
+  vertexInputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+  vertexInputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+
+  VkPipelineRasterizationStateCreateInfo vertexRasterization;
+  memset(&vertexRasterization, 0, sizeof(vertexRasterization));
+  vertexRasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+  vertexRasterization.rasterizerDiscardEnable = VK_TRUE;
+  vertexRasterization.polygonMode = VK_POLYGON_MODE_FILL;
+  vertexRasterization.cullMode = VK_CULL_MODE_NONE;
+  vertexRasterization.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+  vertexRasterization.lineWidth = 1.0f;
+
+  VkGraphicsPipelineCreateInfo vertexPipelineCreateInfo;
+  memset(&vertexPipelineCreateInfo, 0, sizeof(vertexPipelineCreateInfo));
+  vertexPipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+  vertexPipelineCreateInfo.stageCount = 1u;
+  vertexPipelineCreateInfo.pStages = &vertexStage;
+  vertexPipelineCreateInfo.pVertexInputState = &vertexInputState;
+  vertexPipelineCreateInfo.pInputAssemblyState = &vertexInputAssembly;
+  vertexPipelineCreateInfo.pRasterizationState = &vertexRasterization;
+  vertexPipelineCreateInfo.layout = vertexPipelineLayout;
+  vertexPipelineCreateInfo.renderPass = vertexRenderPass;
+  vertexPipelineCreateInfo.subpass = 0u;
+  vertexPipelineCreateInfo.basePipelineIndex = -1;
+  rc = dev->pfnCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1u, &vertexPipelineCreateInfo, 0, &vertexPipeline);
+  if (rc != VK_SUCCESS || vertexPipeline == VK_NULL_HANDLE) {
+    smokeRc = 109;
+    goto cleanup;
+  }
+
+  rc = dev->pfnAllocateCommandBuffers(device, &dev->commandBufferAllocateInfo, &vertexCommandBuffer);
+  if (rc != VK_SUCCESS || vertexCommandBuffer == VK_NULL_HANDLE) {
+    smokeRc = 110;
+    goto cleanup;
+  }
+
+  VkRenderPassBeginInfo vertexPassBeginInfo;
+  memset(&vertexPassBeginInfo, 0, sizeof(vertexPassBeginInfo));
+  vertexPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+  vertexPassBeginInfo.renderPass = vertexRenderPass;
+  vertexPassBeginInfo.framebuffer = vertexFramebuffer;
+  vertexPassBeginInfo.renderArea.extent.width = 1u;
+  vertexPassBeginInfo.renderArea.extent.height = 1u;
+
+  VkSubmitInfo vertexSubmitInfo;
+  memset(&vertexSubmitInfo, 0, sizeof(vertexSubmitInfo));
+  vertexSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  vertexSubmitInfo.commandBufferCount = 1u;
+  vertexSubmitInfo.pCommandBuffers = &vertexCommandBuffer;
+
+  const VkDeviceSize vertexBufferOffset = 0u;
+  for (uint32_t vertexCount = kRuntimeVertexMinCount;
+       vertexCount <= vertexBenchMaxVertices && vertexSampleCount < WEBVULKAN_RUNTIME_VERTEX_MAX_SIZE_COUNT;
+       vertexCount *= 4u) {
+    WebVulkanRuntimeVertexSample* vertexSample = &vertexSamples[vertexSampleCount++];
+    memset(vertexSample, 0, sizeof(*vertexSample));
+    vertexSample->vertexCount = vertexCount;
+    vertexSample->submitIterations = kRuntimeVertexSubmitIterations;
+
+    rc = dev->pfnBeginCommandBuffer(vertexCommandBuffer, &dev->commandBufferBeginInfo);
+    if (rc != VK_SUCCESS) {
+      smokeRc = 110;
+      goto cleanup;
+    }
+    dev->pfnCmdBeginRenderPass(vertexCommandBuffer, &vertexPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    dev->pfnCmdBindPipeline(vertexCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vertexPipeline);
+    dev->pfnCmdBindDescriptorSets(
+      vertexCommandBuffer,
+      VK_PIPELINE_BIND_POINT_GRAPHICS,
+      vertexPipelineLayout,
+      0u,
+      1u,
+      &vertexDescriptorSet,
+      0u,
+      0
+    );
+    dev->pfnCmdBindVertexBuffers(vertexCommandBuffer, 0u, 1u, &vertexBuffers[0], &vertexBufferOffset);
+    dev->pfnCmdDraw(vertexCommandBuffer, vertexCount, 1u, 0u, 0u);
+    dev->pfnCmdEndRenderPass(vertexCommandBuffer);
+    rc = dev->pfnEndCommandBuffer(vertexCommandBuffer);
+    if (rc != VK_SUCCESS) {
+      smokeRc = 110;
+      goto cleanup;
+    }
+
+    memset(mappedVertexFloats[1], 0xff, (size_t)vertexCount * kRuntimeVertexStrideBytes);
+    const double vertexStartMs = emscripten_get_now();
+    for (uint32_t iteration = 0u; iteration < kRuntimeVertexSubmitIterations; ++iteration) {
+      rc = dev->pfnResetFences(device, 1u, &submitFence);
+      if (rc == VK_SUCCESS) {
+        rc = dev->pfnQueueSubmit(queue, 1u, &vertexSubmitInfo, submitFence);
+      }
+      if (rc == VK_SUCCESS) {
+        rc = dev->pfnWaitForFences(device, 1u, &submitFence, VK_TRUE, UINT64_MAX);
+      }
+      if (rc != VK_SUCCESS) {
+        smokeRc = 110;
+        goto cleanup;
+      }
+    }
+    vertexSample->submitMs = emscripten_get_now() - vertexStartMs;
+
+    for (uint32_t v = 0u; v < vertexCount; ++v) {
+      float expected[4];
+      webvulkan_runtime_vertex_position(v, expected);
+      webvulkan_runtime_vertex_transform(expected);
+      const float* observed = &mappedVertexFloats[1][v * 4u];
+      if (memcmp(observed, expected, sizeof(expected)) != 0) {
+        printf("lavapipe runtime smoke vertex mismatch\n");
+        printf("  vertex.count=%u\n", vertexCount);
+        printf("  vertex.index=%u\n", v);
+        printf("  vertex.expected=%.3f,%.3f,%.3f,%.3f\n", expected[0], expected[1], expected[2], expected[3]);
+        printf("  vertex.observed=%.3f,%.3f,%.3f,%.3f\n", observed[0], observed[1], observed[2], observed[3]);
+        smokeRc = 111;
+        goto cleanup;
+      }
+    }
+    vertexSample->verticesChecked = vertexCount;
+  }
+
+cleanup:
+  if (vertexPipeline != VK_NULL_HANDLE && dev->pfnDestroyPipeline) {
+    dev->pfnDestroyPipeline(device, vertexPipeline, 0);
+  }
+  if (vertexPipelineLayout != VK_NULL_HANDLE && dev->pfnDestroyPipelineLayout) {
+    dev->pfnDestroyPipelineLayout(device, vertexPipelineLayout, 0);
+  }
+  if (vertexDescriptorPool != VK_NULL_HANDLE && dev->pfnDestroyDescriptorPool) {
+    dev->pfnDestroyDescriptorPool(device, vertexDescriptorPool, 0);
+  }
+  if (vertexSetLayout != VK_NULL_HANDLE && dev->pfnDestroyDescriptorSetLayout) {
+    dev->pfnDestroyDescriptorSetLayout(device, vertexSetLayout, 0);
+  }
+  if (vertexFramebuffer != VK_NULL_HANDLE && dev->pfnDestroyFramebuffer) {
+    dev->pfnDestroyFramebuffer(device, vertexFramebuffer, 0);
+  }
+  if (vertexRenderPass != VK_NULL_HANDLE && dev->pfnDestroyRenderPass) {
+    dev->pfnDestroyRenderPass(device, vertexRenderPass, 0);
+  }
+  if (vertexShaderModule != VK_NULL_HANDLE && dev->pfnDestroyShaderModule) {
+    dev->pfnDestroyShaderModule(device, vertexShaderModule, 0);
+  }
+  for (uint32_t b = 0u; b < 2u; ++b) {
+    if (mappedVertexFloats[b] && dev->pfnUnmapMemory) {
+      dev->pfnUnmapMemory(device, vertexMemories[b]);
+    }
+    if (vertexBuffers[b] != VK_NULL_HANDLE && dev->pfnDestroyBuffer) {
+      dev->pfnDestroyBuffer(device, vertexBuffers[b], 0);
     }
-    if (fallbackIndex == UINT32_MAX) {
-      fallbackIndex = i;
+    if (vertexMemories[b] != VK_NULL_HANDLE && dev->pfnFreeMemory) {
+      dev->pfnFreeMemory(device, vertexMemories[b], 0);
     }
   }
+  *outSampleCount = vertexSampleCount;
+  return smokeRc;
+}
 
-  return fallbackIndex;
+/* Per-bench report lines; lavapipe_runtime_smoke prints them after the dispatch summary. */
+static void webvulkan_print_runtime_pipeline_report(
+  uint32_t pipelineBenchShaders,
+  uint32_t pipelineBenchKeyCount,
+  uint32_t pipelineBenchBundleCount,
+  WebVulkanRuntimePipelineStateSample* pipelineStateSamples
+) {
+  printf("  pipeline.shaders=%u\n", pipelineBenchShaders);
+  printf("  pipeline.captured_keys=%u\n", pipelineBenchKeyCount);
+  printf("  pipeline.bundle_kernels=%u\n", pipelineBenchBundleCount);
+  for (uint32_t state = 0u; state < WEBVULKAN_RUNTIME_PIPELINE_STATE_COUNT; ++state) {
+    WebVulkanRuntimePipelineStateSample* stateSample = &pipelineStateSamples[state];
+    double pipelineTotalMs = 0.0;
+    for (uint32_t shader = 0u; shader < pipelineBenchShaders; ++shader) {
+      pipelineTotalMs += stateSample->pipelineMs[shader];
+    }
+    printf(
+      "  pipeline.state=%s module_p50_ms=%.6f module_p99_ms=%.6f create_p50_ms=%.6f create_p99_ms=%.6f "
+      "create_avg_ms=%.6f registry_lookup_ms=%.6f registry_lookups=%u\n",
+      g_runtime_pipeline_state_names[state],
+      webvulkan_runtime_percentile_ms(stateSample->moduleMs, pipelineBenchShaders, 50u),
+      webvulkan_runtime_percentile_ms(stateSample->moduleMs, pipelineBenchShaders, 99u),
+      webvulkan_runtime_percentile_ms(stateSample->pipelineMs, pipelineBenchShaders, 50u),
+      webvulkan_runtime_percentile_ms(stateSample->pipelineMs, pipelineBenchShaders, 99u),
+      pipelineTotalMs / (double)pipelineBenchShaders,
+      stateSample->stageMs[WEBVULKAN_RUNTIME_STAGE_REGISTRY_LOOKUP],
+      stateSample->stageCalls[WEBVULKAN_RUNTIME_STAGE_REGISTRY_LOOKUP]
+    );
+  }
 }
 
-static PFN_vkVoidFunction webvulkan_load_device_proc(
-  PFN_vkGetDeviceProcAddr primaryGetDeviceProcAddr,
-  PFN_vkGetDeviceProcAddr secondaryGetDeviceProcAddr,
-  VkDevice device,
-  const char* name
+static void webvulkan_print_runtime_transfer_report(
+  const WebVulkanRuntimeTransferSample* transferSamples,
+  uint32_t transferSampleCount
 ) {
-  PFN_vkVoidFunction proc = 0;
-  if (device != VK_NULL_HANDLE && primaryGetDeviceProcAddr) {
-    proc = primaryGetDeviceProcAddr(device, name);
+#if defined(__wasm_bulk_memory__)
+  printf("  transfer.harness_bulk_memory=yes\n");
+#else
+  printf("  transfer.harness_bulk_memory=no\n");
+#endif
+  printf("  transfer.sizes=%u\n", transferSampleCount);
+  for (uint32_t k = 0u; k < transferSampleCount; ++k) {
+    const WebVulkanRuntimeTransferSample* transferSample = &transferSamples[k];
+    const double transferTotalBytes = (double)transferSample->bytes * (double)transferSample->commandsPerSubmit;
+    char updateGbps[32];
+    if (transferSample->submitMs[WEBVULKAN_RUNTIME_TRANSFER_OP_UPDATE] < 0.0) {
+      snprintf(updateGbps, sizeof(updateGbps), "n/a");
+    } else {
+      snprintf(
+        updateGbps,
+        sizeof(updateGbps),
+        "%.3f",
+        webvulkan_runtime_gbps(transferTotalBytes, transferSample->submitMs[WEBVULKAN_RUNTIME_TRANSFER_OP_UPDATE])
+      );
+    }
+    printf(
+      "  transfer.bytes=%u commands=%u fill_gbps=%.3f copy_gbps=%.3f update_gbps=%s "
+      "host_scalar_fill_gbps=%.3f host_scalar_copy_gbps=%.3f\n",
+      transferSample->bytes,
+      transferSample->commandsPerSubmit,
+      webvulkan_runtime_gbps(transferTotalBytes, transferSample->submitMs[WEBVULKAN_RUNTIME_TRANSFER_OP_FILL]),
+      webvulkan_runtime_gbps(transferTotalBytes, transferSample->submitMs[WEBVULKAN_RUNTIME_TRANSFER_OP_COPY]),
+      updateGbps,
+      webvulkan_runtime_gbps(transferTotalBytes, transferSample->hostScalarFillMs),
+      webvulkan_runtime_gbps(transferTotalBytes, transferSample->hostScalarCopyMs)
+    );
   }
-  if (!proc && device != VK_NULL_HANDLE && secondaryGetDeviceProcAddr) {
-    proc = secondaryGetDeviceProcAddr(device, name);
+}
+
+static void webvulkan_print_runtime_bandwidth_report(
+  const WebVulkanRuntimeBandwidthSample* bandwidthSamples,
+  uint32_t bandwidthSampleCount,
+  uint32_t bandwidthBenchMaxBytes,
+  uint32_t bandwidthKernelCount
+) {
+  printf("  bandwidth.sizes=%u\n", bandwidthSampleCount);
+  printf("  bandwidth.max_bytes=%u\n", bandwidthBenchMaxBytes);
+  printf("  bandwidth.wasm32_cap_bytes=%u\n", kRuntimeBandwidthMaxBytes);
+  printf("  bandwidth.kernels_registered=%u\n", bandwidthKernelCount);
+  for (uint32_t k = 0u; k < bandwidthSampleCount; ++k) {
+    const WebVulkanRuntimeBandwidthSample* bandwidthSample = &bandwidthSamples[k];
+    const double arrayBytes =
+      (double)bandwidthSample->elements * sizeof(uint32_t) * (double)bandwidthSample->dispatchesPerSubmit;
+    const double hostMemcpyGbps = webvulkan_runtime_gbps(2.0 * arrayBytes, bandwidthSample->hostMemcpyMs);
+    for (uint32_t kernel = 0u; kernel < WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_COUNT; ++kernel) {
+      const double kernelGbps = webvulkan_runtime_gbps(
+        (double)g_runtime_bandwidth_kernels[kernel].arrays * arrayBytes,
+        bandwidthSample->submitMs[kernel]
+      );
+      printf(
+        "  bandwidth.kernel=%s bytes=%u elements=%u dispatches=%u submit_ms=%.6f gbps=%.3f "
+        "host_memcpy_gbps=%.3f memcpy_ratio=%.3f wasm_submits=%u\n",
+        g_runtime_bandwidth_kernels[kernel].name,
+        bandwidthSample->bytes,
+        bandwidthSample->elements,
+        bandwidthSample->dispatchesPerSubmit,
+        bandwidthSample->submitMs[kernel],
+        kernelGbps,
+        hostMemcpyGbps,
+        hostMemcpyGbps > 0.0 ? kernelGbps / hostMemcpyGbps : 0.0,
+        bandwidthSample->wasmSubmits[kernel]
+      );
+    }
   }
-  return proc;
 }
 
-EMSCRIPTEN_KEEPALIVE double webvulkan_get_last_dispatch_ms(void) {
-  return g_last_dispatch_wall_ms;
+static void webvulkan_print_runtime_primitive_report(
+  const WebVulkanRuntimePrimitiveSample* primitiveSamples,
+  uint32_t primitiveSampleCount,
+  uint32_t primitiveBenchMaxElements,
+  uint32_t primitiveKernelCount
+) {
+  printf("  primitive.sizes=%u\n", primitiveSampleCount);
+  printf("  primitive.max_elements=%u\n", primitiveBenchMaxElements);
+  printf("  primitive.submit_iterations=%u\n", kRuntimePrimitiveSubmitIterations);
+  printf("  primitive.kernels_registered=%u\n", primitiveKernelCount);
+  for (uint32_t k = 0u; k < primitiveSampleCount; ++k) {
+    const WebVulkanRuntimePrimitiveSample* primitiveSample = &primitiveSamples[k];
+    for (uint32_t primitive = 0u; primitive < WEBVULKAN_RUNTIME_PRIMITIVE_COUNT; ++primitive) {
+      const double submitMs = primitiveSample->submitMs[primitive];
+      const double hostMs = primitiveSample->hostMs[primitive];
+      printf(
+        "  primitive.kernel=%s elements=%u stages=%u submit_ms=%.6f ns_per_element=%.3f "
+        "melements_per_s=%.3f host_ms=%.6f host_ratio=%.3f wasm_submits=%u\n",
+        g_runtime_primitives[primitive].name,
+        primitiveSample->elements,
+        g_runtime_primitives[primitive].stageCount,
+        submitMs,
+        (submitMs * 1.0e6) / (double)primitiveSample->elements,
+        submitMs > 0.0 ? (double)primitiveSample->elements / (submitMs * 1.0e3) : 0.0,
+        hostMs,
+        hostMs > 0.0 ? submitMs / hostMs : 0.0,
+        primitiveSample->wasmSubmits[primitive]
+      );
+    }
+  }
+}
+
+static void webvulkan_print_runtime_render_report(
+  const WebVulkanRuntimeRenderSample* renderSamples,
+  uint32_t renderSampleCount,
+  uint32_t renderSizeCount
+) {
+  printf("  render.scenes=%u\n", (uint32_t)WEBVULKAN_RUNTIME_RENDER_SCENE_COUNT);
+  printf("  render.sizes=%u\n", renderSizeCount);
+  printf("  render.draws_per_submit=%u\n", kRuntimeRenderDrawsPerSubmit);
+  printf("  render.submit_iterations=%u\n", kRuntimeRenderSubmitIterations);
+  for (uint32_t k = 0u; k < renderSampleCount; ++k) {
+    const WebVulkanRuntimeRenderSample* renderSample = &renderSamples[k];
+    const double renderDraws = (double)renderSample->drawsPerSubmit * (double)renderSample->submitIterations;
+    const double renderShadedPixels = (double)renderSample->width * (double)renderSample->height * renderDraws;
+    const double renderReadbackBytes = (double)renderSample->pixelsChecked * (double)sizeof(uint32_t);
+    char nsPerTriangle[32] = "n/a";
+    if (renderSample->trianglesPerDraw > 0u) {
+      snprintf(
+        nsPerTriangle,
+        sizeof(nsPerTriangle),
+        "%.3f",
+        (renderSample->submitMs * 1000000.0) / ((double)renderSample->trianglesPerDraw * renderDraws)
+      );
+    }
+    printf(
+      "  render.scene=%s size=%ux%u triangles=%u submit_ms=%.6f ns_per_pixel=%.3f ns_per_triangle=%s "
+      "readback_gbps=%.3f checked=%u\n",
+      g_runtime_render_scenes[renderSample->scene].name,
+      renderSample->width,
+      renderSample->height,
+      renderSample->trianglesPerDraw,
+      renderSample->submitMs,
+      (renderSample->submitMs * 1000000.0) / renderShadedPixels,
+      nsPerTriangle,
+      webvulkan_runtime_gbps(renderReadbackBytes, renderSample->readbackMs),
+      renderSample->pixelsChecked
+    );
+  }
+}
+
+static void webvulkan_print_runtime_vertex_report(
+  const WebVulkanRuntimeVertexSample* vertexSamples,
+  uint32_t vertexSampleCount
+) {
+  printf("  vertex.sizes=%u\n", vertexSampleCount);
+  for (uint32_t k = 0u; k < vertexSampleCount; ++k) {
+    const WebVulkanRuntimeVertexSample* vertexSample = &vertexSamples[k];
+    const double shadedVertices = (double)vertexSample->vertexCount * (double)vertexSample->submitIterations;
+    printf(
+      "  vertex.count=%u submit_ms=%.6f ns_per_vertex=%.3f checked=%u\n",
+      vertexSample->vertexCount,
+      vertexSample->submitMs,
+      (vertexSample->submitMs * 1000000.0) / shadedVertices,
+      vertexSample->verticesChecked
+    );
+  }
 }
 
 EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   printf("lavapipe runtime smoke stage=begin\n");
   fflush(stdout);
   g_last_dispatch_wall_ms = -1.0;
+  g_last_mapped_storage_base = 0u;
+  g_last_mapped_storage_bytes = 0u;
+  g_last_kernel_storage_address = 0u;
+  memset(g_last_bandwidth_wasm_submits, 0, sizeof(g_last_bandwidth_wasm_submits));
+  webvulkan_release_tracked_device_memory();
+  double setupStageStartMs = emscripten_get_now();
   const WebVulkanRuntimeBenchProfile* benchProfile = webvulkan_get_runtime_bench_profile_desc();
   int smokeRc = 0;
   VkResult rc = VK_SUCCESS;
@@ -225,6 +4063,15 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   VkBuffer storageBuffer = VK_NULL_HANDLE;
   VkDeviceMemory storageMemory = VK_NULL_HANDLE;
   uint32_t* mappedStorageWords = 0;
+  VkBuffer indirectBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory indirectMemory = VK_NULL_HANDLE;
+  VkDispatchIndirectCommand* mappedIndirectCommand = 0;
+  VkImage filterImages[2] = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+  VkDeviceMemory filterImageMemories[2] = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+  VkImageView filterImageViews[2] = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+  uint8_t* mappedFilterImages[2] = { 0, 0 };
+  VkSubresourceLayout filterImageLayouts[2];
+  VkCommandBuffer imageLayoutCommandBuffer = VK_NULL_HANDLE;
   VkCommandPool commandPool = VK_NULL_HANDLE;
   VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
   VkFence submitFence = VK_NULL_HANDLE;
@@ -233,14 +4080,25 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   double dispatchEndMs = 0.0;
   uint32_t dispatchObservedValue = 0u;
   uint32_t dispatchObservedAuxValue = 0u;
-  const uint32_t dispatchesPerSubmit = benchProfile->dispatchesPerSubmit;
-  const uint32_t dispatchSubmitIterations = benchProfile->submitIterations;
-  const uint32_t dispatchX = benchProfile->dispatchX;
-  const uint32_t dispatchY = benchProfile->dispatchY;
-  const uint32_t dispatchZ = benchProfile->dispatchZ;
+  const WebVulkanRuntimeLaunchOverride* launchOverride =
+    g_runtime_launch_override.dispatchesPerSubmit != 0u ? &g_runtime_launch_override : 0;
+  const uint32_t dispatchesPerSubmit =
+    launchOverride ? launchOverride->dispatchesPerSubmit : benchProfile->dispatchesPerSubmit;
+  const uint32_t persistentSamples = g_runtime_persistent_samples;
+  const uint32_t dispatchSubmitIterations = persistentSamples != 0u ? persistentSamples : benchProfile->submitIterations;
+  const uint32_t dispatchX = launchOverride ? launchOverride->dispatchX : benchProfile->dispatchX;
+  const uint32_t dispatchY = launchOverride ? launchOverride->dispatchY : benchProfile->dispatchY;
+  const uint32_t dispatchZ = launchOverride ? launchOverride->dispatchZ : benchProfile->dispatchZ;
+  const int dispatchIndirect = benchProfile->indirect != 0u;
+  const uint32_t dispatchParamMode = benchProfile->paramMode;
+  uint32_t paramSlotStrideWords = 0u;
   const uint32_t shaderWorkload = g_runtime_shader_workload;
   const char* shaderWorkloadName = webvulkan_get_runtime_shader_workload_name(shaderWorkload);
-  const uint32_t shaderWorkgroupSizeX = webvulkan_get_runtime_shader_workgroup_size_x(shaderWorkload);
+  const uint32_t shaderWorkgroupSizeX =
+    launchOverride ? launchOverride->workgroupSizeX : webvulkan_get_runtime_shader_workgroup_size_x(shaderWorkload);
+  const int imageFilter = shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_IMAGE_BOX_FILTER;
+  const uint32_t filterImageWidth = dispatchX * kRuntimeImageFilterTileSize;
+  const uint32_t filterImageHeight = dispatchY * kRuntimeImageFilterTileSize;
   const uint32_t dispatchGroupsPerDispatch = dispatchX * dispatchY * dispatchZ;
   const uint32_t dispatchInvocationsPerDispatch = dispatchGroupsPerDispatch * shaderWorkgroupSizeX;
   const uint32_t dispatchInvocationsPerSubmit = dispatchInvocationsPerDispatch * dispatchesPerSubmit;
@@ -249,53 +4107,56 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   uint32_t expectedDispatchAuxValue = 0u;
   uint32_t clearWordCount = 1u;
   uint32_t uniqueWriteWordCount = 0u;
+  uint32_t subgroupsPerWorkgroup = 0u;
+  uint32_t expectedSubgroupWords[3] = { 0u, 0u, 0u };
+  uint32_t storageBufferWordCount = kSmokeBufferWordCount;
+  uint32_t copyWordCount = 0u;
+  double fencedSubmitMs = 0.0;
+  double hostMemcpyMs = 0.0;
+  const uint32_t transferBenchMaxBytes = g_runtime_transfer_bench_max_bytes;
+  WebVulkanRuntimeTransferSample transferSamples[WEBVULKAN_RUNTIME_TRANSFER_MAX_SIZE_COUNT];
+  uint32_t transferSampleCount = 0u;
+  const uint32_t bandwidthBenchMaxBytes = g_runtime_bandwidth_bench_max_bytes;
+  uint32_t bandwidthKernelCount = 0u;
+  WebVulkanRuntimeBandwidthSample bandwidthSamples[WEBVULKAN_RUNTIME_BANDWIDTH_MAX_SIZE_COUNT];
+  uint32_t bandwidthSampleCount = 0u;
+  const uint32_t primitiveBenchMaxElements = g_runtime_primitive_bench_max_elements;
+  uint32_t primitiveKernelCount = 0u;
+  WebVulkanRuntimePrimitiveSample primitiveSamples[WEBVULKAN_RUNTIME_PRIMITIVE_MAX_SIZE_COUNT];
+  uint32_t primitiveSampleCount = 0u;
+  const uint32_t renderBenchSize = g_runtime_render_bench_size;
+  WebVulkanRuntimeRenderSample renderSamples[WEBVULKAN_RUNTIME_RENDER_SCENE_COUNT * WEBVULKAN_RUNTIME_RENDER_MAX_SIZE_COUNT];
+  uint32_t renderSizeCount = 0u;
+  uint32_t renderSampleCount = 0u;
+  const uint32_t vertexBenchMaxVertices = g_runtime_vertex_bench_max_vertices;
+  WebVulkanRuntimeVertexSample vertexSamples[WEBVULKAN_RUNTIME_VERTEX_MAX_SIZE_COUNT];
+  uint32_t vertexSampleCount = 0u;
+  const uint32_t pipelineBenchShaders = g_runtime_pipeline_bench_shaders;
+  const uint32_t memoryGrowthCycles = g_runtime_memory_growth_cycles;
+  uint32_t pipelineBenchKeyCount = 0u;
+  uint32_t pipelineBenchBundleCount = 0u;
+  WebVulkanRuntimePipelineStateSample pipelineStateSamples[WEBVULKAN_RUNTIME_PIPELINE_STATE_COUNT];
   uint32_t shaderKeyLo = webvulkan_get_runtime_active_shader_key_lo();
   uint32_t shaderKeyHi = webvulkan_get_runtime_active_shader_key_hi();
   const uint32_t* shaderCodeWords = kSmokeComputeSpirv;
   size_t shaderCodeSizeBytes = sizeof(kSmokeComputeSpirv);
   const char* shaderSource = "embedded_static_spirv";
   const char* shaderEntryPoint = "main";
-  PFN_vkDestroyDevice pfnDestroyDevice = 0;
-  PFN_vkGetPhysicalDeviceMemoryProperties pfnGetPhysicalDeviceMemoryProperties = 0;
-  PFN_vkCreateShaderModule pfnCreateShaderModule = 0;
-  PFN_vkDestroyShaderModule pfnDestroyShaderModule = 0;
-  PFN_vkCreateDescriptorSetLayout pfnCreateDescriptorSetLayout = 0;
-  PFN_vkDestroyDescriptorSetLayout pfnDestroyDescriptorSetLayout = 0;
-  PFN_vkCreateDescriptorPool pfnCreateDescriptorPool = 0;
-  PFN_vkDestroyDescriptorPool pfnDestroyDescriptorPool = 0;
-  PFN_vkAllocateDescriptorSets pfnAllocateDescriptorSets = 0;
-  PFN_vkUpdateDescriptorSets pfnUpdateDescriptorSets = 0;
-  PFN_vkCreatePipelineLayout pfnCreatePipelineLayout = 0;
-  PFN_vkDestroyPipelineLayout pfnDestroyPipelineLayout = 0;
-  PFN_vkCreateComputePipelines pfnCreateComputePipelines = 0;
-  PFN_vkDestroyPipeline pfnDestroyPipeline = 0;
-  PFN_vkCreateBuffer pfnCreateBuffer = 0;
-  PFN_vkDestroyBuffer pfnDestroyBuffer = 0;
-  PFN_vkGetBufferMemoryRequirements pfnGetBufferMemoryRequirements = 0;
-  PFN_vkAllocateMemory pfnAllocateMemory = 0;
-  PFN_vkFreeMemory pfnFreeMemory = 0;
-  PFN_vkBindBufferMemory pfnBindBufferMemory = 0;
-  PFN_vkMapMemory pfnMapMemory = 0;
-  PFN_vkUnmapMemory pfnUnmapMemory = 0;
-  PFN_vkGetDeviceQueue pfnGetDeviceQueue = 0;
-  PFN_vkCreateCommandPool pfnCreateCommandPool = 0;
-  PFN_vkDestroyCommandPool pfnDestroyCommandPool = 0;
-  PFN_vkAllocateCommandBuffers pfnAllocateCommandBuffers = 0;
-  PFN_vkBeginCommandBuffer pfnBeginCommandBuffer = 0;
-  PFN_vkEndCommandBuffer pfnEndCommandBuffer = 0;
-  PFN_vkCmdBindPipeline pfnCmdBindPipeline = 0;
-  PFN_vkCmdBindDescriptorSets pfnCmdBindDescriptorSets = 0;
-  PFN_vkCmdDispatch pfnCmdDispatch = 0;
-  PFN_vkCreateFence pfnCreateFence = 0;
-  PFN_vkDestroyFence pfnDestroyFence = 0;
-  PFN_vkQueueSubmit pfnQueueSubmit = 0;
-  PFN_vkWaitForFences pfnWaitForFences = 0;
-  PFN_vkResetFences pfnResetFences = 0;
+  WebVulkanRuntimeSmokeDevice dev;
+  memset(&dev, 0, sizeof(dev));
   PFN_vkGetDeviceProcAddr icdGetDeviceProcAddr = 0;
 
 
   volkInitializeCustom((PFN_vkGetInstanceProcAddr)vk_icdGetInstanceProcAddr);
   webvulkan_runtime_mark_wasm_usage(0, "none");
+  /* The image, indirect and parameter paths size their resources from the profile's grid. */
+  if (launchOverride && (imageFilter || dispatchIndirect || dispatchParamMode != WEBVULKAN_RUNTIME_PARAM_MODE_NONE)) {
+    printf("lavapipe runtime smoke launch override unsupported\n");
+    printf("  shader.workload=%s\n", shaderWorkloadName);
+    printf("  shader.dispatch.profile=%s\n", benchProfile->name);
+    smokeRc = 125;
+    goto cleanup;
+  }
   if (!vkCreateInstance || !vkEnumerateInstanceVersion) {
     smokeRc = 21;
     goto cleanup;
@@ -322,13 +4183,20 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
   createInfo.pApplicationInfo = &appInfo;
 
+  webvulkan_runtime_trace_begin(WEBVULKAN_RUNTIME_TRACE_INSTANCE_CREATE, apiVersion);
   rc = vkCreateInstance(&createInfo, 0, &instance);
+  webvulkan_runtime_trace_end(WEBVULKAN_RUNTIME_TRACE_INSTANCE_CREATE);
   printf("lavapipe runtime smoke stage=after_vkCreateInstance rc=%d\n", (int)rc);
   fflush(stdout);
   if (rc != VK_SUCCESS || instance == VK_NULL_HANDLE) {
     smokeRc = 23;
     goto cleanup;
   }
+  webvulkan_runtime_record_stage_timing(
+    WEBVULKAN_RUNTIME_STAGE_INSTANCE_CREATE,
+    emscripten_get_now() - setupStageStartMs
+  );
+  setupStageStartMs = emscripten_get_now();
 
   volkLoadInstance(instance);
   if (!vkEnumeratePhysicalDevices || !vkDestroyInstance || !vkGetDeviceProcAddr || !vkCreateDevice ||
@@ -364,9 +4232,14 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
     goto cleanup;
   }
 
+  VkPhysicalDeviceSubgroupProperties subgroupProps;
+  memset(&subgroupProps, 0, sizeof(subgroupProps));
+  subgroupProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+
   VkPhysicalDeviceDriverProperties driverProps;
   memset(&driverProps, 0, sizeof(driverProps));
   driverProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DRIVER_PROPERTIES;
+  driverProps.pNext = &subgroupProps;
 
   VkPhysicalDeviceProperties2 props2;
   memset(&props2, 0, sizeof(props2));
@@ -403,9 +4276,13 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
   VkPhysicalDeviceFeatures enabledFeatures;
   memset(&enabledFeatures, 0, sizeof(enabledFeatures));
+  /* The vertex bench validates through a storage buffer written by the vertex shader. */
+  enabledFeatures.vertexPipelineStoresAndAtomics = g_runtime_vertex_bench_max_vertices != 0u ? VK_TRUE : VK_FALSE;
   deviceCreateInfo.pEnabledFeatures = &enabledFeatures;
 
+  webvulkan_runtime_trace_begin(WEBVULKAN_RUNTIME_TRACE_DEVICE_CREATE, deviceCreateInfo.queueCreateInfoCount);
   rc = vkCreateDevice(physicalDevice, &deviceCreateInfo, 0, &device);
+  webvulkan_runtime_trace_end(WEBVULKAN_RUNTIME_TRACE_DEVICE_CREATE);
   printf("lavapipe runtime smoke stage=after_vkCreateDevice rc=%d\n", (int)rc);
   fflush(stdout);
   if (rc != VK_SUCCESS || device == VK_NULL_HANDLE) {
@@ -414,219 +4291,369 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   }
 
   volkLoadDevice(device);
+  dev.physicalDevice = physicalDevice;
+  dev.device = device;
+  webvulkan_runtime_record_stage_timing(
+    WEBVULKAN_RUNTIME_STAGE_DEVICE_CREATE,
+    emscripten_get_now() - setupStageStartMs
+  );
+  setupStageStartMs = emscripten_get_now();
   icdGetDeviceProcAddr = (PFN_vkGetDeviceProcAddr)vk_icdGetInstanceProcAddr(instance, "vkGetDeviceProcAddr");
-  pfnGetPhysicalDeviceMemoryProperties =
+  dev.pfnGetPhysicalDeviceMemoryProperties =
     vkGetPhysicalDeviceMemoryProperties ? vkGetPhysicalDeviceMemoryProperties :
     (PFN_vkGetPhysicalDeviceMemoryProperties)vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceMemoryProperties");
-  pfnDestroyDevice = vkDestroyDevice ? vkDestroyDevice : (PFN_vkDestroyDevice)vkGetDeviceProcAddr(device, "vkDestroyDevice");
-  pfnCreateShaderModule = vkCreateShaderModule ? vkCreateShaderModule :
+  dev.pfnDestroyDevice = vkDestroyDevice ? vkDestroyDevice : (PFN_vkDestroyDevice)vkGetDeviceProcAddr(device, "vkDestroyDevice");
+  dev.pfnCreateShaderModule = vkCreateShaderModule ? vkCreateShaderModule :
                                                 (PFN_vkCreateShaderModule)vkGetDeviceProcAddr(device, "vkCreateShaderModule");
-  pfnDestroyShaderModule = vkDestroyShaderModule ? vkDestroyShaderModule :
+  dev.pfnDestroyShaderModule = vkDestroyShaderModule ? vkDestroyShaderModule :
                                                   (PFN_vkDestroyShaderModule)vkGetDeviceProcAddr(device, "vkDestroyShaderModule");
-  pfnCreateDescriptorSetLayout = vkCreateDescriptorSetLayout ? vkCreateDescriptorSetLayout :
+  dev.pfnCreateDescriptorSetLayout = vkCreateDescriptorSetLayout ? vkCreateDescriptorSetLayout :
                                       (PFN_vkCreateDescriptorSetLayout)vkGetDeviceProcAddr(device, "vkCreateDescriptorSetLayout");
-  pfnDestroyDescriptorSetLayout = vkDestroyDescriptorSetLayout ? vkDestroyDescriptorSetLayout :
+  dev.pfnDestroyDescriptorSetLayout = vkDestroyDescriptorSetLayout ? vkDestroyDescriptorSetLayout :
                                        (PFN_vkDestroyDescriptorSetLayout)vkGetDeviceProcAddr(device, "vkDestroyDescriptorSetLayout");
-  pfnCreateDescriptorPool = vkCreateDescriptorPool ? vkCreateDescriptorPool :
+  dev.pfnCreateDescriptorPool = vkCreateDescriptorPool ? vkCreateDescriptorPool :
                             (PFN_vkCreateDescriptorPool)vkGetDeviceProcAddr(device, "vkCreateDescriptorPool");
-  pfnDestroyDescriptorPool = vkDestroyDescriptorPool ? vkDestroyDescriptorPool :
+  dev.pfnDestroyDescriptorPool = vkDestroyDescriptorPool ? vkDestroyDescriptorPool :
                              (PFN_vkDestroyDescriptorPool)vkGetDeviceProcAddr(device, "vkDestroyDescriptorPool");
-  pfnAllocateDescriptorSets = vkAllocateDescriptorSets ? vkAllocateDescriptorSets :
+  dev.pfnAllocateDescriptorSets = vkAllocateDescriptorSets ? vkAllocateDescriptorSets :
                               (PFN_vkAllocateDescriptorSets)vkGetDeviceProcAddr(device, "vkAllocateDescriptorSets");
-  pfnUpdateDescriptorSets = vkUpdateDescriptorSets ? vkUpdateDescriptorSets :
+  dev.pfnUpdateDescriptorSets = vkUpdateDescriptorSets ? vkUpdateDescriptorSets :
                             (PFN_vkUpdateDescriptorSets)vkGetDeviceProcAddr(device, "vkUpdateDescriptorSets");
-  pfnCreatePipelineLayout = vkCreatePipelineLayout ? vkCreatePipelineLayout :
+  dev.pfnCreatePipelineLayout = vkCreatePipelineLayout ? vkCreatePipelineLayout :
                                                    (PFN_vkCreatePipelineLayout)vkGetDeviceProcAddr(device, "vkCreatePipelineLayout");
-  pfnDestroyPipelineLayout = vkDestroyPipelineLayout ? vkDestroyPipelineLayout :
+  dev.pfnDestroyPipelineLayout = vkDestroyPipelineLayout ? vkDestroyPipelineLayout :
                                                      (PFN_vkDestroyPipelineLayout)vkGetDeviceProcAddr(device, "vkDestroyPipelineLayout");
-  pfnCreateComputePipelines = vkCreateComputePipelines ? vkCreateComputePipelines :
+  dev.pfnCreateComputePipelines = vkCreateComputePipelines ? vkCreateComputePipelines :
                                                       (PFN_vkCreateComputePipelines)vkGetDeviceProcAddr(device, "vkCreateComputePipelines");
-  pfnDestroyPipeline = vkDestroyPipeline ? vkDestroyPipeline :
+  dev.pfnDestroyPipeline = vkDestroyPipeline ? vkDestroyPipeline :
                                           (PFN_vkDestroyPipeline)vkGetDeviceProcAddr(device, "vkDestroyPipeline");
-  pfnCreateBuffer = vkCreateBuffer ? vkCreateBuffer :
+  dev.pfnCreatePipelineCache = vkCreatePipelineCache ? vkCreatePipelineCache :
+                                                (PFN_vkCreatePipelineCache)vkGetDeviceProcAddr(device, "vkCreatePipelineCache");
+  dev.pfnDestroyPipelineCache = vkDestroyPipelineCache ? vkDestroyPipelineCache :
+                                                  (PFN_vkDestroyPipelineCache)vkGetDeviceProcAddr(device, "vkDestroyPipelineCache");
+  dev.pfnCreateBuffer = vkCreateBuffer ? vkCreateBuffer :
                     (PFN_vkCreateBuffer)vkGetDeviceProcAddr(device, "vkCreateBuffer");
-  pfnDestroyBuffer = vkDestroyBuffer ? vkDestroyBuffer :
+  dev.pfnDestroyBuffer = vkDestroyBuffer ? vkDestroyBuffer :
                      (PFN_vkDestroyBuffer)vkGetDeviceProcAddr(device, "vkDestroyBuffer");
-  pfnGetBufferMemoryRequirements = vkGetBufferMemoryRequirements ? vkGetBufferMemoryRequirements :
+  dev.pfnGetBufferMemoryRequirements = vkGetBufferMemoryRequirements ? vkGetBufferMemoryRequirements :
                                    (PFN_vkGetBufferMemoryRequirements)vkGetDeviceProcAddr(device, "vkGetBufferMemoryRequirements");
-  pfnAllocateMemory = vkAllocateMemory ? vkAllocateMemory :
+  dev.pfnAllocateMemory = vkAllocateMemory ? vkAllocateMemory :
                       (PFN_vkAllocateMemory)vkGetDeviceProcAddr(device, "vkAllocateMemory");
-  pfnFreeMemory = vkFreeMemory ? vkFreeMemory :
+  dev.pfnFreeMemory = vkFreeMemory ? vkFreeMemory :
                   (PFN_vkFreeMemory)vkGetDeviceProcAddr(device, "vkFreeMemory");
-  pfnBindBufferMemory = vkBindBufferMemory ? vkBindBufferMemory :
+  dev.pfnBindBufferMemory = vkBindBufferMemory ? vkBindBufferMemory :
                         (PFN_vkBindBufferMemory)vkGetDeviceProcAddr(device, "vkBindBufferMemory");
-  pfnMapMemory = vkMapMemory ? vkMapMemory :
+  dev.pfnMapMemory = vkMapMemory ? vkMapMemory :
                  (PFN_vkMapMemory)vkGetDeviceProcAddr(device, "vkMapMemory");
-  pfnUnmapMemory = vkUnmapMemory ? vkUnmapMemory :
+  dev.pfnUnmapMemory = vkUnmapMemory ? vkUnmapMemory :
                    (PFN_vkUnmapMemory)vkGetDeviceProcAddr(device, "vkUnmapMemory");
-  pfnGetDeviceQueue = vkGetDeviceQueue ? vkGetDeviceQueue :
+  dev.pfnGetDeviceQueue = vkGetDeviceQueue ? vkGetDeviceQueue :
                                        (PFN_vkGetDeviceQueue)vkGetDeviceProcAddr(device, "vkGetDeviceQueue");
-  pfnCreateCommandPool = vkCreateCommandPool ? vkCreateCommandPool :
+  dev.pfnCreateCommandPool = vkCreateCommandPool ? vkCreateCommandPool :
                                             (PFN_vkCreateCommandPool)vkGetDeviceProcAddr(device, "vkCreateCommandPool");
-  pfnDestroyCommandPool = vkDestroyCommandPool ? vkDestroyCommandPool :
+  dev.pfnDestroyCommandPool = vkDestroyCommandPool ? vkDestroyCommandPool :
                                              (PFN_vkDestroyCommandPool)vkGetDeviceProcAddr(device, "vkDestroyCommandPool");
-  pfnAllocateCommandBuffers = vkAllocateCommandBuffers ? vkAllocateCommandBuffers :
+  dev.pfnAllocateCommandBuffers = vkAllocateCommandBuffers ? vkAllocateCommandBuffers :
                                                 (PFN_vkAllocateCommandBuffers)vkGetDeviceProcAddr(device, "vkAllocateCommandBuffers");
-  pfnBeginCommandBuffer = vkBeginCommandBuffer ? vkBeginCommandBuffer :
+  dev.pfnBeginCommandBuffer = vkBeginCommandBuffer ? vkBeginCommandBuffer :
                                               (PFN_vkBeginCommandBuffer)vkGetDeviceProcAddr(device, "vkBeginCommandBuffer");
-  pfnEndCommandBuffer = vkEndCommandBuffer ? vkEndCommandBuffer :
+  dev.pfnEndCommandBuffer = vkEndCommandBuffer ? vkEndCommandBuffer :
                                           (PFN_vkEndCommandBuffer)vkGetDeviceProcAddr(device, "vkEndCommandBuffer");
-  pfnCmdBindPipeline = vkCmdBindPipeline ? vkCmdBindPipeline :
+  dev.pfnCmdBindPipeline = vkCmdBindPipeline ? vkCmdBindPipeline :
                                         (PFN_vkCmdBindPipeline)vkGetDeviceProcAddr(device, "vkCmdBindPipeline");
-  pfnCmdBindDescriptorSets = vkCmdBindDescriptorSets ? vkCmdBindDescriptorSets :
+  dev.pfnCmdBindDescriptorSets = vkCmdBindDescriptorSets ? vkCmdBindDescriptorSets :
                              (PFN_vkCmdBindDescriptorSets)vkGetDeviceProcAddr(device, "vkCmdBindDescriptorSets");
-  pfnCmdDispatch = vkCmdDispatch ? vkCmdDispatch :
+  dev.pfnCmdDispatch = vkCmdDispatch ? vkCmdDispatch :
                                 (PFN_vkCmdDispatch)vkGetDeviceProcAddr(device, "vkCmdDispatch");
-  pfnCreateFence = vkCreateFence ? vkCreateFence :
+  dev.pfnCmdDispatchIndirect = vkCmdDispatchIndirect ? vkCmdDispatchIndirect :
+                                        (PFN_vkCmdDispatchIndirect)vkGetDeviceProcAddr(device, "vkCmdDispatchIndirect");
+  dev.pfnCmdFillBuffer = vkCmdFillBuffer ? vkCmdFillBuffer :
+                                  (PFN_vkCmdFillBuffer)vkGetDeviceProcAddr(device, "vkCmdFillBuffer");
+  dev.pfnCmdCopyBuffer = vkCmdCopyBuffer ? vkCmdCopyBuffer :
+                                  (PFN_vkCmdCopyBuffer)vkGetDeviceProcAddr(device, "vkCmdCopyBuffer");
+  dev.pfnCmdUpdateBuffer = vkCmdUpdateBuffer ? vkCmdUpdateBuffer :
+                                    (PFN_vkCmdUpdateBuffer)vkGetDeviceProcAddr(device, "vkCmdUpdateBuffer");
+  dev.pfnCmdPipelineBarrier = vkCmdPipelineBarrier ? vkCmdPipelineBarrier :
+                                       (PFN_vkCmdPipelineBarrier)vkGetDeviceProcAddr(device, "vkCmdPipelineBarrier");
+  dev.pfnCmdPushConstants = vkCmdPushConstants ? vkCmdPushConstants :
+                                     (PFN_vkCmdPushConstants)vkGetDeviceProcAddr(device, "vkCmdPushConstants");
+  dev.pfnCreateImage = vkCreateImage ? vkCreateImage :
+                                (PFN_vkCreateImage)vkGetDeviceProcAddr(device, "vkCreateImage");
+  dev.pfnDestroyImage = vkDestroyImage ? vkDestroyImage :
+                                 (PFN_vkDestroyImage)vkGetDeviceProcAddr(device, "vkDestroyImage");
+  dev.pfnGetImageMemoryRequirements = vkGetImageMemoryRequirements ? vkGetImageMemoryRequirements :
+                                  (PFN_vkGetImageMemoryRequirements)vkGetDeviceProcAddr(device, "vkGetImageMemoryRequirements");
+  dev.pfnBindImageMemory = vkBindImageMemory ? vkBindImageMemory :
+                                    (PFN_vkBindImageMemory)vkGetDeviceProcAddr(device, "vkBindImageMemory");
+  dev.pfnGetImageSubresourceLayout = vkGetImageSubresourceLayout ? vkGetImageSubresourceLayout :
+                                 (PFN_vkGetImageSubresourceLayout)vkGetDeviceProcAddr(device, "vkGetImageSubresourceLayout");
+  dev.pfnCreateImageView = vkCreateImageView ? vkCreateImageView :
+                                    (PFN_vkCreateImageView)vkGetDeviceProcAddr(device, "vkCreateImageView");
+  dev.pfnDestroyImageView = vkDestroyImageView ? vkDestroyImageView :
+                                     (PFN_vkDestroyImageView)vkGetDeviceProcAddr(device, "vkDestroyImageView");
+  dev.pfnCreateFence = vkCreateFence ? vkCreateFence :
                                 (PFN_vkCreateFence)vkGetDeviceProcAddr(device, "vkCreateFence");
-  pfnDestroyFence = vkDestroyFence ? vkDestroyFence :
+  dev.pfnDestroyFence = vkDestroyFence ? vkDestroyFence :
                                   (PFN_vkDestroyFence)vkGetDeviceProcAddr(device, "vkDestroyFence");
-  pfnQueueSubmit = vkQueueSubmit ? vkQueueSubmit :
+  dev.pfnQueueSubmit = vkQueueSubmit ? vkQueueSubmit :
                                  (PFN_vkQueueSubmit)vkGetDeviceProcAddr(device, "vkQueueSubmit");
-  pfnWaitForFences = vkWaitForFences ? vkWaitForFences :
+  dev.pfnWaitForFences = vkWaitForFences ? vkWaitForFences :
                                      (PFN_vkWaitForFences)vkGetDeviceProcAddr(device, "vkWaitForFences");
-  pfnResetFences = vkResetFences ? vkResetFences :
+  dev.pfnResetFences = vkResetFences ? vkResetFences :
                                    (PFN_vkResetFences)vkGetDeviceProcAddr(device, "vkResetFences");
+  dev.pfnCreateRenderPass = vkCreateRenderPass ? vkCreateRenderPass :
+                                         (PFN_vkCreateRenderPass)vkGetDeviceProcAddr(device, "vkCreateRenderPass");
+  dev.pfnDestroyRenderPass = vkDestroyRenderPass ? vkDestroyRenderPass :
+                                           (PFN_vkDestroyRenderPass)vkGetDeviceProcAddr(device, "vkDestroyRenderPass");
+  dev.pfnCreateFramebuffer = vkCreateFramebuffer ? vkCreateFramebuffer :
+                                           (PFN_vkCreateFramebuffer)vkGetDeviceProcAddr(device, "vkCreateFramebuffer");
+  dev.pfnDestroyFramebuffer = vkDestroyFramebuffer ? vkDestroyFramebuffer :
+                                             (PFN_vkDestroyFramebuffer)vkGetDeviceProcAddr(device, "vkDestroyFramebuffer");
+  dev.pfnCreateGraphicsPipelines = vkCreateGraphicsPipelines ? vkCreateGraphicsPipelines :
+                               (PFN_vkCreateGraphicsPipelines)vkGetDeviceProcAddr(device, "vkCreateGraphicsPipelines");
+  dev.pfnCmdBeginRenderPass = vkCmdBeginRenderPass ? vkCmdBeginRenderPass :
+                                             (PFN_vkCmdBeginRenderPass)vkGetDeviceProcAddr(device, "vkCmdBeginRenderPass");
+  dev.pfnCmdEndRenderPass = vkCmdEndRenderPass ? vkCmdEndRenderPass :
+                                         (PFN_vkCmdEndRenderPass)vkGetDeviceProcAddr(device, "vkCmdEndRenderPass");
+  dev.pfnCmdDraw = vkCmdDraw ? vkCmdDraw :
+                       (PFN_vkCmdDraw)vkGetDeviceProcAddr(device, "vkCmdDraw");
+  dev.pfnCmdBindVertexBuffers = vkCmdBindVertexBuffers ? vkCmdBindVertexBuffers :
+                                                 (PFN_vkCmdBindVertexBuffers)vkGetDeviceProcAddr(device, "vkCmdBindVertexBuffers");
+  dev.pfnCmdSetViewport = vkCmdSetViewport ? vkCmdSetViewport :
+                                     (PFN_vkCmdSetViewport)vkGetDeviceProcAddr(device, "vkCmdSetViewport");
+  dev.pfnCmdSetScissor = vkCmdSetScissor ? vkCmdSetScissor :
+                                   (PFN_vkCmdSetScissor)vkGetDeviceProcAddr(device, "vkCmdSetScissor");
 #define WEBVULKAN_LOAD_DEVICE_IF_MISSING(FIELD, TYPE, NAME) \
   do { \
     if (!(FIELD)) { \
       (FIELD) = (TYPE)webvulkan_load_device_proc(icdGetDeviceProcAddr, vkGetDeviceProcAddr, device, (NAME)); \
     } \
   } while (0)
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnDestroyDevice, PFN_vkDestroyDevice, "vkDestroyDevice");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnCreateShaderModule, PFN_vkCreateShaderModule, "vkCreateShaderModule");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnDestroyShaderModule, PFN_vkDestroyShaderModule, "vkDestroyShaderModule");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnDestroyDevice, PFN_vkDestroyDevice, "vkDestroyDevice");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCreateShaderModule, PFN_vkCreateShaderModule, "vkCreateShaderModule");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnDestroyShaderModule, PFN_vkDestroyShaderModule, "vkDestroyShaderModule");
   WEBVULKAN_LOAD_DEVICE_IF_MISSING(
-    pfnCreateDescriptorSetLayout,
+    dev.pfnCreateDescriptorSetLayout,
     PFN_vkCreateDescriptorSetLayout,
     "vkCreateDescriptorSetLayout"
   );
   WEBVULKAN_LOAD_DEVICE_IF_MISSING(
-    pfnDestroyDescriptorSetLayout,
+    dev.pfnDestroyDescriptorSetLayout,
     PFN_vkDestroyDescriptorSetLayout,
     "vkDestroyDescriptorSetLayout"
   );
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnCreateDescriptorPool, PFN_vkCreateDescriptorPool, "vkCreateDescriptorPool");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCreateDescriptorPool, PFN_vkCreateDescriptorPool, "vkCreateDescriptorPool");
   WEBVULKAN_LOAD_DEVICE_IF_MISSING(
-    pfnDestroyDescriptorPool,
+    dev.pfnDestroyDescriptorPool,
     PFN_vkDestroyDescriptorPool,
     "vkDestroyDescriptorPool"
   );
   WEBVULKAN_LOAD_DEVICE_IF_MISSING(
-    pfnAllocateDescriptorSets,
+    dev.pfnAllocateDescriptorSets,
     PFN_vkAllocateDescriptorSets,
     "vkAllocateDescriptorSets"
   );
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnUpdateDescriptorSets, PFN_vkUpdateDescriptorSets, "vkUpdateDescriptorSets");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnCreatePipelineLayout, PFN_vkCreatePipelineLayout, "vkCreatePipelineLayout");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnUpdateDescriptorSets, PFN_vkUpdateDescriptorSets, "vkUpdateDescriptorSets");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCreatePipelineLayout, PFN_vkCreatePipelineLayout, "vkCreatePipelineLayout");
   WEBVULKAN_LOAD_DEVICE_IF_MISSING(
-    pfnDestroyPipelineLayout,
+    dev.pfnDestroyPipelineLayout,
     PFN_vkDestroyPipelineLayout,
     "vkDestroyPipelineLayout"
   );
   WEBVULKAN_LOAD_DEVICE_IF_MISSING(
-    pfnCreateComputePipelines,
+    dev.pfnCreateComputePipelines,
     PFN_vkCreateComputePipelines,
     "vkCreateComputePipelines"
   );
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnDestroyPipeline, PFN_vkDestroyPipeline, "vkDestroyPipeline");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnCreateBuffer, PFN_vkCreateBuffer, "vkCreateBuffer");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnDestroyBuffer, PFN_vkDestroyBuffer, "vkDestroyBuffer");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnDestroyPipeline, PFN_vkDestroyPipeline, "vkDestroyPipeline");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCreatePipelineCache, PFN_vkCreatePipelineCache, "vkCreatePipelineCache");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnDestroyPipelineCache, PFN_vkDestroyPipelineCache, "vkDestroyPipelineCache");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCreateBuffer, PFN_vkCreateBuffer, "vkCreateBuffer");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnDestroyBuffer, PFN_vkDestroyBuffer, "vkDestroyBuffer");
   WEBVULKAN_LOAD_DEVICE_IF_MISSING(
-    pfnGetBufferMemoryRequirements,
+    dev.pfnGetBufferMemoryRequirements,
     PFN_vkGetBufferMemoryRequirements,
     "vkGetBufferMemoryRequirements"
   );
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnAllocateMemory, PFN_vkAllocateMemory, "vkAllocateMemory");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnFreeMemory, PFN_vkFreeMemory, "vkFreeMemory");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnBindBufferMemory, PFN_vkBindBufferMemory, "vkBindBufferMemory");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnMapMemory, PFN_vkMapMemory, "vkMapMemory");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnUnmapMemory, PFN_vkUnmapMemory, "vkUnmapMemory");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnGetDeviceQueue, PFN_vkGetDeviceQueue, "vkGetDeviceQueue");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnCreateCommandPool, PFN_vkCreateCommandPool, "vkCreateCommandPool");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnAllocateMemory, PFN_vkAllocateMemory, "vkAllocateMemory");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnFreeMemory, PFN_vkFreeMemory, "vkFreeMemory");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnBindBufferMemory, PFN_vkBindBufferMemory, "vkBindBufferMemory");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnMapMemory, PFN_vkMapMemory, "vkMapMemory");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnUnmapMemory, PFN_vkUnmapMemory, "vkUnmapMemory");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnGetDeviceQueue, PFN_vkGetDeviceQueue, "vkGetDeviceQueue");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCreateCommandPool, PFN_vkCreateCommandPool, "vkCreateCommandPool");
   WEBVULKAN_LOAD_DEVICE_IF_MISSING(
-    pfnDestroyCommandPool,
+    dev.pfnDestroyCommandPool,
     PFN_vkDestroyCommandPool,
     "vkDestroyCommandPool"
   );
   WEBVULKAN_LOAD_DEVICE_IF_MISSING(
-    pfnAllocateCommandBuffers,
+    dev.pfnAllocateCommandBuffers,
     PFN_vkAllocateCommandBuffers,
     "vkAllocateCommandBuffers"
   );
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnBeginCommandBuffer, PFN_vkBeginCommandBuffer, "vkBeginCommandBuffer");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnEndCommandBuffer, PFN_vkEndCommandBuffer, "vkEndCommandBuffer");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnCmdBindPipeline, PFN_vkCmdBindPipeline, "vkCmdBindPipeline");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnBeginCommandBuffer, PFN_vkBeginCommandBuffer, "vkBeginCommandBuffer");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnEndCommandBuffer, PFN_vkEndCommandBuffer, "vkEndCommandBuffer");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCmdBindPipeline, PFN_vkCmdBindPipeline, "vkCmdBindPipeline");
   WEBVULKAN_LOAD_DEVICE_IF_MISSING(
-    pfnCmdBindDescriptorSets,
+    dev.pfnCmdBindDescriptorSets,
     PFN_vkCmdBindDescriptorSets,
     "vkCmdBindDescriptorSets"
   );
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnCmdDispatch, PFN_vkCmdDispatch, "vkCmdDispatch");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnCreateFence, PFN_vkCreateFence, "vkCreateFence");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnDestroyFence, PFN_vkDestroyFence, "vkDestroyFence");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnQueueSubmit, PFN_vkQueueSubmit, "vkQueueSubmit");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnWaitForFences, PFN_vkWaitForFences, "vkWaitForFences");
-  WEBVULKAN_LOAD_DEVICE_IF_MISSING(pfnResetFences, PFN_vkResetFences, "vkResetFences");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCmdDispatch, PFN_vkCmdDispatch, "vkCmdDispatch");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(
+    dev.pfnCmdDispatchIndirect,
+    PFN_vkCmdDispatchIndirect,
+    "vkCmdDispatchIndirect"
+  );
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCmdFillBuffer, PFN_vkCmdFillBuffer, "vkCmdFillBuffer");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCmdCopyBuffer, PFN_vkCmdCopyBuffer, "vkCmdCopyBuffer");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCmdUpdateBuffer, PFN_vkCmdUpdateBuffer, "vkCmdUpdateBuffer");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCmdPipelineBarrier, PFN_vkCmdPipelineBarrier, "vkCmdPipelineBarrier");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCmdPushConstants, PFN_vkCmdPushConstants, "vkCmdPushConstants");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCreateImage, PFN_vkCreateImage, "vkCreateImage");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnDestroyImage, PFN_vkDestroyImage, "vkDestroyImage");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(
+    dev.pfnGetImageMemoryRequirements,
+    PFN_vkGetImageMemoryRequirements,
+    "vkGetImageMemoryRequirements"
+  );
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnBindImageMemory, PFN_vkBindImageMemory, "vkBindImageMemory");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(
+    dev.pfnGetImageSubresourceLayout,
+    PFN_vkGetImageSubresourceLayout,
+    "vkGetImageSubresourceLayout"
+  );
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCreateImageView, PFN_vkCreateImageView, "vkCreateImageView");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnDestroyImageView, PFN_vkDestroyImageView, "vkDestroyImageView");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCreateFence, PFN_vkCreateFence, "vkCreateFence");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnDestroyFence, PFN_vkDestroyFence, "vkDestroyFence");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnQueueSubmit, PFN_vkQueueSubmit, "vkQueueSubmit");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnWaitForFences, PFN_vkWaitForFences, "vkWaitForFences");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnResetFences, PFN_vkResetFences, "vkResetFences");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCreateRenderPass, PFN_vkCreateRenderPass, "vkCreateRenderPass");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnDestroyRenderPass, PFN_vkDestroyRenderPass, "vkDestroyRenderPass");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCreateFramebuffer, PFN_vkCreateFramebuffer, "vkCreateFramebuffer");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnDestroyFramebuffer, PFN_vkDestroyFramebuffer, "vkDestroyFramebuffer");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(
+    dev.pfnCreateGraphicsPipelines,
+    PFN_vkCreateGraphicsPipelines,
+    "vkCreateGraphicsPipelines"
+  );
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCmdBeginRenderPass, PFN_vkCmdBeginRenderPass, "vkCmdBeginRenderPass");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCmdEndRenderPass, PFN_vkCmdEndRenderPass, "vkCmdEndRenderPass");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCmdDraw, PFN_vkCmdDraw, "vkCmdDraw");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCmdBindVertexBuffers, PFN_vkCmdBindVertexBuffers, "vkCmdBindVertexBuffers");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCmdSetViewport, PFN_vkCmdSetViewport, "vkCmdSetViewport");
+  WEBVULKAN_LOAD_DEVICE_IF_MISSING(dev.pfnCmdSetScissor, PFN_vkCmdSetScissor, "vkCmdSetScissor");
 #undef WEBVULKAN_LOAD_DEVICE_IF_MISSING
-  if (!pfnDestroyDevice || !pfnGetPhysicalDeviceMemoryProperties ||
-      !pfnCreateShaderModule || !pfnDestroyShaderModule ||
-      !pfnCreatePipelineLayout || !pfnDestroyPipelineLayout ||
-      !pfnCreateComputePipelines || !pfnDestroyPipeline ||
-      !pfnCreateDescriptorSetLayout || !pfnDestroyDescriptorSetLayout ||
-      !pfnCreateDescriptorPool || !pfnDestroyDescriptorPool ||
-      !pfnAllocateDescriptorSets || !pfnUpdateDescriptorSets ||
-      !pfnCreateBuffer || !pfnDestroyBuffer ||
-      !pfnGetBufferMemoryRequirements || !pfnAllocateMemory || !pfnFreeMemory ||
-      !pfnBindBufferMemory || !pfnMapMemory || !pfnUnmapMemory) {
+  if (!dev.pfnDestroyDevice || !dev.pfnGetPhysicalDeviceMemoryProperties ||
+      !dev.pfnCreateShaderModule || !dev.pfnDestroyShaderModule ||
+      !dev.pfnCreatePipelineLayout || !dev.pfnDestroyPipelineLayout ||
+      !dev.pfnCreateComputePipelines || !dev.pfnDestroyPipeline ||
+      !dev.pfnCreateDescriptorSetLayout || !dev.pfnDestroyDescriptorSetLayout ||
+      !dev.pfnCreateDescriptorPool || !dev.pfnDestroyDescriptorPool ||
+      !dev.pfnAllocateDescriptorSets || !dev.pfnUpdateDescriptorSets ||
+      !dev.pfnCreateBuffer || !dev.pfnDestroyBuffer ||
+      !dev.pfnGetBufferMemoryRequirements || !dev.pfnAllocateMemory || !dev.pfnFreeMemory ||
+      !dev.pfnBindBufferMemory || !dev.pfnMapMemory || !dev.pfnUnmapMemory) {
     printf("lavapipe runtime smoke missing device entrypoints\n");
-    printf("  vkGetPhysicalDeviceMemoryProperties=%s\n", pfnGetPhysicalDeviceMemoryProperties ? "present" : "missing");
-    printf("  vkDestroyDevice=%s\n", pfnDestroyDevice ? "present" : "missing");
-    printf("  vkCreateShaderModule=%s\n", pfnCreateShaderModule ? "present" : "missing");
-    printf("  vkDestroyShaderModule=%s\n", pfnDestroyShaderModule ? "present" : "missing");
-    printf("  vkCreateDescriptorSetLayout=%s\n", pfnCreateDescriptorSetLayout ? "present" : "missing");
-    printf("  vkDestroyDescriptorSetLayout=%s\n", pfnDestroyDescriptorSetLayout ? "present" : "missing");
-    printf("  vkCreateDescriptorPool=%s\n", pfnCreateDescriptorPool ? "present" : "missing");
-    printf("  vkDestroyDescriptorPool=%s\n", pfnDestroyDescriptorPool ? "present" : "missing");
-    printf("  vkAllocateDescriptorSets=%s\n", pfnAllocateDescriptorSets ? "present" : "missing");
-    printf("  vkUpdateDescriptorSets=%s\n", pfnUpdateDescriptorSets ? "present" : "missing");
-    printf("  vkCreateBuffer=%s\n", pfnCreateBuffer ? "present" : "missing");
-    printf("  vkDestroyBuffer=%s\n", pfnDestroyBuffer ? "present" : "missing");
-    printf("  vkGetBufferMemoryRequirements=%s\n", pfnGetBufferMemoryRequirements ? "present" : "missing");
-    printf("  vkAllocateMemory=%s\n", pfnAllocateMemory ? "present" : "missing");
-    printf("  vkFreeMemory=%s\n", pfnFreeMemory ? "present" : "missing");
-    printf("  vkBindBufferMemory=%s\n", pfnBindBufferMemory ? "present" : "missing");
-    printf("  vkMapMemory=%s\n", pfnMapMemory ? "present" : "missing");
-    printf("  vkUnmapMemory=%s\n", pfnUnmapMemory ? "present" : "missing");
-    printf("  vkCreatePipelineLayout=%s\n", pfnCreatePipelineLayout ? "present" : "missing");
-    printf("  vkDestroyPipelineLayout=%s\n", pfnDestroyPipelineLayout ? "present" : "missing");
-    printf("  vkCreateComputePipelines=%s\n", pfnCreateComputePipelines ? "present" : "missing");
-    printf("  vkDestroyPipeline=%s\n", pfnDestroyPipeline ? "present" : "missing");
+    printf("  vkGetPhysicalDeviceMemoryProperties=%s\n", dev.pfnGetPhysicalDeviceMemoryProperties ? "present" : "missing");
+    printf("  vkDestroyDevice=%s\n", dev.pfnDestroyDevice ? "present" : "missing");
+    printf("  vkCreateShaderModule=%s\n", dev.pfnCreateShaderModule ? "present" : "missing");
+    printf("  vkDestroyShaderModule=%s\n", dev.pfnDestroyShaderModule ? "present" : "missing");
+    printf("  vkCreateDescriptorSetLayout=%s\n", dev.pfnCreateDescriptorSetLayout ? "present" : "missing");
+    printf("  vkDestroyDescriptorSetLayout=%s\n", dev.pfnDestroyDescriptorSetLayout ? "present" : "missing");
+    printf("  vkCreateDescriptorPool=%s\n", dev.pfnCreateDescriptorPool ? "present" : "missing");
+    printf("  vkDestroyDescriptorPool=%s\n", dev.pfnDestroyDescriptorPool ? "present" : "missing");
+    printf("  vkAllocateDescriptorSets=%s\n", dev.pfnAllocateDescriptorSets ? "present" : "missing");
+    printf("  vkUpdateDescriptorSets=%s\n", dev.pfnUpdateDescriptorSets ? "present" : "missing");
+    printf("  vkCreateBuffer=%s\n", dev.pfnCreateBuffer ? "present" : "missing");
+    printf("  vkDestroyBuffer=%s\n", dev.pfnDestroyBuffer ? "present" : "missing");
+    printf("  vkGetBufferMemoryRequirements=%s\n", dev.pfnGetBufferMemoryRequirements ? "present" : "missing");
+    printf("  vkAllocateMemory=%s\n", dev.pfnAllocateMemory ? "present" : "missing");
+    printf("  vkFreeMemory=%s\n", dev.pfnFreeMemory ? "present" : "missing");
+    printf("  vkBindBufferMemory=%s\n", dev.pfnBindBufferMemory ? "present" : "missing");
+    printf("  vkMapMemory=%s\n", dev.pfnMapMemory ? "present" : "missing");
+    printf("  vkUnmapMemory=%s\n", dev.pfnUnmapMemory ? "present" : "missing");
+    printf("  vkCreatePipelineLayout=%s\n", dev.pfnCreatePipelineLayout ? "present" : "missing");
+    printf("  vkDestroyPipelineLayout=%s\n", dev.pfnDestroyPipelineLayout ? "present" : "missing");
+    printf("  vkCreateComputePipelines=%s\n", dev.pfnCreateComputePipelines ? "present" : "missing");
+    printf("  vkDestroyPipeline=%s\n", dev.pfnDestroyPipeline ? "present" : "missing");
     smokeRc = 31;
     goto cleanup;
   }
-  if (!pfnGetDeviceQueue || !pfnCreateCommandPool || !pfnDestroyCommandPool || !pfnAllocateCommandBuffers ||
-      !pfnBeginCommandBuffer || !pfnEndCommandBuffer || !pfnCmdBindPipeline || !pfnCmdBindDescriptorSets || !pfnCmdDispatch ||
-      !pfnCreateFence || !pfnDestroyFence || !pfnQueueSubmit || !pfnWaitForFences || !pfnResetFences) {
+  if (!dev.pfnGetDeviceQueue || !dev.pfnCreateCommandPool || !dev.pfnDestroyCommandPool || !dev.pfnAllocateCommandBuffers ||
+      !dev.pfnBeginCommandBuffer || !dev.pfnEndCommandBuffer || !dev.pfnCmdBindPipeline || !dev.pfnCmdBindDescriptorSets || !dev.pfnCmdDispatch ||
+      !dev.pfnCreateFence || !dev.pfnDestroyFence || !dev.pfnQueueSubmit || !dev.pfnWaitForFences || !dev.pfnResetFences ||
+      (dispatchIndirect && !dev.pfnCmdDispatchIndirect) ||
+      (dispatchParamMode != WEBVULKAN_RUNTIME_PARAM_MODE_NONE && !dev.pfnCmdPushConstants)) {
     printf("lavapipe runtime smoke missing dispatch entrypoints\n");
-    printf("  vkGetDeviceQueue=%s\n", pfnGetDeviceQueue ? "present" : "missing");
-    printf("  vkCreateCommandPool=%s\n", pfnCreateCommandPool ? "present" : "missing");
-    printf("  vkDestroyCommandPool=%s\n", pfnDestroyCommandPool ? "present" : "missing");
-    printf("  vkAllocateCommandBuffers=%s\n", pfnAllocateCommandBuffers ? "present" : "missing");
-    printf("  vkBeginCommandBuffer=%s\n", pfnBeginCommandBuffer ? "present" : "missing");
-    printf("  vkEndCommandBuffer=%s\n", pfnEndCommandBuffer ? "present" : "missing");
-    printf("  vkCmdBindPipeline=%s\n", pfnCmdBindPipeline ? "present" : "missing");
-    printf("  vkCmdBindDescriptorSets=%s\n", pfnCmdBindDescriptorSets ? "present" : "missing");
-    printf("  vkCmdDispatch=%s\n", pfnCmdDispatch ? "present" : "missing");
-    printf("  vkCreateFence=%s\n", pfnCreateFence ? "present" : "missing");
-    printf("  vkDestroyFence=%s\n", pfnDestroyFence ? "present" : "missing");
-    printf("  vkQueueSubmit=%s\n", pfnQueueSubmit ? "present" : "missing");
-    printf("  vkWaitForFences=%s\n", pfnWaitForFences ? "present" : "missing");
-    printf("  vkResetFences=%s\n", pfnResetFences ? "present" : "missing");
+    printf("  vkGetDeviceQueue=%s\n", dev.pfnGetDeviceQueue ? "present" : "missing");
+    printf("  vkCreateCommandPool=%s\n", dev.pfnCreateCommandPool ? "present" : "missing");
+    printf("  vkDestroyCommandPool=%s\n", dev.pfnDestroyCommandPool ? "present" : "missing");
+    printf("  vkAllocateCommandBuffers=%s\n", dev.pfnAllocateCommandBuffers ? "present" : "missing");
+    printf("  vkBeginCommandBuffer=%s\n", dev.pfnBeginCommandBuffer ? "present" : "missing");
+    printf("  vkEndCommandBuffer=%s\n", dev.pfnEndCommandBuffer ? "present" : "missing");
+    printf("  vkCmdBindPipeline=%s\n", dev.pfnCmdBindPipeline ? "present" : "missing");
+    printf("  vkCmdBindDescriptorSets=%s\n", dev.pfnCmdBindDescriptorSets ? "present" : "missing");
+    printf("  vkCmdDispatch=%s\n", dev.pfnCmdDispatch ? "present" : "missing");
+    printf("  vkCmdDispatchIndirect=%s\n", dev.pfnCmdDispatchIndirect ? "present" : "missing");
+    printf("  vkCmdPushConstants=%s\n", dev.pfnCmdPushConstants ? "present" : "missing");
+    printf("  vkCreateFence=%s\n", dev.pfnCreateFence ? "present" : "missing");
+    printf("  vkDestroyFence=%s\n", dev.pfnDestroyFence ? "present" : "missing");
+    printf("  vkQueueSubmit=%s\n", dev.pfnQueueSubmit ? "present" : "missing");
+    printf("  vkWaitForFences=%s\n", dev.pfnWaitForFences ? "present" : "missing");
+    printf("  vkResetFences=%s\n", dev.pfnResetFences ? "present" : "missing");
     smokeRc = 36;
     goto cleanup;
   }
 
+  if (imageFilter &&
+      (!dev.pfnCreateImage || !dev.pfnDestroyImage || !dev.pfnGetImageMemoryRequirements || !dev.pfnBindImageMemory ||
+       !dev.pfnGetImageSubresourceLayout || !dev.pfnCreateImageView || !dev.pfnDestroyImageView || !dev.pfnCmdPipelineBarrier)) {
+    printf("lavapipe runtime smoke missing image entrypoints\n");
+    printf("  vkCreateImage=%s\n", dev.pfnCreateImage ? "present" : "missing");
+    printf("  vkDestroyImage=%s\n", dev.pfnDestroyImage ? "present" : "missing");
+    printf("  vkGetImageMemoryRequirements=%s\n", dev.pfnGetImageMemoryRequirements ? "present" : "missing");
+    printf("  vkBindImageMemory=%s\n", dev.pfnBindImageMemory ? "present" : "missing");
+    printf("  vkGetImageSubresourceLayout=%s\n", dev.pfnGetImageSubresourceLayout ? "present" : "missing");
+    printf("  vkCreateImageView=%s\n", dev.pfnCreateImageView ? "present" : "missing");
+    printf("  vkDestroyImageView=%s\n", dev.pfnDestroyImageView ? "present" : "missing");
+    printf("  vkCmdPipelineBarrier=%s\n", dev.pfnCmdPipelineBarrier ? "present" : "missing");
+    smokeRc = 95;
+    goto cleanup;
+  }
+
+  g_runtime_accounted_allocate_memory = dev.pfnAllocateMemory;
+  dev.pfnAllocateMemory = webvulkan_accounted_allocate_memory;
+  g_runtime_accounted_free_memory = dev.pfnFreeMemory;
+  dev.pfnFreeMemory = webvulkan_accounted_free_memory;
+
+  if (webvulkan_runtime_trace_enabled()) {
+    g_runtime_traced_create_shader_module = dev.pfnCreateShaderModule;
+    dev.pfnCreateShaderModule = webvulkan_traced_create_shader_module;
+    g_runtime_traced_create_compute_pipelines = dev.pfnCreateComputePipelines;
+    dev.pfnCreateComputePipelines = webvulkan_traced_create_compute_pipelines;
+    g_runtime_traced_queue_submit = dev.pfnQueueSubmit;
+    dev.pfnQueueSubmit = webvulkan_traced_queue_submit;
+    g_runtime_traced_wait_for_fences = dev.pfnWaitForFences;
+    dev.pfnWaitForFences = webvulkan_traced_wait_for_fences;
+    if (dev.pfnCreateGraphicsPipelines) {
+      g_runtime_traced_create_graphics_pipelines = dev.pfnCreateGraphicsPipelines;
+      dev.pfnCreateGraphicsPipelines = webvulkan_traced_create_graphics_pipelines;
+    }
+  }
+
+  if ((dispatchParamMode != WEBVULKAN_RUNTIME_PARAM_MODE_NONE) !=
+      (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_PUSH_CONSTANT_PARAM)) {
+    printf("lavapipe runtime smoke param profile mismatch\n");
+    printf("  shader.dispatch.profile=%s\n", benchProfile->name);
+    printf("  shader.workload=%s\n", shaderWorkloadName);
+    smokeRc = 94;
+    goto cleanup;
+  }
+
   const uint8_t* runtimeSpirvBytes = 0;
   uint32_t runtimeSpirvSize = 0u;
   const char* runtimeSpirvEntrypoint = 0;
@@ -663,7 +4690,7 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   shaderCreateInfo.codeSize = shaderCodeSizeBytes;
   shaderCreateInfo.pCode = shaderCodeWords;
 
-  rc = pfnCreateShaderModule(device, &shaderCreateInfo, 0, &shaderModule);
+  rc = dev.pfnCreateShaderModule(device, &shaderCreateInfo, 0, &shaderModule);
   printf("lavapipe runtime smoke stage=after_vkCreateShaderModule rc=%d\n", (int)rc);
   fflush(stdout);
   if (rc != VK_SUCCESS || shaderModule == VK_NULL_HANDLE) {
@@ -674,17 +4701,31 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   VkDescriptorSetLayoutBinding descriptorSetLayoutBinding;
   memset(&descriptorSetLayoutBinding, 0, sizeof(descriptorSetLayoutBinding));
   descriptorSetLayoutBinding.binding = 0u;
-  descriptorSetLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  descriptorSetLayoutBinding.descriptorType = dispatchParamMode == WEBVULKAN_RUNTIME_PARAM_MODE_DESCRIPTOR ?
+                                                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC :
+                                                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
   descriptorSetLayoutBinding.descriptorCount = 1u;
   descriptorSetLayoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
+  /* image_box_filter adds a texel-fetch source at binding 1 and a storage image at binding 2. */
+  VkDescriptorSetLayoutBinding descriptorSetLayoutBindings[3];
+  memset(descriptorSetLayoutBindings, 0, sizeof(descriptorSetLayoutBindings));
+  descriptorSetLayoutBindings[0] = descriptorSetLayoutBinding;
+  descriptorSetLayoutBindings[1] = descriptorSetLayoutBinding;
+  descriptorSetLayoutBindings[1].binding = 1u;
+  descriptorSetLayoutBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+  descriptorSetLayoutBindings[2] = descriptorSetLayoutBinding;
+  descriptorSetLayoutBindings[2].binding = 2u;
+  descriptorSetLayoutBindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+  const uint32_t descriptorBindingCount = imageFilter ? 3u : 1u;
+
   VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo;
   memset(&descriptorSetLayoutCreateInfo, 0, sizeof(descriptorSetLayoutCreateInfo));
   descriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-  descriptorSetLayoutCreateInfo.bindingCount = 1u;
-  descriptorSetLayoutCreateInfo.pBindings = &descriptorSetLayoutBinding;
+  descriptorSetLayoutCreateInfo.bindingCount = descriptorBindingCount;
+  descriptorSetLayoutCreateInfo.pBindings = descriptorSetLayoutBindings;
 
-  rc = pfnCreateDescriptorSetLayout(device, &descriptorSetLayoutCreateInfo, 0, &descriptorSetLayout);
+  rc = dev.pfnCreateDescriptorSetLayout(device, &descriptorSetLayoutCreateInfo, 0, &descriptorSetLayout);
   if (rc != VK_SUCCESS || descriptorSetLayout == VK_NULL_HANDLE) {
     smokeRc = 37;
     goto cleanup;
@@ -695,8 +4736,17 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
   pipelineLayoutCreateInfo.setLayoutCount = 1u;
   pipelineLayoutCreateInfo.pSetLayouts = &descriptorSetLayout;
+  VkPushConstantRange pushConstantRange;
+  memset(&pushConstantRange, 0, sizeof(pushConstantRange));
+  pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  pushConstantRange.offset = 0u;
+  pushConstantRange.size = sizeof(uint32_t);
+  if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_PUSH_CONSTANT_PARAM) {
+    pipelineLayoutCreateInfo.pushConstantRangeCount = 1u;
+    pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+  }
 
-  rc = pfnCreatePipelineLayout(device, &pipelineLayoutCreateInfo, 0, &pipelineLayout);
+  rc = dev.pfnCreatePipelineLayout(device, &pipelineLayoutCreateInfo, 0, &pipelineLayout);
   if (rc != VK_SUCCESS || pipelineLayout == VK_NULL_HANDLE) {
     smokeRc = 33;
     goto cleanup;
@@ -709,21 +4759,70 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   shaderStage.module = shaderModule;
   shaderStage.pName = shaderEntryPoint;
 
+  VkSpecializationMapEntry specMapEntries[2];
+  memset(specMapEntries, 0, sizeof(specMapEntries));
+  for (uint32_t i = 0u; i < 2u; ++i) {
+    specMapEntries[i].constantID = g_runtime_spec_entries[i].constantId;
+    specMapEntries[i].offset = g_runtime_spec_entries[i].offset;
+    specMapEntries[i].size = g_runtime_spec_entries[i].size;
+  }
+  VkSpecializationInfo specInfo;
+  memset(&specInfo, 0, sizeof(specInfo));
+  specInfo.mapEntryCount = 2u;
+  specInfo.pMapEntries = specMapEntries;
+  specInfo.dataSize = sizeof(g_runtime_spec_constants);
+  specInfo.pData = g_runtime_spec_constants;
+  if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_SPEC_CONSTANT_TILES) {
+    shaderStage.pSpecializationInfo = &specInfo;
+  }
+
   VkComputePipelineCreateInfo pipelineCreateInfo;
   memset(&pipelineCreateInfo, 0, sizeof(pipelineCreateInfo));
   pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
   pipelineCreateInfo.stage = shaderStage;
   pipelineCreateInfo.layout = pipelineLayout;
 
-  rc = pfnCreateComputePipelines(device, VK_NULL_HANDLE, 1u, &pipelineCreateInfo, 0, &computePipeline);
+  rc = dev.pfnCreateComputePipelines(device, VK_NULL_HANDLE, 1u, &pipelineCreateInfo, 0, &computePipeline);
   printf("lavapipe runtime smoke stage=after_vkCreateComputePipelines rc=%d\n", (int)rc);
   fflush(stdout);
   if (rc != VK_SUCCESS || computePipeline == VK_NULL_HANDLE) {
     smokeRc = 34;
     goto cleanup;
   }
+  webvulkan_runtime_record_stage_timing(
+    WEBVULKAN_RUNTIME_STAGE_PIPELINE_CREATE,
+    emscripten_get_now() - setupStageStartMs
+  );
+
+  if (pipelineBenchShaders != 0u) {
+    smokeRc = webvulkan_run_runtime_pipeline_bench(
+      &dev,
+      pipelineBenchShaders,
+      &deviceCreateInfo,
+      &descriptorSetLayoutCreateInfo,
+      &pipelineLayoutCreateInfo,
+      &pipelineCreateInfo,
+      shaderKeyLo,
+      shaderKeyHi,
+      pipelineStateSamples,
+      &pipelineBenchKeyCount,
+      &pipelineBenchBundleCount
+    );
+    if (smokeRc != 0) {
+      goto cleanup;
+    }
+  }
+
+  g_runtime_memory_growth_sample_count = 0u;
+  if (memoryGrowthCycles != 0u) {
+    smokeRc = webvulkan_run_runtime_memory_growth(&dev, memoryGrowthCycles, &pipelineCreateInfo);
+    if (smokeRc != 0) {
+      goto cleanup;
+    }
+  }
+  setupStageStartMs = emscripten_get_now();
 
-  pfnGetDeviceQueue(device, queueFamilyIndex, 0u, &queue);
+  dev.pfnGetDeviceQueue(device, queueFamilyIndex, 0u, &queue);
   if (queue == VK_NULL_HANDLE) {
     smokeRc = 61;
     goto cleanup;
@@ -731,16 +4830,28 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
 
   VkPhysicalDeviceMemoryProperties memoryProperties;
   memset(&memoryProperties, 0, sizeof(memoryProperties));
-  pfnGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+  dev.pfnGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+  if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_BUFFER_COPY) {
+    if (dispatchesPerSubmit != 1u || dispatchInvocationsPerSubmit > (UINT32_MAX - 2u) / 2u) {
+      smokeRc = 87;
+      goto cleanup;
+    }
+    /* { count, source, destination, kernel storage address } */
+    copyWordCount = dispatchInvocationsPerSubmit;
+    if (2u + (2u * copyWordCount) > storageBufferWordCount) {
+      storageBufferWordCount = 2u + (2u * copyWordCount);
+    }
+  }
 
   VkBufferCreateInfo bufferCreateInfo;
   memset(&bufferCreateInfo, 0, sizeof(bufferCreateInfo));
   bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-  bufferCreateInfo.size = sizeof(uint32_t) * (VkDeviceSize)kSmokeBufferWordCount;
+  bufferCreateInfo.size = sizeof(uint32_t) * (VkDeviceSize)storageBufferWordCount;
   bufferCreateInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
   bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-  rc = pfnCreateBuffer(device, &bufferCreateInfo, 0, &storageBuffer);
+  rc = dev.pfnCreateBuffer(device, &bufferCreateInfo, 0, &storageBuffer);
   if (rc != VK_SUCCESS || storageBuffer == VK_NULL_HANDLE) {
     smokeRc = 58;
     goto cleanup;
@@ -748,7 +4859,7 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
 
   VkMemoryRequirements bufferMemoryRequirements;
   memset(&bufferMemoryRequirements, 0, sizeof(bufferMemoryRequirements));
-  pfnGetBufferMemoryRequirements(device, storageBuffer, &bufferMemoryRequirements);
+  dev.pfnGetBufferMemoryRequirements(device, storageBuffer, &bufferMemoryRequirements);
 
   int hasHostCoherentMemory = 0;
   uint32_t memoryTypeIndex = find_memory_type_index(
@@ -769,23 +4880,25 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   memoryAllocateInfo.allocationSize = bufferMemoryRequirements.size;
   memoryAllocateInfo.memoryTypeIndex = memoryTypeIndex;
 
-  rc = pfnAllocateMemory(device, &memoryAllocateInfo, 0, &storageMemory);
+  rc = dev.pfnAllocateMemory(device, &memoryAllocateInfo, 0, &storageMemory);
   if (rc != VK_SUCCESS || storageMemory == VK_NULL_HANDLE) {
     smokeRc = 60;
     goto cleanup;
   }
 
-  rc = pfnBindBufferMemory(device, storageBuffer, storageMemory, 0u);
+  rc = dev.pfnBindBufferMemory(device, storageBuffer, storageMemory, 0u);
   if (rc != VK_SUCCESS) {
     smokeRc = 69;
     goto cleanup;
   }
 
-  rc = pfnMapMemory(device, storageMemory, 0u, sizeof(uint32_t) * (VkDeviceSize)kSmokeBufferWordCount, 0u, (void**)&mappedStorageWords);
+  rc = dev.pfnMapMemory(device, storageMemory, 0u, sizeof(uint32_t) * (VkDeviceSize)storageBufferWordCount, 0u, (void**)&mappedStorageWords);
   if (rc != VK_SUCCESS || !mappedStorageWords) {
     smokeRc = 70;
     goto cleanup;
   }
+  g_last_mapped_storage_base = (uint32_t)(uintptr_t)mappedStorageWords;
+  g_last_mapped_storage_bytes = (uint32_t)sizeof(uint32_t) * storageBufferWordCount;
   if (shaderWorkload >= WEBVULKAN_RUNTIME_SHADER_WORKLOAD_COUNT) {
     smokeRc = 77;
     goto cleanup;
@@ -794,7 +4907,50 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
     uniqueWriteWordCount = dispatchInvocationsPerDispatch;
     clearWordCount = 1u + uniqueWriteWordCount;
   }
-  if (clearWordCount > kSmokeBufferWordCount) {
+  if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_ATOMIC_SHARDED_HISTOGRAM) {
+    clearWordCount = kRuntimeHistogramBinCount;
+  }
+  if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_GROUPSHARED_REDUCTION) {
+    clearWordCount = 2u;
+  }
+  if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_GROUPSHARED_SCAN) {
+    clearWordCount = 1u + shaderWorkgroupSizeX;
+  }
+  if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_PUSH_CONSTANT_PARAM) {
+    clearWordCount = 2u;
+    if (dispatchParamMode == WEBVULKAN_RUNTIME_PARAM_MODE_DESCRIPTOR) {
+      /* One slot per dispatch, each holding { accumulator, param } at a dynamic offset. */
+      VkDeviceSize slotAlignment = props.limits.minStorageBufferOffsetAlignment;
+      if (slotAlignment < 2u * sizeof(uint32_t)) {
+        slotAlignment = 2u * sizeof(uint32_t);
+      }
+      paramSlotStrideWords = (uint32_t)(slotAlignment / sizeof(uint32_t));
+      clearWordCount = paramSlotStrideWords * dispatchesPerSubmit;
+    }
+  }
+  if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_SUBGROUP_REDUCTION) {
+    const VkFlags requiredSubgroupOps = VK_SUBGROUP_FEATURE_BASIC_BIT |
+                                        VK_SUBGROUP_FEATURE_ARITHMETIC_BIT |
+                                        VK_SUBGROUP_FEATURE_BALLOT_BIT;
+    if (subgroupProps.subgroupSize == 0u ||
+        (shaderWorkgroupSizeX % subgroupProps.subgroupSize) != 0u ||
+        (subgroupProps.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT) == 0u ||
+        (subgroupProps.supportedOperations & requiredSubgroupOps) != requiredSubgroupOps) {
+      smokeRc = 84;
+      goto cleanup;
+    }
+    if (webvulkan_get_runtime_dispatch_mode() == WEBVULKAN_RUNTIME_DISPATCH_MODE_FAST_WASM &&
+        webvulkan_get_runtime_subgroup_size() != subgroupProps.subgroupSize) {
+      printf("lavapipe runtime smoke subgroup size mismatch\n");
+      printf("  device.subgroup_size=%u\n", subgroupProps.subgroupSize);
+      printf("  runtime.subgroup_size=%u\n", webvulkan_get_runtime_subgroup_size());
+      smokeRc = 85;
+      goto cleanup;
+    }
+    subgroupsPerWorkgroup = shaderWorkgroupSizeX / subgroupProps.subgroupSize;
+    clearWordCount = 4u;
+  }
+  if (clearWordCount > storageBufferWordCount) {
     smokeRc = 78;
     goto cleanup;
   }
@@ -815,28 +4971,231 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
     expectedDispatchValue = dispatchInvocationsPerSubmit;
     expectedDispatchAuxValue = uniqueWriteWordCount;
     break;
+  case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_ATOMIC_SHARDED_HISTOGRAM:
+    if ((dispatchInvocationsPerSubmit % kRuntimeHistogramBinCount) != 0u) {
+      smokeRc = 81;
+      goto cleanup;
+    }
+    expectedDispatchValue = dispatchInvocationsPerSubmit / kRuntimeHistogramBinCount;
+    expectedDispatchAuxValue = dispatchInvocationsPerSubmit;
+    break;
+  case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_GROUPSHARED_REDUCTION:
+  case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_GROUPSHARED_SCAN:
+    expectedDispatchAuxValue = webvulkan_runtime_groupshared_prefix_sum(shaderWorkgroupSizeX - 1u);
+    expectedDispatchValue = dispatchGroupsPerDispatch * dispatchesPerSubmit * expectedDispatchAuxValue;
+    break;
+  case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_BUFFER_COPY:
+    expectedDispatchValue = copyWordCount;
+    expectedDispatchAuxValue = copyWordCount;
+    break;
+  case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_SPEC_CONSTANT_TILES:
+    expectedDispatchValue = dispatchInvocationsPerSubmit * g_runtime_spec_constants[0] * g_runtime_spec_constants[1];
+    expectedDispatchAuxValue = webvulkan_get_runtime_specialization_key();
+    break;
+  case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_IMAGE_BOX_FILTER:
+    expectedDispatchValue = filterImageWidth * filterImageHeight;
+    expectedDispatchAuxValue = filterImageWidth * filterImageHeight;
+    break;
+  case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_PUSH_CONSTANT_PARAM:
+    if (dispatchParamMode == WEBVULKAN_RUNTIME_PARAM_MODE_DESCRIPTOR) {
+      expectedDispatchValue = dispatchInvocationsPerDispatch;
+      expectedDispatchAuxValue = dispatchInvocationsPerDispatch * ((dispatchesPerSubmit * (dispatchesPerSubmit + 1u)) / 2u);
+    } else {
+      expectedDispatchValue = dispatchInvocationsPerDispatch * ((dispatchesPerSubmit * (dispatchesPerSubmit + 1u)) / 2u);
+      expectedDispatchAuxValue = 0u;
+    }
+    break;
+  case WEBVULKAN_RUNTIME_SHADER_WORKLOAD_SUBGROUP_REDUCTION:
+    expectedDispatchValue =
+      dispatchGroupsPerDispatch * dispatchesPerSubmit * webvulkan_runtime_groupshared_prefix_sum(shaderWorkgroupSizeX - 1u);
+    expectedDispatchAuxValue = dispatchGroupsPerDispatch * dispatchesPerSubmit * subgroupsPerWorkgroup;
+    expectedSubgroupWords[0] = expectedDispatchAuxValue;
+    expectedSubgroupWords[1] = dispatchInvocationsPerSubmit / 2u;
+    expectedSubgroupWords[2] = dispatchGroupsPerDispatch * dispatchesPerSubmit * subgroupProps.subgroupSize *
+                               ((subgroupsPerWorkgroup * (subgroupsPerWorkgroup - 1u)) / 2u);
+    break;
   default:
     smokeRc = 79;
     goto cleanup;
   }
 
-  for (uint32_t i = 0u; i < clearWordCount; ++i) {
-    mappedStorageWords[i] = 0u;
+  memset(mappedStorageWords, 0, sizeof(uint32_t) * (size_t)clearWordCount);
+  for (uint32_t i = 0u; i < copyWordCount; ++i) {
+    mappedStorageWords[1u + i] = webvulkan_runtime_copy_pattern(i);
+    mappedStorageWords[1u + copyWordCount + i] = kRuntimeCopyPoisonValue;
+  }
+  if (copyWordCount > 0u) {
+    mappedStorageWords[1u + (2u * copyWordCount)] = 0u;
+  }
+
+  if (dispatchIndirect) {
+    VkBufferCreateInfo indirectBufferCreateInfo;
+    memset(&indirectBufferCreateInfo, 0, sizeof(indirectBufferCreateInfo));
+    indirectBufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    indirectBufferCreateInfo.size = sizeof(VkDispatchIndirectCommand);
+    indirectBufferCreateInfo.usage = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+    indirectBufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    rc = dev.pfnCreateBuffer(device, &indirectBufferCreateInfo, 0, &indirectBuffer);
+    if (rc != VK_SUCCESS || indirectBuffer == VK_NULL_HANDLE) {
+      smokeRc = 93;
+      goto cleanup;
+    }
+
+    VkMemoryRequirements indirectMemoryRequirements;
+    memset(&indirectMemoryRequirements, 0, sizeof(indirectMemoryRequirements));
+    dev.pfnGetBufferMemoryRequirements(device, indirectBuffer, &indirectMemoryRequirements);
+    int indirectHostCoherent = 0;
+    const uint32_t indirectMemoryTypeIndex = find_memory_type_index(
+      &memoryProperties,
+      indirectMemoryRequirements.memoryTypeBits,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+      &indirectHostCoherent
+    );
+    if (indirectMemoryTypeIndex == UINT32_MAX || !indirectHostCoherent) {
+      smokeRc = 93;
+      goto cleanup;
+    }
+
+    VkMemoryAllocateInfo indirectAllocateInfo;
+    memset(&indirectAllocateInfo, 0, sizeof(indirectAllocateInfo));
+    indirectAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    indirectAllocateInfo.allocationSize = indirectMemoryRequirements.size;
+    indirectAllocateInfo.memoryTypeIndex = indirectMemoryTypeIndex;
+    rc = dev.pfnAllocateMemory(device, &indirectAllocateInfo, 0, &indirectMemory);
+    if (rc != VK_SUCCESS || indirectMemory == VK_NULL_HANDLE) {
+      smokeRc = 93;
+      goto cleanup;
+    }
+    rc = dev.pfnBindBufferMemory(device, indirectBuffer, indirectMemory, 0u);
+    if (rc != VK_SUCCESS) {
+      smokeRc = 93;
+      goto cleanup;
+    }
+    rc = dev.pfnMapMemory(
+      device,
+      indirectMemory,
+      0u,
+      sizeof(VkDispatchIndirectCommand),
+      0u,
+      (void**)&mappedIndirectCommand
+    );
+    if (rc != VK_SUCCESS || !mappedIndirectCommand) {
+      smokeRc = 93;
+      goto cleanup;
+    }
+    /* Record against an empty grid so the real group counts are only visible at execution time. */
+    memset(mappedIndirectCommand, 0, sizeof(*mappedIndirectCommand));
+  }
+
+  memset(filterImageLayouts, 0, sizeof(filterImageLayouts));
+  for (uint32_t i = 0u; i < 2u && imageFilter; ++i) {
+    /* Linear, host-visible images so the source can be written and the result read back in place. */
+    VkImageCreateInfo imageCreateInfo;
+    memset(&imageCreateInfo, 0, sizeof(imageCreateInfo));
+    imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageCreateInfo.format = VK_FORMAT_R32_UINT;
+    imageCreateInfo.extent.width = filterImageWidth;
+    imageCreateInfo.extent.height = filterImageHeight;
+    imageCreateInfo.extent.depth = 1u;
+    imageCreateInfo.mipLevels = 1u;
+    imageCreateInfo.arrayLayers = 1u;
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCreateInfo.tiling = VK_IMAGE_TILING_LINEAR;
+    imageCreateInfo.usage = i == 0u ? VK_IMAGE_USAGE_SAMPLED_BIT : VK_IMAGE_USAGE_STORAGE_BIT;
+    imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_PREINITIALIZED;
+    rc = dev.pfnCreateImage(device, &imageCreateInfo, 0, &filterImages[i]);
+    if (rc != VK_SUCCESS || filterImages[i] == VK_NULL_HANDLE) {
+      smokeRc = 96;
+      goto cleanup;
+    }
+
+    VkMemoryRequirements imageMemoryRequirements;
+    memset(&imageMemoryRequirements, 0, sizeof(imageMemoryRequirements));
+    dev.pfnGetImageMemoryRequirements(device, filterImages[i], &imageMemoryRequirements);
+    int imageHostCoherent = 0;
+    const uint32_t imageMemoryTypeIndex = find_memory_type_index(
+      &memoryProperties,
+      imageMemoryRequirements.memoryTypeBits,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+      &imageHostCoherent
+    );
+    if (imageMemoryTypeIndex == UINT32_MAX || !imageHostCoherent) {
+      smokeRc = 96;
+      goto cleanup;
+    }
+
+    VkMemoryAllocateInfo imageAllocateInfo;
+    memset(&imageAllocateInfo, 0, sizeof(imageAllocateInfo));
+    imageAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    imageAllocateInfo.allocationSize = imageMemoryRequirements.size;
+    imageAllocateInfo.memoryTypeIndex = imageMemoryTypeIndex;
+    rc = dev.pfnAllocateMemory(device, &imageAllocateInfo, 0, &filterImageMemories[i]);
+    if (rc != VK_SUCCESS || filterImageMemories[i] == VK_NULL_HANDLE) {
+      smokeRc = 96;
+      goto cleanup;
+    }
+    rc = dev.pfnBindImageMemory(device, filterImages[i], filterImageMemories[i], 0u);
+    if (rc != VK_SUCCESS) {
+      smokeRc = 96;
+      goto cleanup;
+    }
+    rc = dev.pfnMapMemory(device, filterImageMemories[i], 0u, VK_WHOLE_SIZE, 0u, (void**)&mappedFilterImages[i]);
+    if (rc != VK_SUCCESS || !mappedFilterImages[i]) {
+      smokeRc = 96;
+      goto cleanup;
+    }
+
+    VkImageSubresource imageSubresource;
+    memset(&imageSubresource, 0, sizeof(imageSubresource));
+    imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    dev.pfnGetImageSubresourceLayout(device, filterImages[i], &imageSubresource, &filterImageLayouts[i]);
+    if (filterImageLayouts[i].rowPitch < sizeof(uint32_t) * (VkDeviceSize)filterImageWidth) {
+      smokeRc = 96;
+      goto cleanup;
+    }
+    for (uint32_t y = 0u; y < filterImageHeight; ++y) {
+      uint32_t* row = (uint32_t*)(mappedFilterImages[i] + filterImageLayouts[i].offset +
+                                  (size_t)y * (size_t)filterImageLayouts[i].rowPitch);
+      for (uint32_t x = 0u; x < filterImageWidth; ++x) {
+        row[x] = i == 0u ? webvulkan_runtime_image_pattern(x, y) : kRuntimeCopyPoisonValue;
+      }
+    }
+
+    VkImageViewCreateInfo imageViewCreateInfo;
+    memset(&imageViewCreateInfo, 0, sizeof(imageViewCreateInfo));
+    imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    imageViewCreateInfo.image = filterImages[i];
+    imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    imageViewCreateInfo.format = VK_FORMAT_R32_UINT;
+    imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    imageViewCreateInfo.subresourceRange.levelCount = 1u;
+    imageViewCreateInfo.subresourceRange.layerCount = 1u;
+    rc = dev.pfnCreateImageView(device, &imageViewCreateInfo, 0, &filterImageViews[i]);
+    if (rc != VK_SUCCESS || filterImageViews[i] == VK_NULL_HANDLE) {
+      smokeRc = 96;
+      goto cleanup;
+    }
   }
 
-  VkDescriptorPoolSize descriptorPoolSize;
-  memset(&descriptorPoolSize, 0, sizeof(descriptorPoolSize));
-  descriptorPoolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-  descriptorPoolSize.descriptorCount = 1u;
+  VkDescriptorPoolSize descriptorPoolSizes[3];
+  memset(descriptorPoolSizes, 0, sizeof(descriptorPoolSizes));
+  for (uint32_t i = 0u; i < descriptorBindingCount; ++i) {
+    descriptorPoolSizes[i].type = descriptorSetLayoutBindings[i].descriptorType;
+    descriptorPoolSizes[i].descriptorCount = 1u;
+  }
 
   VkDescriptorPoolCreateInfo descriptorPoolCreateInfo;
   memset(&descriptorPoolCreateInfo, 0, sizeof(descriptorPoolCreateInfo));
   descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
   descriptorPoolCreateInfo.maxSets = 1u;
-  descriptorPoolCreateInfo.poolSizeCount = 1u;
-  descriptorPoolCreateInfo.pPoolSizes = &descriptorPoolSize;
+  descriptorPoolCreateInfo.poolSizeCount = descriptorBindingCount;
+  descriptorPoolCreateInfo.pPoolSizes = descriptorPoolSizes;
 
-  rc = pfnCreateDescriptorPool(device, &descriptorPoolCreateInfo, 0, &descriptorPool);
+  rc = dev.pfnCreateDescriptorPool(device, &descriptorPoolCreateInfo, 0, &descriptorPool);
   if (rc != VK_SUCCESS || descriptorPool == VK_NULL_HANDLE) {
     smokeRc = 71;
     goto cleanup;
@@ -849,7 +5208,7 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   descriptorSetAllocateInfo.descriptorSetCount = 1u;
   descriptorSetAllocateInfo.pSetLayouts = &descriptorSetLayout;
 
-  rc = pfnAllocateDescriptorSets(device, &descriptorSetAllocateInfo, &descriptorSet);
+  rc = dev.pfnAllocateDescriptorSets(device, &descriptorSetAllocateInfo, &descriptorSet);
   if (rc != VK_SUCCESS || descriptorSet == VK_NULL_HANDLE) {
     smokeRc = 72;
     goto cleanup;
@@ -859,18 +5218,34 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   memset(&descriptorBufferInfo, 0, sizeof(descriptorBufferInfo));
   descriptorBufferInfo.buffer = storageBuffer;
   descriptorBufferInfo.offset = 0u;
-  descriptorBufferInfo.range = sizeof(uint32_t) * (VkDeviceSize)kSmokeBufferWordCount;
+  descriptorBufferInfo.range = sizeof(uint32_t) * (VkDeviceSize)storageBufferWordCount;
+  if (dispatchParamMode == WEBVULKAN_RUNTIME_PARAM_MODE_DESCRIPTOR) {
+    descriptorBufferInfo.range = sizeof(uint32_t) * (VkDeviceSize)paramSlotStrideWords;
+  }
 
-  VkWriteDescriptorSet writeDescriptorSet;
-  memset(&writeDescriptorSet, 0, sizeof(writeDescriptorSet));
-  writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-  writeDescriptorSet.dstSet = descriptorSet;
-  writeDescriptorSet.dstBinding = 0u;
-  writeDescriptorSet.descriptorCount = 1u;
-  writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-  writeDescriptorSet.pBufferInfo = &descriptorBufferInfo;
+  VkDescriptorImageInfo descriptorImageInfos[2];
+  memset(descriptorImageInfos, 0, sizeof(descriptorImageInfos));
+  for (uint32_t i = 0u; i < 2u; ++i) {
+    descriptorImageInfos[i].imageView = filterImageViews[i];
+    descriptorImageInfos[i].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+  }
+
+  VkWriteDescriptorSet writeDescriptorSets[3];
+  memset(writeDescriptorSets, 0, sizeof(writeDescriptorSets));
+  for (uint32_t i = 0u; i < descriptorBindingCount; ++i) {
+    writeDescriptorSets[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writeDescriptorSets[i].dstSet = descriptorSet;
+    writeDescriptorSets[i].dstBinding = i;
+    writeDescriptorSets[i].descriptorCount = 1u;
+    writeDescriptorSets[i].descriptorType = descriptorSetLayoutBindings[i].descriptorType;
+    if (i == 0u) {
+      writeDescriptorSets[i].pBufferInfo = &descriptorBufferInfo;
+    } else {
+      writeDescriptorSets[i].pImageInfo = &descriptorImageInfos[i - 1u];
+    }
+  }
 
-  pfnUpdateDescriptorSets(device, 1u, &writeDescriptorSet, 0u, 0);
+  dev.pfnUpdateDescriptorSets(device, descriptorBindingCount, writeDescriptorSets, 0u, 0);
 
   VkCommandPoolCreateInfo commandPoolCreateInfo;
   memset(&commandPoolCreateInfo, 0, sizeof(commandPoolCreateInfo));
@@ -878,7 +5253,7 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   commandPoolCreateInfo.queueFamilyIndex = queueFamilyIndex;
   commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
-  rc = pfnCreateCommandPool(device, &commandPoolCreateInfo, 0, &commandPool);
+  rc = dev.pfnCreateCommandPool(device, &commandPoolCreateInfo, 0, &commandPool);
   if (rc != VK_SUCCESS || commandPool == VK_NULL_HANDLE) {
     smokeRc = 62;
     goto cleanup;
@@ -891,7 +5266,7 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
   commandBufferAllocateInfo.commandBufferCount = 1u;
 
-  rc = pfnAllocateCommandBuffers(device, &commandBufferAllocateInfo, &commandBuffer);
+  rc = dev.pfnAllocateCommandBuffers(device, &commandBufferAllocateInfo, &commandBuffer);
   if (rc != VK_SUCCESS || commandBuffer == VK_NULL_HANDLE) {
     smokeRc = 63;
     goto cleanup;
@@ -902,71 +5277,196 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
   commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
-  rc = pfnBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo);
+  const double commandRecordStartMs = emscripten_get_now();
+  rc = dev.pfnBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo);
   if (rc != VK_SUCCESS) {
     smokeRc = 64;
     goto cleanup;
   }
 
-  pfnCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline);
-  pfnCmdBindDescriptorSets(
-    commandBuffer,
-    VK_PIPELINE_BIND_POINT_COMPUTE,
-    pipelineLayout,
-    0u,
-    1u,
-    &descriptorSet,
-    0u,
-    0
-  );
+  dev.pfnCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline);
+  if (dispatchParamMode != WEBVULKAN_RUNTIME_PARAM_MODE_DESCRIPTOR) {
+    dev.pfnCmdBindDescriptorSets(
+      commandBuffer,
+      VK_PIPELINE_BIND_POINT_COMPUTE,
+      pipelineLayout,
+      0u,
+      1u,
+      &descriptorSet,
+      0u,
+      0
+    );
+  } else {
+    const uint32_t noPushedParam = 0u;
+    dev.pfnCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0u, sizeof(noPushedParam), &noPushedParam);
+  }
   for (uint32_t dispatchIndex = 0u; dispatchIndex < dispatchesPerSubmit; ++dispatchIndex) {
-    pfnCmdDispatch(commandBuffer, dispatchX, dispatchY, dispatchZ);
+    /* The same per-dispatch parameter either rides in push constants or in a dynamically offset slot. */
+    if (dispatchParamMode == WEBVULKAN_RUNTIME_PARAM_MODE_PUSH_CONSTANT) {
+      const uint32_t param = dispatchIndex + 1u;
+      dev.pfnCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0u, sizeof(param), &param);
+    } else if (dispatchParamMode == WEBVULKAN_RUNTIME_PARAM_MODE_DESCRIPTOR) {
+      const uint32_t dynamicOffset = dispatchIndex * paramSlotStrideWords * (uint32_t)sizeof(uint32_t);
+      dev.pfnCmdBindDescriptorSets(
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        pipelineLayout,
+        0u,
+        1u,
+        &descriptorSet,
+        1u,
+        &dynamicOffset
+      );
+    }
+    if (dispatchIndirect) {
+      dev.pfnCmdDispatchIndirect(commandBuffer, indirectBuffer, 0u);
+    } else {
+      dev.pfnCmdDispatch(commandBuffer, dispatchX, dispatchY, dispatchZ);
+    }
   }
 
-  rc = pfnEndCommandBuffer(commandBuffer);
+  rc = dev.pfnEndCommandBuffer(commandBuffer);
   if (rc != VK_SUCCESS) {
     smokeRc = 65;
     goto cleanup;
   }
+  webvulkan_runtime_record_stage_timing(
+    WEBVULKAN_RUNTIME_STAGE_COMMAND_RECORD,
+    emscripten_get_now() - commandRecordStartMs
+  );
 
   VkFenceCreateInfo fenceCreateInfo;
   memset(&fenceCreateInfo, 0, sizeof(fenceCreateInfo));
   fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-  rc = pfnCreateFence(device, &fenceCreateInfo, 0, &submitFence);
+  rc = dev.pfnCreateFence(device, &fenceCreateInfo, 0, &submitFence);
   if (rc != VK_SUCCESS || submitFence == VK_NULL_HANDLE) {
     smokeRc = 66;
     goto cleanup;
   }
 
+  if (imageFilter) {
+    /* Move both images to GENERAL once, keeping the host-written source texels. */
+    VkCommandBufferAllocateInfo imageLayoutAllocateInfo = commandBufferAllocateInfo;
+    rc = dev.pfnAllocateCommandBuffers(device, &imageLayoutAllocateInfo, &imageLayoutCommandBuffer);
+    if (rc != VK_SUCCESS || imageLayoutCommandBuffer == VK_NULL_HANDLE) {
+      smokeRc = 96;
+      goto cleanup;
+    }
+    rc = dev.pfnBeginCommandBuffer(imageLayoutCommandBuffer, &commandBufferBeginInfo);
+    if (rc != VK_SUCCESS) {
+      smokeRc = 96;
+      goto cleanup;
+    }
+    VkImageMemoryBarrier imageBarriers[2];
+    memset(imageBarriers, 0, sizeof(imageBarriers));
+    for (uint32_t i = 0u; i < 2u; ++i) {
+      imageBarriers[i].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+      imageBarriers[i].srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
+      imageBarriers[i].dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+      imageBarriers[i].oldLayout = VK_IMAGE_LAYOUT_PREINITIALIZED;
+      imageBarriers[i].newLayout = VK_IMAGE_LAYOUT_GENERAL;
+      imageBarriers[i].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      imageBarriers[i].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      imageBarriers[i].image = filterImages[i];
+      imageBarriers[i].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      imageBarriers[i].subresourceRange.levelCount = 1u;
+      imageBarriers[i].subresourceRange.layerCount = 1u;
+    }
+    dev.pfnCmdPipelineBarrier(
+      imageLayoutCommandBuffer,
+      VK_PIPELINE_STAGE_HOST_BIT,
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      0u,
+      0u,
+      0,
+      0u,
+      0,
+      2u,
+      imageBarriers
+    );
+    rc = dev.pfnEndCommandBuffer(imageLayoutCommandBuffer);
+    if (rc != VK_SUCCESS) {
+      smokeRc = 96;
+      goto cleanup;
+    }
+    VkSubmitInfo imageLayoutSubmitInfo;
+    memset(&imageLayoutSubmitInfo, 0, sizeof(imageLayoutSubmitInfo));
+    imageLayoutSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    imageLayoutSubmitInfo.commandBufferCount = 1u;
+    imageLayoutSubmitInfo.pCommandBuffers = &imageLayoutCommandBuffer;
+    rc = dev.pfnQueueSubmit(queue, 1u, &imageLayoutSubmitInfo, submitFence);
+    if (rc != VK_SUCCESS) {
+      smokeRc = 96;
+      goto cleanup;
+    }
+    rc = dev.pfnWaitForFences(device, 1u, &submitFence, VK_TRUE, UINT64_MAX);
+    if (rc != VK_SUCCESS) {
+      smokeRc = 96;
+      goto cleanup;
+    }
+  }
+
   VkSubmitInfo submitInfo;
   memset(&submitInfo, 0, sizeof(submitInfo));
   submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
   submitInfo.commandBufferCount = 1u;
   submitInfo.pCommandBuffers = &commandBuffer;
+  webvulkan_runtime_record_stage_timing(
+    WEBVULKAN_RUNTIME_STAGE_RESOURCE_SETUP,
+    emscripten_get_now() - setupStageStartMs
+  );
 
   dispatchStartMs = emscripten_get_now();
   for (uint32_t iteration = 0u; iteration < dispatchSubmitIterations; ++iteration) {
-    for (uint32_t i = 0u; i < clearWordCount; ++i) {
-      mappedStorageWords[i] = 0u;
+    memset(mappedStorageWords, 0, sizeof(uint32_t) * (size_t)clearWordCount);
+    for (uint32_t slot = 0u; slot < dispatchesPerSubmit && paramSlotStrideWords > 0u; ++slot) {
+      mappedStorageWords[(slot * paramSlotStrideWords) + 1u] = slot + 1u;
+    }
+    if (mappedIndirectCommand) {
+      mappedIndirectCommand->x = dispatchX;
+      mappedIndirectCommand->y = dispatchY;
+      mappedIndirectCommand->z = dispatchZ;
+    }
+    for (uint32_t sample = 0u; sample < kRuntimeImageFilterSampleCount && imageFilter; ++sample) {
+      const uint32_t texel = (sample * filterImageWidth * filterImageHeight) / kRuntimeImageFilterSampleCount;
+      uint32_t* row = (uint32_t*)(mappedFilterImages[1] + filterImageLayouts[1].offset +
+                                  (size_t)(texel / filterImageWidth) * (size_t)filterImageLayouts[1].rowPitch);
+      row[texel % filterImageWidth] = kRuntimeCopyPoisonValue;
     }
-    rc = pfnResetFences(device, 1u, &submitFence);
+    for (uint32_t sample = 0u; sample < kRuntimeCopySampleCount && copyWordCount > 0u; ++sample) {
+      mappedStorageWords[1u + copyWordCount + ((sample * copyWordCount) / kRuntimeCopySampleCount)] =
+        kRuntimeCopyPoisonValue;
+    }
+    rc = dev.pfnResetFences(device, 1u, &submitFence);
     if (rc != VK_SUCCESS) {
       smokeRc = 74;
       goto cleanup;
     }
 
-    rc = pfnQueueSubmit(queue, 1u, &submitInfo, submitFence);
+    const double submitStartMs = emscripten_get_now();
+    rc = dev.pfnQueueSubmit(queue, 1u, &submitInfo, submitFence);
     if (rc != VK_SUCCESS) {
       smokeRc = 75;
       goto cleanup;
     }
 
-    rc = pfnWaitForFences(device, 1u, &submitFence, VK_TRUE, UINT64_MAX);
+    const double fenceWaitStartMs = emscripten_get_now();
+    rc = dev.pfnWaitForFences(device, 1u, &submitFence, VK_TRUE, UINT64_MAX);
     if (rc != VK_SUCCESS) {
       smokeRc = 76;
       goto cleanup;
     }
+    const double submitEndMs = emscripten_get_now();
+    const double submitMs = submitEndMs - submitStartMs;
+    webvulkan_runtime_record_stage_timing(WEBVULKAN_RUNTIME_STAGE_QUEUE_SUBMIT, fenceWaitStartMs - submitStartMs);
+    webvulkan_runtime_record_stage_timing(WEBVULKAN_RUNTIME_STAGE_FENCE_WAIT, submitEndMs - fenceWaitStartMs);
+    fencedSubmitMs += submitMs;
+    if (persistentSamples != 0u) {
+      g_runtime_persistent_sample_ms[iteration] = submitMs / (double)dispatchesPerSubmit;
+    }
 
+    /* Host readback covers reading and checking the mapped results of this submit. */
+    const double readbackStartMs = emscripten_get_now();
     dispatchObservedValue = mappedStorageWords[0];
     if (dispatchObservedValue != expectedDispatchValue) {
       printf("lavapipe runtime smoke dispatch mismatch\n");
@@ -1004,10 +5504,210 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
       }
       dispatchObservedAuxValue = uniqueWriteWordCount;
     }
+
+    if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_ATOMIC_SHARDED_HISTOGRAM) {
+      uint32_t histogramTotal = 0u;
+      for (uint32_t bin = 0u; bin < kRuntimeHistogramBinCount; ++bin) {
+        uint32_t observedValue = mappedStorageWords[bin];
+        if (observedValue != expectedDispatchValue) {
+          printf("lavapipe runtime smoke histogram bin mismatch\n");
+          printf("  shader.dispatch.iteration=%u\n", iteration);
+          printf("  shader.dispatch.histogram_bin=%u\n", bin);
+          printf("  shader.dispatch.histogram_expected=%u\n", expectedDispatchValue);
+          printf("  shader.dispatch.histogram_observed=%u\n", observedValue);
+          smokeRc = 82;
+          goto cleanup;
+        }
+        histogramTotal += observedValue;
+      }
+      dispatchObservedAuxValue = histogramTotal;
+    }
+
+    if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_GROUPSHARED_REDUCTION ||
+        shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_GROUPSHARED_SCAN) {
+      const uint32_t checkedLaneCount =
+        shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_GROUPSHARED_SCAN ? shaderWorkgroupSizeX : 1u;
+      for (uint32_t i = 0u; i < checkedLaneCount; ++i) {
+        uint32_t lane = shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_GROUPSHARED_SCAN ? i : shaderWorkgroupSizeX - 1u;
+        uint32_t expectedValue = webvulkan_runtime_groupshared_prefix_sum(lane);
+        uint32_t observedValue = mappedStorageWords[1u + i];
+        if (observedValue != expectedValue) {
+          printf("lavapipe runtime smoke groupshared mismatch\n");
+          printf("  shader.dispatch.iteration=%u\n", iteration);
+          printf("  shader.dispatch.groupshared_index=%u\n", i);
+          printf("  shader.dispatch.groupshared_expected=%u\n", expectedValue);
+          printf("  shader.dispatch.groupshared_observed=%u\n", observedValue);
+          smokeRc = 83;
+          goto cleanup;
+        }
+      }
+      dispatchObservedAuxValue = mappedStorageWords[checkedLaneCount];
+    }
+
+    if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_SUBGROUP_REDUCTION) {
+      for (uint32_t i = 0u; i < 3u; ++i) {
+        uint32_t observedValue = mappedStorageWords[1u + i];
+        if (observedValue != expectedSubgroupWords[i]) {
+          printf("lavapipe runtime smoke subgroup mismatch\n");
+          printf("  shader.dispatch.iteration=%u\n", iteration);
+          printf("  shader.dispatch.subgroup_word=%u\n", 1u + i);
+          printf("  shader.dispatch.subgroup_expected=%u\n", expectedSubgroupWords[i]);
+          printf("  shader.dispatch.subgroup_observed=%u\n", observedValue);
+          smokeRc = 86;
+          goto cleanup;
+        }
+      }
+      dispatchObservedAuxValue = mappedStorageWords[1];
+    }
+
+    if (imageFilter) {
+      /* Sampled texels are re-poisoned every submit; the last submit checks the whole image. */
+      const int checkAllTexels = iteration + 1u == dispatchSubmitIterations;
+      const uint32_t texelCount = filterImageWidth * filterImageHeight;
+      const uint32_t checkedTexelCount = checkAllTexels ? texelCount : kRuntimeImageFilterSampleCount;
+      for (uint32_t i = 0u; i < checkedTexelCount; ++i) {
+        const uint32_t texel = checkAllTexels ? i : (i * texelCount) / kRuntimeImageFilterSampleCount;
+        const uint32_t x = texel % filterImageWidth;
+        const uint32_t y = texel / filterImageWidth;
+        const uint32_t* row = (const uint32_t*)(mappedFilterImages[1] + filterImageLayouts[1].offset +
+                                                (size_t)y * (size_t)filterImageLayouts[1].rowPitch);
+        uint32_t expectedValue = webvulkan_runtime_image_box_filter_reference(x, y, filterImageWidth, filterImageHeight);
+        if (row[x] != expectedValue) {
+          printf("lavapipe runtime smoke image filter mismatch\n");
+          printf("  shader.dispatch.iteration=%u\n", iteration);
+          printf("  shader.image.texel=%u,%u\n", x, y);
+          printf("  shader.image.expected=%u\n", expectedValue);
+          printf("  shader.image.observed=%u\n", row[x]);
+          smokeRc = 97;
+          goto cleanup;
+        }
+      }
+      dispatchObservedAuxValue = checkedTexelCount;
+    }
+
+    if (paramSlotStrideWords > 0u) {
+      uint32_t paramTotal = 0u;
+      for (uint32_t slot = 0u; slot < dispatchesPerSubmit; ++slot) {
+        uint32_t expectedValue = dispatchInvocationsPerDispatch * (slot + 1u);
+        uint32_t observedValue = mappedStorageWords[slot * paramSlotStrideWords];
+        if (observedValue != expectedValue) {
+          printf("lavapipe runtime smoke descriptor param mismatch\n");
+          printf("  shader.dispatch.iteration=%u\n", iteration);
+          printf("  shader.dispatch.param_slot=%u\n", slot);
+          printf("  shader.dispatch.param_expected=%u\n", expectedValue);
+          printf("  shader.dispatch.param_observed=%u\n", observedValue);
+          smokeRc = 94;
+          goto cleanup;
+        }
+        paramTotal += observedValue;
+      }
+      dispatchObservedAuxValue = paramTotal;
+    }
+
+    if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_BUFFER_COPY) {
+      /* Sampled words are re-poisoned every submit; the last submit checks the whole destination. */
+      const int checkAllWords = iteration + 1u == dispatchSubmitIterations;
+      const uint32_t checkedWordCount = checkAllWords ? copyWordCount : kRuntimeCopySampleCount;
+      for (uint32_t i = 0u; i < checkedWordCount; ++i) {
+        uint32_t index = checkAllWords ? i : (i * copyWordCount) / kRuntimeCopySampleCount;
+        uint32_t expectedValue = webvulkan_runtime_copy_pattern(index);
+        uint32_t observedValue = mappedStorageWords[1u + copyWordCount + index];
+        if (observedValue != expectedValue) {
+          printf("lavapipe runtime smoke buffer copy mismatch\n");
+          printf("  shader.dispatch.iteration=%u\n", iteration);
+          printf("  shader.dispatch.copy_index=%u\n", index);
+          printf("  shader.dispatch.copy_expected=0x%08x\n", expectedValue);
+          printf("  shader.dispatch.copy_observed=0x%08x\n", observedValue);
+          smokeRc = 88;
+          goto cleanup;
+        }
+      }
+      dispatchObservedAuxValue = checkedWordCount;
+    }
+    webvulkan_runtime_record_stage_timing(WEBVULKAN_RUNTIME_STAGE_HOST_READBACK, emscripten_get_now() - readbackStartMs);
   }
   dispatchEndMs = emscripten_get_now();
+  if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_BUFFER_COPY) {
+    g_last_kernel_storage_address = mappedStorageWords[1u + (2u * copyWordCount)];
+    const double hostMemcpyStartMs = emscripten_get_now();
+    for (uint32_t iteration = 0u; iteration < dispatchSubmitIterations; ++iteration) {
+      memcpy(&mappedStorageWords[1u + copyWordCount], &mappedStorageWords[1u], sizeof(uint32_t) * (size_t)copyWordCount);
+    }
+    hostMemcpyMs = emscripten_get_now() - hostMemcpyStartMs;
+  }
+  /* Persistent mode reports pure dispatch cost; the default loop keeps its per-iteration reset and validation. */
   g_last_dispatch_wall_ms =
-    (dispatchEndMs - dispatchStartMs) / (double)totalDispatches;
+    (persistentSamples != 0u ? fencedSubmitMs : dispatchEndMs - dispatchStartMs) / (double)totalDispatches;
+
+  /* The benches below submit on the dispatch queue and fence. */
+  dev.queue = queue;
+  dev.submitFence = submitFence;
+  dev.memoryProperties = memoryProperties;
+  dev.commandBufferAllocateInfo = commandBufferAllocateInfo;
+  dev.commandBufferBeginInfo = commandBufferBeginInfo;
+
+  if (transferBenchMaxBytes != 0u) {
+    smokeRc = webvulkan_run_runtime_transfer_bench(
+      &dev,
+      transferBenchMaxBytes,
+      transferSamples,
+      &transferSampleCount
+    );
+    if (smokeRc != 0) {
+      goto cleanup;
+    }
+  }
+
+  if (bandwidthBenchMaxBytes != 0u) {
+    smokeRc = webvulkan_run_runtime_bandwidth_bench(
+      &dev,
+      bandwidthBenchMaxBytes,
+      bandwidthSamples,
+      &bandwidthSampleCount,
+      &bandwidthKernelCount
+    );
+    if (smokeRc != 0) {
+      goto cleanup;
+    }
+  }
+
+  if (primitiveBenchMaxElements != 0u) {
+    smokeRc = webvulkan_run_runtime_primitive_bench(
+      &dev,
+      primitiveBenchMaxElements,
+      primitiveSamples,
+      &primitiveSampleCount,
+      &primitiveKernelCount
+    );
+    if (smokeRc != 0) {
+      goto cleanup;
+    }
+  }
+
+  if (renderBenchSize != 0u) {
+    smokeRc = webvulkan_run_runtime_render_bench(
+      &dev,
+      renderBenchSize,
+      renderSamples,
+      &renderSampleCount,
+      &renderSizeCount
+    );
+    if (smokeRc != 0) {
+      goto cleanup;
+    }
+  }
+
+  if (vertexBenchMaxVertices != 0u) {
+    smokeRc = webvulkan_run_runtime_vertex_bench(
+      &dev,
+      vertexBenchMaxVertices,
+      vertexSamples,
+      &vertexSampleCount
+    );
+    if (smokeRc != 0) {
+      goto cleanup;
+    }
+  }
 
   printf("lavapipe runtime smoke ok\n");
   printf("  backend=mesa lavapipe (swrast)\n");
@@ -1027,6 +5727,8 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
          VK_API_VERSION_PATCH(props.apiVersion));
   printf("  driver.name=%s\n", driverProps.driverName);
   printf("  driver.info=%s\n", driverProps.driverInfo);
+  printf("  device.subgroup_size=%u\n", subgroupProps.subgroupSize);
+  printf("  runtime.subgroup_size=%u\n", webvulkan_get_runtime_subgroup_size());
   printf("  proof.device_name_contains_llvmpipe=%s\n", proofDeviceName ? "yes" : "no");
   printf("  proof.driver_name_contains_llvmpipe=%s\n", proofDriverName ? "yes" : "no");
   printf("  vulkan_loader=volk (custom vk_icdGetInstanceProcAddr)\n");
@@ -1041,6 +5743,19 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
   printf("  shader.dispatch=ok\n");
   printf("  shader.dispatch.profile=%s\n", benchProfile->name);
   printf("  shader.dispatch.grid=%ux%ux%u\n", dispatchX, dispatchY, dispatchZ);
+  printf("  shader.dispatch.launch_override=%s\n", launchOverride ? "yes" : "no");
+  printf("  shader.dispatch.indirect=%s\n", dispatchIndirect ? "yes" : "no");
+  if (imageFilter) {
+    printf("  shader.image.size=%ux%u\n", filterImageWidth, filterImageHeight);
+    printf("  shader.image.row_pitch_bytes=%u\n", (uint32_t)filterImageLayouts[1].rowPitch);
+    printf("  shader.image.texels_checked=%u\n", dispatchObservedAuxValue);
+  }
+  printf("  shader.dispatch.param_mode=%s\n", webvulkan_get_runtime_param_mode_name(dispatchParamMode));
+  if (paramSlotStrideWords > 0u) {
+    printf("  shader.dispatch.param_slot_stride_bytes=%u\n", paramSlotStrideWords * (uint32_t)sizeof(uint32_t));
+    printf("  shader.dispatch.param_total_expected=%u\n", expectedDispatchAuxValue);
+    printf("  shader.dispatch.param_total_observed=%u\n", dispatchObservedAuxValue);
+  }
   printf("  shader.dispatch.submit_iterations=%u\n", dispatchSubmitIterations);
   printf("  shader.dispatch.dispatches_per_submit=%u\n", dispatchesPerSubmit);
   printf("  shader.dispatch.total_dispatches=%u\n", totalDispatches);
@@ -1054,6 +5769,77 @@ EMSCRIPTEN_KEEPALIVE int lavapipe_runtime_smoke(void) {
     printf("  shader.dispatch.unique_writes_expected=%u\n", expectedDispatchAuxValue);
     printf("  shader.dispatch.unique_writes_observed=%u\n", dispatchObservedAuxValue);
   }
+  if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_ATOMIC_SHARDED_HISTOGRAM) {
+    printf("  shader.dispatch.histogram_bins=%u\n", kRuntimeHistogramBinCount);
+    printf("  shader.dispatch.histogram_total_expected=%u\n", expectedDispatchAuxValue);
+    printf("  shader.dispatch.histogram_total_observed=%u\n", dispatchObservedAuxValue);
+  }
+  if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_GROUPSHARED_REDUCTION ||
+      shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_GROUPSHARED_SCAN) {
+    printf("  shader.dispatch.groupshared_words=%u\n", shaderWorkgroupSizeX);
+    printf("  shader.dispatch.workgroup_sum_expected=%u\n", expectedDispatchAuxValue);
+    printf("  shader.dispatch.workgroup_sum_observed=%u\n", dispatchObservedAuxValue);
+  }
+  if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_SPEC_CONSTANT_TILES) {
+    printf("  shader.specialization.tile_size=%u\n", g_runtime_spec_constants[0]);
+    printf("  shader.specialization.tile_repeats=%u\n", g_runtime_spec_constants[1]);
+    printf("  shader.specialization.key=%u\n", expectedDispatchAuxValue);
+  }
+  if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_SUBGROUP_REDUCTION) {
+    printf("  shader.dispatch.subgroups_per_workgroup=%u\n", subgroupsPerWorkgroup);
+    printf("  shader.dispatch.subgroups_expected=%u\n", expectedDispatchAuxValue);
+    printf("  shader.dispatch.subgroups_observed=%u\n", dispatchObservedAuxValue);
+    printf("  shader.dispatch.ballot_even_lanes=%u\n", expectedSubgroupWords[1]);
+  }
+  if (shaderWorkload == WEBVULKAN_RUNTIME_SHADER_WORKLOAD_BUFFER_COPY) {
+    const double copyBytes = (double)copyWordCount * sizeof(uint32_t) * (double)dispatchSubmitIterations;
+    printf("  shader.dispatch.buffer_words=%u\n", storageBufferWordCount);
+    printf("  shader.dispatch.copy_bytes_per_submit=%u\n", copyWordCount * (uint32_t)sizeof(uint32_t));
+    printf("  shader.dispatch.copy_gbps=%.3f\n", webvulkan_runtime_gbps(copyBytes, fencedSubmitMs));
+    printf("  shader.dispatch.host_memcpy_gbps=%.3f\n", webvulkan_runtime_gbps(copyBytes, hostMemcpyMs));
+    printf("  runtime.imported_memory_wasm_modules=%u\n", webvulkan_runtime_get_registered_imported_memory_wasm_count());
+  }
+  if (transferSampleCount > 0u) {
+    webvulkan_print_runtime_transfer_report(transferSamples, transferSampleCount);
+  }
+  if (bandwidthSampleCount > 0u) {
+    webvulkan_print_runtime_bandwidth_report(
+      bandwidthSamples,
+      bandwidthSampleCount,
+      bandwidthBenchMaxBytes,
+      bandwidthKernelCount
+    );
+  }
+  if (primitiveSampleCount > 0u) {
+    webvulkan_print_runtime_primitive_report(
+      primitiveSamples,
+      primitiveSampleCount,
+      primitiveBenchMaxElements,
+      primitiveKernelCount
+    );
+  }
+  if (renderSampleCount > 0u) {
+    webvulkan_print_runtime_render_report(renderSamples, renderSampleCount, renderSizeCount);
+  }
+  if (vertexSampleCount > 0u) {
+    webvulkan_print_runtime_vertex_report(vertexSamples, vertexSampleCount);
+  }
+  if (pipelineBenchShaders != 0u) {
+    webvulkan_print_runtime_pipeline_report(
+      pipelineBenchShaders,
+      pipelineBenchKeyCount,
+      pipelineBenchBundleCount,
+      pipelineStateSamples
+    );
+  }
+  printf("  setup.instance_ms=%.6f\n", webvulkan_runtime_get_stage_last_ms(WEBVULKAN_RUNTIME_STAGE_INSTANCE_CREATE));
+  printf("  setup.device_ms=%.6f\n", webvulkan_runtime_get_stage_last_ms(WEBVULKAN_RUNTIME_STAGE_DEVICE_CREATE));
+  printf("  setup.pipeline_ms=%.6f\n", webvulkan_runtime_get_stage_last_ms(WEBVULKAN_RUNTIME_STAGE_PIPELINE_CREATE));
+  printf("  setup.resources_ms=%.6f\n", webvulkan_runtime_get_stage_last_ms(WEBVULKAN_RUNTIME_STAGE_RESOURCE_SETUP));
+  if (persistentSamples != 0u) {
+    printf("  shader.dispatch.timing=persistent\n");
+    printf("  shader.dispatch.persistent_samples=%u\n", persistentSamples);
+  }
   printf("  shader.dispatch.wall_ms=%.6f\n", g_last_dispatch_wall_ms);
 
 cleanup:
@@ -1063,42 +5849,67 @@ cleanup:
   }
 #endif
   if (device != VK_NULL_HANDLE) {
-    if (mappedStorageWords && pfnUnmapMemory && storageMemory != VK_NULL_HANDLE) {
-      pfnUnmapMemory(device, storageMemory);
+    if (mappedStorageWords && dev.pfnUnmapMemory && storageMemory != VK_NULL_HANDLE) {
+      dev.pfnUnmapMemory(device, storageMemory);
       mappedStorageWords = 0;
     }
-    if (submitFence != VK_NULL_HANDLE && pfnDestroyFence) {
-      pfnDestroyFence(device, submitFence, 0);
+    if (mappedIndirectCommand && dev.pfnUnmapMemory && indirectMemory != VK_NULL_HANDLE) {
+      dev.pfnUnmapMemory(device, indirectMemory);
+      mappedIndirectCommand = 0;
+    }
+    if (indirectBuffer != VK_NULL_HANDLE && dev.pfnDestroyBuffer) {
+      dev.pfnDestroyBuffer(device, indirectBuffer, 0);
+    }
+    if (indirectMemory != VK_NULL_HANDLE && dev.pfnFreeMemory) {
+      dev.pfnFreeMemory(device, indirectMemory, 0);
+    }
+    for (uint32_t i = 0u; i < 2u; ++i) {
+      if (filterImageViews[i] != VK_NULL_HANDLE && dev.pfnDestroyImageView) {
+        dev.pfnDestroyImageView(device, filterImageViews[i], 0);
+      }
+      if (mappedFilterImages[i] && dev.pfnUnmapMemory) {
+        dev.pfnUnmapMemory(device, filterImageMemories[i]);
+      }
+      if (filterImages[i] != VK_NULL_HANDLE && dev.pfnDestroyImage) {
+        dev.pfnDestroyImage(device, filterImages[i], 0);
+      }
+      if (filterImageMemories[i] != VK_NULL_HANDLE && dev.pfnFreeMemory) {
+        dev.pfnFreeMemory(device, filterImageMemories[i], 0);
+      }
+    }
+    if (submitFence != VK_NULL_HANDLE && dev.pfnDestroyFence) {
+      dev.pfnDestroyFence(device, submitFence, 0);
     }
-    if (commandPool != VK_NULL_HANDLE && pfnDestroyCommandPool) {
-      pfnDestroyCommandPool(device, commandPool, 0);
+    if (commandPool != VK_NULL_HANDLE && dev.pfnDestroyCommandPool) {
+      dev.pfnDestroyCommandPool(device, commandPool, 0);
     }
-    if (descriptorPool != VK_NULL_HANDLE && pfnDestroyDescriptorPool) {
-      pfnDestroyDescriptorPool(device, descriptorPool, 0);
+    if (descriptorPool != VK_NULL_HANDLE && dev.pfnDestroyDescriptorPool) {
+      dev.pfnDestroyDescriptorPool(device, descriptorPool, 0);
     }
-    if (computePipeline != VK_NULL_HANDLE && pfnDestroyPipeline) {
-      pfnDestroyPipeline(device, computePipeline, 0);
+    if (computePipeline != VK_NULL_HANDLE && dev.pfnDestroyPipeline) {
+      dev.pfnDestroyPipeline(device, computePipeline, 0);
     }
-    if (pipelineLayout != VK_NULL_HANDLE && pfnDestroyPipelineLayout) {
-      pfnDestroyPipelineLayout(device, pipelineLayout, 0);
+    if (pipelineLayout != VK_NULL_HANDLE && dev.pfnDestroyPipelineLayout) {
+      dev.pfnDestroyPipelineLayout(device, pipelineLayout, 0);
     }
-    if (descriptorSetLayout != VK_NULL_HANDLE && pfnDestroyDescriptorSetLayout) {
-      pfnDestroyDescriptorSetLayout(device, descriptorSetLayout, 0);
+    if (descriptorSetLayout != VK_NULL_HANDLE && dev.pfnDestroyDescriptorSetLayout) {
+      dev.pfnDestroyDescriptorSetLayout(device, descriptorSetLayout, 0);
     }
-    if (shaderModule != VK_NULL_HANDLE && pfnDestroyShaderModule) {
-      pfnDestroyShaderModule(device, shaderModule, 0);
+    if (shaderModule != VK_NULL_HANDLE && dev.pfnDestroyShaderModule) {
+      dev.pfnDestroyShaderModule(device, shaderModule, 0);
     }
-    if (storageBuffer != VK_NULL_HANDLE && pfnDestroyBuffer) {
-      pfnDestroyBuffer(device, storageBuffer, 0);
+    if (storageBuffer != VK_NULL_HANDLE && dev.pfnDestroyBuffer) {
+      dev.pfnDestroyBuffer(device, storageBuffer, 0);
     }
-    if (storageMemory != VK_NULL_HANDLE && pfnFreeMemory) {
-      pfnFreeMemory(device, storageMemory, 0);
+    if (storageMemory != VK_NULL_HANDLE && dev.pfnFreeMemory) {
+      dev.pfnFreeMemory(device, storageMemory, 0);
     }
-    if (pfnDestroyDevice) {
-      pfnDestroyDevice(device, 0);
+    if (dev.pfnDestroyDevice) {
+      dev.pfnDestroyDevice(device, 0);
     } else if (vkDestroyDevice) {
       vkDestroyDevice(device, 0);
     }
+    webvulkan_release_tracked_device_memory();
   }
 
   if (instance != VK_NULL_HANDLE) {
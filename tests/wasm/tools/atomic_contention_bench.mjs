@@ -0,0 +1,351 @@
+import { spawn } from "node:child_process";
+import { performance } from "node:perf_hooks";
+import { Worker, isMainThread, workerData, parentPort } from "node:worker_threads";
+
+const controlGeneration = 0;
+const controlDoneCount = 1;
+const controlKernelIndex = 2;
+const controlInvocations = 3;
+const controlParam = 4;
+const controlThreadCount = 5;
+const controlQuit = 6;
+const controlWordCount = 8;
+
+const counterBaseAddress = 1 << 20;
+const wasmPageBytes = 65536;
+const wasmMaxPages = 1024;
+const workgroupSize = 64;
+const histogramBinCount = 16;
+
+const kernels = [
+  { name: "atomic_single_counter", exportName: "atomic_single_counter", param: 0 },
+  { name: "atomic_single_counter_cas", exportName: "atomic_single_counter_cas", param: 0 },
+  { name: "atomic_per_workgroup_counters", exportName: "atomic_per_workgroup_counters", param: workgroupSize },
+  { name: "atomic_sharded_histogram", exportName: "atomic_sharded_histogram", param: histogramBinCount }
+];
+
+if (!isMainThread) {
+  const { module, memory, control, index } = workerData;
+  const instance = new WebAssembly.Instance(module, { env: { memory } });
+  const controlWords = new Int32Array(control);
+  const kernelFns = kernels.map((kernel) => instance.exports[kernel.exportName]);
+  parentPort.postMessage("ready");
+
+  let seenGeneration = 0;
+  for (;;) {
+    Atomics.wait(controlWords, controlGeneration, seenGeneration);
+    seenGeneration = Atomics.load(controlWords, controlGeneration);
+    if (Atomics.load(controlWords, controlQuit) !== 0) {
+      break;
+    }
+    const kernelFn = kernelFns[Atomics.load(controlWords, controlKernelIndex)];
+    const invocations = Atomics.load(controlWords, controlInvocations) >>> 0;
+    const param = Atomics.load(controlWords, controlParam) >>> 0;
+    const threadCount = Atomics.load(controlWords, controlThreadCount) >>> 0;
+    const chunk = Math.ceil(invocations / threadCount);
+    const first = Math.min(index * chunk, invocations);
+    const count = Math.min(chunk, invocations - first);
+    if (count > 0) {
+      kernelFn(counterBaseAddress, first, count, param);
+    }
+    Atomics.add(controlWords, controlDoneCount, 1);
+    Atomics.notify(controlWords, controlDoneCount);
+  }
+} else {
+  await runMain();
+}
+
+function runProcess(command, args, options = {}) {
+  return new Promise((resolve, reject) => {
+    const child = spawn(command, args, { stdio: ["pipe", "pipe", "pipe"] });
+    const stdoutChunks = [];
+    const stderrChunks = [];
+
+    child.stdout.on("data", (chunk) => stdoutChunks.push(Buffer.from(chunk)));
+    child.stderr.on("data", (chunk) => stderrChunks.push(Buffer.from(chunk)));
+    child.on("error", reject);
+    child.on("close", (code) => {
+      resolve({
+        code: code ?? -1,
+        stdout: Buffer.concat(stdoutChunks),
+        stderr: Buffer.concat(stderrChunks).toString("utf8")
+      });
+    });
+
+    if (options.stdin !== undefined) {
+      child.stdin.end(options.stdin);
+    } else {
+      child.stdin.end();
+    }
+  });
+}
+
+function firstLine(value) {
+  const text = (value || "").trim();
+  if (!text) {
+    return "";
+  }
+  return text.split("\n", 1)[0];
+}
+
+function parsePositiveInteger(value, label) {
+  const parsed = Number.parseInt(value, 10);
+  if (!Number.isInteger(parsed) || parsed <= 0) {
+    throw new Error(`${label} must be a positive integer, got '${value}'`);
+  }
+  return parsed;
+}
+
+function parseNonNegativeInteger(value, label) {
+  const parsed = Number.parseInt(value, 10);
+  if (!Number.isInteger(parsed) || parsed < 0) {
+    throw new Error(`${label} must be a non-negative integer, got '${value}'`);
+  }
+  return parsed;
+}
+
+const atomicKernelSource = `
+typedef unsigned int u32;
+
+static u32* word_ptr(u32 address) {
+  return (u32*)(unsigned long)address;
+}
+
+void atomic_single_counter(u32 base, u32 first, u32 count, u32 param) {
+  (void)first;
+  (void)param;
+  for (u32 i = 0u; i < count; ++i) {
+    __atomic_fetch_add(word_ptr(base), 1u, __ATOMIC_SEQ_CST);
+  }
+}
+
+void atomic_single_counter_cas(u32 base, u32 first, u32 count, u32 param) {
+  (void)first;
+  (void)param;
+  u32* counter = word_ptr(base);
+  for (u32 i = 0u; i < count; ++i) {
+    u32 observed = __atomic_load_n(counter, __ATOMIC_RELAXED);
+    for (;;) {
+      u32 previous = __sync_val_compare_and_swap(counter, observed, observed + 1u);
+      if (previous == observed) {
+        break;
+      }
+      observed = previous;
+    }
+  }
+}
+
+void atomic_per_workgroup_counters(u32 base, u32 first, u32 count, u32 workgroupSize) {
+  for (u32 i = 0u; i < count; ++i) {
+    u32 group = (first + i) / workgroupSize;
+    __atomic_fetch_add(word_ptr(base + (group * 4u)), 1u, __ATOMIC_SEQ_CST);
+  }
+}
+
+void atomic_sharded_histogram(u32 base, u32 first, u32 count, u32 binCount) {
+  for (u32 i = 0u; i < count; ++i) {
+    u32 bin = (first + i) % binCount;
+    __atomic_fetch_add(word_ptr(base + (bin * 4u)), 1u, __ATOMIC_SEQ_CST);
+  }
+}
+`;
+
+async function compileAtomicKernels() {
+  const wasmerBin = process.env.WEBVULKAN_WASMER_BIN;
+  if (!wasmerBin) {
+    throw new Error("WEBVULKAN_WASMER_BIN is required for atomic contention benchmark");
+  }
+  const clangPackage = process.env.WEBVULKAN_CLANG_WASM_PACKAGE || "clang/clang";
+  const args = [
+    "run",
+    "--quiet",
+    clangPackage,
+    "--",
+    "--target=wasm32-unknown-unknown",
+    "-O2",
+    "-matomics",
+    "-mbulk-memory",
+    "-x",
+    "c",
+    "-",
+    "-nostdlib",
+    "-Wl,--no-entry",
+    "-Wl,--import-memory",
+    "-Wl,--shared-memory",
+    `-Wl,--max-memory=${wasmMaxPages * wasmPageBytes}`
+  ];
+  for (const kernel of kernels) {
+    args.push(`-Wl,--export=${kernel.exportName}`);
+  }
+  args.push("-o", "-");
+
+  const compileResult = await runProcess(wasmerBin, args, { stdin: atomicKernelSource });
+  if (compileResult.code !== 0) {
+    const reason = firstLine(compileResult.stderr) || `exit_code=${compileResult.code}`;
+    throw new Error(`failed to compile atomic kernels C -> Wasm: ${reason}`);
+  }
+  if (!WebAssembly.validate(compileResult.stdout)) {
+    throw new Error("atomic kernels C -> Wasm output failed WebAssembly.validate");
+  }
+  return {
+    provider: `${clangPackage} c-runtime+atomics+shared-memory`,
+    bytes: compileResult.stdout
+  };
+}
+
+function counterWordCount(kernel, invocations) {
+  if (kernel.name === "atomic_per_workgroup_counters") {
+    return Math.ceil(invocations / kernel.param);
+  }
+  if (kernel.name === "atomic_sharded_histogram") {
+    return kernel.param;
+  }
+  return 1;
+}
+
+function validateCounters(kernel, invocations, counters) {
+  const wordCount = counters.length;
+  for (let i = 0; i < wordCount; ++i) {
+    let expected = invocations;
+    if (kernel.name === "atomic_per_workgroup_counters") {
+      expected = Math.min(kernel.param, invocations - (i * kernel.param));
+    } else if (kernel.name === "atomic_sharded_histogram") {
+      expected = Math.floor(invocations / kernel.param) + (i < (invocations % kernel.param) ? 1 : 0);
+    }
+    if (counters[i] !== expected) {
+      throw new Error(
+        `atomic contention mismatch kernel=${kernel.name} word=${i} expected=${expected} observed=${counters[i]}`
+      );
+    }
+  }
+}
+
+function summarizeContentionTimings(kernel, threadCount, invocations, samples) {
+  let minMs = samples[0];
+  let maxMs = samples[0];
+  let sumMs = 0.0;
+  for (const sample of samples) {
+    minMs = Math.min(minMs, sample);
+    maxMs = Math.max(maxMs, sample);
+    sumMs += sample;
+  }
+  const avgMs = sumMs / samples.length;
+  console.log("atomic contention summary");
+  console.log(`  kernel=${kernel.name}`);
+  console.log(`  threads=${threadCount}`);
+  console.log(`  invocations=${invocations}`);
+  console.log(`  counter_words=${counterWordCount(kernel, invocations)}`);
+  console.log(`  samples=${samples.length}`);
+  console.log(`  min_ms=${minMs.toFixed(6)}`);
+  console.log(`  avg_ms=${avgMs.toFixed(6)}`);
+  console.log(`  max_ms=${maxMs.toFixed(6)}`);
+  console.log(`  avg_ns_per_invocation=${((avgMs * 1_000_000.0) / invocations).toFixed(3)}`);
+  console.log(`  avg_minvocations_per_s=${(invocations / (avgMs * 1000.0)).toFixed(3)}`);
+}
+
+async function startWorkers(module, memory, control, threadCount) {
+  const workers = [];
+  const ready = [];
+  for (let index = 0; index < threadCount; ++index) {
+    const worker = new Worker(new URL(import.meta.url), { workerData: { module, memory, control, index } });
+    ready.push(new Promise((resolve, reject) => {
+      worker.once("message", resolve);
+      worker.once("error", reject);
+    }));
+    workers.push(worker);
+  }
+  await Promise.all(ready);
+  return workers;
+}
+
+async function stopWorkers(workers, controlWords) {
+  const exited = workers.map((worker) => new Promise((resolve) => worker.once("exit", resolve)));
+  Atomics.store(controlWords, controlQuit, 1);
+  Atomics.add(controlWords, controlGeneration, 1);
+  Atomics.notify(controlWords, controlGeneration);
+  await Promise.all(exited);
+  Atomics.store(controlWords, controlQuit, 0);
+}
+
+function runKernelOnce(controlWords, kernelIndex, kernel, invocations, threadCount) {
+  Atomics.store(controlWords, controlDoneCount, 0);
+  Atomics.store(controlWords, controlKernelIndex, kernelIndex);
+  Atomics.store(controlWords, controlInvocations, invocations);
+  Atomics.store(controlWords, controlParam, kernel.param);
+  Atomics.store(controlWords, controlThreadCount, threadCount);
+  const startMs = performance.now();
+  Atomics.add(controlWords, controlGeneration, 1);
+  Atomics.notify(controlWords, controlGeneration);
+  for (;;) {
+    const done = Atomics.load(controlWords, controlDoneCount);
+    if (done >= threadCount) {
+      break;
+    }
+    Atomics.wait(controlWords, controlDoneCount, done);
+  }
+  return performance.now() - startMs;
+}
+
+async function runMain() {
+  const threadCounts = (process.env.WEBVULKAN_ATOMIC_BENCH_THREADS || "1,2,4,8")
+    .split(",")
+    .map((value) => value.trim())
+    .filter((value) => value.length > 0)
+    .map((value) => parsePositiveInteger(value, "WEBVULKAN_ATOMIC_BENCH_THREADS"));
+  const invocations = parsePositiveInteger(
+    process.env.WEBVULKAN_ATOMIC_BENCH_INVOCATIONS || "1048576",
+    "WEBVULKAN_ATOMIC_BENCH_INVOCATIONS"
+  );
+  const benchIterations = parsePositiveInteger(
+    process.env.WEBVULKAN_RUNTIME_BENCH_ITERATIONS || "5",
+    "WEBVULKAN_RUNTIME_BENCH_ITERATIONS"
+  );
+  const warmupIterations = parseNonNegativeInteger(
+    process.env.WEBVULKAN_RUNTIME_WARMUP_ITERATIONS || "1",
+    "WEBVULKAN_RUNTIME_WARMUP_ITERATIONS"
+  );
+
+  const compiled = await compileAtomicKernels();
+  const module = await WebAssembly.compile(compiled.bytes);
+  const maxCounterWords = Math.max(...kernels.map((kernel) => counterWordCount(kernel, invocations)));
+  const requiredPages = Math.ceil((counterBaseAddress + (maxCounterWords * 4)) / wasmPageBytes);
+  if (requiredPages > wasmMaxPages) {
+    throw new Error(`WEBVULKAN_ATOMIC_BENCH_INVOCATIONS=${invocations} needs ${requiredPages} pages, max is ${wasmMaxPages}`);
+  }
+  const memory = new WebAssembly.Memory({ initial: Math.max(32, requiredPages), maximum: wasmMaxPages, shared: true });
+  const control = new SharedArrayBuffer(controlWordCount * 4);
+  const controlWords = new Int32Array(control);
+
+  console.log("atomic contention bench");
+  console.log(`  provider=${compiled.provider}`);
+  console.log(`  wasm.bytes=${compiled.bytes.length}`);
+  console.log(`  threads=${threadCounts.join(",")}`);
+  console.log(`  invocations=${invocations}`);
+  console.log(`  workgroup_size=${workgroupSize}`);
+  console.log(`  histogram_bins=${histogramBinCount}`);
+
+  for (const threadCount of threadCounts) {
+    const workers = await startWorkers(module, memory, control, threadCount);
+    try {
+      for (let kernelIndex = 0; kernelIndex < kernels.length; ++kernelIndex) {
+        const kernel = kernels[kernelIndex];
+        const wordCount = counterWordCount(kernel, invocations);
+        const counters = new Uint32Array(memory.buffer, counterBaseAddress, wordCount);
+        const samplesMs = [];
+        for (let i = 0; i < warmupIterations + benchIterations; ++i) {
+          counters.fill(0);
+          const elapsedMs = runKernelOnce(controlWords, kernelIndex, kernel, invocations, threadCount);
+          validateCounters(kernel, invocations, counters);
+          if (i >= warmupIterations) {
+            samplesMs.push(elapsedMs);
+          }
+        }
+        summarizeContentionTimings(kernel, threadCount, invocations, samplesMs);
+      }
+    } finally {
+      await stopWorkers(workers, controlWords);
+    }
+  }
+
+  console.log("atomic contention bench passed");
+}
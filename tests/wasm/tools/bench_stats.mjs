@@ -0,0 +1,125 @@
+/*
+ * Timing statistics shared by smoke_runtime.mjs (per-run reports) and
+ * validate_dispatch_bench.mjs (cross-mode gate). Bootstrap resampling uses a
+ * fixed seed so the same samples always give the same interval.
+ */
+
+export const benchConfidenceLevel = 0.95;
+export const benchBootstrapResamples = 2000;
+const benchBootstrapSeed = 0x5eed1234;
+const tukeyFenceScale = 1.5;
+const minSamplesForOutlierRejection = 4;
+
+function createSeededRandom(seed) {
+  let state = seed >>> 0;
+  return () => {
+    state = (state + 0x6d2b79f5) >>> 0;
+    let t = state;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+function mean(values) {
+  return values.reduce((sum, value) => sum + value, 0.0) / values.length;
+}
+
+/* Linear interpolation between closest ranks; `sortedValues` must be ascending. */
+export function percentile(sortedValues, fraction) {
+  if (!sortedValues.length) {
+    throw new Error("Cannot take a percentile of an empty value list");
+  }
+  const position = (sortedValues.length - 1) * fraction;
+  const lower = Math.floor(position);
+  const upper = Math.ceil(position);
+  return sortedValues[lower] + (sortedValues[upper] - sortedValues[lower]) * (position - lower);
+}
+
+/* Tukey fences at 1.5 IQR. Fewer than four samples are kept as-is. */
+export function rejectOutliers(values) {
+  if (values.length < minSamplesForOutlierRejection) {
+    return { kept: values.slice(), rejected: [] };
+  }
+  const sorted = values.slice().sort((a, b) => a - b);
+  const q1 = percentile(sorted, 0.25);
+  const q3 = percentile(sorted, 0.75);
+  const fence = (q3 - q1) * tukeyFenceScale;
+  const kept = [];
+  const rejected = [];
+  for (const value of values) {
+    if (value < q1 - fence || value > q3 + fence) {
+      rejected.push(value);
+    } else {
+      kept.push(value);
+    }
+  }
+  return { kept, rejected };
+}
+
+function resample(values, random) {
+  const drawn = new Array(values.length);
+  for (let i = 0; i < values.length; ++i) {
+    drawn[i] = values[Math.floor(random() * values.length)];
+  }
+  return drawn;
+}
+
+function intervalFromEstimates(estimates) {
+  estimates.sort((a, b) => a - b);
+  const tail = (1.0 - benchConfidenceLevel) / 2.0;
+  return { low: percentile(estimates, tail), high: percentile(estimates, 1.0 - tail) };
+}
+
+/* Percentile bootstrap interval of the mean. */
+export function bootstrapMeanInterval(values) {
+  const random = createSeededRandom(benchBootstrapSeed);
+  const estimates = new Array(benchBootstrapResamples);
+  for (let i = 0; i < benchBootstrapResamples; ++i) {
+    estimates[i] = mean(resample(values, random));
+  }
+  return intervalFromEstimates(estimates);
+}
+
+/* Percentile bootstrap interval of mean(numerator) / mean(denominator), resampling both sides. */
+export function bootstrapRatioInterval(numeratorValues, denominatorValues) {
+  const random = createSeededRandom(benchBootstrapSeed);
+  const estimates = new Array(benchBootstrapResamples);
+  for (let i = 0; i < benchBootstrapResamples; ++i) {
+    estimates[i] = mean(resample(numeratorValues, random)) / mean(resample(denominatorValues, random));
+  }
+  return intervalFromEstimates(estimates);
+}
+
+/*
+ * Percentiles describe every sample, tails included. Mean, stddev and the
+ * confidence interval use only the samples left after outlier rejection.
+ */
+export function computeTimingStats(samples) {
+  if (!samples.length) {
+    throw new Error("Cannot summarize an empty sample list");
+  }
+  const sorted = samples.slice().sort((a, b) => a - b);
+  const { kept, rejected } = rejectOutliers(samples);
+  const keptMean = mean(kept);
+  const variance = kept.length > 1 ?
+    kept.reduce((sum, value) => sum + (value - keptMean) * (value - keptMean), 0.0) / (kept.length - 1) :
+    0.0;
+  const interval = bootstrapMeanInterval(kept);
+  return {
+    count: samples.length,
+    kept: kept.length,
+    outliers: rejected.length,
+    minMs: sorted[0],
+    maxMs: sorted[sorted.length - 1],
+    meanMs: mean(samples),
+    medianMs: percentile(sorted, 0.5),
+    p90Ms: percentile(sorted, 0.9),
+    p99Ms: percentile(sorted, 0.99),
+    trimmedMeanMs: keptMean,
+    stddevMs: Math.sqrt(variance),
+    ciLowMs: interval.low,
+    ciHighMs: interval.high,
+    keptSamples: kept
+  };
+}
@@ -0,0 +1,122 @@
+import { spawn } from "node:child_process";
+import { mkdtemp, readFile, rm, writeFile } from "node:fs/promises";
+import { tmpdir } from "node:os";
+import { join } from "node:path";
+
+const dxcWasmJs = process.env.WEBVULKAN_DXC_WASM_JS;
+if (!dxcWasmJs) {
+  throw new Error("WEBVULKAN_DXC_WASM_JS is not set");
+}
+
+// Keep in sync with runtimeSpirvTargetEnv in smoke_runtime.mjs.
+const spirvTargetEnv = "vulkan1.1";
+
+function runProcess(command, args, options = {}) {
+  return new Promise((resolve, reject) => {
+    const child = spawn(command, args, { cwd: options.cwd, stdio: ["ignore", "pipe", "pipe"] });
+    const stdoutChunks = [];
+    const stderrChunks = [];
+
+    child.stdout.on("data", (chunk) => stdoutChunks.push(Buffer.from(chunk)));
+    child.stderr.on("data", (chunk) => stderrChunks.push(Buffer.from(chunk)));
+    child.on("error", reject);
+    child.on("close", (code) => {
+      resolve({
+        code: code ?? -1,
+        stdout: Buffer.concat(stdoutChunks).toString("utf8"),
+        stderr: Buffer.concat(stderrChunks).toString("utf8")
+      });
+    });
+  });
+}
+
+// Every wave intrinsic the subgroup_reduction workload uses, plus prefix and vote ops.
+const waveOpsSource = `
+RWStructuredBuffer<uint> OutBuf : register(u0);
+
+[numthreads(64, 1, 1)]
+void wave_ops(uint3 groupThreadId : SV_GroupThreadID) {
+  uint lane = groupThreadId.x;
+  uint waveSum = WaveActiveSum(lane + 1u);
+  uint wavePrefix = WavePrefixSum(lane + 1u);
+  uint waveFirstLane = WaveReadLaneFirst(lane);
+  uint4 evenBallot = WaveActiveBallot((lane & 1u) == 0u);
+  bool anyOdd = WaveActiveAnyTrue((lane & 1u) != 0u);
+  OutBuf[lane] = wavePrefix;
+  if (WaveIsFirstLane()) {
+    OutBuf[64] = waveSum + waveFirstLane + countbits(evenBallot.x) + (anyOdd ? 1u : 0u);
+  }
+}
+`;
+
+const spirvOpCapability = 17;
+const expectedCapabilities = new Map([
+  [61, "GroupNonUniform"],
+  [62, "GroupNonUniformVote"],
+  [63, "GroupNonUniformArithmetic"],
+  [64, "GroupNonUniformBallot"]
+]);
+
+const scratchDir = await mkdtemp(join(tmpdir(), "webvulkan-dxc-wave-"));
+let bytes;
+try {
+  await writeFile(join(scratchDir, "wave_ops.hlsl"), waveOpsSource, "utf8");
+  const result = await runProcess(
+    process.execPath,
+    [
+      dxcWasmJs,
+      "-spirv",
+      `-fspv-target-env=${spirvTargetEnv}`,
+      "-T",
+      "cs_6_0",
+      "-E",
+      "wave_ops",
+      "-Fo",
+      "wave_ops.spv",
+      "wave_ops.hlsl"
+    ],
+    { cwd: scratchDir }
+  );
+  if (result.code !== 0) {
+    const stderr = result.stderr.trim();
+    throw new Error(`dxc-wasm failed to compile wave ops with code=${result.code}${stderr ? `\n${stderr}` : ""}`);
+  }
+  bytes = await readFile(join(scratchDir, "wave_ops.spv"));
+} finally {
+  await rm(scratchDir, { recursive: true, force: true });
+}
+
+if (bytes.length < 20 || bytes.length % 4 !== 0 || bytes.readUInt32LE(0) !== 0x07230203) {
+  throw new Error(`dxc-wasm did not produce valid SPIR-V (bytes=${bytes.length})`);
+}
+const version = bytes.readUInt32LE(4);
+const versionMajor = (version >>> 16) & 0xff;
+const versionMinor = (version >>> 8) & 0xff;
+if (versionMajor < 1 || (versionMajor === 1 && versionMinor < 3)) {
+  throw new Error(`wave ops need SPIR-V 1.3 or newer, got ${versionMajor}.${versionMinor}`);
+}
+
+const capabilities = new Set();
+for (let offset = 20; offset < bytes.length;) {
+  const word = bytes.readUInt32LE(offset);
+  const wordCount = word >>> 16;
+  if (wordCount === 0) {
+    throw new Error(`malformed SPIR-V instruction at byte ${offset}`);
+  }
+  if ((word & 0xffff) === spirvOpCapability) {
+    capabilities.add(bytes.readUInt32LE(offset + 4));
+  }
+  offset += wordCount * 4;
+}
+for (const [capability, name] of expectedCapabilities) {
+  if (!capabilities.has(capability)) {
+    throw new Error(`wave ops SPIR-V is missing OpCapability ${name}`);
+  }
+}
+
+console.log("dxc wave ops smoke ok");
+console.log(`  spirv.target_env=${spirvTargetEnv}`);
+console.log(`  spirv.version=${versionMajor}.${versionMinor}`);
+console.log(`  spirv.bytes=${bytes.length}`);
+console.log(`  spirv.capabilities=${[...expectedCapabilities.values()].join(",")}`);
+console.log("runtime smoke passed");
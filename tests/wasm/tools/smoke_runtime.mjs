@@ -1,9 +1,11 @@
 import { spawn } from "node:child_process";
-import { mkdtemp, readFile, rm, writeFile } from "node:fs/promises";
+import { mkdir, mkdtemp, readFile, rm, writeFile } from "node:fs/promises";
 import { tmpdir } from "node:os";
 import { join } from "node:path";
 import { pathToFileURL } from "node:url";
 
+import { benchBootstrapResamples, benchConfidenceLevel, computeTimingStats } from "./bench_stats.mjs";
+
 function runProcess(command, args, options = {}) {
   return new Promise((resolve, reject) => {
     const child = spawn(command, args, {
@@ -44,6 +46,50 @@ const runtimeDefaultKeyLo = 0x12345678 >>> 0;
 const runtimeDefaultKeyHi = 0 >>> 0;
 const runtimeShaderBundleHasWasmFlag = 0x1 >>> 0;
 const runtimeShaderBundleHasExpectedValueFlag = 0x2 >>> 0;
+const runtimeHistogramBinCount = 16;
+const runtimeMaxSubgroupSize = 128;
+// Subgroup size the standalone wave-op check compiles the kernel with, off the default.
+const runtimeSubgroupCheckSize = 8;
+const runtimeSpecTileSize = 16;
+const runtimeSpecTileRepeats = 4;
+const runtimeSharedWasmModuleId = 1;
+const runtimeRenderShaderKeyBase = 0x72656e00 >>> 0;
+const runtimeRenderKeyHi = 0 >>> 0;
+const runtimeVertexKeyLo = 0x76657274 >>> 0;
+const runtimeVertexKeyHi = 0 >>> 0;
+const runtimeSharedKernelProbeKeyBase = 0x73686b00 >>> 0;
+const runtimeSharedKernelProbeKeyHi = 0 >>> 0;
+const runtimeBandwidthShaderKeyBase = 0x62770000 >>> 0;
+const runtimeBandwidthKeyHi = 0 >>> 0;
+const runtimeBandwidthMinBytes = 64 * 1024;
+const runtimeBandwidthMaxBytes = 256 * 1024 * 1024;
+const runtimePrimitiveShaderKeyBase = 0x70720000 >>> 0;
+const runtimePrimitiveKeyHi = 0 >>> 0;
+const runtimePrimitiveMinElements = 4096;
+const runtimePrimitiveMaxElements = 4 * 1024 * 1024;
+const runtimeSweepShaderKeyBase = 0x73770000 >>> 0;
+const runtimeSweepKeyHi = 0 >>> 0;
+const runtimeSweepMaxWorkgroupSize = 1024;
+const runtimeSweepWorkgroupsPerDispatch = [1, 64, 4096];
+const runtimeSweepDispatchesPerSubmit = [1, 16, 256];
+const runtimeLaunchMaxInvocationsPerSubmit = 1 << 22;
+const runtimeTraceMaxEvents = 65536;
+const runtimeMemoryGrowthMaxCycles = 1024;
+const runtimeMemoryFields = [
+  "linear_bytes",
+  "malloc_in_use_bytes",
+  "malloc_footprint_bytes",
+  "peak_malloc_footprint_bytes",
+  "registry_payload_bytes",
+  "device_memory_bytes",
+  "peak_device_memory_bytes",
+  "device_memory_allocations",
+  "pipeline_heap_delta_bytes",
+  "last_pipeline_heap_delta_bytes",
+  "live_pipelines"
+];
+const runtimeWasmModuleCache = new Map();
+let runtimeWasmCompileCount = 0;
 
 function runtimeShaderThreadgroupSizeX(workloadName) {
   return workloadName === "write_const" ? 1 : 64;
@@ -60,6 +106,37 @@ function runtimeBenchProfileDescriptor(profileName) {
     case "large_grid":
     case "hot_loop_single_dispatch":
       return { dispatchesPerSubmit: 1, submitIterations: 64, dispatchX: 256, dispatchY: 1, dispatchZ: 1 };
+    case "large_buffer":
+      return { dispatchesPerSubmit: 1, submitIterations: 16, dispatchX: 16384, dispatchY: 1, dispatchZ: 1 };
+    case "indirect_dispatch":
+      return {
+        dispatchesPerSubmit: 256,
+        submitIterations: 16,
+        dispatchX: 4,
+        dispatchY: 1,
+        dispatchZ: 1,
+        indirect: true
+      };
+    case "push_constant_sweep":
+      return {
+        dispatchesPerSubmit: 256,
+        submitIterations: 16,
+        dispatchX: 4,
+        dispatchY: 1,
+        dispatchZ: 1,
+        paramMode: "push_constant"
+      };
+    case "descriptor_param_sweep":
+      return {
+        dispatchesPerSubmit: 256,
+        submitIterations: 16,
+        dispatchX: 4,
+        dispatchY: 1,
+        dispatchZ: 1,
+        paramMode: "descriptor"
+      };
+    case "image_filter_2d":
+      return { dispatchesPerSubmit: 1, submitIterations: 16, dispatchX: 32, dispatchY: 32, dispatchZ: 1 };
     default:
       throw new Error(`Unsupported runtime bench profile '${profileName}'`);
   }
@@ -73,6 +150,22 @@ function runtimeShaderEntrypoint(workloadName) {
       return "atomic_per_workgroup";
     case "no_race_unique_writes":
       return "no_race_unique_writes";
+    case "atomic_sharded_histogram":
+      return "atomic_sharded_histogram";
+    case "groupshared_reduction":
+      return "groupshared_reduction";
+    case "groupshared_scan":
+      return "groupshared_scan";
+    case "subgroup_reduction":
+      return "subgroup_reduction";
+    case "spec_constant_tiles":
+      return "spec_constant_tiles";
+    case "buffer_copy":
+      return "buffer_copy";
+    case "push_constant_param":
+      return "push_constant_param";
+    case "image_box_filter":
+      return "image_box_filter";
     case "write_const":
       return "write_const";
     default:
@@ -112,6 +205,171 @@ void ${entrypoint}(uint3 groupThreadId : SV_GroupThreadID) {
 `;
   }
 
+  if (workloadName === "atomic_sharded_histogram") {
+    return `
+RWStructuredBuffer<uint> OutBuf : register(u0);
+
+[numthreads(${threadgroupSizeX}, 1, 1)]
+void ${entrypoint}(uint3 tid : SV_DispatchThreadID) {
+  InterlockedAdd(OutBuf[tid.x % ${runtimeHistogramBinCount}u], 1u);
+}
+`;
+  }
+
+  if (workloadName === "groupshared_reduction") {
+    return `
+RWStructuredBuffer<uint> OutBuf : register(u0);
+groupshared uint Scratch[${threadgroupSizeX}];
+
+[numthreads(${threadgroupSizeX}, 1, 1)]
+void ${entrypoint}(uint3 groupThreadId : SV_GroupThreadID) {
+  uint lane = groupThreadId.x;
+  Scratch[lane] = lane + 1u;
+  GroupMemoryBarrierWithGroupSync();
+  [unroll]
+  for (uint stride = ${threadgroupSizeX >> 1}u; stride > 0u; stride >>= 1u) {
+    if (lane < stride) {
+      Scratch[lane] += Scratch[lane + stride];
+    }
+    GroupMemoryBarrierWithGroupSync();
+  }
+  if (lane == 0u) {
+    InterlockedAdd(OutBuf[0], Scratch[0]);
+    OutBuf[1] = Scratch[0];
+  }
+}
+`;
+  }
+
+  if (workloadName === "groupshared_scan") {
+    return `
+RWStructuredBuffer<uint> OutBuf : register(u0);
+groupshared uint Scratch[${threadgroupSizeX}];
+
+[numthreads(${threadgroupSizeX}, 1, 1)]
+void ${entrypoint}(uint3 groupThreadId : SV_GroupThreadID) {
+  uint lane = groupThreadId.x;
+  Scratch[lane] = lane + 1u;
+  GroupMemoryBarrierWithGroupSync();
+  [unroll]
+  for (uint offset = 1u; offset < ${threadgroupSizeX}u; offset <<= 1u) {
+    uint value = Scratch[lane];
+    if (lane >= offset) {
+      value += Scratch[lane - offset];
+    }
+    GroupMemoryBarrierWithGroupSync();
+    Scratch[lane] = value;
+    GroupMemoryBarrierWithGroupSync();
+  }
+  OutBuf[1u + lane] = Scratch[lane];
+  if (lane == ${threadgroupSizeX - 1}u) {
+    InterlockedAdd(OutBuf[0], Scratch[lane]);
+  }
+}
+`;
+  }
+
+  if (workloadName === "spec_constant_tiles") {
+    return `
+RWStructuredBuffer<uint> OutBuf : register(u0);
+[[vk::constant_id(0)]] const uint kTileSize = 1u;
+[[vk::constant_id(1)]] const uint kTileRepeats = 1u;
+
+[numthreads(${threadgroupSizeX}, 1, 1)]
+void ${entrypoint}(uint3 tid : SV_DispatchThreadID) {
+  uint tileWork = 0u;
+  for (uint repeat = 0u; repeat < kTileRepeats; ++repeat) {
+    for (uint i = 0u; i < kTileSize; ++i) {
+      tileWork += 1u;
+    }
+  }
+  InterlockedAdd(OutBuf[0], tileWork);
+}
+`;
+  }
+
+  if (workloadName === "subgroup_reduction") {
+    return `
+RWStructuredBuffer<uint> OutBuf : register(u0);
+
+[numthreads(${threadgroupSizeX}, 1, 1)]
+void ${entrypoint}(uint3 groupThreadId : SV_GroupThreadID) {
+  uint lane = groupThreadId.x;
+  uint waveSum = WaveActiveSum(lane + 1u);
+  uint waveFirstLane = WaveReadLaneFirst(lane);
+  uint4 evenBallot = WaveActiveBallot((lane & 1u) == 0u);
+  if (WaveIsFirstLane()) {
+    InterlockedAdd(OutBuf[0], waveSum);
+    InterlockedAdd(OutBuf[1], 1u);
+    InterlockedAdd(OutBuf[2], countbits(evenBallot.x) + countbits(evenBallot.y) + countbits(evenBallot.z) + countbits(evenBallot.w));
+    InterlockedAdd(OutBuf[3], waveFirstLane);
+  }
+}
+`;
+  }
+
+  if (workloadName === "buffer_copy") {
+    return `
+RWStructuredBuffer<uint> OutBuf : register(u0);
+
+[numthreads(${threadgroupSizeX}, 1, 1)]
+void ${entrypoint}(uint3 tid : SV_DispatchThreadID) {
+  if (tid.x == 0u && tid.y == 0u && tid.z == 0u) {
+    OutBuf[0] = ${dispatchInvocationsPerSubmit}u;
+  }
+  uint idx = tid.x;
+  OutBuf[1u + ${dispatchInvocationsPerSubmit}u + idx] = OutBuf[1u + idx];
+}
+`;
+  }
+
+  if (workloadName === "image_box_filter") {
+    return `
+RWStructuredBuffer<uint> OutBuf : register(u0);
+Texture2D<uint> Src : register(t1);
+[[vk::image_format("r32ui")]] RWTexture2D<uint> Dst : register(u2);
+
+[numthreads(8, 8, 1)]
+void ${entrypoint}(uint3 tid : SV_DispatchThreadID) {
+  uint width;
+  uint height;
+  Src.GetDimensions(width, height);
+  if (tid.x >= width || tid.y >= height) {
+    return;
+  }
+  int2 maxCoord = int2(width - 1u, height - 1u);
+  uint sum = 0u;
+  [unroll]
+  for (int dy = -1; dy <= 1; ++dy) {
+    [unroll]
+    for (int dx = -1; dx <= 1; ++dx) {
+      sum += Src.Load(int3(clamp(int2(tid.xy) + int2(dx, dy), int2(0, 0), maxCoord), 0));
+    }
+  }
+  Dst[tid.xy] = sum;
+  if (tid.x == 0u && tid.y == 0u) {
+    OutBuf[0] = width * height;
+  }
+}
+`;
+  }
+
+  if (workloadName === "push_constant_param") {
+    return `
+RWStructuredBuffer<uint> OutBuf : register(u0);
+
+struct PushParams {
+  uint param;
+};
+[[vk::push_constant]] PushParams Push;
+
+[numthreads(${threadgroupSizeX}, 1, 1)]
+void ${entrypoint}(uint3 tid : SV_DispatchThreadID) {
+  InterlockedAdd(OutBuf[0], Push.param + OutBuf[1]);
+}
+`;
+  }
+
   if (workloadName === "no_race_unique_writes") {
     return `
 RWStructuredBuffer<uint> OutBuf : register(u0);
@@ -157,29 +415,49 @@ void ${entrypoint}(uint3 tid : SV_DispatchThreadID) {
 `;
 }
 
-async function compileRuntimeSpirv(storeValue, workloadName) {
+/*
+ * `launch` is a launch sweep point shaped like a profile descriptor plus
+ * workgroupSizeX; without one the bench profile and the workload's default
+ * workgroup size apply.
+ */
+function runtimeShaderHlslFor(storeValue, workloadName, launch = null) {
   const storeConst = `0x${(storeValue >>> 0).toString(16)}u`;
-  const threadgroupSizeX = runtimeShaderThreadgroupSizeX(workloadName);
-  const shaderEntrypoint = runtimeShaderEntrypoint(workloadName);
-  const profile = runtimeBenchProfileDescriptor(runtimeBenchProfile);
+  const threadgroupSizeX = launch ? launch.workgroupSizeX : runtimeShaderThreadgroupSizeX(workloadName);
+  const grid = launch || runtimeBenchProfileDescriptor(runtimeBenchProfile);
   const dispatchWorkgroupsPerSubmit =
-    profile.dispatchesPerSubmit *
-    profile.dispatchX *
-    profile.dispatchY *
-    profile.dispatchZ;
+    grid.dispatchesPerSubmit *
+    grid.dispatchX *
+    grid.dispatchY *
+    grid.dispatchZ;
   const dispatchInvocationsPerSubmit = dispatchWorkgroupsPerSubmit * threadgroupSizeX;
-  const dxcWasmJs = process.env.WEBVULKAN_DXC_WASM_JS || "";
-  if (!dxcWasmJs) {
-    throw new Error("WEBVULKAN_DXC_WASM_JS is required for runtime smoke");
-  }
-
-  const hlslSource = runtimeShaderHlslSource(
+  return runtimeShaderHlslSource(
     storeConst,
     threadgroupSizeX,
     workloadName,
     dispatchInvocationsPerSubmit,
     dispatchWorkgroupsPerSubmit
   );
+}
+
+async function compileRuntimeSpirv(storeValue, workloadName) {
+  return compileHlslToSpirv(
+    runtimeShaderHlslFor(storeValue, workloadName),
+    "cs_6_0",
+    runtimeShaderEntrypoint(workloadName)
+  );
+}
+
+/*
+ * Wave intrinsics lower to SPIR-V 1.3 GroupNonUniform* capabilities, which dxc
+ * refuses under its default vulkan1.0 target.
+ */
+const runtimeSpirvTargetEnv = "vulkan1.1";
+
+async function compileHlslToSpirv(hlslSource, targetProfile, shaderEntrypoint) {
+  const dxcWasmJs = process.env.WEBVULKAN_DXC_WASM_JS || "";
+  if (!dxcWasmJs) {
+    throw new Error("WEBVULKAN_DXC_WASM_JS is required for runtime smoke");
+  }
 
   const scratchDir = await mkdtemp(join(tmpdir(), "webvulkan-dxc-wasm-"));
   const inputFile = "runtime_smoke.hlsl";
@@ -191,8 +469,9 @@ async function compileRuntimeSpirv(storeValue, workloadName) {
   const compileArgs = [
     dxcWasmJs,
     "-spirv",
+    `-fspv-target-env=${runtimeSpirvTargetEnv}`,
     "-T",
-    "cs_6_0",
+    targetProfile,
     "-E",
     shaderEntrypoint,
     "-Fo",
@@ -221,249 +500,1984 @@ async function compileRuntimeSpirv(storeValue, workloadName) {
   };
 }
 
-async function compileRuntimeLlvmirToWasm() {
-  const wasmerBin = process.env.WEBVULKAN_WASMER_BIN;
-  if (!wasmerBin) {
-    throw new Error("WEBVULKAN_WASMER_BIN is required for runtime Wasm module smoke path");
-  }
+/*
+ * Offscreen render bench shaders. Every scene writes values that are exact in
+ * RGBA8 (blend to within one unit), so readback can be checked per pixel.
+ * Order matches WEBVULKAN_RUNTIME_RENDER_SHADER_* in lavapipe_runtime_smoke.c.
+ */
+const runtimeRenderVertexHlsl = `
+float4 render_vs(uint vertexId : SV_VertexID) : SV_Position {
+  float2 uv = float2((vertexId << 1) & 2, vertexId & 2);
+  return float4(uv * 2.0f - 1.0f, 0.0f, 1.0f);
+}
+`;
 
-  const clangPackage = process.env.WEBVULKAN_CLANG_WASM_PACKAGE || "clang/clang";
-  const runtimeCSource = `
-typedef unsigned int u32;
+const runtimeRenderGridVertexHlsl = `
+struct GridConstants {
+  uint cellsPerSide;
+};
+[[vk::push_constant]] GridConstants grid;
+
+float4 render_grid_vs(uint vertexId : SV_VertexID) : SV_Position {
+  uint cell = vertexId / 6;
+  uint corner = vertexId % 6;
+  float2 uv = float2((0x1A >> corner) & 1, (0x34 >> corner) & 1);
+  float2 cellOrigin = float2(cell % grid.cellsPerSide, cell / grid.cellsPerSide);
+  return float4((cellOrigin + uv) / grid.cellsPerSide * 2.0f - 1.0f, 0.0f, 1.0f);
+}
+`;
 
-static void store_u32(u32 address, u32 value) {
-  *((u32*)(unsigned long)address) = value;
+const runtimeRenderFragmentHlsl = `
+float4 render_ps(float4 position : SV_Position) : SV_Target0 {
+  uint2 pixel = uint2(position.xy);
+  return float4((pixel.x & 255) / 255.0f, (pixel.y & 255) / 255.0f, 1.0f, 1.0f);
 }
+`;
 
-void __wasm_signal(void) {
+const runtimeRenderTextureHlsl = `
+Texture2D<float4> renderTexture : register(t0);
+
+float4 render_texture_ps(float4 position : SV_Position) : SV_Target0 {
+  int2 texel = int2(position.xy) & 63;
+  return renderTexture.Load(int3(texel, 0));
 }
+`;
 
-void run(u32 dst, u32 offset, u32 value, u32 workload, u32 invocations, u32 workgroups) {
-  if (workload == 1u) {
-    store_u32(dst, invocations);
-    return;
+const runtimeRenderBlendHlsl = `
+float4 render_blend_ps(float4 position : SV_Position) : SV_Target0 {
+  return float4(1.0f, 0.0f, 0.0f, 0.5f);
+}
+`;
+
+const runtimeRenderShaders = [
+  { hlsl: runtimeRenderVertexHlsl, profile: "vs_6_0", entrypoint: "render_vs" },
+  { hlsl: runtimeRenderGridVertexHlsl, profile: "vs_6_0", entrypoint: "render_grid_vs" },
+  { hlsl: runtimeRenderFragmentHlsl, profile: "ps_6_0", entrypoint: "render_ps" },
+  { hlsl: runtimeRenderTextureHlsl, profile: "ps_6_0", entrypoint: "render_texture_ps" },
+  { hlsl: runtimeRenderBlendHlsl, profile: "ps_6_0", entrypoint: "render_blend_ps" }
+];
+
+/* Vertex bench shader: transforms each position and stores it for host validation. */
+const runtimeVertexHlsl = `
+RWStructuredBuffer<float4> outPositions : register(u0);
+
+float4 vertex_vs(float4 position : POSITION, uint vertexId : SV_VertexID) : SV_Position {
+  float4 transformed = float4(position.xy * 0.5f + 0.25f, position.zw);
+  outPositions[vertexId] = transformed;
+  return transformed;
+}
+`;
+
+/*
+ * Bandwidth bench kernels. The buffer holds a header { elements, invocation stride,
+ * scale, gather rows } and then x, y and z of `elements` words each; every invocation
+ * grid-strides over the elements. Order matches WEBVULKAN_RUNTIME_BANDWIDTH_KERNEL_*
+ * in lavapipe_runtime_smoke.c, as do the kernel export names.
+ */
+function runtimeBandwidthHlsl(entrypoint, body) {
+  return `
+RWStructuredBuffer<uint> Buf : register(u0);
+
+[numthreads(64, 1, 1)]
+void ${entrypoint}(uint3 tid : SV_DispatchThreadID) {
+  uint elements = Buf[0];
+  uint stride = Buf[1];
+  uint scale = Buf[2];
+  uint rows = Buf[3];
+  uint x = 4u;
+  uint y = 4u + elements;
+  uint z = 4u + elements * 2u;
+  for (uint i = tid.x; i < elements; i += stride) {
+    ${body}
   }
-  if (workload == 2u) {
-    store_u32(dst, workgroups);
-    return;
+}
+`;
+}
+
+const runtimeBandwidthShaders = [
+  {
+    entrypoint: "bandwidth_copy",
+    kernelExport: "kernel_bandwidth_copy",
+    body: "Buf[y + i] = Buf[x + i];"
+  },
+  {
+    entrypoint: "bandwidth_saxpy",
+    kernelExport: "kernel_bandwidth_saxpy",
+    body: "Buf[y + i] = scale * Buf[x + i] + Buf[y + i];"
+  },
+  {
+    entrypoint: "bandwidth_triad",
+    kernelExport: "kernel_bandwidth_triad",
+    body: "Buf[z + i] = Buf[x + i] + scale * Buf[y + i];"
+  },
+  {
+    entrypoint: "bandwidth_gather",
+    kernelExport: "kernel_bandwidth_gather",
+    body: "Buf[y + i] = Buf[x + (i % rows) * 16u + i / rows];"
   }
-  if (workload == 3u) {
-    store_u32(dst, invocations);
-    u32 base = dst + 4u;
-    for (u32 i = 0u; i < invocations; ++i) {
-      store_u32(base + (i * 4u), i + 1u);
+];
+
+/*
+ * Data-parallel primitive stages, one 256-lane workgroup per block of 256 keys.
+ * Header words: { elements, blocks, scan region offset, scan region count, radix
+ * shift, reduce result, invocation stride }; input keys start at word 16, then the
+ * output, 256 histogram bins and the partials. scan_partials runs as a single
+ * workgroup over the header's scan region, so exclusive_scan (one partial per
+ * block) and radix_pass (digit-major block counts) share it. Order matches
+ * WEBVULKAN_RUNTIME_PRIMITIVE_SHADER_* in lavapipe_runtime_smoke.c.
+ */
+const runtimePrimitiveHlslPrelude = `
+RWStructuredBuffer<uint> Buf : register(u0);
+groupshared uint Shared[256];
+groupshared uint Keys[256];
+
+static const uint kInput = 16u;
+
+uint output_offset() {
+  return kInput + Buf[0];
+}
+
+uint bins_offset() {
+  return kInput + Buf[0] * 2u;
+}
+
+// Callers store Shared[lane] and sync first; Shared ends as an inclusive scan.
+void scan_shared(uint lane) {
+  for (uint offset = 1u; offset < 256u; offset <<= 1u) {
+    uint value = Shared[lane];
+    if (lane >= offset) {
+      value += Shared[lane - offset];
     }
-    return;
+    GroupMemoryBarrierWithGroupSync();
+    Shared[lane] = value;
+    GroupMemoryBarrierWithGroupSync();
+  }
+}
+
+// Callers store Shared[lane] and sync first; Shared[0] ends as the group total.
+void reduce_shared(uint lane) {
+  for (uint stride = 128u; stride > 0u; stride >>= 1u) {
+    if (lane < stride) {
+      Shared[lane] += Shared[lane + stride];
+    }
+    GroupMemoryBarrierWithGroupSync();
   }
-  store_u32(dst + offset, value);
 }
 `;
 
-  const compileResult = await runProcess(wasmerBin, [
-    "run",
-    "--quiet",
-    clangPackage,
-    "--",
-    "--target=wasm32-unknown-unknown",
-    "-O2",
-    "-x",
-    "c",
-    "-",
-    "-nostdlib",
-    "-Wl,--no-entry",
-    "-Wl,--export=__wasm_signal",
-    "-Wl,--export=run",
-    "-o",
-    "-"
-  ], { stdin: runtimeCSource });
+function runtimePrimitiveHlsl(entrypoint, body) {
+  return `${runtimePrimitiveHlslPrelude}
+[numthreads(256, 1, 1)]
+void ${entrypoint}(uint3 tid : SV_DispatchThreadID, uint3 group : SV_GroupID, uint3 gtid : SV_GroupThreadID) {
+  uint elements = Buf[0];
+  uint blocks = Buf[1];
+  uint partials = Buf[2];
+  uint lane = gtid.x;
+${body}
+}
+`;
+}
 
-  if (compileResult.code !== 0) {
-    const reason = firstLine(compileResult.stderr) || `exit_code=${compileResult.code}`;
-    throw new Error(`failed to compile runtime C -> Wasm: ${reason}`);
+const runtimePrimitiveShaders = [
+  {
+    entrypoint: "primitive_reduce",
+    kernelExport: "kernel_primitive_reduce",
+    body: `
+  uint stride = Buf[6];
+  uint sum = 0u;
+  for (uint i = tid.x; i < elements; i += stride) {
+    sum += Buf[kInput + i];
+  }
+  Shared[lane] = sum;
+  GroupMemoryBarrierWithGroupSync();
+  reduce_shared(lane);
+  if (lane == 0u) {
+    InterlockedAdd(Buf[5], Shared[0]);
+  }`
+  },
+  {
+    entrypoint: "primitive_histogram",
+    kernelExport: "kernel_primitive_histogram",
+    body: `
+  uint stride = Buf[6];
+  Shared[lane] = 0u;
+  GroupMemoryBarrierWithGroupSync();
+  for (uint i = tid.x; i < elements; i += stride) {
+    InterlockedAdd(Shared[Buf[kInput + i] & 255u], 1u);
   }
+  GroupMemoryBarrierWithGroupSync();
+  if (Shared[lane] != 0u) {
+    InterlockedAdd(Buf[bins_offset() + lane], Shared[lane]);
+  }`
+  },
+  {
+    entrypoint: "primitive_block_sum",
+    kernelExport: "kernel_primitive_block_sum",
+    body: `
+  uint i = group.x * 256u + lane;
+  Shared[lane] = i < elements ? Buf[kInput + i] : 0u;
+  GroupMemoryBarrierWithGroupSync();
+  reduce_shared(lane);
+  if (lane == 0u) {
+    Buf[partials + group.x] = Shared[0];
+  }`
+  },
+  {
+    entrypoint: "primitive_scan_partials",
+    kernelExport: "kernel_primitive_scan_partials",
+    body: `
+  uint count = Buf[3];
+  uint carry = 0u;
+  for (uint chunk = 0u; chunk < count; chunk += 256u) {
+    uint i = chunk + lane;
+    uint value = i < count ? Buf[partials + i] : 0u;
+    Shared[lane] = value;
+    GroupMemoryBarrierWithGroupSync();
+    scan_shared(lane);
+    if (i < count) {
+      Buf[partials + i] = carry + Shared[lane] - value;
+    }
+    carry += Shared[255];
+    GroupMemoryBarrierWithGroupSync();
+  }`
+  },
+  {
+    entrypoint: "primitive_block_scan",
+    kernelExport: "kernel_primitive_block_scan",
+    body: `
+  uint i = group.x * 256u + lane;
+  uint value = i < elements ? Buf[kInput + i] : 0u;
+  Shared[lane] = value;
+  GroupMemoryBarrierWithGroupSync();
+  scan_shared(lane);
+  if (i < elements) {
+    Buf[output_offset() + i] = Buf[partials + group.x] + Shared[lane] - value;
+  }`
+  },
+  {
+    entrypoint: "primitive_radix_count",
+    kernelExport: "kernel_primitive_radix_count",
+    body: `
+  uint i = group.x * 256u + lane;
+  Shared[lane] = 0u;
+  GroupMemoryBarrierWithGroupSync();
+  if (i < elements) {
+    InterlockedAdd(Shared[(Buf[kInput + i] >> Buf[4]) & 255u], 1u);
+  }
+  GroupMemoryBarrierWithGroupSync();
+  Buf[partials + lane * blocks + group.x] = Shared[lane];`
+  },
+  {
+    /*
+     * Eight stable 1-bit splits sort the block by digit in groupshared memory; each
+     * key then lands at its digit's global offset plus its rank within the block.
+     * Padding keys sort last, so lanes below `valid` hold exactly the block's keys.
+     */
+    entrypoint: "primitive_radix_scatter",
+    kernelExport: "kernel_primitive_radix_scatter",
+    body: `
+  uint shift = Buf[4];
+  uint valid = min(elements - group.x * 256u, 256u);
+  uint key = lane < valid ? Buf[kInput + group.x * 256u + lane] : 0xffffffffu;
+  for (uint bit = 0u; bit < 8u; ++bit) {
+    uint flag = (key >> (shift + bit)) & 1u;
+    Shared[lane] = flag;
+    GroupMemoryBarrierWithGroupSync();
+    scan_shared(lane);
+    uint onesBefore = Shared[lane] - flag;
+    uint zeros = 256u - Shared[255];
+    Keys[flag != 0u ? zeros + onesBefore : lane - onesBefore] = key;
+    GroupMemoryBarrierWithGroupSync();
+    key = Keys[lane];
+    GroupMemoryBarrierWithGroupSync();
+  }
+  uint digit = (key >> shift) & 255u;
+  if (lane == 0u || digit != ((Keys[lane - 1u] >> shift) & 255u)) {
+    Shared[digit] = lane;
+  }
+  GroupMemoryBarrierWithGroupSync();
+  if (lane < valid) {
+    Buf[output_offset() + Buf[partials + digit * blocks + group.x] + lane - Shared[digit]] = key;
+  }`
+  }
+];
 
-  const wasmMagic = Buffer.from([0x00, 0x61, 0x73, 0x6d]);
-  if (compileResult.stdout.length < 8 || !compileResult.stdout.subarray(0, 4).equals(wasmMagic)) {
-    throw new Error("clang-in-wasm did not produce valid Wasm runtime module");
+// Kernels follow the registry's subgroup size unless a specialization pins its own.
+function runtimeKernelSubgroupSize(specialization) {
+  if (specialization && specialization.subgroupSize !== undefined) {
+    return specialization.subgroupSize;
   }
-  if (!WebAssembly.validate(compileResult.stdout)) {
-    throw new Error("runtime C -> Wasm output failed WebAssembly.validate");
+  return runtime.ccall("webvulkan_get_runtime_subgroup_size", "number", [], []) >>> 0;
+}
+
+function runtimeSpecializationDefines(specialization) {
+  const defines = [`#define WEBVULKAN_SUBGROUP_SIZE ${runtimeKernelSubgroupSize(specialization)}u`];
+  if (!specialization) {
+    return defines.join("\n");
+  }
+  if (specialization.tileSize !== undefined) {
+    defines.push(`#define WEBVULKAN_SPEC_TILE_SIZE ${specialization.tileSize >>> 0}u`);
+    defines.push(`#define WEBVULKAN_SPEC_TILE_REPEATS ${specialization.tileRepeats >>> 0}u`);
   }
+  if (specialization.grid) {
+    const grid = specialization.grid;
+    const workgroups = grid.dispatchesPerSubmit * grid.groupCountX * grid.groupCountY * grid.groupCountZ;
+    defines.push(`#define WEBVULKAN_FIXED_WORKGROUP_SIZE_X ${grid.workgroupSizeX >>> 0}u`);
+    defines.push(`#define WEBVULKAN_FIXED_WORKGROUPS ${workgroups >>> 0}u`);
+    defines.push(`#define WEBVULKAN_FIXED_INVOCATIONS ${(workgroups * grid.workgroupSizeX) >>> 0}u`);
+  }
+  return defines.join("\n");
+}
 
-  return {
-    provider: `${clangPackage} c-runtime`,
-    entrypoint: "run",
-    bytes: compileResult.stdout
-  };
+function runtimeKernelSpecializationFor(workloadName) {
+  let specialization = null;
+  if (workloadName === "spec_constant_tiles") {
+    specialization = { tileSize: runtimeSpecTileSize, tileRepeats: runtimeSpecTileRepeats };
+  }
+  if (runtimeKernelSpecialization === "grid") {
+    const profile = runtimeBenchProfileDescriptor(runtimeBenchProfile);
+    specialization = specialization || {};
+    specialization.grid = {
+      workgroupSizeX: runtimeShaderThreadgroupSizeX(workloadName),
+      groupCountX: profile.dispatchX,
+      groupCountY: profile.dispatchY,
+      groupCountZ: profile.dispatchZ,
+      dispatchesPerSubmit: profile.dispatchesPerSubmit
+    };
+  }
+  return specialization;
 }
 
-const modulePath = process.env.SMOKE_MODULE;
-if (!modulePath) {
-  throw new Error("SMOKE_MODULE is not set");
+function runtimeSpecializationCacheKey(specialization) {
+  const parts = [`subgroup=${runtimeKernelSubgroupSize(specialization)}`];
+  if (!specialization) {
+    return parts.join(",");
+  }
+  if (specialization.tileSize !== undefined) {
+    parts.push(`tile=${specialization.tileSize}x${specialization.tileRepeats}`);
+  }
+  if (specialization.grid) {
+    const grid = specialization.grid;
+    parts.push(
+      `grid=${grid.groupCountX}x${grid.groupCountY}x${grid.groupCountZ}` +
+      `:wg=${grid.workgroupSizeX}:dispatches=${grid.dispatchesPerSubmit}`
+    );
+  }
+  return parts.join(",");
 }
-const exportName = process.env.SMOKE_EXPORT || "_wasm_runtime_smoke";
-const requireRuntimeSpirv = process.env.SMOKE_REQUIRE_RUNTIME_SPIRV === "1";
-const runtimeExecutionMode = process.env.WEBVULKAN_RUNTIME_EXECUTION_MODE || "fast_wasm";
-const runtimeBenchIterations = Number.parseInt(process.env.WEBVULKAN_RUNTIME_BENCH_ITERATIONS || "8", 10);
-const runtimeWarmupIterations = Number.parseInt(process.env.WEBVULKAN_RUNTIME_WARMUP_ITERATIONS || "2", 10);
-const runtimeBenchProfile = process.env.WEBVULKAN_RUNTIME_BENCH_PROFILE || "dispatch_overhead";
-const runtimeBenchProfileMap = new Map([
-  ["dispatch_overhead", 0],
-  ["balanced_grid", 1],
-  ["large_grid", 2],
-  ["micro", 0],
-  ["realistic", 1],
-  ["hot_loop_single_dispatch", 2]
-]);
-const runtimeShaderWorkload = process.env.WEBVULKAN_RUNTIME_SHADER_WORKLOAD || "write_const";
-const runtimeShaderWorkloadMap = new Map([
-  ["write_const", 0],
-  ["atomic_single_counter", 1],
-  ["atomic_per_workgroup", 2],
-  ["no_race_unique_writes", 3]
-]);
-const runtimeBenchProfileValue = runtimeBenchProfileMap.get(runtimeBenchProfile);
-const runtimeShaderWorkloadValue = runtimeShaderWorkloadMap.get(runtimeShaderWorkload);
 
-if (!Number.isInteger(runtimeBenchIterations) || runtimeBenchIterations <= 0) {
-  throw new Error(`WEBVULKAN_RUNTIME_BENCH_ITERATIONS must be a positive integer, got ${runtimeBenchIterations}`);
+async function compileRuntimeLlvmirToWasmCached(specialization = null) {
+  const cacheKey = runtimeSpecializationCacheKey(specialization);
+  const cached = runtimeWasmModuleCache.get(cacheKey);
+  if (cached) {
+    return cached;
+  }
+  const compiled = await compileRuntimeLlvmirToWasm(specialization);
+  compiled.cacheKey = cacheKey;
+  runtimeWasmModuleCache.set(cacheKey, compiled);
+  return compiled;
 }
-if (!Number.isInteger(runtimeWarmupIterations) || runtimeWarmupIterations < 0) {
-  throw new Error(`WEBVULKAN_RUNTIME_WARMUP_ITERATIONS must be a non-negative integer, got ${runtimeWarmupIterations}`);
+
+function runtimeKernelExportName(workloadName) {
+  return `kernel_${workloadName}`;
 }
-if (runtimeBenchProfileValue === undefined) {
-  throw new Error(`Unsupported WEBVULKAN_RUNTIME_BENCH_PROFILE='${runtimeBenchProfile}'`);
+
+/*
+ * One translation unit exports a kernel per workload with the workload id folded in,
+ * so the whole shader set shares one compile and one instantiation.
+ */
+function runtimeKernelExportSource() {
+  return [...runtimeShaderWorkloadMap.entries()]
+    .filter(([workloadName]) => !runtimeLlvmpipeOnlyWorkloads.has(workloadName))
+    .map(([workloadName, workloadValue]) => `
+void ${runtimeKernelExportName(workloadName)}(
+  u32 dst,
+  u32 offset,
+  u32 value,
+  u32 workload,
+  u32 invocations,
+  u32 workgroups
+) {
+  run_dispatch(dst, offset, value, ${workloadValue}u, invocations, workgroups);
+}`).join("\n");
+}
+
+function runtimeWasmHasDataSegments(bytes) {
+  let cursor = 8;
+  const readUleb = () => {
+    let value = 0;
+    let shift = 0;
+    for (;;) {
+      const byte = bytes[cursor++];
+      value += (byte & 0x7f) * 2 ** shift;
+      if ((byte & 0x80) === 0) {
+        return value;
+      }
+      shift += 7;
+    }
+  };
+  while (cursor < bytes.length) {
+    const sectionId = bytes[cursor++];
+    const sectionSize = readUleb();
+    const sectionEnd = cursor + sectionSize;
+    if (sectionId === 11 && readUleb() > 0) {
+      return true;
+    }
+    cursor = sectionEnd;
+  }
+  return false;
+}
+
+async function compileRuntimeLlvmirToWasm(specialization = null) {
+  ++runtimeWasmCompileCount;
+  const wasmerBin = process.env.WEBVULKAN_WASMER_BIN;
+  if (!wasmerBin) {
+    throw new Error("WEBVULKAN_WASMER_BIN is required for runtime Wasm module smoke path");
+  }
+
+  const clangPackage = process.env.WEBVULKAN_CLANG_WASM_PACKAGE || "clang/clang";
+  const runtimeCSource = `
+${runtimeSpecializationDefines(specialization)}
+typedef unsigned int u32;
+
+#ifndef WEBVULKAN_SPEC_TILE_SIZE
+#define WEBVULKAN_SPEC_TILE_SIZE 1u
+#endif
+#ifndef WEBVULKAN_SPEC_TILE_REPEATS
+#define WEBVULKAN_SPEC_TILE_REPEATS 1u
+#endif
+
+static void store_u32(u32 address, u32 value) {
+  *((u32*)(unsigned long)address) = value;
+}
+
+static u32 load_u32(u32 address) {
+  return *((const u32*)(unsigned long)address);
+}
+
+static u32 atomic_add_u32(u32 address, u32 value) {
+  return __atomic_fetch_add((u32*)(unsigned long)address, value, __ATOMIC_SEQ_CST);
+}
+
+/*
+ * The module imports nothing; the driver instantiates it behind its shared-memory shim
+ * and hands it storage addresses. If the shim maps this module's memory onto the
+ * lavapipe heap, a stack frame or data segment would alias that heap, so the build
+ * fails on any function that needs a stack frame. Temporaries live in storage words.
+ */
+#define WEBVULKAN_GROUPSHARED_MAX_WORDS 1024u
+
+/*
+ * Groupshared workloads run one workgroup at a time. The reduction keeps its lanes in
+ * the storage words after its two outputs; the scan works in place on its output.
+ * Each barrier splits the invocation loop, so every lane finishes a phase before
+ * any lane starts the next one. The tree reduction and the scan need a power-of-two
+ * workgroup that fits the scratch words; any other size traps rather than return
+ * a partial sum the harness could mistake for a result.
+ */
+static void run_groupshared_reduction(u32 dst, u32 workgroupSize, u32 workgroups) {
+  u32* groupshared = (u32*)(unsigned long)(dst + 8u);
+  for (u32 group = 0u; group < workgroups; ++group) {
+    for (u32 lane = 0u; lane < workgroupSize; ++lane) {
+      groupshared[lane] = lane + 1u;
+    }
+    for (u32 stride = workgroupSize >> 1u; stride > 0u; stride >>= 1u) {
+      for (u32 lane = 0u; lane < stride; ++lane) {
+        groupshared[lane] += groupshared[lane + stride];
+      }
+    }
+    atomic_add_u32(dst, groupshared[0]);
+    store_u32(dst + 4u, groupshared[0]);
+  }
+}
+
+static void run_groupshared_scan(u32 dst, u32 workgroupSize, u32 workgroups) {
+  u32* groupshared = (u32*)(unsigned long)(dst + 4u);
+  for (u32 group = 0u; group < workgroups; ++group) {
+    for (u32 lane = 0u; lane < workgroupSize; ++lane) {
+      groupshared[lane] = lane + 1u;
+    }
+    for (u32 offset = 1u; offset < workgroupSize; offset <<= 1u) {
+      for (u32 lane = workgroupSize - 1u; lane >= offset; --lane) {
+        groupshared[lane] += groupshared[lane - offset];
+      }
+    }
+    atomic_add_u32(dst, groupshared[workgroupSize - 1u]);
+  }
+}
+
+typedef u32 u32x4 __attribute__((vector_size(16)));
+typedef u32 u32x4_unaligned __attribute__((vector_size(16), aligned(4)));
+
+/*
+ * One subgroup is WEBVULKAN_SUBGROUP_SIZE lanes, taken four at a time as SIMD128
+ * vectors of u32 and one at a time for the lanes a vector cannot fill. Wave ops
+ * reduce across the subgroup, and the per-subgroup results are folded into the
+ * output words once.
+ */
+static void run_subgroup_reduction(u32 dst, u32 workgroupSize, u32 workgroups) {
+  const u32x4 laneOffsets = { 0u, 1u, 2u, 3u };
+  u32 waveSumTotal = 0u;
+  u32 subgroupCount = 0u;
+  u32 ballotTotal = 0u;
+  u32 firstLaneTotal = 0u;
+  for (u32 group = 0u; group < workgroups; ++group) {
+    for (u32 base = 0u; base < workgroupSize; base += WEBVULKAN_SUBGROUP_SIZE) {
+      u32 lane = 0u;
+      for (; lane + 4u <= WEBVULKAN_SUBGROUP_SIZE; lane += 4u) {
+        u32x4 lanes = laneOffsets + (base + lane);
+        u32x4 values = lanes + 1u;
+        u32x4 evenLanes = (u32x4)((lanes & 1u) == 0u) & 1u;
+        waveSumTotal += values[0] + values[1] + values[2] + values[3];
+        ballotTotal += evenLanes[0] + evenLanes[1] + evenLanes[2] + evenLanes[3];
+      }
+      for (; lane < WEBVULKAN_SUBGROUP_SIZE; ++lane) {
+        waveSumTotal += base + lane + 1u;
+        ballotTotal += ((base + lane) & 1u) == 0u ? 1u : 0u;
+      }
+      firstLaneTotal += base;
+      ++subgroupCount;
+    }
+  }
+  atomic_add_u32(dst, waveSumTotal);
+  atomic_add_u32(dst + 4u, subgroupCount);
+  atomic_add_u32(dst + 8u, ballotTotal);
+  atomic_add_u32(dst + 12u, firstLaneTotal);
+}
+
+void __wasm_signal(void) {
+}
+
+static inline __attribute__((always_inline)) void run_workload(
+  u32 dst,
+  u32 offset,
+  u32 value,
+  u32 workload,
+  u32 invocations,
+  u32 workgroups
+) {
+  /*
+   * The parameter comes from the dynamically offset slot at dst. The pinned Mesa fork
+   * does not pass push constants to Wasm kernels, so push_constant_sweep stays on llvmpipe.
+   */
+  if (workload == 10u) {
+    atomic_add_u32(dst, invocations * load_u32(dst + 4u));
+    return;
+  }
+  if (workload == 1u) {
+    for (u32 i = 0u; i < invocations; ++i) {
+      atomic_add_u32(dst, 1u);
+    }
+    return;
+  }
+  if (workload == 2u) {
+    for (u32 group = 0u; group < workgroups; ++group) {
+      atomic_add_u32(dst, 1u);
+    }
+    return;
+  }
+  if (workload == 4u) {
+    for (u32 i = 0u; i < invocations; ++i) {
+      atomic_add_u32(dst + ((i % ${runtimeHistogramBinCount}u) * 4u), 1u);
+    }
+    return;
+  }
+  if (workload == 5u || workload == 6u) {
+    u32 workgroupSize = workgroups != 0u ? invocations / workgroups : 0u;
+    if (workgroupSize == 0u || workgroupSize > WEBVULKAN_GROUPSHARED_MAX_WORDS ||
+        (workgroupSize & (workgroupSize - 1u)) != 0u) {
+      __builtin_trap();
+    }
+    if (workload == 5u) {
+      run_groupshared_reduction(dst, workgroupSize, workgroups);
+    } else {
+      run_groupshared_scan(dst, workgroupSize, workgroups);
+    }
+    return;
+  }
+  if (workload == 8u) {
+    u32 tileWork = 0u;
+    for (u32 repeat = 0u; repeat < WEBVULKAN_SPEC_TILE_REPEATS; ++repeat) {
+      for (u32 i = 0u; i < WEBVULKAN_SPEC_TILE_SIZE; ++i) {
+        tileWork += 1u;
+      }
+    }
+    atomic_add_u32(dst, invocations * tileWork);
+    return;
+  }
+  if (workload == 7u) {
+    u32 workgroupSize = workgroups != 0u ? invocations / workgroups : 0u;
+    if (workgroupSize == 0u || (workgroupSize % WEBVULKAN_SUBGROUP_SIZE) != 0u) {
+      __builtin_trap();
+    }
+    run_subgroup_reduction(dst, workgroupSize, workgroups);
+    return;
+  }
+  if (workload == 9u) {
+    store_u32(dst, invocations);
+    __builtin_memcpy(
+      (void*)(unsigned long)(dst + 4u + (invocations * 4u)),
+      (const void*)(unsigned long)(dst + 4u),
+      invocations * 4u
+    );
+    /* The harness compares this with the range it mapped to prove the copy ran in place. */
+    store_u32(dst + 4u + (invocations * 8u), dst);
+    return;
+  }
+  if (workload == 3u) {
+    store_u32(dst, invocations);
+    u32 base = dst + 4u;
+    for (u32 i = 0u; i < invocations; ++i) {
+      store_u32(base + (i * 4u), i + 1u);
+    }
+    return;
+  }
+  store_u32(dst + offset, value);
+}
+
+static inline __attribute__((always_inline)) void run_dispatch(
+  u32 dst,
+  u32 offset,
+  u32 value,
+  u32 workload,
+  u32 invocations,
+  u32 workgroups
+) {
+#ifdef WEBVULKAN_FIXED_WORKGROUPS
+  if (invocations == WEBVULKAN_FIXED_INVOCATIONS && workgroups == WEBVULKAN_FIXED_WORKGROUPS) {
+    run_workload(
+      dst,
+      offset,
+      value,
+      workload,
+      WEBVULKAN_FIXED_INVOCATIONS,
+      WEBVULKAN_FIXED_WORKGROUPS
+    );
+    return;
+  }
+#endif
+  run_workload(dst, offset, value, workload, invocations, workgroups);
+}
+
+void run(u32 dst, u32 offset, u32 value, u32 workload, u32 invocations, u32 workgroups) {
+  run_dispatch(dst, offset, value, workload, invocations, workgroups);
+}
+
+#define WEBVULKAN_BANDWIDTH_HEADER_WORDS 4u
+#define WEBVULKAN_BANDWIDTH_GATHER_COLUMNS 16u
+
+/*
+ * Bandwidth kernels read the header the harness wrote at dst and walk every element
+ * in one call. Arrays start 16-byte aligned and hold a multiple of 64 elements, so
+ * the SIMD loops need no tail; copy lowers to memory.copy.
+ */
+static inline u32* bandwidth_array(u32 dst, u32 array) {
+  const u32 elements = load_u32(dst);
+  return (u32*)(unsigned long)(dst + (WEBVULKAN_BANDWIDTH_HEADER_WORDS + array * elements) * 4u);
+}
+
+void kernel_bandwidth_copy(u32 dst, u32 offset, u32 value, u32 workload, u32 invocations, u32 workgroups) {
+  __builtin_memcpy(bandwidth_array(dst, 1u), bandwidth_array(dst, 0u), load_u32(dst) * 4u);
+}
+
+void kernel_bandwidth_saxpy(u32 dst, u32 offset, u32 value, u32 workload, u32 invocations, u32 workgroups) {
+  const u32 elements = load_u32(dst);
+  const u32 scale = load_u32(dst + 8u);
+  const u32x4_unaligned* x = (const u32x4_unaligned*)bandwidth_array(dst, 0u);
+  u32x4_unaligned* y = (u32x4_unaligned*)bandwidth_array(dst, 1u);
+  for (u32 i = 0u; i < elements / 4u; ++i) {
+    y[i] = x[i] * scale + y[i];
+  }
+}
+
+void kernel_bandwidth_triad(u32 dst, u32 offset, u32 value, u32 workload, u32 invocations, u32 workgroups) {
+  const u32 elements = load_u32(dst);
+  const u32 scale = load_u32(dst + 8u);
+  const u32x4_unaligned* x = (const u32x4_unaligned*)bandwidth_array(dst, 0u);
+  const u32x4_unaligned* y = (const u32x4_unaligned*)bandwidth_array(dst, 1u);
+  u32x4_unaligned* z = (u32x4_unaligned*)bandwidth_array(dst, 2u);
+  for (u32 i = 0u; i < elements / 4u; ++i) {
+    z[i] = x[i] + y[i] * scale;
+  }
+}
+
+/* y[c * rows + r] = x[r * 16 + c]: sequential writes, 64-byte strided reads. */
+void kernel_bandwidth_gather(u32 dst, u32 offset, u32 value, u32 workload, u32 invocations, u32 workgroups) {
+  const u32 rows = load_u32(dst + 12u);
+  const u32* x = bandwidth_array(dst, 0u);
+  u32* y = bandwidth_array(dst, 1u);
+  for (u32 column = 0u; column < WEBVULKAN_BANDWIDTH_GATHER_COLUMNS; ++column) {
+    for (u32 row = 0u; row < rows; ++row) {
+      y[column * rows + row] = x[row * WEBVULKAN_BANDWIDTH_GATHER_COLUMNS + column];
+    }
+  }
+}
+
+#define WEBVULKAN_PRIMITIVE_HEADER_WORDS 16u
+#define WEBVULKAN_PRIMITIVE_BLOCK_SIZE 256u
+#define WEBVULKAN_PRIMITIVE_BINS 256u
+
+/*
+ * Primitive stages read the header the harness wrote at dst and cover the whole
+ * dispatch in one call, walking blocks in order, so they count straight into the
+ * harness's bins and digit-major counts without atomics.
+ */
+static inline u32* primitive_words(u32 dst) {
+  return (u32*)(unsigned long)dst;
+}
+
+static inline u32 primitive_block_elements(const u32* words, u32 block) {
+  const u32 remaining = words[0] - block * WEBVULKAN_PRIMITIVE_BLOCK_SIZE;
+  return remaining < WEBVULKAN_PRIMITIVE_BLOCK_SIZE ? remaining : WEBVULKAN_PRIMITIVE_BLOCK_SIZE;
+}
+
+void kernel_primitive_reduce(u32 dst, u32 offset, u32 value, u32 workload, u32 invocations, u32 workgroups) {
+  const u32* words = primitive_words(dst);
+  const u32 elements = words[0];
+  const u32x4_unaligned* keys = (const u32x4_unaligned*)(words + WEBVULKAN_PRIMITIVE_HEADER_WORDS);
+  u32x4 lanes = { 0u, 0u, 0u, 0u };
+  for (u32 i = 0u; i < elements / 4u; ++i) {
+    lanes += keys[i];
+  }
+  u32 sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  for (u32 i = elements & ~3u; i < elements; ++i) {
+    sum += words[WEBVULKAN_PRIMITIVE_HEADER_WORDS + i];
+  }
+  atomic_add_u32(dst + 20u, sum);
+}
+
+void kernel_primitive_histogram(u32 dst, u32 offset, u32 value, u32 workload, u32 invocations, u32 workgroups) {
+  const u32* words = primitive_words(dst);
+  const u32 elements = words[0];
+  u32* bins = primitive_words(dst) + WEBVULKAN_PRIMITIVE_HEADER_WORDS + elements * 2u;
+  for (u32 i = 0u; i < elements; ++i) {
+    bins[words[WEBVULKAN_PRIMITIVE_HEADER_WORDS + i] & 255u] += 1u;
+  }
+}
+
+void kernel_primitive_block_sum(u32 dst, u32 offset, u32 value, u32 workload, u32 invocations, u32 workgroups) {
+  u32* words = primitive_words(dst);
+  const u32* keys = words + WEBVULKAN_PRIMITIVE_HEADER_WORDS;
+  u32* partials = words + words[2];
+  for (u32 block = 0u; block < words[1]; ++block) {
+    const u32 count = primitive_block_elements(words, block);
+    u32 sum = 0u;
+    for (u32 k = 0u; k < count; ++k) {
+      sum += keys[block * WEBVULKAN_PRIMITIVE_BLOCK_SIZE + k];
+    }
+    partials[block] = sum;
+  }
+}
+
+void kernel_primitive_scan_partials(u32 dst, u32 offset, u32 value, u32 workload, u32 invocations, u32 workgroups) {
+  u32* words = primitive_words(dst);
+  u32* region = words + words[2];
+  const u32 count = words[3];
+  u32 running = 0u;
+  for (u32 i = 0u; i < count; ++i) {
+    const u32 current = region[i];
+    region[i] = running;
+    running += current;
+  }
+}
+
+void kernel_primitive_block_scan(u32 dst, u32 offset, u32 value, u32 workload, u32 invocations, u32 workgroups) {
+  u32* words = primitive_words(dst);
+  const u32* keys = words + WEBVULKAN_PRIMITIVE_HEADER_WORDS;
+  u32* output = words + WEBVULKAN_PRIMITIVE_HEADER_WORDS + words[0];
+  const u32* partials = words + words[2];
+  for (u32 block = 0u; block < words[1]; ++block) {
+    const u32 count = primitive_block_elements(words, block);
+    const u32 base = block * WEBVULKAN_PRIMITIVE_BLOCK_SIZE;
+    u32 running = partials[block];
+    for (u32 k = 0u; k < count; ++k) {
+      output[base + k] = running;
+      running += keys[base + k];
+    }
+  }
+}
+
+void kernel_primitive_radix_count(u32 dst, u32 offset, u32 value, u32 workload, u32 invocations, u32 workgroups) {
+  u32* words = primitive_words(dst);
+  const u32* keys = words + WEBVULKAN_PRIMITIVE_HEADER_WORDS;
+  u32* counts = words + words[2];
+  const u32 blocks = words[1];
+  const u32 shift = words[4];
+  for (u32 block = 0u; block < blocks; ++block) {
+    const u32 count = primitive_block_elements(words, block);
+    for (u32 digit = 0u; digit < WEBVULKAN_PRIMITIVE_BINS; ++digit) {
+      counts[digit * blocks + block] = 0u;
+    }
+    for (u32 k = 0u; k < count; ++k) {
+      counts[((keys[block * WEBVULKAN_PRIMITIVE_BLOCK_SIZE + k] >> shift) & 255u) * blocks + block] += 1u;
+    }
+  }
+}
+
+/*
+ * Walking each block in order keeps the scatter stable, like the shader's local sort.
+ * The scanned offsets serve as cursors; radix_count rebuilds them every submit.
+ */
+void kernel_primitive_radix_scatter(u32 dst, u32 offset, u32 value, u32 workload, u32 invocations, u32 workgroups) {
+  u32* words = primitive_words(dst);
+  const u32* keys = words + WEBVULKAN_PRIMITIVE_HEADER_WORDS;
+  u32* output = words + WEBVULKAN_PRIMITIVE_HEADER_WORDS + words[0];
+  u32* cursors = words + words[2];
+  const u32 blocks = words[1];
+  const u32 shift = words[4];
+  for (u32 block = 0u; block < blocks; ++block) {
+    const u32 count = primitive_block_elements(words, block);
+    for (u32 k = 0u; k < count; ++k) {
+      const u32 key = keys[block * WEBVULKAN_PRIMITIVE_BLOCK_SIZE + k];
+      output[cursors[((key >> shift) & 255u) * blocks + block]++] = key;
+    }
+  }
+}
+
+${runtimeKernelExportSource()}
+`;
+
+  const compileResult = await runProcess(wasmerBin, [
+    "run",
+    "--quiet",
+    clangPackage,
+    "--",
+    "--target=wasm32-unknown-unknown",
+    "-O2",
+    "-matomics",
+    "-msimd128",
+    "-mbulk-memory",
+    // A stack frame would live below __stack_pointer in the shared lavapipe heap.
+    "-Wframe-larger-than=0",
+    "-Werror=frame-larger-than",
+    "-x",
+    "c",
+    "-",
+    "-nostdlib",
+    "-Wl,--no-entry",
+    "-Wl,--export=__wasm_signal",
+    "-Wl,--export=run",
+    ...runtimeBandwidthShaders.map((shader) => `-Wl,--export=${shader.kernelExport}`),
+    ...runtimePrimitiveShaders.map((shader) => `-Wl,--export=${shader.kernelExport}`),
+    ...[...runtimeShaderWorkloadMap.keys()]
+      .filter((workloadName) => !runtimeLlvmpipeOnlyWorkloads.has(workloadName))
+      .map((workloadName) => `-Wl,--export=${runtimeKernelExportName(workloadName)}`),
+    "-o",
+    "-"
+  ], { stdin: runtimeCSource });
+
+  if (compileResult.code !== 0) {
+    const reason = firstLine(compileResult.stderr) || `exit_code=${compileResult.code}`;
+    throw new Error(`failed to compile runtime C -> Wasm: ${reason}`);
+  }
+
+  const wasmMagic = Buffer.from([0x00, 0x61, 0x73, 0x6d]);
+  if (compileResult.stdout.length < 8 || !compileResult.stdout.subarray(0, 4).equals(wasmMagic)) {
+    throw new Error("clang-in-wasm did not produce valid Wasm runtime module");
+  }
+  if (!WebAssembly.validate(compileResult.stdout)) {
+    throw new Error("runtime C -> Wasm output failed WebAssembly.validate");
+  }
+  // The driver instantiates kernels with no import object.
+  const kernelImports = WebAssembly.Module.imports(new WebAssembly.Module(compileResult.stdout));
+  if (kernelImports.length !== 0) {
+    throw new Error(
+      `runtime C -> Wasm output imports ${kernelImports.map((entry) => `${entry.module}.${entry.name}`).join(", ")}`
+    );
+  }
+  if (runtimeWasmHasDataSegments(compileResult.stdout)) {
+    throw new Error("runtime C -> Wasm output has data segments that would alias the lavapipe heap");
+  }
+
+  return {
+    provider: `${clangPackage} c-runtime${specialization && specialization.grid ? "+grid-specialized" : ""}`,
+    entrypoint: "run",
+    bytes: compileResult.stdout
+  };
+}
+
+const modulePath = process.env.SMOKE_MODULE;
+if (!modulePath) {
+  throw new Error("SMOKE_MODULE is not set");
+}
+const exportName = process.env.SMOKE_EXPORT || "_wasm_runtime_smoke";
+const requireRuntimeSpirv = process.env.SMOKE_REQUIRE_RUNTIME_SPIRV === "1";
+const runtimeExecutionMode = process.env.WEBVULKAN_RUNTIME_EXECUTION_MODE || "fast_wasm";
+const runtimeBenchIterations = Number.parseInt(process.env.WEBVULKAN_RUNTIME_BENCH_ITERATIONS || "8", 10);
+const runtimeWarmupIterations = Number.parseInt(process.env.WEBVULKAN_RUNTIME_WARMUP_ITERATIONS || "2", 10);
+const runtimePersistentSamples = Number.parseInt(process.env.WEBVULKAN_RUNTIME_PERSISTENT_SAMPLES || "0", 10);
+const runtimeBenchProfile = process.env.WEBVULKAN_RUNTIME_BENCH_PROFILE || "dispatch_overhead";
+const runtimeBenchProfileMap = new Map([
+  ["dispatch_overhead", 0],
+  ["balanced_grid", 1],
+  ["large_grid", 2],
+  ["large_buffer", 3],
+  ["indirect_dispatch", 4],
+  ["push_constant_sweep", 5],
+  ["descriptor_param_sweep", 6],
+  ["image_filter_2d", 7],
+  ["micro", 0],
+  ["realistic", 1],
+  ["hot_loop_single_dispatch", 2]
+]);
+const runtimeShaderWorkload = process.env.WEBVULKAN_RUNTIME_SHADER_WORKLOAD || "write_const";
+const runtimeKernelSpecialization = process.env.WEBVULKAN_RUNTIME_KERNEL_SPECIALIZATION || "generic";
+const runtimeTransferBenchMaxBytes = Number.parseInt(process.env.WEBVULKAN_RUNTIME_TRANSFER_BENCH_MAX_BYTES || "0", 10);
+const runtimeRenderBenchSize = Number.parseInt(process.env.WEBVULKAN_RUNTIME_RENDER_BENCH_SIZE || "0", 10);
+const runtimeVertexBenchMaxVertices =
+  Number.parseInt(process.env.WEBVULKAN_RUNTIME_VERTEX_BENCH_MAX_VERTICES || "0", 10);
+const runtimePipelineBenchShaders =
+  Number.parseInt(process.env.WEBVULKAN_RUNTIME_PIPELINE_BENCH_SHADERS || "0", 10);
+const runtimeBandwidthBenchMaxBytes =
+  Number.parseInt(process.env.WEBVULKAN_RUNTIME_BANDWIDTH_BENCH_MAX_BYTES || "0", 10);
+const runtimePrimitiveBenchMaxElements =
+  Number.parseInt(process.env.WEBVULKAN_RUNTIME_PRIMITIVE_BENCH_MAX_ELEMENTS || "0", 10);
+const runtimeSweepMaxWorkgroup =
+  Number.parseInt(process.env.WEBVULKAN_RUNTIME_SWEEP_MAX_WORKGROUP_SIZE || "0", 10);
+const runtimeSweepSamples = Number.parseInt(process.env.WEBVULKAN_RUNTIME_SWEEP_SAMPLES || "8", 10);
+const runtimeFastWasmSubgroupSize = Number.parseInt(process.env.WEBVULKAN_RUNTIME_SUBGROUP_SIZE || "4", 10);
+const runtimeTraceEvents = Number.parseInt(process.env.WEBVULKAN_RUNTIME_TRACE_EVENTS || "0", 10);
+const runtimeMemoryGrowthCycles = Number.parseInt(process.env.WEBVULKAN_RUNTIME_MEMORY_GROWTH_CYCLES || "0", 10);
+const runtimeMemoryGrowthMaxBytesPerCycle =
+  Number.parseFloat(process.env.WEBVULKAN_RUNTIME_MEMORY_GROWTH_MAX_BYTES_PER_CYCLE || "256");
+const runtimeBenchJsonDir = process.env.WEBVULKAN_RUNTIME_BENCH_JSON_DIR || "";
+const runtimeShaderWorkloadMap = new Map([
+  ["write_const", 0],
+  ["atomic_single_counter", 1],
+  ["atomic_per_workgroup", 2],
+  ["no_race_unique_writes", 3],
+  ["atomic_sharded_histogram", 4],
+  ["groupshared_reduction", 5],
+  ["groupshared_scan", 6],
+  ["subgroup_reduction", 7],
+  ["spec_constant_tiles", 8],
+  ["buffer_copy", 9],
+  ["push_constant_param", 10],
+  ["image_box_filter", 11]
+]);
+/*
+ * Workloads without a fast_wasm kernel. The pinned Mesa fork does not describe bound
+ * images to Wasm kernels, so the image filter only runs through llvmpipe.
+ */
+const runtimeLlvmpipeOnlyWorkloads = new Set(["image_box_filter"]);
+const runtimeBenchProfileValue = runtimeBenchProfileMap.get(runtimeBenchProfile);
+const runtimeShaderWorkloadValue = runtimeShaderWorkloadMap.get(runtimeShaderWorkload);
+
+if (!Number.isInteger(runtimeBenchIterations) || runtimeBenchIterations <= 0) {
+  throw new Error(`WEBVULKAN_RUNTIME_BENCH_ITERATIONS must be a positive integer, got ${runtimeBenchIterations}`);
+}
+if (!Number.isInteger(runtimeWarmupIterations) || runtimeWarmupIterations < 0) {
+  throw new Error(`WEBVULKAN_RUNTIME_WARMUP_ITERATIONS must be a non-negative integer, got ${runtimeWarmupIterations}`);
+}
+if (!Number.isInteger(runtimePersistentSamples) || runtimePersistentSamples < 0 || runtimePersistentSamples > 4096) {
+  throw new Error(`WEBVULKAN_RUNTIME_PERSISTENT_SAMPLES must be 0..4096, got ${runtimePersistentSamples}`);
+}
+if (!Number.isInteger(runtimePipelineBenchShaders) || runtimePipelineBenchShaders < 0 || runtimePipelineBenchShaders > 32) {
+  throw new Error(`WEBVULKAN_RUNTIME_PIPELINE_BENCH_SHADERS must be 0..32, got ${runtimePipelineBenchShaders}`);
+}
+if (!Number.isInteger(runtimeBandwidthBenchMaxBytes) ||
+    (runtimeBandwidthBenchMaxBytes !== 0 &&
+     (runtimeBandwidthBenchMaxBytes < runtimeBandwidthMinBytes || runtimeBandwidthBenchMaxBytes > runtimeBandwidthMaxBytes))) {
+  throw new Error(
+    `WEBVULKAN_RUNTIME_BANDWIDTH_BENCH_MAX_BYTES must be 0 or ${runtimeBandwidthMinBytes}..${runtimeBandwidthMaxBytes} ` +
+    `(wasm32 cap), got ${runtimeBandwidthBenchMaxBytes}`
+  );
+}
+if (!Number.isInteger(runtimePrimitiveBenchMaxElements) ||
+    (runtimePrimitiveBenchMaxElements !== 0 &&
+     (runtimePrimitiveBenchMaxElements < runtimePrimitiveMinElements ||
+      runtimePrimitiveBenchMaxElements > runtimePrimitiveMaxElements))) {
+  throw new Error(
+    `WEBVULKAN_RUNTIME_PRIMITIVE_BENCH_MAX_ELEMENTS must be 0 or ${runtimePrimitiveMinElements}..` +
+    `${runtimePrimitiveMaxElements}, got ${runtimePrimitiveBenchMaxElements}`
+  );
+}
+if (!Number.isInteger(runtimeSweepMaxWorkgroup) ||
+    runtimeSweepMaxWorkgroup < 0 ||
+    runtimeSweepMaxWorkgroup > runtimeSweepMaxWorkgroupSize ||
+    (runtimeSweepMaxWorkgroup & (runtimeSweepMaxWorkgroup - 1)) !== 0) {
+  throw new Error(
+    `WEBVULKAN_RUNTIME_SWEEP_MAX_WORKGROUP_SIZE must be 0 or a power of two up to ${runtimeSweepMaxWorkgroupSize}, ` +
+    `got ${runtimeSweepMaxWorkgroup}`
+  );
+}
+if (!Number.isInteger(runtimeSweepSamples) || runtimeSweepSamples <= 0 || runtimeSweepSamples > 4096) {
+  throw new Error(`WEBVULKAN_RUNTIME_SWEEP_SAMPLES must be 1..4096, got ${runtimeSweepSamples}`);
+}
+if (!Number.isInteger(runtimeFastWasmSubgroupSize) ||
+    runtimeFastWasmSubgroupSize <= 0 ||
+    runtimeFastWasmSubgroupSize > runtimeMaxSubgroupSize ||
+    (runtimeFastWasmSubgroupSize & (runtimeFastWasmSubgroupSize - 1)) !== 0) {
+  throw new Error(
+    `WEBVULKAN_RUNTIME_SUBGROUP_SIZE must be a power of two up to ${runtimeMaxSubgroupSize}, ` +
+    `got ${process.env.WEBVULKAN_RUNTIME_SUBGROUP_SIZE}`
+  );
+}
+if (!Number.isInteger(runtimeTraceEvents) ||
+    runtimeTraceEvents < 0 ||
+    runtimeTraceEvents > runtimeTraceMaxEvents ||
+    (runtimeTraceEvents & (runtimeTraceEvents - 1)) !== 0) {
+  throw new Error(
+    `WEBVULKAN_RUNTIME_TRACE_EVENTS must be 0 or a power of two up to ${runtimeTraceMaxEvents}, got ${runtimeTraceEvents}`
+  );
+}
+if (!Number.isInteger(runtimeMemoryGrowthCycles) ||
+    runtimeMemoryGrowthCycles < 0 ||
+    runtimeMemoryGrowthCycles > runtimeMemoryGrowthMaxCycles) {
+  throw new Error(
+    `WEBVULKAN_RUNTIME_MEMORY_GROWTH_CYCLES must be 0..${runtimeMemoryGrowthMaxCycles}, got ${runtimeMemoryGrowthCycles}`
+  );
+}
+if (!Number.isFinite(runtimeMemoryGrowthMaxBytesPerCycle) || runtimeMemoryGrowthMaxBytesPerCycle < 0) {
+  throw new Error(
+    "WEBVULKAN_RUNTIME_MEMORY_GROWTH_MAX_BYTES_PER_CYCLE must be a non-negative number, " +
+    `got '${process.env.WEBVULKAN_RUNTIME_MEMORY_GROWTH_MAX_BYTES_PER_CYCLE}'`
+  );
+}
+if (runtimeBenchProfileValue === undefined) {
+  throw new Error(`Unsupported WEBVULKAN_RUNTIME_BENCH_PROFILE='${runtimeBenchProfile}'`);
 }
 if (runtimeShaderWorkloadValue === undefined) {
   throw new Error(`Unsupported WEBVULKAN_RUNTIME_SHADER_WORKLOAD='${runtimeShaderWorkload}'`);
 }
-if (runtimeExecutionMode !== "fast_wasm" && runtimeExecutionMode !== "raw_llvm_ir") {
-  throw new Error(`Unsupported WEBVULKAN_RUNTIME_EXECUTION_MODE='${runtimeExecutionMode}'`);
+if (runtimeExecutionMode !== "fast_wasm" && runtimeExecutionMode !== "raw_llvm_ir") {
+  throw new Error(`Unsupported WEBVULKAN_RUNTIME_EXECUTION_MODE='${runtimeExecutionMode}'`);
+}
+if (runtimeKernelSpecialization !== "generic" && runtimeKernelSpecialization !== "grid") {
+  throw new Error(`Unsupported WEBVULKAN_RUNTIME_KERNEL_SPECIALIZATION='${runtimeKernelSpecialization}'`);
+}
+if (!Number.isInteger(runtimeTransferBenchMaxBytes) || runtimeTransferBenchMaxBytes < 0) {
+  throw new Error(
+    `WEBVULKAN_RUNTIME_TRANSFER_BENCH_MAX_BYTES must be a non-negative integer, got ${runtimeTransferBenchMaxBytes}`
+  );
+}
+if (!Number.isInteger(runtimeRenderBenchSize) ||
+    (runtimeRenderBenchSize !== 0 && (runtimeRenderBenchSize < 16 || runtimeRenderBenchSize > 2048))) {
+  throw new Error(`WEBVULKAN_RUNTIME_RENDER_BENCH_SIZE must be 0 or 16..2048, got ${runtimeRenderBenchSize}`);
+}
+if (!Number.isInteger(runtimeVertexBenchMaxVertices) ||
+    (runtimeVertexBenchMaxVertices !== 0 &&
+     (runtimeVertexBenchMaxVertices < 1024 || runtimeVertexBenchMaxVertices > 1048576))) {
+  throw new Error(
+    `WEBVULKAN_RUNTIME_VERTEX_BENCH_MAX_VERTICES must be 0 or 1024..1048576, got ${runtimeVertexBenchMaxVertices}`
+  );
+}
+
+/*
+ * Counts every Wasm instantiation in the process, whoever makes it. The driver
+ * instantiates the kernel module it looks up itself, so this is the only count that
+ * sees its dispatch path; the registry's own counters only see registration.
+ */
+let runtimeProcessWasmInstantiations = 0;
+const NativeWasmInstance = WebAssembly.Instance;
+WebAssembly.Instance = class extends NativeWasmInstance {
+  constructor(module, importObject) {
+    super(module, importObject);
+    ++runtimeProcessWasmInstantiations;
+  }
+};
+for (const name of ["instantiate", "instantiateStreaming"]) {
+  const native = WebAssembly[name];
+  if (typeof native === "function") {
+    WebAssembly[name] = async (...args) => {
+      const result = await native.apply(WebAssembly, args);
+      ++runtimeProcessWasmInstantiations;
+      return result;
+    };
+  }
+}
+
+const moduleUrl = pathToFileURL(modulePath).href;
+const imported = await import(moduleUrl);
+const factory = imported.default;
+
+if (typeof factory !== "function") {
+  throw new Error("Expected default export factory from Emscripten module");
+}
+
+const runtime = await factory({
+  print: (text) => process.stdout.write(String(text) + "\n"),
+  printErr: (text) => process.stderr.write(String(text) + "\n"),
+  onAbort: (what) => {
+    process.stderr.write(`wasm abort: ${String(what)}\n`);
+    process.stderr.write(`${new Error("wasm abort stack").stack}\n`);
+  },
+  quit_: (status, toThrow) => {
+    process.stderr.write(`wasm quit status=${status}\n`);
+    process.stderr.write(`${new Error("wasm quit stack").stack}\n`);
+    throw toThrow;
+  }
+});
+
+if (requireRuntimeSpirv) {
+  if (typeof runtime.ccall !== "function") {
+    throw new Error("Expected runtime method ccall for runtime shader registry");
+  }
+}
+
+const smokeFn = runtime[exportName];
+if (typeof smokeFn !== "function") {
+  throw new Error(`Export ${exportName} not found`);
+}
+
+function invokeSmokeOnce() {
+  let rc = 0;
+  try {
+    rc = smokeFn();
+  } catch (error) {
+    process.stderr.write(`smoke invocation threw: ${String(error)}\n`);
+    if (error && typeof error === "object") {
+      try {
+        const ownKeys = Object.getOwnPropertyNames(error);
+        process.stderr.write(`smoke invocation error keys: ${ownKeys.join(",")}\n`);
+        for (const key of ownKeys) {
+          process.stderr.write(`  ${key}=${String(error[key])}\n`);
+        }
+      } catch {
+      }
+    }
+    if (error && error.stack) {
+      process.stderr.write(`${error.stack}\n`);
+    }
+    throw error;
+  }
+  if (rc !== 0) {
+    throw new Error(`Runtime smoke failed with rc=${rc}`);
+  }
+}
+
+function invokeSmokeOnceWithTimingMs() {
+  invokeSmokeOnce();
+  const wallMs = runtime.ccall("webvulkan_get_last_dispatch_ms", "number", [], []);
+  if (!Number.isFinite(wallMs) || wallMs < 0) {
+    throw new Error(`Invalid dispatch wall time returned from smoke: ${wallMs}`);
+  }
+  return wallMs;
+}
+
+function setRuntimePersistentSamples(samples) {
+  const setSamplesRc = runtime.ccall(
+    "webvulkan_set_runtime_persistent_samples",
+    "number",
+    ["number"],
+    [samples]
+  );
+  if (setSamplesRc !== 0) {
+    throw new Error(`webvulkan_set_runtime_persistent_samples failed with rc=${setSamplesRc} samples=${samples}`);
+  }
+}
+
+/* Registry stage counters in WEBVULKAN_RUNTIME_STAGE_* order, accumulated since the last reset. */
+function getRuntimeStageTimings() {
+  const stages = [
+    "instance_create",
+    "device_create",
+    "pipeline_create",
+    "resource_setup",
+    "command_record",
+    "queue_submit",
+    "fence_wait",
+    "host_readback",
+    "registry_lookup"
+  ];
+  const timings = {};
+  for (let stage = 0; stage < stages.length; ++stage) {
+    timings[stages[stage]] = {
+      total_ms: runtime.ccall("webvulkan_runtime_get_stage_total_ms", "number", ["number"], [stage]),
+      last_ms: runtime.ccall("webvulkan_runtime_get_stage_last_ms", "number", ["number"], [stage]),
+      count: runtime.ccall("webvulkan_runtime_get_stage_count", "number", ["number"], [stage]) >>> 0
+    };
+  }
+  return timings;
+}
+
+/*
+ * Default timing calls the smoke once per sample, so each sample also covers the
+ * per-iteration buffer reset and validation. Persistent timing makes one call that
+ * reuses the device and pipeline for every sample and times only the fenced submit.
+ */
+function collectDispatchSamplesMs(mode) {
+  const samplesMs = [];
+  runtime.ccall("webvulkan_runtime_reset_stage_timings", null, [], []);
+  if (runtimePersistentSamples === 0) {
+    for (let i = 0; i < runtimeBenchIterations; ++i) {
+      console.log(`runtime smoke benchmark mode=${mode} run=${i + 1}/${runtimeBenchIterations}`);
+      samplesMs.push(invokeSmokeOnceWithTimingMs());
+    }
+    return samplesMs;
+  }
+  console.log(`runtime smoke benchmark mode=${mode} persistent_samples=${runtimePersistentSamples}`);
+  setRuntimePersistentSamples(runtimePersistentSamples);
+  try {
+    invokeSmokeOnceWithTimingMs();
+    for (let i = 0; i < runtimePersistentSamples; ++i) {
+      const sampleMs = runtime.ccall("webvulkan_get_runtime_persistent_sample_ms", "number", ["number"], [i]);
+      if (!Number.isFinite(sampleMs) || sampleMs < 0) {
+        throw new Error(`Invalid persistent dispatch sample ${i}: ${sampleMs}`);
+      }
+      samplesMs.push(sampleMs);
+    }
+  } finally {
+    setRuntimePersistentSamples(0);
+  }
+  return samplesMs;
+}
+
+/*
+ * Prints the "dispatch timing summary" block that validate_dispatch_bench.mjs parses
+ * and, with WEBVULKAN_RUNTIME_BENCH_JSON_DIR set, writes the same numbers plus the raw
+ * samples to dispatch_bench_<mode>_<profile>_<workload>_<timing>.json there.
+ */
+async function summarizeDispatchTimings(mode, profile, samples) {
+  if (!samples.length) {
+    throw new Error(`No dispatch timing samples for mode=${mode}`);
+  }
+  const stats = computeTimingStats(samples);
+  const profileDesc = runtimeBenchProfileDescriptor(profile);
+  const invocationsPerDispatch =
+    profileDesc.dispatchX *
+    profileDesc.dispatchY *
+    profileDesc.dispatchZ *
+    runtimeShaderThreadgroupSizeX(runtimeShaderWorkload);
+  const timing = runtimePersistentSamples === 0 ? "per_call" : "persistent";
+  const submitIterations = runtimePersistentSamples === 0 ? profileDesc.submitIterations : runtimePersistentSamples;
+  const totalDispatchesPerRun = profileDesc.dispatchesPerSubmit * submitIterations;
+  const totalInvocationsPerRun = totalDispatchesPerRun * invocationsPerDispatch;
+  const nsPerInvocation = (ms) => (ms * 1_000_000.0) / invocationsPerDispatch;
+  const stageTimings = getRuntimeStageTimings();
+  console.log("dispatch timing summary");
+  console.log(`  mode=${mode}`);
+  console.log(`  profile=${profile}`);
+  console.log(`  workload=${runtimeShaderWorkload}`);
+  console.log(`  timing=${timing}`);
+  console.log(`  samples=${samples.length}`);
+  console.log(`  dispatches_per_submit=${profileDesc.dispatchesPerSubmit}`);
+  console.log(`  submit_iterations=${submitIterations}`);
+  console.log(`  total_dispatches_per_run=${totalDispatchesPerRun}`);
+  console.log(`  invocations_per_dispatch=${invocationsPerDispatch}`);
+  console.log(`  total_invocations_per_run=${totalInvocationsPerRun}`);
+  console.log(`  min_ms=${stats.minMs.toFixed(6)}`);
+  console.log(`  avg_ms=${stats.meanMs.toFixed(6)}`);
+  console.log(`  max_ms=${stats.maxMs.toFixed(6)}`);
+  console.log(`  median_ms=${stats.medianMs.toFixed(6)}`);
+  console.log(`  p90_ms=${stats.p90Ms.toFixed(6)}`);
+  console.log(`  p99_ms=${stats.p99Ms.toFixed(6)}`);
+  console.log(`  stddev_ms=${stats.stddevMs.toFixed(6)}`);
+  console.log(`  outliers_rejected=${stats.outliers}`);
+  console.log(`  trimmed_mean_ms=${stats.trimmedMeanMs.toFixed(6)}`);
+  console.log(`  ci95_low_ms=${stats.ciLowMs.toFixed(6)}`);
+  console.log(`  ci95_high_ms=${stats.ciHighMs.toFixed(6)}`);
+  console.log(`  min_ns_per_invocation=${nsPerInvocation(stats.minMs).toFixed(3)}`);
+  console.log(`  avg_ns_per_invocation=${nsPerInvocation(stats.meanMs).toFixed(3)}`);
+  console.log(`  max_ns_per_invocation=${nsPerInvocation(stats.maxMs).toFixed(3)}`);
+  console.log(`  median_ns_per_invocation=${nsPerInvocation(stats.medianMs).toFixed(3)}`);
+  for (const [stage, timing] of Object.entries(stageTimings)) {
+    console.log(`  stage_${stage}_total_ms=${timing.total_ms.toFixed(6)}`);
+    console.log(`  stage_${stage}_last_ms=${timing.last_ms.toFixed(6)}`);
+    console.log(`  stage_${stage}_count=${timing.count}`);
+  }
+  console.log(`  samples_ms=${samples.map((sample) => sample.toFixed(6)).join(",")}`);
+
+  if (!runtimeBenchJsonDir) {
+    return;
+  }
+  const report = {
+    mode,
+    profile,
+    workload: runtimeShaderWorkload,
+    timing,
+    dispatches_per_submit: profileDesc.dispatchesPerSubmit,
+    submit_iterations: submitIterations,
+    invocations_per_dispatch: invocationsPerDispatch,
+    samples_ms: samples,
+    stats: {
+      count: stats.count,
+      kept: stats.kept,
+      outliers_rejected: stats.outliers,
+      min_ms: stats.minMs,
+      max_ms: stats.maxMs,
+      mean_ms: stats.meanMs,
+      median_ms: stats.medianMs,
+      p90_ms: stats.p90Ms,
+      p99_ms: stats.p99Ms,
+      stddev_ms: stats.stddevMs,
+      trimmed_mean_ms: stats.trimmedMeanMs,
+      confidence_level: benchConfidenceLevel,
+      bootstrap_resamples: benchBootstrapResamples,
+      ci_low_ms: stats.ciLowMs,
+      ci_high_ms: stats.ciHighMs,
+      median_ns_per_invocation: nsPerInvocation(stats.medianMs)
+    },
+    stage_timings: stageTimings
+  };
+  await mkdir(runtimeBenchJsonDir, { recursive: true });
+  const reportPath = join(runtimeBenchJsonDir, `dispatch_bench_${mode}_${profile}_${runtimeShaderWorkload}_${timing}.json`);
+  await writeFile(reportPath, JSON.stringify(report, null, 2) + "\n", "utf8");
+  console.log(`dispatch timing report path=${reportPath}`);
+}
+
+function setRuntimeBenchProfile(profileValue) {
+  const setProfileRc = runtime.ccall(
+    "webvulkan_set_runtime_bench_profile",
+    "number",
+    ["number"],
+    [profileValue]
+  );
+  if (setProfileRc !== 0) {
+    throw new Error(`webvulkan_set_runtime_bench_profile failed with rc=${setProfileRc}`);
+  }
+}
+
+function setRuntimeTransferBenchMaxBytes(maxBytes) {
+  const setTransferRc = runtime.ccall(
+    "webvulkan_set_runtime_transfer_bench_max_bytes",
+    "number",
+    ["number"],
+    [maxBytes]
+  );
+  if (setTransferRc !== 0) {
+    throw new Error(`webvulkan_set_runtime_transfer_bench_max_bytes failed with rc=${setTransferRc} max_bytes=${maxBytes}`);
+  }
+}
+
+function runTransferBench(mode) {
+  if (runtimeTransferBenchMaxBytes === 0) {
+    return;
+  }
+  console.log(`runtime smoke transfer_bench mode=${mode} max_bytes=${runtimeTransferBenchMaxBytes}`);
+  setRuntimeTransferBenchMaxBytes(runtimeTransferBenchMaxBytes);
+  try {
+    invokeSmokeOnce();
+  } finally {
+    setRuntimeTransferBenchMaxBytes(0);
+  }
+}
+
+function setRuntimePipelineBenchShaders(shaders) {
+  const setShadersRc = runtime.ccall(
+    "webvulkan_set_runtime_pipeline_bench_shaders",
+    "number",
+    ["number"],
+    [shaders]
+  );
+  if (setShadersRc !== 0) {
+    throw new Error(`webvulkan_set_runtime_pipeline_bench_shaders failed with rc=${setShadersRc} shaders=${shaders}`);
+  }
+}
+
+function setRuntimePipelineBenchKernel(moduleId, kernelExport) {
+  const setKernelRc = runtime.ccall(
+    "webvulkan_set_runtime_pipeline_bench_kernel",
+    "number",
+    ["number", "string"],
+    [moduleId, kernelExport]
+  );
+  if (setKernelRc !== 0) {
+    throw new Error(`webvulkan_set_runtime_pipeline_bench_kernel failed with rc=${setKernelRc} export=${kernelExport}`);
+  }
+}
+
+/*
+ * Creates N distinct write_const pipelines cold, with fast-path kernels registered
+ * under their captured keys, and through a primed VkPipelineCache. Only fast_wasm
+ * has a shared module to register, so raw_llvm_ir's bundle state matches cold.
+ */
+function runPipelineBench(mode) {
+  if (runtimePipelineBenchShaders === 0) {
+    return;
+  }
+  console.log(`runtime smoke pipeline_bench mode=${mode} shaders=${runtimePipelineBenchShaders}`);
+  setRuntimePipelineBenchKernel(
+    mode === "fast_wasm" ? runtimeSharedWasmModuleId : 0,
+    runtimeKernelExportName("write_const")
+  );
+  setRuntimePipelineBenchShaders(runtimePipelineBenchShaders);
+  try {
+    invokeSmokeOnce();
+  } finally {
+    setRuntimePipelineBenchShaders(0);
+  }
+}
+
+function setRuntimeBandwidthBenchMaxBytes(maxBytes) {
+  const setBandwidthRc = runtime.ccall(
+    "webvulkan_set_runtime_bandwidth_bench_max_bytes",
+    "number",
+    ["number"],
+    [maxBytes]
+  );
+  if (setBandwidthRc !== 0) {
+    throw new Error(
+      `webvulkan_set_runtime_bandwidth_bench_max_bytes failed with rc=${setBandwidthRc} max_bytes=${maxBytes}`
+    );
+  }
+}
+
+/*
+ * Sweeps copy, saxpy, triad and strided gather from 64 KiB to the configured buffer
+ * size and prints GB/s next to the harness's own memcpy. fast_wasm registers the
+ * shared module's kernel_bandwidth_* exports under the captured bench keys;
+ * raw_llvm_ir runs the same SPIR-V through llvmpipe.
+ */
+async function runBandwidthBench(mode) {
+  if (runtimeBandwidthBenchMaxBytes === 0) {
+    return;
+  }
+  for (let kernel = 0; kernel < runtimeBandwidthShaders.length; ++kernel) {
+    const shader = runtimeBandwidthShaders[kernel];
+    const spirv = await compileHlslToSpirv(
+      runtimeBandwidthHlsl(shader.entrypoint, shader.body),
+      "cs_6_0",
+      shader.entrypoint
+    );
+    const keyLo = (runtimeBandwidthShaderKeyBase + kernel) >>> 0;
+    registerRuntimeShaderBundle(keyLo, runtimeBandwidthKeyHi, spirv, null, 0);
+    const setKeyRc = runtime.ccall(
+      "webvulkan_set_runtime_bandwidth_shader_key",
+      "number",
+      ["number", "number", "number"],
+      [kernel, keyLo, runtimeBandwidthKeyHi]
+    );
+    if (setKeyRc !== 0) {
+      throw new Error(`webvulkan_set_runtime_bandwidth_shader_key(${kernel}) failed with rc=${setKeyRc}`);
+    }
+  }
+  runtime.ccall(
+    "webvulkan_set_runtime_bandwidth_bench_kernel_module",
+    "number",
+    ["number"],
+    [mode === "fast_wasm" ? runtimeSharedWasmModuleId : 0]
+  );
+  console.log(`runtime smoke bandwidth_bench mode=${mode} max_bytes=${runtimeBandwidthBenchMaxBytes}`);
+  setRuntimeBandwidthBenchMaxBytes(runtimeBandwidthBenchMaxBytes);
+  try {
+    invokeSmokeOnce();
+  } finally {
+    setRuntimeBandwidthBenchMaxBytes(0);
+  }
+  if (mode !== "fast_wasm") {
+    return;
+  }
+  // The harness counts the submits after which the driver had marked Wasm usage.
+  const kernelSubmits = runtimeBandwidthShaders.map((shader, kernel) =>
+    runtime.ccall("webvulkan_get_last_bandwidth_wasm_submits", "number", ["number"], [kernel]) >>> 0
+  );
+  const missingKernel = kernelSubmits.findIndex((submits) => submits === 0);
+  if (missingKernel >= 0) {
+    throw new Error(
+      `fast_wasm mode failed: bandwidth kernel ${runtimeBandwidthShaders[missingKernel].entrypoint} ` +
+      "never ran on the runtime Wasm path"
+    );
+  }
+  console.log(`proof.bandwidth_wasm_submits=${kernelSubmits.join(",")}`);
+}
+
+function setRuntimePrimitiveBenchMaxElements(maxElements) {
+  const setPrimitiveRc = runtime.ccall(
+    "webvulkan_set_runtime_primitive_bench_max_elements",
+    "number",
+    ["number"],
+    [maxElements]
+  );
+  if (setPrimitiveRc !== 0) {
+    throw new Error(
+      `webvulkan_set_runtime_primitive_bench_max_elements failed with rc=${setPrimitiveRc} max_elements=${maxElements}`
+    );
+  }
+}
+
+/*
+ * Runs reduce, exclusive_scan, histogram and one radix sort pass from 4k keys up to
+ * the configured count; the harness checks every output word against its host
+ * reference. fast_wasm registers the shared module's kernel_primitive_* exports
+ * under the captured stage keys; raw_llvm_ir runs the same SPIR-V through llvmpipe.
+ */
+async function runPrimitiveBench(mode) {
+  if (runtimePrimitiveBenchMaxElements === 0) {
+    return;
+  }
+  for (let shaderIndex = 0; shaderIndex < runtimePrimitiveShaders.length; ++shaderIndex) {
+    const shader = runtimePrimitiveShaders[shaderIndex];
+    const spirv = await compileHlslToSpirv(
+      runtimePrimitiveHlsl(shader.entrypoint, shader.body),
+      "cs_6_0",
+      shader.entrypoint
+    );
+    const keyLo = (runtimePrimitiveShaderKeyBase + shaderIndex) >>> 0;
+    registerRuntimeShaderBundle(keyLo, runtimePrimitiveKeyHi, spirv, null, 0);
+    const setKeyRc = runtime.ccall(
+      "webvulkan_set_runtime_primitive_shader_key",
+      "number",
+      ["number", "number", "number"],
+      [shaderIndex, keyLo, runtimePrimitiveKeyHi]
+    );
+    if (setKeyRc !== 0) {
+      throw new Error(`webvulkan_set_runtime_primitive_shader_key(${shaderIndex}) failed with rc=${setKeyRc}`);
+    }
+  }
+  runtime.ccall(
+    "webvulkan_set_runtime_primitive_bench_kernel_module",
+    "number",
+    ["number"],
+    [mode === "fast_wasm" ? runtimeSharedWasmModuleId : 0]
+  );
+  console.log(`runtime smoke primitive_bench mode=${mode} max_elements=${runtimePrimitiveBenchMaxElements}`);
+  setRuntimePrimitiveBenchMaxElements(runtimePrimitiveBenchMaxElements);
+  try {
+    invokeSmokeOnce();
+  } finally {
+    setRuntimePrimitiveBenchMaxElements(0);
+  }
+}
+
+function setRuntimeRenderBenchSize(size) {
+  const setRenderRc = runtime.ccall(
+    "webvulkan_set_runtime_render_bench_size",
+    "number",
+    ["number"],
+    [size]
+  );
+  if (setRenderRc !== 0) {
+    throw new Error(`webvulkan_set_runtime_render_bench_size failed with rc=${setRenderRc} size=${size}`);
+  }
+}
+
+/*
+ * Runs the offscreen graphics suite (clear, fullscreen triangle, small triangles,
+ * textured quads, blend) at several resolutions and reads every frame back.
+ * Fragment shading stays on llvmpipe in both modes.
+ */
+async function runRenderBench(mode) {
+  if (runtimeRenderBenchSize === 0) {
+    return;
+  }
+  for (let index = 0; index < runtimeRenderShaders.length; ++index) {
+    const shader = runtimeRenderShaders[index];
+    const spirv = await compileHlslToSpirv(shader.hlsl, shader.profile, shader.entrypoint);
+    const keyLo = (runtimeRenderShaderKeyBase + index) >>> 0;
+    registerRuntimeShaderBundle(keyLo, runtimeRenderKeyHi, spirv, null, 0);
+    const setKeyRc = runtime.ccall(
+      "webvulkan_set_runtime_render_shader_key",
+      "number",
+      ["number", "number", "number"],
+      [index, keyLo, runtimeRenderKeyHi]
+    );
+    if (setKeyRc !== 0) {
+      throw new Error(`webvulkan_set_runtime_render_shader_key(${index}) failed with rc=${setKeyRc}`);
+    }
+  }
+  console.log(`runtime smoke render_bench mode=${mode} size=${runtimeRenderBenchSize}`);
+  setRuntimeRenderBenchSize(runtimeRenderBenchSize);
+  try {
+    invokeSmokeOnce();
+  } finally {
+    setRuntimeRenderBenchSize(0);
+  }
 }
 
-const moduleUrl = pathToFileURL(modulePath).href;
-const imported = await import(moduleUrl);
-const factory = imported.default;
+function setRuntimeVertexBenchMaxVertices(maxVertices) {
+  const setVertexRc = runtime.ccall(
+    "webvulkan_set_runtime_vertex_bench_max_vertices",
+    "number",
+    ["number"],
+    [maxVertices]
+  );
+  if (setVertexRc !== 0) {
+    throw new Error(
+      `webvulkan_set_runtime_vertex_bench_max_vertices failed with rc=${setVertexRc} max_vertices=${maxVertices}`
+    );
+  }
+}
 
-if (typeof factory !== "function") {
-  throw new Error("Expected default export factory from Emscripten module");
+/*
+ * Sweeps point-list draws from 1k vertices to the configured maximum with rasterizer
+ * discard on. Vertex shading stays on llvmpipe's draw module in both modes.
+ */
+async function runVertexBench(mode) {
+  if (runtimeVertexBenchMaxVertices === 0) {
+    return;
+  }
+  const vertexSpirv = await compileHlslToSpirv(runtimeVertexHlsl, "vs_6_0", "vertex_vs");
+  registerRuntimeShaderBundle(runtimeVertexKeyLo, runtimeVertexKeyHi, vertexSpirv, null, 0);
+  const setKeyRc = runtime.ccall(
+    "webvulkan_set_runtime_vertex_shader_key",
+    "number",
+    ["number", "number"],
+    [runtimeVertexKeyLo, runtimeVertexKeyHi]
+  );
+  if (setKeyRc !== 0) {
+    throw new Error(`webvulkan_set_runtime_vertex_shader_key failed with rc=${setKeyRc}`);
+  }
+  console.log(`runtime smoke vertex_bench mode=${mode} max_vertices=${runtimeVertexBenchMaxVertices}`);
+  setRuntimeVertexBenchMaxVertices(runtimeVertexBenchMaxVertices);
+  try {
+    invokeSmokeOnce();
+  } finally {
+    setRuntimeVertexBenchMaxVertices(0);
+  }
 }
 
-const runtime = await factory({
-  print: (text) => process.stdout.write(String(text) + "\n"),
-  printErr: (text) => process.stderr.write(String(text) + "\n"),
-  onAbort: (what) => {
-    process.stderr.write(`wasm abort: ${String(what)}\n`);
-    process.stderr.write(`${new Error("wasm abort stack").stack}\n`);
-  },
-  quit_: (status, toThrow) => {
-    process.stderr.write(`wasm quit status=${status}\n`);
-    process.stderr.write(`${new Error("wasm quit stack").stack}\n`);
-    throw toThrow;
+function setRuntimeLaunchOverride(launch) {
+  const setLaunchRc = runtime.ccall(
+    "webvulkan_set_runtime_launch_override",
+    "number",
+    ["number", "number", "number", "number", "number"],
+    launch ?
+      [launch.dispatchesPerSubmit, launch.dispatchX, launch.dispatchY, launch.dispatchZ, launch.workgroupSizeX] :
+      [0, 0, 0, 0, 0]
+  );
+  if (setLaunchRc !== 0) {
+    throw new Error(`webvulkan_set_runtime_launch_override failed with rc=${setLaunchRc} launch=${JSON.stringify(launch)}`);
   }
-});
+}
 
-if (requireRuntimeSpirv) {
-  if (typeof runtime.ccall !== "function") {
-    throw new Error("Expected runtime method ccall for runtime shader registry");
+/*
+ * Grid shapes per workgroup count: 1D, then square 2D and cubic 3D shapes where
+ * the count allows them. A single workgroup is only swept as 1D.
+ */
+function runtimeSweepGridShapes() {
+  const shapes = [];
+  for (const workgroups of runtimeSweepWorkgroupsPerDispatch) {
+    shapes.push({ dims: 1, dispatchX: workgroups, dispatchY: 1, dispatchZ: 1 });
+    const side2 = Math.round(Math.sqrt(workgroups));
+    if (workgroups > 1 && side2 * side2 === workgroups) {
+      shapes.push({ dims: 2, dispatchX: side2, dispatchY: side2, dispatchZ: 1 });
+    }
+    const side3 = Math.round(Math.cbrt(workgroups));
+    if (workgroups > 1 && side3 * side3 * side3 === workgroups) {
+      shapes.push({ dims: 3, dispatchX: side3, dispatchY: side3, dispatchZ: side3 });
+    }
   }
+  return shapes;
 }
 
-const smokeFn = runtime[exportName];
-if (typeof smokeFn !== "function") {
-  throw new Error(`Export ${exportName} not found`);
+/*
+ * Binds the workload built for one sweep point: registers its SPIR-V under a
+ * sweep-private key, lets one smoke call at the point's launch shape report the
+ * driver key, then registers the bundle (and, in fast_wasm, the shared module's
+ * kernel) under that key. Points that produce the same HLSL reuse the first key.
+ */
+async function bindRuntimeSweepShader(mode, shaderValue, launch, boundKeys) {
+  const hlslSource = runtimeShaderHlslFor(shaderValue, runtimeShaderWorkload, launch);
+  const bound = boundKeys.get(hlslSource);
+  if (bound) {
+    setActiveShaderBundleKey(bound.keyLo, bound.keyHi);
+    return;
+  }
+  const spirv = await compileHlslToSpirv(hlslSource, "cs_6_0", runtimeShaderEntrypoint(runtimeShaderWorkload));
+  const sweepKeyLo = (runtimeSweepShaderKeyBase + boundKeys.size) >>> 0;
+  registerRuntimeShaderBundle(sweepKeyLo, runtimeSweepKeyHi, spirv, null, shaderValue);
+  setActiveShaderBundleKey(sweepKeyLo, runtimeSweepKeyHi);
+  runtime.ccall("webvulkan_runtime_reset_captured_shader_key", null, [], []);
+  setRuntimeLaunchOverride(launch);
+  let discoverRc;
+  try {
+    discoverRc = smokeFn();
+  } finally {
+    setRuntimeLaunchOverride(null);
+  }
+  if (discoverRc !== 0) {
+    throw new Error(`launch sweep discover_key failed with rc=${discoverRc} launch=${JSON.stringify(launch)}`);
+  }
+  if (runtime.ccall("webvulkan_runtime_has_captured_shader_key", "number", [], []) === 0) {
+    throw new Error(`driver did not report a shader key for launch sweep point ${JSON.stringify(launch)}`);
+  }
+  const keyLo = runtime.ccall("webvulkan_runtime_get_captured_shader_key_lo", "number", [], []) >>> 0;
+  const keyHi = runtime.ccall("webvulkan_runtime_get_captured_shader_key_hi", "number", [], []) >>> 0;
+  runtime.ccall("webvulkan_runtime_unregister_shader_bundle", "number", ["number", "number"], [
+    sweepKeyLo,
+    runtimeSweepKeyHi
+  ]);
+  registerRuntimeShaderBundle(keyLo, keyHi, spirv, null, shaderValue);
+  if (mode === "fast_wasm") {
+    registerRuntimeWasmKernel(keyLo, keyHi, runtimeSharedWasmModuleId, runtimeKernelExportName(runtimeShaderWorkload));
+  }
+  setActiveShaderBundleKey(keyLo, keyHi);
+  boundKeys.set(hlslSource, { keyLo, keyHi });
 }
 
-function invokeSmokeOnce() {
-  let rc = 0;
+/*
+ * Launch sweep: workgroup sizes 1..WEBVULKAN_RUNTIME_SWEEP_MAX_WORKGROUP_SIZE in
+ * powers of two, against every grid shape and dispatches-per-submit count. Each
+ * point is one persistent smoke call of WEBVULKAN_RUNTIME_SWEEP_SAMPLES fenced
+ * submits; points above the harness's invocations-per-submit cap are skipped.
+ * Prints one launch_sweep.point line per point and, with
+ * WEBVULKAN_RUNTIME_BENCH_JSON_DIR set, writes launch_sweep_<mode>_<workload>.csv
+ * and .json with one row per point, ready to pivot into a heatmap.
+ */
+async function runLaunchSweep(mode, shaderValue, mainKeyLo, mainKeyHi) {
+  if (runtimeSweepMaxWorkgroup === 0) {
+    return;
+  }
+  const shapes = runtimeSweepGridShapes();
+  const boundKeys = new Map();
+  const points = [];
+  let skipped = 0;
+  console.log(
+    `runtime smoke launch_sweep mode=${mode} workload=${runtimeShaderWorkload} ` +
+    `max_workgroup_size=${runtimeSweepMaxWorkgroup} samples=${runtimeSweepSamples}`
+  );
   try {
-    rc = smokeFn();
-  } catch (error) {
-    process.stderr.write(`smoke invocation threw: ${String(error)}\n`);
-    if (error && typeof error === "object") {
-      try {
-        const ownKeys = Object.getOwnPropertyNames(error);
-        process.stderr.write(`smoke invocation error keys: ${ownKeys.join(",")}\n`);
-        for (const key of ownKeys) {
-          process.stderr.write(`  ${key}=${String(error[key])}\n`);
+    for (let workgroupSizeX = 1; workgroupSizeX <= runtimeSweepMaxWorkgroup; workgroupSizeX *= 2) {
+      for (const shape of shapes) {
+        for (const dispatchesPerSubmit of runtimeSweepDispatchesPerSubmit) {
+          const launch = { ...shape, dispatchesPerSubmit, workgroupSizeX };
+          const invocationsPerDispatch = shape.dispatchX * shape.dispatchY * shape.dispatchZ * workgroupSizeX;
+          if (invocationsPerDispatch * dispatchesPerSubmit > runtimeLaunchMaxInvocationsPerSubmit) {
+            skipped += 1;
+            continue;
+          }
+          await bindRuntimeSweepShader(mode, shaderValue, launch, boundKeys);
+          setRuntimeLaunchOverride(launch);
+          setRuntimePersistentSamples(runtimeSweepSamples);
+          try {
+            invokeSmokeOnce();
+          } finally {
+            setRuntimePersistentSamples(0);
+            setRuntimeLaunchOverride(null);
+          }
+          const samplesMs = [];
+          for (let i = 0; i < runtimeSweepSamples; ++i) {
+            samplesMs.push(runtime.ccall("webvulkan_get_runtime_persistent_sample_ms", "number", ["number"], [i]));
+          }
+          const stats = computeTimingStats(samplesMs);
+          const point = {
+            mode,
+            workload: runtimeShaderWorkload,
+            dims: shape.dims,
+            grid_x: shape.dispatchX,
+            grid_y: shape.dispatchY,
+            grid_z: shape.dispatchZ,
+            workgroup_size: workgroupSizeX,
+            dispatches_per_submit: dispatchesPerSubmit,
+            invocations_per_dispatch: invocationsPerDispatch,
+            samples: samplesMs.length,
+            median_ms: stats.medianMs,
+            p90_ms: stats.p90Ms,
+            min_ms: stats.minMs,
+            ns_per_invocation: (stats.medianMs * 1_000_000.0) / invocationsPerDispatch,
+            // Every smoke run clears the driver's Wasm usage mark before it dispatches.
+            wasm_used: runtime.ccall("webvulkan_get_runtime_wasm_used", "number", [], []) !== 0
+          };
+          points.push(point);
+          console.log(
+            `launch_sweep.point mode=${mode} dims=${point.dims} ` +
+            `grid=${point.grid_x}x${point.grid_y}x${point.grid_z} workgroup_size=${workgroupSizeX} ` +
+            `dispatches_per_submit=${dispatchesPerSubmit} median_ms=${point.median_ms.toFixed(6)} ` +
+            `ns_per_invocation=${point.ns_per_invocation.toFixed(3)} wasm_used=${point.wasm_used ? "yes" : "no"}`
+          );
         }
-      } catch {
       }
     }
-    if (error && error.stack) {
-      process.stderr.write(`${error.stack}\n`);
+  } finally {
+    setRuntimeLaunchOverride(null);
+    setActiveShaderBundleKey(mainKeyLo, mainKeyHi);
+  }
+  console.log(`launch_sweep.summary mode=${mode} points=${points.length} skipped=${skipped} shaders=${boundKeys.size}`);
+  if (mode === "fast_wasm") {
+    const fallbackPoint = points.find((point) => !point.wasm_used);
+    if (fallbackPoint) {
+      throw new Error(
+        `fast_wasm mode failed: launch sweep point grid=${fallbackPoint.grid_x}x${fallbackPoint.grid_y}x` +
+        `${fallbackPoint.grid_z} workgroup_size=${fallbackPoint.workgroup_size} ` +
+        `dispatches_per_submit=${fallbackPoint.dispatches_per_submit} did not run on the runtime Wasm path`
+      );
     }
-    throw error;
+    console.log(`proof.launch_sweep_wasm_used=${points.length}/${points.length}`);
   }
-  if (rc !== 0) {
-    throw new Error(`Runtime smoke failed with rc=${rc}`);
+
+  if (!runtimeBenchJsonDir) {
+    return;
+  }
+  const columns = Object.keys(points[0]);
+  const csvLines = [columns.join(",")];
+  for (const point of points) {
+    csvLines.push(columns.map((column) => point[column]).join(","));
   }
+  await mkdir(runtimeBenchJsonDir, { recursive: true });
+  const reportBase = join(runtimeBenchJsonDir, `launch_sweep_${mode}_${runtimeShaderWorkload}`);
+  await writeFile(`${reportBase}.csv`, csvLines.join("\n") + "\n", "utf8");
+  await writeFile(
+    `${reportBase}.json`,
+    JSON.stringify({ mode, workload: runtimeShaderWorkload, samples: runtimeSweepSamples, skipped, points }, null, 2) + "\n",
+    "utf8"
+  );
+  console.log(`launch sweep report path=${reportBase}.csv`);
 }
 
-function invokeSmokeOnceWithTimingMs() {
-  invokeSmokeOnce();
-  const wallMs = runtime.ccall("webvulkan_get_last_dispatch_ms", "number", [], []);
-  if (!Number.isFinite(wallMs) || wallMs < 0) {
-    throw new Error(`Invalid dispatch wall time returned from smoke: ${wallMs}`);
+function setRuntimeMemoryGrowthCycles(cycles) {
+  const setCyclesRc = runtime.ccall(
+    "webvulkan_set_runtime_memory_growth_cycles",
+    "number",
+    ["number"],
+    [cycles]
+  );
+  if (setCyclesRc !== 0) {
+    throw new Error(`webvulkan_set_runtime_memory_growth_cycles failed with rc=${setCyclesRc} cycles=${cycles}`);
   }
-  return wallMs;
 }
 
-function summarizeDispatchTimings(mode, profile, samples) {
-  if (!samples.length) {
-    throw new Error(`No dispatch timing samples for mode=${mode}`);
+function getRuntimeMemoryFootprint() {
+  const footprint = {};
+  runtimeMemoryFields.forEach((field, index) => {
+    footprint[field] =
+      runtime.ccall("webvulkan_runtime_get_memory_footprint_value", "number", ["number"], [index]) >>> 0;
+  });
+  return footprint;
+}
+
+function renderMemoryGrowthSvg(title, samples) {
+  const series = [
+    { field: "malloc_in_use_bytes", color: "#1f77b4" },
+    { field: "malloc_footprint_bytes", color: "#ff7f0e" },
+    { field: "registry_payload_bytes", color: "#2ca02c" },
+    { field: "device_memory_bytes", color: "#d62728" }
+  ];
+  const width = 800;
+  const height = 400;
+  const margin = 48;
+  const maxCycle = Math.max(1, samples.length - 1);
+  const maxBytes = Math.max(1, ...samples.flatMap((sample) => series.map((line) => sample[line.field])));
+  const x = (cycle) => margin + ((width - 2 * margin) * cycle) / maxCycle;
+  const y = (bytes) => height - margin - ((height - 2 * margin) * bytes) / maxBytes;
+  const lines = [
+    `<svg xmlns="http://www.w3.org/2000/svg" width="${width}" height="${height}" font-family="sans-serif" font-size="12">`,
+    `<text x="${margin}" y="20">${title}</text>`,
+    `<text x="${margin}" y="${height - 12}">cycle 0..${maxCycle}</text>`,
+    `<text x="4" y="${margin - 8}">${(maxBytes / 1048576).toFixed(2)} MiB</text>`,
+    `<line x1="${margin}" y1="${height - margin}" x2="${width - margin}" y2="${height - margin}" stroke="#888"/>`,
+    `<line x1="${margin}" y1="${margin}" x2="${margin}" y2="${height - margin}" stroke="#888"/>`
+  ];
+  series.forEach((line, index) => {
+    const points = samples.map((sample, cycle) => `${x(cycle).toFixed(1)},${y(sample[line.field]).toFixed(1)}`);
+    lines.push(`<polyline fill="none" stroke="${line.color}" stroke-width="1.5" points="${points.join(" ")}"/>`);
+    lines.push(`<text x="${width - margin - 200}" y="${margin + 16 * index}" fill="${line.color}">${line.field}</text>`);
+  });
+  lines.push("</svg>");
+  return lines.join("\n") + "\n";
+}
+
+/*
+ * Creates and destroys the smoke compute pipeline N times inside one smoke call and
+ * samples the heap footprint after every cycle. A non-zero bytes_per_cycle on
+ * malloc_in_use_bytes is memory the driver keeps after vkDestroyPipeline; the run
+ * fails once it exceeds WEBVULKAN_RUNTIME_MEMORY_GROWTH_MAX_BYTES_PER_CYCLE.
+ */
+async function runMemoryGrowth(mode) {
+  if (runtimeMemoryGrowthCycles === 0) {
+    return;
   }
-  let minMs = samples[0];
-  let maxMs = samples[0];
-  let sumMs = 0.0;
-  for (const sample of samples) {
-    if (sample < minMs) {
-      minMs = sample;
-    }
-    if (sample > maxMs) {
-      maxMs = sample;
+  console.log(`runtime smoke memory_growth mode=${mode} cycles=${runtimeMemoryGrowthCycles}`);
+  setRuntimeMemoryGrowthCycles(runtimeMemoryGrowthCycles);
+  try {
+    invokeSmokeOnce();
+  } finally {
+    setRuntimeMemoryGrowthCycles(0);
+  }
+  const sampleCount = runtime.ccall("webvulkan_get_runtime_memory_growth_sample_count", "number", [], []) >>> 0;
+  if (sampleCount !== runtimeMemoryGrowthCycles + 1) {
+    throw new Error(`memory growth recorded ${sampleCount} samples, expected ${runtimeMemoryGrowthCycles + 1}`);
+  }
+  const samples = [];
+  for (let sample = 0; sample < sampleCount; ++sample) {
+    const point = { cycle: sample };
+    runtimeMemoryFields.forEach((field, index) => {
+      point[field] = runtime.ccall(
+        "webvulkan_get_runtime_memory_growth_sample",
+        "number",
+        ["number", "number"],
+        [sample, index]
+      ) >>> 0;
+    });
+    samples.push(point);
+    console.log(
+      `memory_growth.cycle mode=${mode} cycle=${sample} linear_bytes=${point.linear_bytes} ` +
+      `malloc_in_use_bytes=${point.malloc_in_use_bytes} malloc_footprint_bytes=${point.malloc_footprint_bytes} ` +
+      `registry_payload_bytes=${point.registry_payload_bytes} device_memory_bytes=${point.device_memory_bytes} ` +
+      `pipeline_heap_delta_bytes=${point.pipeline_heap_delta_bytes} live_pipelines=${point.live_pipelines}`
+    );
+    if (sample > 0 && point.live_pipelines === 0) {
+      throw new Error(`memory growth cycle ${sample} sampled no live pipeline`);
     }
-    sumMs += sample;
   }
-  const avgMs = sumMs / samples.length;
-  const profileDesc = runtimeBenchProfileDescriptor(profile);
-  const invocationsPerDispatch =
-    profileDesc.dispatchX *
-    profileDesc.dispatchY *
-    profileDesc.dispatchZ *
-    runtimeShaderThreadgroupSizeX(runtimeShaderWorkload);
-  const totalDispatchesPerRun = profileDesc.dispatchesPerSubmit * profileDesc.submitIterations;
-  const totalInvocationsPerRun = totalDispatchesPerRun * invocationsPerDispatch;
-  const minNsPerInvocation = (minMs * 1_000_000.0) / invocationsPerDispatch;
-  const avgNsPerInvocation = (avgMs * 1_000_000.0) / invocationsPerDispatch;
-  const maxNsPerInvocation = (maxMs * 1_000_000.0) / invocationsPerDispatch;
-  console.log("dispatch timing summary");
-  console.log(`  mode=${mode}`);
-  console.log(`  profile=${profile}`);
-  console.log(`  samples=${samples.length}`);
-  console.log(`  dispatches_per_submit=${profileDesc.dispatchesPerSubmit}`);
-  console.log(`  submit_iterations=${profileDesc.submitIterations}`);
-  console.log(`  total_dispatches_per_run=${totalDispatchesPerRun}`);
-  console.log(`  invocations_per_dispatch=${invocationsPerDispatch}`);
-  console.log(`  total_invocations_per_run=${totalInvocationsPerRun}`);
-  console.log(`  min_ms=${minMs.toFixed(6)}`);
-  console.log(`  avg_ms=${avgMs.toFixed(6)}`);
-  console.log(`  max_ms=${maxMs.toFixed(6)}`);
-  console.log(`  min_ns_per_invocation=${minNsPerInvocation.toFixed(3)}`);
-  console.log(`  avg_ns_per_invocation=${avgNsPerInvocation.toFixed(3)}`);
-  console.log(`  max_ns_per_invocation=${maxNsPerInvocation.toFixed(3)}`);
+  const first = samples[0];
+  const last = samples[samples.length - 1];
+  const bytesPerCycle = (last.malloc_in_use_bytes - first.malloc_in_use_bytes) / runtimeMemoryGrowthCycles;
+  const footprint = getRuntimeMemoryFootprint();
+  console.log(`memory_growth.summary mode=${mode}`);
+  console.log(`  cycles=${runtimeMemoryGrowthCycles}`);
+  console.log(`  bytes_per_cycle=${bytesPerCycle.toFixed(1)}`);
+  console.log(`  pipeline_heap_delta_bytes=${last.last_pipeline_heap_delta_bytes}`);
+  console.log(`  linear_bytes=${footprint.linear_bytes}`);
+  console.log(`  peak_malloc_footprint_bytes=${footprint.peak_malloc_footprint_bytes}`);
+  console.log(`  registry_payload_bytes=${footprint.registry_payload_bytes}`);
+  console.log(`  device_memory_bytes=${footprint.device_memory_bytes}`);
+  console.log(`  peak_device_memory_bytes=${footprint.peak_device_memory_bytes}`);
+  console.log(`  max_bytes_per_cycle=${runtimeMemoryGrowthMaxBytesPerCycle}`);
+
+  if (runtimeBenchJsonDir) {
+    await writeMemoryGrowthReport(mode, bytesPerCycle, footprint, samples);
+  }
+  if (bytesPerCycle > runtimeMemoryGrowthMaxBytesPerCycle) {
+    throw new Error(
+      `memory growth mode=${mode} leaks ${bytesPerCycle.toFixed(1)} bytes per cycle, ` +
+      `above WEBVULKAN_RUNTIME_MEMORY_GROWTH_MAX_BYTES_PER_CYCLE=${runtimeMemoryGrowthMaxBytesPerCycle}`
+    );
+  }
 }
 
-function setRuntimeBenchProfile(profileValue) {
-  const setProfileRc = runtime.ccall(
-    "webvulkan_set_runtime_bench_profile",
-    "number",
-    ["number"],
-    [profileValue]
+async function writeMemoryGrowthReport(mode, bytesPerCycle, footprint, samples) {
+  const columns = Object.keys(samples[0]);
+  const csvLines = [columns.join(",")];
+  for (const sample of samples) {
+    csvLines.push(columns.map((column) => sample[column]).join(","));
+  }
+  await mkdir(runtimeBenchJsonDir, { recursive: true });
+  const reportBase = join(runtimeBenchJsonDir, `memory_growth_${mode}_${runtimeShaderWorkload}`);
+  await writeFile(`${reportBase}.csv`, csvLines.join("\n") + "\n", "utf8");
+  await writeFile(
+    `${reportBase}.json`,
+    JSON.stringify(
+      { mode, workload: runtimeShaderWorkload, cycles: runtimeMemoryGrowthCycles, bytes_per_cycle: bytesPerCycle, footprint, samples },
+      null,
+      2
+    ) + "\n",
+    "utf8"
   );
-  if (setProfileRc !== 0) {
-    throw new Error(`webvulkan_set_runtime_bench_profile failed with rc=${setProfileRc}`);
+  await writeFile(
+    `${reportBase}.svg`,
+    renderMemoryGrowthSvg(`memory growth ${mode} ${runtimeShaderWorkload}`, samples),
+    "utf8"
+  );
+  console.log(`memory growth report path=${reportBase}.csv`);
+}
+
+function enableRuntimeTrace(capacity) {
+  const rc = runtime.ccall("webvulkan_runtime_trace_enable", "number", ["number"], [capacity >>> 0]);
+  if (rc !== 0) {
+    throw new Error(`webvulkan_runtime_trace_enable failed rc=${rc} capacity=${capacity}`);
+  }
+}
+
+async function writeRuntimeTrace() {
+  if (runtimeTraceEvents === 0) {
+    return;
+  }
+  const events = runtime.ccall("webvulkan_runtime_trace_get_event_count", "number", [], []) >>> 0;
+  const dropped = runtime.ccall("webvulkan_runtime_trace_get_dropped_count", "number", [], []) >>> 0;
+  const traceJson = runtime.ccall("webvulkan_runtime_trace_export_json", "string", [], []);
+  if (!traceJson) {
+    throw new Error(`webvulkan_runtime_trace_export_json failed events=${events}`);
   }
+  const trace = JSON.parse(traceJson);
+  console.log(`runtime trace events=${events} dropped=${dropped} exported=${trace.traceEvents.length}`);
+  if (!runtimeBenchJsonDir) {
+    return;
+  }
+  await mkdir(runtimeBenchJsonDir, { recursive: true });
+  const tracePath = join(runtimeBenchJsonDir, `trace_${runtimeExecutionMode}_${runtimeShaderWorkload}.json`);
+  await writeFile(tracePath, traceJson, "utf8");
+  console.log(`runtime trace path=${tracePath}`);
 }
 
 function setRuntimeShaderWorkload(workloadValue) {
@@ -478,6 +2492,167 @@ function setRuntimeShaderWorkload(workloadValue) {
   }
 }
 
+function setRuntimeSubgroupSize(subgroupSize) {
+  const setSubgroupRc = runtime.ccall(
+    "webvulkan_set_runtime_subgroup_size",
+    "number",
+    ["number"],
+    [subgroupSize]
+  );
+  if (setSubgroupRc !== 0) {
+    throw new Error(`webvulkan_set_runtime_subgroup_size failed with rc=${setSubgroupRc}`);
+  }
+}
+
+function setRuntimeSpecializationConstants(specialization) {
+  const setSpecRc = runtime.ccall(
+    "webvulkan_set_runtime_specialization_constants",
+    "number",
+    ["number", "number"],
+    [specialization.tileSize, specialization.tileRepeats]
+  );
+  if (setSpecRc !== 0) {
+    throw new Error(`webvulkan_set_runtime_specialization_constants failed with rc=${setSpecRc}`);
+  }
+  const identityRc = runtime.ccall("webvulkan_check_runtime_specialization_identity", "number", [], []);
+  if (identityRc !== 0) {
+    throw new Error(`specialization keys do not follow the constant set, rc=${identityRc}`);
+  }
+  return runtime.ccall("webvulkan_get_runtime_specialization_key", "number", [], []) >>> 0;
+}
+
+function setRuntimeShaderSpecialization(keyLo, keyHi, specializationKey) {
+  const setRc = runtime.ccall(
+    "webvulkan_runtime_set_shader_specialization",
+    "number",
+    ["number", "number", "number"],
+    [keyLo, keyHi, specializationKey >>> 0]
+  );
+  if (setRc !== 0) {
+    throw new Error(`webvulkan_runtime_set_shader_specialization failed with rc=${setRc}`);
+  }
+}
+
+function setRuntimeShaderDispatchGrid(keyLo, keyHi, grid) {
+  const setRc = runtime.ccall(
+    "webvulkan_runtime_set_shader_dispatch_grid",
+    "number",
+    ["number", "number", "number", "number", "number"],
+    [keyLo, keyHi, grid.groupCountX, grid.groupCountY, grid.groupCountZ]
+  );
+  if (setRc !== 0) {
+    throw new Error(`webvulkan_runtime_set_shader_dispatch_grid failed with rc=${setRc}`);
+  }
+}
+
+function registerRuntimeSpecializedWasmModule(keyLo, keyHi, specializationKey, grid, runtimeWasmModule) {
+  const registerRc = runtime.ccall(
+    "webvulkan_register_runtime_wasm_module_for_grid",
+    "number",
+    ["number", "number", "number", "number", "number", "number", "array", "number", "string", "string"],
+    [
+      keyLo,
+      keyHi,
+      specializationKey >>> 0,
+      grid ? grid.groupCountX : 0,
+      grid ? grid.groupCountY : 0,
+      grid ? grid.groupCountZ : 0,
+      runtimeWasmModule.bytes,
+      runtimeWasmModule.bytes.length,
+      runtimeWasmModule.entrypoint,
+      runtimeWasmModule.provider
+    ]
+  );
+  if (registerRc !== 0) {
+    throw new Error(`webvulkan_register_runtime_wasm_module_for_grid failed with rc=${registerRc}`);
+  }
+}
+
+function registerRuntimeSharedWasmModule(moduleId, runtimeWasmModule) {
+  const registerRc = runtime.ccall(
+    "webvulkan_register_runtime_wasm_shared_module",
+    "number",
+    ["number", "array", "number", "string"],
+    [moduleId, runtimeWasmModule.bytes, runtimeWasmModule.bytes.length, runtimeWasmModule.provider]
+  );
+  if (registerRc !== 0) {
+    throw new Error(`webvulkan_register_runtime_wasm_shared_module failed with rc=${registerRc}`);
+  }
+}
+
+function registerRuntimeWasmKernel(keyLo, keyHi, moduleId, exportName) {
+  const registerRc = runtime.ccall(
+    "webvulkan_register_runtime_wasm_kernel",
+    "number",
+    ["number", "number", "number", "number", "number", "number", "number", "string"],
+    [keyLo, keyHi, 0, 0, 0, 0, moduleId, exportName]
+  );
+  if (registerRc !== 0) {
+    throw new Error(`webvulkan_register_runtime_wasm_kernel failed with rc=${registerRc} export=${exportName}`);
+  }
+}
+
+// Two kernels of one shared module bind to its single instance; a failed rebind keeps the old one.
+function checkSharedModuleKernels(moduleId) {
+  const probeExports = [runtimeKernelExportName("write_const"), runtimeKernelExportName("atomic_single_counter")];
+  const instantiationsBefore = getRuntimeWasmInstanceCounts().instantiationCount;
+  const bindings = [];
+  const instances = [];
+  for (let i = 0; i < probeExports.length; ++i) {
+    const keyLo = (runtimeSharedKernelProbeKeyBase + i) >>> 0;
+    registerRuntimeWasmKernel(keyLo, runtimeSharedKernelProbeKeyHi, moduleId, probeExports[i]);
+    bindings.push(
+      runtime.ccall("webvulkan_runtime_get_wasm_kernel_binding", "number", ["number", "number"], [
+        keyLo,
+        runtimeSharedKernelProbeKeyHi
+      ]) >>> 0
+    );
+    instances.push(
+      runtime.ccall("webvulkan_runtime_get_wasm_kernel_instance", "number", ["number", "number"], [
+        keyLo,
+        runtimeSharedKernelProbeKeyHi
+      ]) >>> 0
+    );
+  }
+  const probeInstantiations = getRuntimeWasmInstanceCounts().instantiationCount - instantiationsBefore;
+  if (probeInstantiations !== 0) {
+    throw new Error(`shared module kernels instantiated the module again (${probeInstantiations} times)`);
+  }
+  if (bindings.includes(0) || bindings[0] === bindings[1]) {
+    throw new Error(`shared module kernels did not get distinct bindings: ${bindings.join(",")}`);
+  }
+  if (instances[0] === 0 || instances[0] !== instances[1]) {
+    throw new Error(`shared module kernels resolved different instances: ${instances.join(",")}`);
+  }
+
+  console.log("runtime smoke shared_module_check rebinding to a missing export (one error expected)");
+  const failedRc = runtime.ccall(
+    "webvulkan_register_runtime_wasm_kernel",
+    "number",
+    ["number", "number", "number", "number", "number", "number", "number", "string"],
+    [runtimeSharedKernelProbeKeyBase, runtimeSharedKernelProbeKeyHi, 0, 0, 0, 0, moduleId, "webvulkan_missing_kernel"]
+  );
+  if (failedRc !== -8) {
+    throw new Error(`rebinding a kernel to a missing export returned rc=${failedRc}, expected -8`);
+  }
+  const keptBinding = runtime.ccall("webvulkan_runtime_get_wasm_kernel_binding", "number", ["number", "number"], [
+    runtimeSharedKernelProbeKeyBase,
+    runtimeSharedKernelProbeKeyHi
+  ]) >>> 0;
+  if (keptBinding !== bindings[0]) {
+    throw new Error(`failed kernel rebind dropped the previous binding (${bindings[0]} -> ${keptBinding})`);
+  }
+
+  for (let i = 0; i < probeExports.length; ++i) {
+    runtime.ccall("webvulkan_runtime_unregister_shader_bundle", "number", ["number", "number"], [
+      (runtimeSharedKernelProbeKeyBase + i) >>> 0,
+      runtimeSharedKernelProbeKeyHi
+    ]);
+  }
+  console.log(`proof.shared_module_kernels=${probeExports.length} instance=${instances[0]}`);
+  console.log("proof.failed_rebind_kept_binding=yes");
+}
+
 function clearRuntimeShaderBundles() {
   runtime.ccall("webvulkan_runtime_clear_shader_bundles", null, [], []);
 }
@@ -551,13 +2726,42 @@ function getRuntimeRegisteredBundleCounts() {
   return { spirvCount, wasmCount };
 }
 
+function getRuntimeWasmInstanceCounts() {
+  const liveCount = runtime.ccall("webvulkan_runtime_get_live_wasm_instance_count", "number", [], []) >>> 0;
+  const instantiationCount = runtime.ccall("webvulkan_runtime_get_wasm_instantiation_count", "number", [], []) >>> 0;
+  const gridLookupHitCount =
+    runtime.ccall("webvulkan_runtime_get_wasm_grid_lookup_hit_count", "number", [], []) >>> 0;
+  return {
+    liveCount,
+    instantiationCount,
+    gridLookupHitCount
+  };
+}
+
 async function runFastWasmSmoke(shaderValue) {
+  if (runtimeLlvmpipeOnlyWorkloads.has(runtimeShaderWorkload)) {
+    throw new Error(`fast_wasm mode has no kernel for the '${runtimeShaderWorkload}' workload; run it in raw_llvm_ir mode`);
+  }
+  // The pinned Mesa fork hands Wasm kernels no push constants, so a kernel could only miss them.
+  if (runtimeBenchProfileDescriptor(runtimeBenchProfile).paramMode === "push_constant") {
+    throw new Error(`fast_wasm mode cannot run the '${runtimeBenchProfile}' profile; run it in raw_llvm_ir mode`);
+  }
   const spirv = await compileRuntimeSpirv(shaderValue, runtimeShaderWorkload);
-  const runtimeWasm = await compileRuntimeLlvmirToWasm();
+  setRuntimeSubgroupSize(runtimeFastWasmSubgroupSize);
+  const runtimeWasm = await compileRuntimeLlvmirToWasmCached();
+  const specialization = runtimeKernelSpecializationFor(runtimeShaderWorkload);
+  const specializedWasm = specialization ? await compileRuntimeLlvmirToWasmCached(specialization) : null;
+  if (runtimeShaderWorkload === "subgroup_reduction") {
+    await checkSubgroupKernelAtSize(runtimeSubgroupCheckSize);
+  }
   setRuntimeBenchProfile(runtimeBenchProfileValue);
   setRuntimeShaderWorkload(runtimeShaderWorkloadValue);
+  const specializationKey = specialization && specialization.tileSize !== undefined ?
+    setRuntimeSpecializationConstants(specialization) :
+    0;
   clearRuntimeShaderBundles();
   runtime.ccall("webvulkan_runtime_reset_captured_shader_key", null, [], []);
+  runtime.ccall("webvulkan_runtime_reset_wasm_instance_counters", null, [], []);
   setRuntimeDispatchModeFastWasm(true);
   setActiveShaderBundleKey(runtimeDefaultKeyLo, runtimeDefaultKeyHi);
   registerRuntimeShaderBundle(runtimeDefaultKeyLo, runtimeDefaultKeyHi, spirv, null, shaderValue);
@@ -565,6 +2769,7 @@ async function runFastWasmSmoke(shaderValue) {
   console.log("runtime shader compile ok");
   console.log(`  mode=fast_wasm`);
   console.log(`  profile=${runtimeBenchProfile}`);
+  console.log(`  kernel_specialization=${runtimeKernelSpecialization}`);
   console.log(`  shader.workload=${runtimeShaderWorkload}`);
   console.log(`  shader.value=0x${shaderValue.toString(16).padStart(8, "0")}`);
   console.log(`  spirv.provider=${spirv.provider}`);
@@ -573,6 +2778,12 @@ async function runFastWasmSmoke(shaderValue) {
   console.log(`  runtime_wasm.provider=${runtimeWasm.provider}`);
   console.log(`  runtime_wasm.entrypoint=${runtimeWasm.entrypoint}`);
   console.log(`  runtime_wasm.bytes=${runtimeWasm.bytes.length}`);
+  console.log(`  runtime_wasm.subgroup_size=${runtimeKernelSubgroupSize(null)}`);
+  if (specializedWasm) {
+    console.log(`  runtime_wasm.specialized.cache_key=${specializedWasm.cacheKey}`);
+    console.log(`  runtime_wasm.specialized.provider=${specializedWasm.provider}`);
+    console.log(`  runtime_wasm.specialized.bytes=${specializedWasm.bytes.length}`);
+  }
   const bootstrapCounts = getRuntimeRegisteredBundleCounts();
   console.log(`  runtime_registry.bootstrap.spirv=${bootstrapCounts.spirvCount}`);
   console.log(`  runtime_registry.bootstrap.wasm=${bootstrapCounts.wasmCount}`);
@@ -594,22 +2805,84 @@ async function runFastWasmSmoke(shaderValue) {
 
   const capturedKeyLo = runtime.ccall("webvulkan_runtime_get_captured_shader_key_lo", "number", [], []) >>> 0;
   const capturedKeyHi = runtime.ccall("webvulkan_runtime_get_captured_shader_key_hi", "number", [], []) >>> 0;
-  registerRuntimeShaderBundle(capturedKeyLo, capturedKeyHi, spirv, runtimeWasm, shaderValue);
+  registerRuntimeShaderBundle(capturedKeyLo, capturedKeyHi, spirv, null, shaderValue);
+  registerRuntimeSharedWasmModule(runtimeSharedWasmModuleId, runtimeWasm);
+  registerRuntimeWasmKernel(
+    capturedKeyLo,
+    capturedKeyHi,
+    runtimeSharedWasmModuleId,
+    runtimeKernelExportName(runtimeShaderWorkload)
+  );
+  checkSharedModuleKernels(runtimeSharedWasmModuleId);
   setActiveShaderBundleKey(capturedKeyLo, capturedKeyHi);
   console.log(`runtime shader key captured=0x${capturedKeyHi.toString(16).padStart(8, "0")}${capturedKeyLo.toString(16).padStart(8, "0")}`);
+  if (specializedWasm) {
+    registerRuntimeSpecializedWasmModule(
+      capturedKeyLo,
+      capturedKeyHi,
+      specializationKey,
+      specialization.grid || null,
+      specializedWasm
+    );
+    // Pipelines of this key use these constants; a miss now takes llvmpipe, not the generic kernel.
+    setRuntimeShaderSpecialization(capturedKeyLo, capturedKeyHi, specializationKey);
+    if (specialization.grid) {
+      setRuntimeShaderDispatchGrid(capturedKeyLo, capturedKeyHi, specialization.grid);
+    }
+    const specializedCount = runtime.ccall(
+      "webvulkan_runtime_get_registered_specialized_wasm_count",
+      "number",
+      [],
+      []
+    ) >>> 0;
+    const gridCount = runtime.ccall("webvulkan_runtime_get_registered_grid_wasm_count", "number", [], []) >>> 0;
+    console.log(
+      `runtime specialization key=${specializationKey} ` +
+      `specialized_wasm=${specializedCount} grid_wasm=${gridCount}`
+    );
+  }
   const capturedCounts = getRuntimeRegisteredBundleCounts();
-  console.log(`runtime registry counts spirv=${capturedCounts.spirvCount} wasm=${capturedCounts.wasmCount}`);
+  const sharedModuleCount = runtime.ccall(
+    "webvulkan_runtime_get_registered_shared_wasm_module_count",
+    "number",
+    [],
+    []
+  ) >>> 0;
+  console.log(
+    `runtime registry counts spirv=${capturedCounts.spirvCount} wasm=${capturedCounts.wasmCount} ` +
+    `shared_modules=${sharedModuleCount}`
+  );
+  console.log(`runtime wasm module cache entries=${runtimeWasmModuleCache.size} compiles=${runtimeWasmCompileCount}`);
+  const registrationInstanceCounts = getRuntimeWasmInstanceCounts();
+  console.log(
+    `runtime wasm instance pool live=${registrationInstanceCounts.liveCount} ` +
+    `instantiations=${registrationInstanceCounts.instantiationCount}`
+  );
 
   for (let i = 0; i < runtimeWarmupIterations; ++i) {
     console.log(`runtime smoke warmup mode=fast_wasm run=${i + 1}/${runtimeWarmupIterations}`);
     invokeSmokeOnce();
   }
 
-  const samplesMs = [];
-  for (let i = 0; i < runtimeBenchIterations; ++i) {
-    console.log(`runtime smoke benchmark mode=fast_wasm run=${i + 1}/${runtimeBenchIterations}`);
-    samplesMs.push(invokeSmokeOnceWithTimingMs());
+  /*
+   * Every sampled run creates its pipeline, so it may instantiate a fixed handful of
+   * modules. An instantiation per submit or per dispatch reaches the submit count.
+   */
+  const sampledRuns = runtimePersistentSamples === 0 ? runtimeBenchIterations : 1;
+  const submitsPerRun = runtimePersistentSamples === 0 ?
+    runtimeBenchProfileDescriptor(runtimeBenchProfile).submitIterations :
+    runtimePersistentSamples;
+  const instantiationsBeforeSamples = runtimeProcessWasmInstantiations;
+  const samplesMs = collectDispatchSamplesMs("fast_wasm");
+  const dispatchInstantiations = runtimeProcessWasmInstantiations - instantiationsBeforeSamples;
+  const dispatchInstanceCounts = getRuntimeWasmInstanceCounts();
+  if (dispatchInstantiations >= sampledRuns * submitsPerRun) {
+    throw new Error(
+      `fast_wasm mode failed: ${dispatchInstantiations} Wasm instantiations over ${sampledRuns} sampled runs ` +
+      `of ${submitsPerRun} submits, so instantiation happens on the dispatch path`
+    );
   }
+  const profileParamMode = runtimeBenchProfileDescriptor(runtimeBenchProfile).paramMode || "none";
 
   const provider = runtime.ccall("webvulkan_get_runtime_wasm_provider", "string", [], []) || "none";
   const wasmUsed = runtime.ccall("webvulkan_get_runtime_wasm_used", "number", [], []) !== 0;
@@ -620,19 +2893,146 @@ async function runFastWasmSmoke(shaderValue) {
     throw new Error("fast_wasm mode failed: provider is inline-wasm-module");
   }
 
-  summarizeDispatchTimings("fast_wasm", runtimeBenchProfile, samplesMs);
+  // The driver's pipeline lookups must resolve the grid entry and run its module.
+  let timingModeName = "fast_wasm";
+  const gridLookupHits = dispatchInstanceCounts.gridLookupHitCount - registrationInstanceCounts.gridLookupHitCount;
+  if (specialization && specialization.grid) {
+    if (gridLookupHits === 0 || !provider.includes("+grid-specialized")) {
+      throw new Error(
+        `fast_wasm_grid_specialized failed: driver lookups hit the grid entry ${gridLookupHits} times ` +
+        `and ran provider '${provider}'`
+      );
+    }
+    timingModeName = "fast_wasm_grid_specialized";
+  }
+
+  await summarizeDispatchTimings(timingModeName, runtimeBenchProfile, samplesMs);
   console.log("proof.execute_path=fast_wasm");
   console.log("proof.interpreter=disabled_for_dispatch");
   console.log(`proof.llvm_ir_wasm_provider=${provider}`);
+  if (specializationKey !== 0) {
+    console.log(`proof.specialization_key=${specializationKey}`);
+    console.log("proof.specialization_identity=yes");
+  }
+  if (specialization && specialization.grid) {
+    console.log("proof.grid_specialized_module_used=yes");
+    console.log(`proof.wasm_grid_lookup_hits=${gridLookupHits}`);
+  }
+  console.log(`proof.wasm_instantiations_at_registration=${registrationInstanceCounts.instantiationCount}`);
+  console.log(`proof.wasm_instantiations_during_samples=${dispatchInstantiations}`);
+  console.log(`proof.wasm_sampled_runs=${sampledRuns}`);
+  if (profileParamMode !== "none") {
+    console.log(`proof.param_mode=${profileParamMode}`);
+  }
+  if (runtimeShaderWorkload === "buffer_copy") {
+    checkZeroCopyStorage();
+    console.log("proof.zero_copy_storage=yes");
+  }
+  if (runtimeShaderWorkload === "subgroup_reduction") {
+    console.log(`proof.subgroup_size=${runtimeKernelSubgroupSize(null)}`);
+    console.log(`proof.subgroup_kernel_checked_at_size=${runtimeSubgroupCheckSize}`);
+  }
+  runPipelineBench("fast_wasm");
+  runTransferBench("fast_wasm");
+  await runBandwidthBench("fast_wasm");
+  await runPrimitiveBench("fast_wasm");
+  await runRenderBench("fast_wasm");
+  await runVertexBench("fast_wasm");
+  await runLaunchSweep("fast_wasm", shaderValue, capturedKeyLo, capturedKeyHi);
+  await runMemoryGrowth("fast_wasm");
+}
+
+/*
+ * Runs the subgroup_reduction kernel of a module built for another subgroup size on
+ * the module's own memory, outside the driver, whose device subgroup size is fixed.
+ * For G workgroups of W lanes in subgroups of S lanes, n = W / S, the words are
+ * G*W*(W+1)/2, G*n, G*W/2 and G*S*n*(n-1)/2. A W that S does not divide must trap.
+ */
+async function checkSubgroupKernelAtSize(subgroupSize) {
+  const compiled = await compileRuntimeLlvmirToWasmCached({ subgroupSize });
+  const instance = new WebAssembly.Instance(new WebAssembly.Module(compiled.bytes), {});
+  const memory = instance.exports.memory;
+  const kernel = instance.exports[runtimeKernelExportName("subgroup_reduction")];
+  const workloadValue = runtimeShaderWorkloadMap.get("subgroup_reduction");
+  const groups = 3;
+  const workgroupSize = subgroupSize * 4;
+  const subgroups = workgroupSize / subgroupSize;
+  const dst = memory.grow(1) * 65536;
+  kernel(dst, 0, 0, workloadValue, groups * workgroupSize, groups);
+  const observed = new Uint32Array(memory.buffer, dst, 4);
+  const expected = [
+    (groups * workgroupSize * (workgroupSize + 1)) / 2,
+    groups * subgroups,
+    (groups * workgroupSize) / 2,
+    (groups * subgroupSize * subgroups * (subgroups - 1)) / 2
+  ];
+  for (let i = 0; i < expected.length; ++i) {
+    if (observed[i] !== expected[i]) {
+      throw new Error(
+        `subgroup_reduction at subgroup size ${subgroupSize} wrote word ${i}=${observed[i]}, expected ${expected[i]}`
+      );
+    }
+  }
+  let trapped = false;
+  try {
+    kernel(dst + 16, 0, 0, workloadValue, subgroupSize + subgroupSize / 2, 1);
+  } catch (error) {
+    if (!(error instanceof WebAssembly.RuntimeError)) {
+      throw error;
+    }
+    trapped = true;
+  }
+  if (!trapped) {
+    throw new Error(`subgroup_reduction at subgroup size ${subgroupSize} accepted a partial subgroup`);
+  }
+}
+
+/*
+ * The buffer_copy kernel writes the storage address the driver handed it after the
+ * copy destination. It must lie inside the buffer the harness mapped, or the shim
+ * copied storage into the kernel's own memory and back.
+ */
+function checkZeroCopyStorage() {
+  const dst = runtime.ccall("webvulkan_get_last_kernel_storage_address", "number", [], []) >>> 0;
+  if (dst === 0) {
+    throw new Error("fast_wasm mode failed: the buffer_copy kernel did not report its storage address");
+  }
+  const base = runtime.ccall("webvulkan_get_last_mapped_storage_base", "number", [], []) >>> 0;
+  const bytes = runtime.ccall("webvulkan_get_last_mapped_storage_bytes", "number", [], []) >>> 0;
+  if (base === 0 || bytes === 0) {
+    throw new Error("fast_wasm mode failed: the harness did not record its mapped storage range");
+  }
+  if (dst < base || dst >= base + bytes) {
+    throw new Error(
+      `fast_wasm mode failed: kernel storage address 0x${dst.toString(16)} is outside the mapped range ` +
+      `0x${base.toString(16)}+${bytes}, so storage went through a copy`
+    );
+  }
 }
 
+// Workloads with an llvmpipe baseline target next to their fast_wasm one.
+const runtimeRawLlvmIrWorkloads = new Set([
+  "write_const",
+  "spec_constant_tiles",
+  "image_box_filter",
+  "push_constant_param"
+]);
+
 async function runRawLlvmIrSmoke(shaderValue) {
-  if (runtimeShaderWorkload !== "write_const") {
-    throw new Error(`raw_llvm_ir mode currently supports only write_const workload, got '${runtimeShaderWorkload}'`);
+  if (!runtimeRawLlvmIrWorkloads.has(runtimeShaderWorkload)) {
+    throw new Error(
+      `raw_llvm_ir mode currently supports only ${[...runtimeRawLlvmIrWorkloads].join(", ")} workloads, ` +
+      `got '${runtimeShaderWorkload}'`
+    );
   }
   const spirv = await compileRuntimeSpirv(shaderValue, runtimeShaderWorkload);
   setRuntimeBenchProfile(runtimeBenchProfileValue);
   setRuntimeShaderWorkload(runtimeShaderWorkloadValue);
+  // Same spec constants as fast_wasm, so the pair is an A/B of one specialized pipeline.
+  const specialization = runtimeKernelSpecializationFor(runtimeShaderWorkload);
+  const specializationKey = specialization && specialization.tileSize !== undefined ?
+    setRuntimeSpecializationConstants(specialization) :
+    0;
   clearRuntimeShaderBundles();
   runtime.ccall("webvulkan_runtime_reset_captured_shader_key", null, [], []);
   setRuntimeDispatchModeFastWasm(false);
@@ -672,11 +3072,7 @@ async function runRawLlvmIrSmoke(shaderValue) {
     invokeSmokeOnce();
   }
 
-  const samplesMs = [];
-  for (let i = 0; i < runtimeBenchIterations; ++i) {
-    console.log(`runtime smoke benchmark mode=raw_llvm_ir run=${i + 1}/${runtimeBenchIterations}`);
-    samplesMs.push(invokeSmokeOnceWithTimingMs());
-  }
+  const samplesMs = collectDispatchSamplesMs("raw_llvm_ir");
 
   const provider = runtime.ccall("webvulkan_get_runtime_wasm_provider", "string", [], []) || "none";
   const wasmUsed = runtime.ccall("webvulkan_get_runtime_wasm_used", "number", [], []) !== 0;
@@ -684,20 +3080,40 @@ async function runRawLlvmIrSmoke(shaderValue) {
     throw new Error(`raw_llvm_ir mode failed: runtime Wasm path should be disabled, provider=${provider}`);
   }
 
-  summarizeDispatchTimings("raw_llvm_ir", runtimeBenchProfile, samplesMs);
+  await summarizeDispatchTimings("raw_llvm_ir", runtimeBenchProfile, samplesMs);
   console.log("proof.execute_path=raw_llvm_ir");
+  const profileParamMode = runtimeBenchProfileDescriptor(runtimeBenchProfile).paramMode || "none";
+  if (profileParamMode !== "none") {
+    console.log(`proof.param_mode=${profileParamMode}`);
+  }
+  if (specializationKey !== 0) {
+    console.log(`proof.specialization_key=${specializationKey}`);
+    console.log("proof.specialization_identity=yes");
+  }
   console.log(`proof.fast_wasm_provider=${provider}`);
+  runPipelineBench("raw_llvm_ir");
+  runTransferBench("raw_llvm_ir");
+  await runBandwidthBench("raw_llvm_ir");
+  await runPrimitiveBench("raw_llvm_ir");
+  await runRenderBench("raw_llvm_ir");
+  await runVertexBench("raw_llvm_ir");
+  await runLaunchSweep("raw_llvm_ir", shaderValue, capturedKeyLo, capturedKeyHi);
+  await runMemoryGrowth("raw_llvm_ir");
 }
 
 if (!requireRuntimeSpirv) {
   invokeSmokeOnce();
 } else {
   const runtimeShaderValue = 0x12345678 >>> 0;
+  if (runtimeTraceEvents !== 0) {
+    enableRuntimeTrace(runtimeTraceEvents);
+  }
   if (runtimeExecutionMode === "fast_wasm") {
     await runFastWasmSmoke(runtimeShaderValue);
   } else {
     await runRawLlvmIrSmoke(runtimeShaderValue);
   }
+  await writeRuntimeTrace();
 }
 
 console.log("runtime smoke passed");
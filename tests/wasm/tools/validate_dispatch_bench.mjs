@@ -1,4 +1,8 @@
-import { readFile, writeFile } from "node:fs/promises";
+import { mkdir, readFile, writeFile } from "node:fs/promises";
+import { basename, join } from "node:path";
+import { fileURLToPath } from "node:url";
+
+import { bootstrapRatioInterval, computeTimingStats } from "./bench_stats.mjs";
 
 function parsePositiveFloat(value, label) {
   const parsed = Number.parseFloat(value);
@@ -8,6 +12,15 @@ function parsePositiveFloat(value, label) {
   return parsed;
 }
 
+/* A single sample can round to 0.000000 ms on a fast path, so only negatives are invalid. */
+function parseNonNegativeFloat(value, label) {
+  const parsed = Number.parseFloat(value);
+  if (!Number.isFinite(parsed) || parsed < 0.0) {
+    throw new Error(`Invalid ${label}: '${value}'`);
+  }
+  return parsed;
+}
+
 function envThresholdForProfile(profileName) {
   const profileEnvKey = `WEBVULKAN_BENCH_MIN_SPEEDUP_${profileName.toUpperCase()}`;
   const profileOverride = process.env[profileEnvKey];
@@ -15,6 +28,13 @@ function envThresholdForProfile(profileName) {
   return parsePositiveFloat(profileOverride || globalDefault, profileEnvKey);
 }
 
+function envRegressionToleranceForProfile(profileName) {
+  const profileEnvKey = `WEBVULKAN_BENCH_REGRESSION_TOLERANCE_${profileName.toUpperCase()}`;
+  const profileOverride = process.env[profileEnvKey];
+  const globalDefault = process.env.WEBVULKAN_BENCH_REGRESSION_TOLERANCE || "0.15";
+  return parsePositiveFloat(profileOverride || globalDefault, profileEnvKey);
+}
+
 function normalizeRequiredProfiles() {
   const rawProfiles = process.env.WEBVULKAN_BENCH_REQUIRED_PROFILES || "dispatch_overhead,balanced_grid";
   return rawProfiles
@@ -34,10 +54,19 @@ function pushSummaryIfComplete(block, sink) {
   if (!Number.isFinite(avgMs) || avgMs <= 0.0) {
     throw new Error(`Invalid avg_ms in summary block: '${block.avg_ms}'`);
   }
+  /* Logs from before samples_ms was printed contribute their average as one sample. */
+  let samplesMs = [avgMs];
+  if (block.samples_ms) {
+    samplesMs = block.samples_ms.split(",").map((value) => parseNonNegativeFloat(value, "samples_ms entry"));
+  }
   sink.push({
     mode: block.mode,
     profile: block.profile,
-    avgMs
+    /* Logs from before workload and timing were printed only ran write_const per call. */
+    workload: block.workload || "write_const",
+    timing: block.timing || "per_call",
+    avgMs,
+    samplesMs
   });
 }
 
@@ -74,6 +103,37 @@ function parseSummaryBlocks(logText) {
   return summaries;
 }
 
+/* dispatch_bench_<mode>_<profile>_<workload>_<timing>.json as written by smoke_runtime.mjs. */
+function parseSummaryReport(reportText, reportPath) {
+  const report = JSON.parse(reportText);
+  if (!report.mode || !report.profile || !Array.isArray(report.samples_ms) || !report.samples_ms.length) {
+    throw new Error(`Benchmark report '${reportPath}' has no mode/profile/samples_ms entries`);
+  }
+  const samplesMs = report.samples_ms.map((value) => parseNonNegativeFloat(String(value), "samples_ms entry"));
+  return {
+    mode: report.mode,
+    profile: report.profile,
+    workload: report.workload || "write_const",
+    timing: report.timing || "per_call",
+    avgMs: average(samplesMs),
+    samplesMs
+  };
+}
+
+function statsReport(stats) {
+  return {
+    samples: stats.count,
+    outliers_rejected: stats.outliers,
+    median_ms: stats.medianMs,
+    p90_ms: stats.p90Ms,
+    p99_ms: stats.p99Ms,
+    stddev_ms: stats.stddevMs,
+    trimmed_mean_ms: stats.trimmedMeanMs,
+    ci95_low_ms: stats.ciLowMs,
+    ci95_high_ms: stats.ciHighMs
+  };
+}
+
 function average(values) {
   if (!values.length) {
     throw new Error("Cannot average an empty value list");
@@ -81,18 +141,80 @@ function average(values) {
   return values.reduce((sum, value) => sum + value, 0.0) / values.length;
 }
 
-function ensureModeEntries(mapByProfile, profileName, modeName) {
-  const byMode = mapByProfile.get(profileName);
-  if (!byMode || !byMode.has(modeName)) {
-    throw new Error(`Missing benchmark summary for profile='${profileName}' mode='${modeName}'`);
+/*
+ * Samples are printed with six decimals, so a 0.000000 sample only says the run
+ * took less than one microsecond. The speedup interval floors fast_wasm samples
+ * at that resolution so a resample of zeros does not divide by zero.
+ */
+const sampleResolutionMs = 0.000001;
+
+function benchGroupKey(workload, timing) {
+  return `${workload}/${timing}`;
+}
+
+async function readBaseline(baselineDir, profileName) {
+  let text;
+  try {
+    text = await readFile(join(baselineDir, `${profileName}.json`), "utf8");
+  } catch (error) {
+    if (error.code === "ENOENT") {
+      return null;
+    }
+    throw error;
+  }
+  const baseline = JSON.parse(text);
+  if (baseline.profile !== profileName || !baseline.groups) {
+    throw new Error(`Baseline for profile='${profileName}' has no matching profile/groups entries`);
+  }
+  return baseline;
+}
+
+/*
+ * A mode regresses when even the low end of its current interval is slower than
+ * the baseline mean plus the tolerance, and counts as improved when the high end
+ * is faster than the baseline minus the tolerance. Anything in between is drift
+ * the runner's noise can explain.
+ */
+function compareWithBaseline(profileName, groupKey, modeName, baselineMode, stats, tolerance) {
+  const baselineMs = parsePositiveFloat(
+    baselineMode.trimmed_mean_ms,
+    `baseline ${profileName}/${groupKey}/${modeName}`
+  );
+  const limitMs = baselineMs * (1.0 + tolerance);
+  let status = "ok";
+  if (stats.ciLowMs > limitMs) {
+    status = "regressed";
+  } else if (stats.ciHighMs < baselineMs * (1.0 - tolerance)) {
+    status = "improved";
+  }
+  return {
+    profile: profileName,
+    group: groupKey,
+    mode: modeName,
+    baseline_ms: baselineMs,
+    current_trimmed_mean_ms: stats.trimmedMeanMs,
+    current_ci95_low_ms: stats.ciLowMs,
+    current_ci95_high_ms: stats.ciHighMs,
+    change_pct: (stats.trimmedMeanMs / baselineMs - 1.0) * 100.0,
+    tolerance,
+    status
+  };
+}
+
+function ensureModeEntries(byMode, profileName, groupKey, modeName) {
+  if (!byMode.has(modeName)) {
+    throw new Error(`Missing benchmark summary for profile='${profileName}' group='${groupKey}' mode='${modeName}'`);
   }
   return byMode.get(modeName);
 }
 
-let logPath = "";
+const inputPaths = [];
 let emitJson = false;
 let jsonOutPath = "";
 let enforceThresholds = true;
+let compareBaselines = false;
+let updateBaselines = false;
+let baselineDir = fileURLToPath(new URL("../bench-baselines/", import.meta.url));
 
 const args = process.argv.slice(2);
 for (let i = 0; i < args.length; ++i) {
@@ -105,6 +227,23 @@ for (let i = 0; i < args.length; ++i) {
     enforceThresholds = false;
     continue;
   }
+  if (arg === "--compare-baselines") {
+    compareBaselines = true;
+    continue;
+  }
+  if (arg === "--update-baselines") {
+    updateBaselines = true;
+    continue;
+  }
+  if (arg === "--baseline-dir") {
+    const nextValue = args[i + 1];
+    if (!nextValue) {
+      throw new Error("--baseline-dir requires a directory path");
+    }
+    baselineDir = nextValue;
+    i += 1;
+    continue;
+  }
   if (arg === "--json-out") {
     const nextValue = args[i + 1];
     if (!nextValue) {
@@ -117,70 +256,168 @@ for (let i = 0; i < args.length; ++i) {
   if (arg.startsWith("--")) {
     throw new Error(`Unknown option '${arg}'`);
   }
-  if (!logPath) {
-    logPath = arg;
-    continue;
-  }
-  throw new Error("Only one runtime-smoke-log-path argument is supported");
+  inputPaths.push(arg);
 }
 
-if (!logPath) {
+if (!inputPaths.length) {
   throw new Error(
-    "Usage: node validate_dispatch_bench.mjs <runtime-smoke-log-path> [--emit-json] [--json-out <path>] [--no-validate]"
+    "Usage: node validate_dispatch_bench.mjs <runtime-smoke-log-or-report-path>... [--emit-json] [--json-out <path>] [--no-validate] " +
+      "[--compare-baselines] [--update-baselines] [--baseline-dir <path>]"
   );
 }
+if (compareBaselines && updateBaselines) {
+  throw new Error("--compare-baselines and --update-baselines are mutually exclusive");
+}
+/* Recording a new baseline must not be blocked by the gates it is meant to reset. */
+if (updateBaselines) {
+  enforceThresholds = false;
+}
 
-const logText = await readFile(logPath, "utf8");
-const summaries = parseSummaryBlocks(logText);
+/* Inputs are runtime smoke logs or the per-block JSON reports the smoke writes next to them. */
+const summaries = [];
+for (const inputPath of inputPaths) {
+  const inputText = await readFile(inputPath, "utf8");
+  if (inputPath.endsWith(".json")) {
+    summaries.push(parseSummaryReport(inputText, inputPath));
+  } else {
+    summaries.push(...parseSummaryBlocks(inputText));
+  }
+}
 if (!summaries.length) {
   throw new Error("No 'dispatch timing summary' blocks were found in runtime smoke log");
 }
 
+/*
+ * Samples are pooled per profile, workload/timing group and mode. Different
+ * workloads and per-call versus persistent timings measure different things, so
+ * they are never mixed into one distribution.
+ */
 const benchmarksByProfile = new Map();
 for (const summary of summaries) {
   if (!benchmarksByProfile.has(summary.profile)) {
     benchmarksByProfile.set(summary.profile, new Map());
   }
-  const profileMap = benchmarksByProfile.get(summary.profile);
-  if (!profileMap.has(summary.mode)) {
-    profileMap.set(summary.mode, []);
+  const byGroup = benchmarksByProfile.get(summary.profile);
+  const groupKey = benchGroupKey(summary.workload, summary.timing);
+  if (!byGroup.has(groupKey)) {
+    byGroup.set(groupKey, { workload: summary.workload, timing: summary.timing, byMode: new Map() });
+  }
+  const byMode = byGroup.get(groupKey).byMode;
+  if (!byMode.has(summary.mode)) {
+    byMode.set(summary.mode, []);
   }
-  profileMap.get(summary.mode).push(summary.avgMs);
+  byMode.get(summary.mode).push(...summary.samplesMs);
 }
 
 const requiredProfiles = normalizeRequiredProfiles();
 const reportProfiles = [];
 for (const profileName of requiredProfiles) {
-  const fastSamples = ensureModeEntries(benchmarksByProfile, profileName, "fast_wasm");
-  const rawSamples = ensureModeEntries(benchmarksByProfile, profileName, "raw_llvm_ir");
-
-  const fastAvgMs = average(fastSamples);
-  const rawAvgMs = average(rawSamples);
-  const speedup = rawAvgMs / fastAvgMs;
-  const minSpeedup = envThresholdForProfile(profileName);
-  const profilePass = speedup >= minSpeedup;
-
-  reportProfiles.push({
-    name: profileName,
-    fast_wasm_avg_ms: fastAvgMs,
-    raw_llvm_ir_avg_ms: rawAvgMs,
-    speedup_x: speedup,
-    required_min_speedup_x: minSpeedup,
-    pass: profilePass
-  });
+  const byGroup = benchmarksByProfile.get(profileName);
+  if (!byGroup) {
+    throw new Error(`Missing benchmark summary for profile='${profileName}'`);
+  }
+  for (const [groupKey, group] of byGroup) {
+    const fastSamples = ensureModeEntries(group.byMode, profileName, groupKey, "fast_wasm");
+    const rawSamples = ensureModeEntries(group.byMode, profileName, groupKey, "raw_llvm_ir");
 
-  console.log(
-    `[bench] profile=${profileName} fast_wasm_avg_ms=${fastAvgMs.toFixed(6)} raw_llvm_ir_avg_ms=${rawAvgMs.toFixed(6)} speedup=${speedup.toFixed(3)}x required>=${minSpeedup.toFixed(3)}x`
-  );
+    /*
+     * The gate compares the raw/fast ratio of the trimmed means with the
+     * threshold. The bootstrap interval of that ratio is reported next to it but
+     * does not gate, since a handful of samples on a shared runner gives a wide
+     * interval.
+     */
+    const fastStats = computeTimingStats(fastSamples);
+    const rawStats = computeTimingStats(rawSamples);
+    if (fastStats.trimmedMeanMs <= 0.0) {
+      throw new Error(
+        `fast_wasm samples for profile='${profileName}' group='${groupKey}' are all 0.000000 ms; ` +
+          "the speedup is unbounded, raise WEBVULKAN_RUNTIME_BENCH_ITERATIONS or the workload size"
+      );
+    }
+    const speedup = rawStats.trimmedMeanMs / fastStats.trimmedMeanMs;
+    const speedupInterval = bootstrapRatioInterval(
+      rawStats.keptSamples,
+      fastStats.keptSamples.map((value) => Math.max(value, sampleResolutionMs))
+    );
+    const minSpeedup = envThresholdForProfile(profileName);
+    const profilePass = speedup >= minSpeedup;
+
+    reportProfiles.push({
+      name: profileName,
+      workload: group.workload,
+      timing: group.timing,
+      fast_wasm_avg_ms: fastStats.meanMs,
+      raw_llvm_ir_avg_ms: rawStats.meanMs,
+      fast_wasm: statsReport(fastStats),
+      raw_llvm_ir: statsReport(rawStats),
+      speedup_x: speedup,
+      speedup_ci95_low_x: speedupInterval.low,
+      speedup_ci95_high_x: speedupInterval.high,
+      required_min_speedup_x: minSpeedup,
+      pass: profilePass
+    });
 
-  if (enforceThresholds && speedup < minSpeedup) {
-    throw new Error(
-      `Benchmark gate failed for profile='${profileName}': observed speedup ${speedup.toFixed(3)}x < required ${minSpeedup.toFixed(3)}x`
+    console.log(
+      `[bench] profile=${profileName} workload=${group.workload} timing=${group.timing} fast_wasm_ci95_ms=[${fastStats.ciLowMs.toFixed(6)},${fastStats.ciHighMs.toFixed(6)}] raw_llvm_ir_ci95_ms=[${rawStats.ciLowMs.toFixed(6)},${rawStats.ciHighMs.toFixed(6)}] speedup=${speedup.toFixed(3)}x ci95=[${speedupInterval.low.toFixed(3)}x,${speedupInterval.high.toFixed(3)}x] required>=${minSpeedup.toFixed(3)}x`
     );
+
+    if (enforceThresholds && !profilePass) {
+      throw new Error(
+        `Benchmark gate failed for profile='${profileName}' group='${groupKey}': observed speedup ${speedup.toFixed(3)}x < required ${minSpeedup.toFixed(3)}x (ci95=[${speedupInterval.low.toFixed(3)}x,${speedupInterval.high.toFixed(3)}x])`
+      );
+    }
+  }
+}
+
+const baselineComparisons = [];
+if (compareBaselines) {
+  for (const profileName of requiredProfiles) {
+    const baseline = await readBaseline(baselineDir, profileName);
+    if (!baseline) {
+      throw new Error(
+        `Missing baseline for profile='${profileName}' in ${baselineDir}; record one with --update-baselines`
+      );
+    }
+    const tolerance = envRegressionToleranceForProfile(profileName);
+    const byGroup = benchmarksByProfile.get(profileName);
+    /* Every measured mode needs a baseline, and every baseline mode must have been measured. */
+    for (const [groupKey, group] of byGroup) {
+      for (const modeName of group.byMode.keys()) {
+        if (!baseline.groups[groupKey] || !baseline.groups[groupKey][modeName]) {
+          throw new Error(
+            `Missing baseline for profile='${profileName}' group='${groupKey}' mode='${modeName}'; ` +
+              "record one with --update-baselines"
+          );
+        }
+      }
+    }
+    for (const [groupKey, baselineModes] of Object.entries(baseline.groups)) {
+      const group = byGroup.get(groupKey);
+      for (const [modeName, baselineMode] of Object.entries(baselineModes)) {
+        if (!group || !group.byMode.has(modeName)) {
+          throw new Error(
+            `Baseline profile='${profileName}' group='${groupKey}' mode='${modeName}' has no samples in the log`
+          );
+        }
+        const comparison = compareWithBaseline(
+          profileName,
+          groupKey,
+          modeName,
+          baselineMode,
+          computeTimingStats(group.byMode.get(modeName)),
+          tolerance
+        );
+        baselineComparisons.push(comparison);
+        console.log(
+          `[bench] baseline profile=${profileName} group=${groupKey} mode=${modeName} baseline_ms=${comparison.baseline_ms.toFixed(6)} current_ci95_ms=[${comparison.current_ci95_low_ms.toFixed(6)},${comparison.current_ci95_high_ms.toFixed(6)}] change=${comparison.change_pct.toFixed(1)}% tolerance=${(tolerance * 100.0).toFixed(1)}% status=${comparison.status}`
+        );
+      }
+    }
   }
 }
 
 const speedupValues = reportProfiles.map((profile) => profile.speedup_x);
+const minSpeedupCiLowObserved = Math.min(...reportProfiles.map((profile) => profile.speedup_ci95_low_x));
 const minSpeedupObserved = Math.min(...speedupValues);
 const maxSpeedupObserved = Math.max(...speedupValues);
 const avgSpeedupObserved = average(speedupValues);
@@ -196,9 +433,14 @@ const report = {
     max_speedup_x: maxSpeedupObserved,
     avg_speedup_x: avgSpeedupObserved,
     geomean_speedup_x: geometricMeanSpeedupObserved,
+    min_speedup_ci95_low_x: minSpeedupCiLowObserved,
     all_profiles_pass: reportProfiles.every((profile) => profile.pass)
   }
 };
+if (compareBaselines) {
+  report.baselines = baselineComparisons;
+  report.summary.baseline_regressions = baselineComparisons.filter((entry) => entry.status === "regressed").length;
+}
 
 if (jsonOutPath) {
   await writeFile(jsonOutPath, JSON.stringify(report, null, 2) + "\n", "utf8");
@@ -209,6 +451,42 @@ if (emitJson) {
   console.log(JSON.stringify(report, null, 2));
 }
 
+if (updateBaselines) {
+  await mkdir(baselineDir, { recursive: true });
+  for (const [profileName, byGroup] of benchmarksByProfile) {
+    const groups = {};
+    for (const [groupKey, group] of byGroup) {
+      const modes = {};
+      for (const [modeName, modeSamples] of group.byMode) {
+        const stats = computeTimingStats(modeSamples);
+        modes[modeName] = {
+          samples: stats.count,
+          trimmed_mean_ms: stats.trimmedMeanMs,
+          median_ms: stats.medianMs,
+          p90_ms: stats.p90Ms,
+          ci95_low_ms: stats.ciLowMs,
+          ci95_high_ms: stats.ciHighMs
+        };
+      }
+      groups[groupKey] = modes;
+    }
+    const baselinePath = join(baselineDir, `${profileName}.json`);
+    const baseline = { profile: profileName, source: inputPaths.map((inputPath) => basename(inputPath)).join(","), groups };
+    await writeFile(baselinePath, JSON.stringify(baseline, null, 2) + "\n", "utf8");
+    console.log(`[bench] baseline updated profile=${profileName} path=${baselinePath}`);
+  }
+}
+
+const baselineRegressions = baselineComparisons.filter((entry) => entry.status === "regressed");
+if (enforceThresholds && baselineRegressions.length) {
+  throw new Error(
+    "Baseline regression gate failed: " +
+      baselineRegressions
+        .map((entry) => `${entry.profile}/${entry.group}/${entry.mode} ${entry.change_pct.toFixed(1)}% slower than baseline`)
+        .join(", ")
+  );
+}
+
 if (enforceThresholds) {
   console.log("[bench] runtime benchmark gate passed");
 } else {